@@ -464,11 +464,21 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest
 
     HEADERS += \
+        src/ADSB/ADSBTest.h \
+        src/AnalyzeView/ExifParserTest.h \
+        src/AnalyzeView/LogDownloadControllerTest.h \
+        src/AnalyzeView/TimeSeriesRingBufferTest.h \
+        src/AnalyzeView/ULogReaderTest.h \
         src/Audio/AudioOutputTest.h \
+        src/comm/LinkOutboundSchedulerTest.h \
+        src/comm/MAVLinkForwarderTest.h \
+        src/comm/MAVLinkFrameScannerTest.h \
+        src/comm/MAVLinkParseBenchmarkTest.h \
         src/FactSystem/FactSystemTestBase.h \
         src/FactSystem/FactSystemTestGeneric.h \
         src/FactSystem/FactSystemTestPX4.h \
         src/FactSystem/ParameterManagerTest.h \
+        src/FactSystem/SettingsFactWriterTest.h \
         src/MissionManager/CameraCalcTest.h \
         src/MissionManager/CameraSectionTest.h \
         src/MissionManager/CorridorScanComplexItemTest.h \
@@ -481,6 +491,7 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/MissionItemTest.h \
         src/MissionManager/MissionManagerTest.h \
         src/MissionManager/MissionSettingsTest.h \
+        src/MissionManager/PlanBenchmarkTest.h \
         src/MissionManager/PlanMasterControllerTest.h \
         src/MissionManager/QGCMapPolygonTest.h \
         src/MissionManager/QGCMapPolylineTest.h \
@@ -492,17 +503,26 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.h \
         src/MissionManager/TransectStyleComplexItemTestBase.h \
         src/MissionManager/VisualMissionItemTest.h \
+        src/qgcunittest/BenchmarkResults.h \
         src/qgcunittest/ComponentInformationCacheTest.h \
         src/qgcunittest/GeoTest.h \
         src/qgcunittest/MavlinkLogTest.h \
         src/qgcunittest/MultiSignalSpy.h \
         src/qgcunittest/MultiSignalSpyV2.h \
+        src/qgcunittest/TelemetryTracerTest.h \
         src/qgcunittest/UnitTest.h \
+        src/QmlControls/ParameterSearchIndexTest.h \
+        src/uas/UASMessageHandlerTest.h \
+        src/Vehicle/CommandLatencyStatsTest.h \
         src/Vehicle/FTPManagerTest.h \
         src/Vehicle/InitialConnectTest.h \
+        src/Vehicle/MultiVehicleManagerTest.h \
         src/Vehicle/RequestMessageTest.h \
         src/Vehicle/SendMavCommandWithHandlerTest.h \
         src/Vehicle/SendMavCommandWithSignallingTest.h \
+        src/Vehicle/SwarmBenchmarkTest.h \
+        src/Vehicle/TimerWheelTest.h \
+        src/Vehicle/TrajectoryPointsTest.h \
         src/Vehicle/VehicleLinkManagerTest.h \
         #src/qgcunittest/RadioConfigTest.h \
         #src/AnalyzeView/LogDownloadTest.h \
@@ -512,11 +532,21 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         #src/qgcunittest/MessageBoxTest.h \
 
     SOURCES += \
+        src/ADSB/ADSBTest.cc \
+        src/AnalyzeView/ExifParserTest.cc \
+        src/AnalyzeView/LogDownloadControllerTest.cc \
+        src/AnalyzeView/TimeSeriesRingBufferTest.cc \
+        src/AnalyzeView/ULogReaderTest.cc \
         src/Audio/AudioOutputTest.cc \
+        src/comm/LinkOutboundSchedulerTest.cc \
+        src/comm/MAVLinkForwarderTest.cc \
+        src/comm/MAVLinkFrameScannerTest.cc \
+        src/comm/MAVLinkParseBenchmarkTest.cc \
         src/FactSystem/FactSystemTestBase.cc \
         src/FactSystem/FactSystemTestGeneric.cc \
         src/FactSystem/FactSystemTestPX4.cc \
         src/FactSystem/ParameterManagerTest.cc \
+        src/FactSystem/SettingsFactWriterTest.cc \
         src/MissionManager/CameraCalcTest.cc \
         src/MissionManager/CameraSectionTest.cc \
         src/MissionManager/CorridorScanComplexItemTest.cc \
@@ -529,6 +559,7 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/MissionItemTest.cc \
         src/MissionManager/MissionManagerTest.cc \
         src/MissionManager/MissionSettingsTest.cc \
+        src/MissionManager/PlanBenchmarkTest.cc \
         src/MissionManager/PlanMasterControllerTest.cc \
         src/MissionManager/QGCMapPolygonTest.cc \
         src/MissionManager/QGCMapPolylineTest.cc \
@@ -540,18 +571,27 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.cc \
         src/MissionManager/TransectStyleComplexItemTestBase.cc \
         src/MissionManager/VisualMissionItemTest.cc \
+        src/qgcunittest/BenchmarkResults.cc \
         src/qgcunittest/ComponentInformationCacheTest.cc \
         src/qgcunittest/GeoTest.cc \
         src/qgcunittest/MavlinkLogTest.cc \
         src/qgcunittest/MultiSignalSpy.cc \
         src/qgcunittest/MultiSignalSpyV2.cc \
+        src/qgcunittest/TelemetryTracerTest.cc \
         src/qgcunittest/UnitTest.cc \
         src/qgcunittest/UnitTestList.cc \
+        src/QmlControls/ParameterSearchIndexTest.cc \
+        src/uas/UASMessageHandlerTest.cc \
+        src/Vehicle/CommandLatencyStatsTest.cc \
         src/Vehicle/FTPManagerTest.cc \
         src/Vehicle/InitialConnectTest.cc \
+        src/Vehicle/MultiVehicleManagerTest.cc \
         src/Vehicle/RequestMessageTest.cc \
         src/Vehicle/SendMavCommandWithHandlerTest.cc \
         src/Vehicle/SendMavCommandWithSignallingTest.cc \
+        src/Vehicle/SwarmBenchmarkTest.cc \
+        src/Vehicle/TimerWheelTest.cc \
+        src/Vehicle/TrajectoryPointsTest.cc \
         src/Vehicle/VehicleLinkManagerTest.cc \
         #src/qgcunittest/RadioConfigTest.cc \
         #src/AnalyzeView/LogDownloadTest.cc \
@@ -565,11 +605,15 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
 # Main QGC Headers and Source files
 
 HEADERS += \
+    src/ADSB/ADSBSpatialIndex.h \
     src/ADSB/ADSBVehicle.h \
     src/ADSB/ADSBVehicleManager.h \
     src/AnalyzeView/LogDownloadController.h \
     src/AnalyzeView/PX4LogParser.h \
+    src/AnalyzeView/TelemetryTraceController.h \
+    src/AnalyzeView/TimeSeriesRingBuffer.h \
     src/AnalyzeView/ULogParser.h \
+    src/AnalyzeView/ULogReader.h \
     src/AnalyzeView/MavlinkConsoleController.h \
     src/Audio/AudioOutput.h \
     src/Vehicle/Autotune.h \
@@ -658,6 +702,7 @@ HEADERS += \
     src/QmlControls/InstrumentValueData.h \
     src/QmlControls/FactValueGrid.h \
     src/QmlControls/ParameterEditorController.h \
+    src/QmlControls/ParameterSearchIndex.h \
     src/QmlControls/QGCFileDialogController.h \
     src/QmlControls/QGCImageProvider.h \
     src/QmlControls/QGroundControlQmlGlobal.h \
@@ -686,6 +731,7 @@ HEADERS += \
     src/Settings/VideoSettings.h \
     src/ShapeFileHelper.h \
     src/SHPFileHelper.h \
+    src/TelemetryTracer.h \
     src/Terrain/TerrainQuery.h \
     src/TerrainTile.h \
     src/Vehicle/Actuators/ActuatorActions.h \
@@ -696,6 +742,7 @@ HEADERS += \
     src/Vehicle/Actuators/GeometryImage.h \
     src/Vehicle/Actuators/Mixer.h \
     src/Vehicle/Actuators/MotorAssignment.h \
+    src/Vehicle/CommandLatencyStats.h \
     src/Vehicle/CompInfo.h \
     src/Vehicle/CompInfoActuators.h \
     src/Vehicle/CompInfoEvents.h \
@@ -709,6 +756,7 @@ HEADERS += \
     src/Vehicle/HealthAndArmingChecks.h \
     src/Vehicle/ImageProtocolManager.h \
     src/Vehicle/InitialConnectStateMachine.h \
+    src/Vehicle/LinkHealth.h \
     src/Vehicle/MAVLinkLogManager.h \
     src/Vehicle/MAVLinkStreamConfig.h \
     src/Vehicle/MultiVehicleManager.h \
@@ -716,6 +764,7 @@ HEADERS += \
     src/Vehicle/SysStatusSensorInfo.h \
     src/Vehicle/TerrainFactGroup.h \
     src/Vehicle/TerrainProtocolHandler.h \
+    src/Vehicle/TimerWheel.h \
     src/Vehicle/TrajectoryPoints.h \
     src/Vehicle/Vehicle.h \
     src/Vehicle/VehicleObjectAvoidance.h \
@@ -737,7 +786,10 @@ HEADERS += \
     src/comm/LinkConfiguration.h \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
+    src/comm/LinkOutboundScheduler.h \
     src/comm/LogReplayLink.h \
+    src/comm/MAVLinkForwarder.h \
+    src/comm/MAVLinkFrameScanner.h \
     src/comm/MAVLinkProtocol.h \
     src/comm/QGCMAVLink.h \
     src/comm/TCPLink.h \
@@ -764,6 +816,7 @@ HEADERS += \
     src/comm/MockLink.h \
     src/comm/MockLinkFTP.h \
     src/comm/MockLinkMissionItemHandler.h \
+    src/comm/MockLinkSwarm.h \
 }
 
 WindowsBuild {
@@ -820,11 +873,15 @@ AndroidBuild {
 }
 
 SOURCES += \
+    src/ADSB/ADSBSpatialIndex.cc \
     src/ADSB/ADSBVehicle.cc \
     src/ADSB/ADSBVehicleManager.cc \
     src/AnalyzeView/LogDownloadController.cc \
     src/AnalyzeView/PX4LogParser.cc \
+    src/AnalyzeView/TelemetryTraceController.cc \
+    src/AnalyzeView/TimeSeriesRingBuffer.cc \
     src/AnalyzeView/ULogParser.cc \
+    src/AnalyzeView/ULogReader.cc \
     src/AnalyzeView/MavlinkConsoleController.cc \
     src/Audio/AudioOutput.cc \
     src/Vehicle/Autotune.cpp \
@@ -909,6 +966,7 @@ SOURCES += \
     src/QmlControls/InstrumentValueData.cc \
     src/QmlControls/FactValueGrid.cc \
     src/QmlControls/ParameterEditorController.cc \
+    src/QmlControls/ParameterSearchIndex.cc \
     src/QmlControls/QGCFileDialogController.cc \
     src/QmlControls/QGCImageProvider.cc \
     src/QmlControls/QGroundControlQmlGlobal.cc \
@@ -937,6 +995,7 @@ SOURCES += \
     src/Settings/VideoSettings.cc \
     src/ShapeFileHelper.cc \
     src/SHPFileHelper.cc \
+    src/TelemetryTracer.cc \
     src/Terrain/TerrainQuery.cc \
     src/TerrainTile.cc\
     src/Vehicle/Actuators/ActuatorActions.cc \
@@ -947,6 +1006,7 @@ SOURCES += \
     src/Vehicle/Actuators/GeometryImage.cc \
     src/Vehicle/Actuators/Mixer.cc \
     src/Vehicle/Actuators/MotorAssignment.cc \
+    src/Vehicle/CommandLatencyStats.cc \
     src/Vehicle/CompInfo.cc \
     src/Vehicle/CompInfoActuators.cc \
     src/Vehicle/CompInfoEvents.cc \
@@ -960,6 +1020,7 @@ SOURCES += \
     src/Vehicle/HealthAndArmingChecks.cc \
     src/Vehicle/ImageProtocolManager.cc \
     src/Vehicle/InitialConnectStateMachine.cc \
+    src/Vehicle/LinkHealth.cc \
     src/Vehicle/MAVLinkLogManager.cc \
     src/Vehicle/MAVLinkStreamConfig.cc \
     src/Vehicle/MultiVehicleManager.cc \
@@ -967,6 +1028,7 @@ SOURCES += \
     src/Vehicle/SysStatusSensorInfo.cc \
     src/Vehicle/TerrainFactGroup.cc \
     src/Vehicle/TerrainProtocolHandler.cc \
+    src/Vehicle/TimerWheel.cc \
     src/Vehicle/TrajectoryPoints.cc \
     src/Vehicle/Vehicle.cc \
     src/Vehicle/VehicleObjectAvoidance.cc \
@@ -988,7 +1050,10 @@ SOURCES += \
     src/comm/LinkConfiguration.cc \
     src/comm/LinkInterface.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkOutboundScheduler.cc \
     src/comm/LogReplayLink.cc \
+    src/comm/MAVLinkForwarder.cc \
+    src/comm/MAVLinkFrameScanner.cc \
     src/comm/MAVLinkProtocol.cc \
     src/comm/QGCMAVLink.cc \
     src/comm/TCPLink.cc \
@@ -1010,6 +1075,7 @@ SOURCES += \
     src/comm/MockLink.cc \
     src/comm/MockLinkFTP.cc \
     src/comm/MockLinkMissionItemHandler.cc \
+    src/comm/MockLinkSwarm.cc \
 }
 
 !NoSerialBuild {
@@ -1252,6 +1318,7 @@ HEADERS += \
     src/FactSystem/FactValueSliderListModel.h \
     src/FactSystem/ParameterManager.h \
     src/FactSystem/SettingsFact.h \
+    src/FactSystem/SettingsFactWriter.h \
 
 SOURCES += \
     src/FactSystem/Fact.cc \
@@ -1262,6 +1329,7 @@ SOURCES += \
     src/FactSystem/FactValueSliderListModel.cc \
     src/FactSystem/ParameterManager.cc \
     src/FactSystem/SettingsFact.cc \
+    src/FactSystem/SettingsFactWriter.cc \
 
 #-------------------------------------------------------------------------------------
 # MAVLink Inspector
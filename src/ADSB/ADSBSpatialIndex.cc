@@ -0,0 +1,109 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBSpatialIndex.h"
+
+#include <QtMath>
+
+int ADSBSpatialIndex::_latCell(double latitude)
+{
+    return static_cast<int>(qFloor((latitude + 90.0) / _cellSizeDegrees));
+}
+
+/// Longitude cells wrap around the anti-meridian
+int ADSBSpatialIndex::_lonCell(double longitude)
+{
+    int cell = static_cast<int>(qFloor((longitude + 180.0) / _cellSizeDegrees)) % _cLonCells;
+    return cell < 0 ? cell + _cLonCells : cell;
+}
+
+quint64 ADSBSpatialIndex::_cellKey(int latCell, int lonCell)
+{
+    return (static_cast<quint64>(static_cast<quint32>(latCell)) << 32) | static_cast<quint32>(lonCell);
+}
+
+void ADSBSpatialIndex::update(uint32_t icaoAddress, const QGeoCoordinate& coordinate)
+{
+    if (!coordinate.isValid()) {
+        remove(icaoAddress);
+        return;
+    }
+
+    const quint64 newCellKey = _cellKey(_latCell(coordinate.latitude()), _lonCell(coordinate.longitude()));
+
+    auto iter = _entries.find(icaoAddress);
+    if (iter != _entries.end()) {
+        if (iter->cellKey != newCellKey) {
+            _cells[iter->cellKey].removeOne(icaoAddress);
+            if (_cells[iter->cellKey].isEmpty()) {
+                _cells.remove(iter->cellKey);
+            }
+            _cells[newCellKey].append(icaoAddress);
+            iter->cellKey = newCellKey;
+        }
+        iter->coordinate = coordinate;
+    } else {
+        _entries.insert(icaoAddress, { newCellKey, coordinate });
+        _cells[newCellKey].append(icaoAddress);
+    }
+}
+
+void ADSBSpatialIndex::remove(uint32_t icaoAddress)
+{
+    auto iter = _entries.find(icaoAddress);
+    if (iter != _entries.end()) {
+        auto cellIter = _cells.find(iter->cellKey);
+        if (cellIter != _cells.end()) {
+            cellIter->removeOne(icaoAddress);
+            if (cellIter->isEmpty()) {
+                _cells.erase(cellIter);
+            }
+        }
+        _entries.erase(iter);
+    }
+}
+
+void ADSBSpatialIndex::clear(void)
+{
+    _entries.clear();
+    _cells.clear();
+}
+
+QVector<uint32_t> ADSBSpatialIndex::query(const QGeoCoordinate& center, double radiusMeters) const
+{
+    QVector<uint32_t> result;
+    if (!center.isValid() || _entries.isEmpty()) {
+        return result;
+    }
+
+    const double latRadiusDegrees = radiusMeters / _metersPerDegree;
+    const double cosLatitude      = qMax(qCos(qDegreesToRadians(center.latitude())), 0.01);
+    const double lonRadiusDegrees = qMin(radiusMeters / (_metersPerDegree * cosLatitude), 180.0);
+
+    const int latCellMin = _latCell(qMax(center.latitude() - latRadiusDegrees, -90.0));
+    const int latCellMax = _latCell(qMin(center.latitude() + latRadiusDegrees, 90.0));
+    const int cLonSpan   = qMin(static_cast<int>(qCeil((2 * lonRadiusDegrees) / _cellSizeDegrees)) + 1, static_cast<int>(_cLonCells));
+    const int lonCellMin = _lonCell(center.longitude() - lonRadiusDegrees);
+
+    for (int latCell=latCellMin; latCell<=latCellMax; latCell++) {
+        for (int i=0; i<cLonSpan; i++) {
+            auto cellIter = _cells.constFind(_cellKey(latCell, (lonCellMin + i) % _cLonCells));
+            if (cellIter == _cells.constEnd()) {
+                continue;
+            }
+            for (uint32_t icaoAddress: cellIter.value()) {
+                if (_entries.value(icaoAddress).coordinate.distanceTo(center) <= radiusMeters) {
+                    result.append(icaoAddress);
+                }
+            }
+        }
+    }
+
+    return result;
+}
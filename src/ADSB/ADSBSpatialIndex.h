@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QVector>
+#include <QGeoCoordinate>
+
+/// Uniform lat/lon grid of ADSB targets keyed by ICAO address. Used for proximity queries without
+/// having to check the distance to every known target.
+class ADSBSpatialIndex
+{
+public:
+    ADSBSpatialIndex(void) = default;
+
+    void    update  (uint32_t icaoAddress, const QGeoCoordinate& coordinate);
+    void    remove  (uint32_t icaoAddress);
+    void    clear   (void);
+    int     count   (void) const { return _entries.count(); }
+
+    /// @return ICAO addresses of all targets within radiusMeters of center
+    QVector<uint32_t> query(const QGeoCoordinate& center, double radiusMeters) const;
+
+private:
+    struct Entry_t {
+        quint64         cellKey;
+        QGeoCoordinate  coordinate;
+    };
+
+    static int      _latCell    (double latitude);
+    static int      _lonCell    (double longitude);
+    static quint64  _cellKey    (int latCell, int lonCell);
+
+    QHash<uint32_t, Entry_t>            _entries;
+    QHash<quint64, QVector<uint32_t>>   _cells;
+
+    static constexpr double _cellSizeDegrees    = 0.05;     ///< ~5.5km north/south
+    static constexpr int    _cLonCells          = 7200;     ///< 360 / _cellSizeDegrees
+    static constexpr double _metersPerDegree    = 111319.49;
+};
@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBTest.h"
+#include "ADSBVehicleManager.h"
+#include "ADSBSpatialIndex.h"
+
+#include <QSignalSpy>
+
+#include <algorithm>
+
+void ADSBTest::_sbsParserTest(void)
+{
+    ADSBVehicle::VehicleInfo_t adsbInfo;
+
+    // Airborne position, Mode C altitude is in feet
+    QVERIFY(ADSBTCPLink::_parseLine("MSG,3,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,DLH123  ,10000,,,52.5,13.4,,,0,0,0,0\r\n", adsbInfo));
+    QCOMPARE(adsbInfo.icaoAddress,      static_cast<uint32_t>(0x4CA2D6));
+    QCOMPARE(adsbInfo.availableFlags,   static_cast<uint32_t>(ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable));
+    QCOMPARE(adsbInfo.callsign,         QStringLiteral("DLH123"));
+    QCOMPARE(adsbInfo.location,         QGeoCoordinate(52.5, 13.4));
+    QVERIFY(qAbs(adsbInfo.altitude - 3048.0) < 0.001);
+
+    // Airborne velocity
+    QVERIFY(ADSBTCPLink::_parseLine("MSG,4,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,,450,271.5,,,64,,,,,0", adsbInfo));
+    QCOMPARE(adsbInfo.availableFlags,   static_cast<uint32_t>(ADSBVehicle::HeadingAvailable));
+    QCOMPARE(adsbInfo.heading,          271.5);
+
+    // Identification
+    QVERIFY(ADSBTCPLink::_parseLine("MSG,1,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,DLH123,,,,,,,,,,,0", adsbInfo));
+    QCOMPARE(adsbInfo.availableFlags,   static_cast<uint32_t>(ADSBVehicle::CallsignAvailable));
+    QCOMPARE(adsbInfo.callsign,         QStringLiteral("DLH123"));
+
+    // Lines which must be rejected, including ones which end before the fields that are needed
+    const char* rgBadLines[] = {
+        "",
+        "\r\n",
+        "SEL,,1,1,4CA2D6",
+        "MSG,3,1,1,NOTHEX,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,10000,,,52.5,13.4,,,0,0,0,0",
+        "MSG,3,1,1,4CA2D6",
+        "MSG,3,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,10000,,,52.5",
+        "MSG,3,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,10000,,,0,0,,,0,0,0,0",
+        "MSG,4,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,,450",
+        "MSG,8,1,1,4CA2D6,1,2020/05/17,12:00:00.000,2020/05/17,12:00:00.000,,,,,,,,,,,,0",
+    };
+    for (const char* badLine: rgBadLines) {
+        QVERIFY2(!ADSBTCPLink::_parseLine(badLine, adsbInfo), badLine);
+    }
+}
+
+void ADSBTest::_spatialIndexTest(void)
+{
+    ADSBSpatialIndex    index;
+    QGeoCoordinate      center(47.0, 8.0);
+
+    auto sortedQuery = [&](const QGeoCoordinate& queryCenter, double radiusMeters) {
+        QVector<uint32_t> result = index.query(queryCenter, radiusMeters);
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    QVERIFY(index.query(center, 2000).isEmpty());
+
+    index.update(1, center);
+    index.update(2, center.atDistanceAndAzimuth(1000, 0));
+    index.update(3, center.atDistanceAndAzimuth(1900, 90));
+    index.update(4, center.atDistanceAndAzimuth(10000, 180));
+    QCOMPARE(index.count(), 4);
+
+    QCOMPARE(sortedQuery(center, 2000), QVector<uint32_t>({ 1, 2, 3 }));
+    QCOMPARE(sortedQuery(center, 500),  QVector<uint32_t>({ 1 }));
+    QCOMPARE(sortedQuery(center, 20000),QVector<uint32_t>({ 1, 2, 3, 4 }));
+
+    // Moving to another cell and removing keep the index consistent
+    index.update(2, center.atDistanceAndAzimuth(50000, 0));
+    QCOMPARE(sortedQuery(center, 2000), QVector<uint32_t>({ 1, 3 }));
+    QCOMPARE(sortedQuery(center.atDistanceAndAzimuth(50000, 0), 100), QVector<uint32_t>({ 2 }));
+    index.remove(3);
+    QCOMPARE(index.count(), 3);
+    QCOMPARE(sortedQuery(center, 2000), QVector<uint32_t>({ 1 }));
+    index.update(1, QGeoCoordinate());
+    QCOMPARE(index.count(), 2);
+    QVERIFY(index.query(center, 2000).isEmpty());
+
+    // Targets just across a cell boundary and across the anti-meridian are found
+    index.clear();
+    QCOMPARE(index.count(), 0);
+    index.update(5, QGeoCoordinate(47.0499, 8.0));
+    index.update(6, QGeoCoordinate(0, 179.999));
+    QCOMPARE(sortedQuery(QGeoCoordinate(47.0501, 8.0), 100),  QVector<uint32_t>({ 5 }));
+    QCOMPARE(sortedQuery(QGeoCoordinate(0, -179.999), 1000),  QVector<uint32_t>({ 6 }));
+}
+
+void ADSBTest::_alertTest(void)
+{
+    ADSBVehicle::VehicleInfo_t vehicleInfo;
+    vehicleInfo.icaoAddress     = 0x4CA2D6;
+    vehicleInfo.location        = QGeoCoordinate(47.0, 8.0);
+    vehicleInfo.alert           = true;
+    vehicleInfo.availableFlags  = ADSBVehicle::LocationAvailable | ADSBVehicle::AlertAvailable;
+
+    ADSBVehicle adsbVehicle(vehicleInfo, nullptr);
+    QSignalSpy  spyAlertChanged(&adsbVehicle, &ADSBVehicle::alertChanged);
+    QVERIFY(adsbVehicle.alert());
+
+    // Proximity can't clear an alert reported by the source
+    adsbVehicle.setProximityAlert(true);
+    adsbVehicle.setProximityAlert(false);
+    QVERIFY(adsbVehicle.alert());
+    QCOMPARE(spyAlertChanged.count(), 0);
+
+    // The source clearing its alert leaves the proximity alert in place
+    adsbVehicle.setProximityAlert(true);
+    vehicleInfo.alert = false;
+    adsbVehicle.update(vehicleInfo);
+    QVERIFY(adsbVehicle.alert());
+    QCOMPARE(spyAlertChanged.count(), 0);
+
+    adsbVehicle.setProximityAlert(false);
+    QVERIFY(!adsbVehicle.alert());
+    QCOMPARE(spyAlertChanged.count(), 1);
+}
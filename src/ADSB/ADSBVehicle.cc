@@ -15,11 +15,12 @@
 #include <QtMath>
 
 ADSBVehicle::ADSBVehicle(const VehicleInfo_t& vehicleInfo, QObject* parent)
-    : QObject       (parent)
-    , _icaoAddress  (vehicleInfo.icaoAddress)
-    , _altitude     (qQNaN())
-    , _heading      (qQNaN())
-    , _alert        (false)
+    : QObject           (parent)
+    , _icaoAddress      (vehicleInfo.icaoAddress)
+    , _altitude         (qQNaN())
+    , _heading          (qQNaN())
+    , _sourceAlert      (false)
+    , _proximityAlert   (false)
 {
     update(vehicleInfo);
 }
@@ -55,14 +56,28 @@ void ADSBVehicle::update(const VehicleInfo_t& vehicleInfo)
         }
     }
     if (vehicleInfo.availableFlags & AlertAvailable) {
-        if (vehicleInfo.alert != _alert) {
-            _alert = vehicleInfo.alert;
-            emit alertChanged();
+        if (vehicleInfo.alert != _sourceAlert) {
+            const bool oldAlert = alert();
+            _sourceAlert = vehicleInfo.alert;
+            if (alert() != oldAlert) {
+                emit alertChanged();
+            }
         }
     }
     _lastUpdateTimer.restart();
 }
 
+void ADSBVehicle::setProximityAlert(bool proximityAlert)
+{
+    if (proximityAlert != _proximityAlert) {
+        const bool oldAlert = alert();
+        _proximityAlert = proximityAlert;
+        if (alert() != oldAlert) {
+            emit alertChanged();
+        }
+    }
+}
+
 bool ADSBVehicle::expired()
 {
     return _lastUpdateTimer.hasExpired(expirationTimeoutMs);
@@ -45,17 +45,21 @@ public:
     Q_PROPERTY(QGeoCoordinate   coordinate  READ coordinate     NOTIFY coordinateChanged)
     Q_PROPERTY(double           altitude    READ altitude       NOTIFY altitudeChanged)     // NaN for not available
     Q_PROPERTY(double           heading     READ heading        NOTIFY headingChanged)      // NaN for not available
-    Q_PROPERTY(bool             alert       READ alert          NOTIFY alertChanged)        // Collision path
+    Q_PROPERTY(bool             alert       READ alert          NOTIFY alertChanged)        // Collision path, reported by the ADSB source or by proximity to our vehicles
 
     int             icaoAddress (void) const { return static_cast<int>(_icaoAddress); }
     QString         callsign    (void) const { return _callsign; }
     QGeoCoordinate  coordinate  (void) const { return _coordinate; }
     double          altitude    (void) const { return _altitude; }
     double          heading     (void) const { return _heading; }
-    bool            alert       (void) const { return _alert; }
+    bool            alert       (void) const { return _sourceAlert || _proximityAlert; }
 
     void update(const VehicleInfo_t& vehicleInfo);
 
+    /// Sets the alert raised by proximity to one of our vehicles. It does not count as an update from the vehicle and
+    /// does not clear an alert reported by the ADSB source.
+    void setProximityAlert(bool proximityAlert);
+
     /// check if the vehicle is expired and should be removed
     bool expired();
 
@@ -72,7 +76,8 @@ private:
     QGeoCoordinate  _coordinate;
     double          _altitude;
     double          _heading;
-    bool            _alert;
+    bool            _sourceAlert;       ///< Alert reported by the ADSB source
+    bool            _proximityAlert;    ///< Alert raised by ADSBVehicleManager
 
     QElapsedTimer   _lastUpdateTimer;
 
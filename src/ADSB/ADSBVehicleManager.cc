@@ -12,6 +12,8 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "ADSBVehicleManagerSettings.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
 
 #include <QDebug>
 
@@ -28,10 +30,15 @@ void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
     _adsbVehicleCleanupTimer.setSingleShot(false);
     _adsbVehicleCleanupTimer.start(1000);
 
+    // Updates are only pushed to the model at a fixed rate so a busy receiver does not flood the QML map
+    connect(&_publishTimer, &QTimer::timeout, this, &ADSBVehicleManager::_publishUpdates);
+    _publishTimer.setSingleShot(false);
+    _publishTimer.start(_publishIntervalMsecs);
+
     ADSBVehicleManagerSettings* settings = qgcApp()->toolbox()->settingsManager()->adsbVehicleManagerSettings();
     if (settings->adsbServerConnectEnabled()->rawValue().toBool()) {
         _tcpLink = new ADSBTCPLink(settings->adsbServerHostAddress()->rawValue().toString(), settings->adsbServerPort()->rawValue().toInt(), this);
-        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdate,  this, &ADSBVehicleManager::adsbVehicleUpdate,   Qt::QueuedConnection);
+        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdates, this, &ADSBVehicleManager::adsbVehicleUpdates,  Qt::QueuedConnection);
         connect(_tcpLink, &ADSBTCPLink::error,              this, &ADSBVehicleManager::_tcpError,           Qt::QueuedConnection);
     }
 }
@@ -39,30 +46,147 @@ void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
 void ADSBVehicleManager::_cleanupStaleVehicles()
 {
     // Remove all expired ADSB vehicles
-    for (int i=_adsbVehicles.count()-1; i>=0; i--) {
-        ADSBVehicle* adsbVehicle = _adsbVehicles.value<ADSBVehicle*>(i);
-        if (adsbVehicle->expired()) {
-            qCDebug(ADSBVehicleManagerLog) << "Expired" << QStringLiteral("%1").arg(adsbVehicle->icaoAddress(), 0, 16);
-            _adsbVehicles.removeAt(i);
-            _adsbICAOMap.remove(adsbVehicle->icaoAddress());
-            adsbVehicle->deleteLater();
+    QList<uint32_t> rgExpired;
+    for (auto iter = _adsbICAOMap.constBegin(); iter != _adsbICAOMap.constEnd(); iter++) {
+        if (iter.value()->expired()) {
+            rgExpired.append(iter.key());
         }
     }
+
+    for (uint32_t icaoAddress: rgExpired) {
+        ADSBVehicle* adsbVehicle = _adsbICAOMap.take(icaoAddress);
+        qCDebug(ADSBVehicleManagerLog) << "Expired" << QStringLiteral("%1").arg(icaoAddress, 0, 16);
+        _adsbVehicles.removeOne(adsbVehicle);
+        _spatialIndex.remove(icaoAddress);
+        _alertICAOs.remove(icaoAddress);
+        adsbVehicle->deleteLater();
+    }
 }
 
 void ADSBVehicleManager::adsbVehicleUpdate(const ADSBVehicle::VehicleInfo_t vehicleInfo)
 {
-    uint32_t icaoAddress = vehicleInfo.icaoAddress;
-
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
-    } else {
-        if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
-            ADSBVehicle* adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-            _adsbICAOMap[icaoAddress] = adsbVehicle;
-            _adsbVehicles.append(adsbVehicle);
+    auto iter = _pendingUpdates.find(vehicleInfo.icaoAddress);
+    if (iter == _pendingUpdates.end()) {
+        _pendingUpdates.insert(vehicleInfo.icaoAddress, vehicleInfo);
+        return;
+    }
+
+    // Merge with the update which is already pending so only the latest value of each field is applied
+    ADSBVehicle::VehicleInfo_t& pendingInfo = iter.value();
+    if (vehicleInfo.availableFlags & ADSBVehicle::CallsignAvailable) {
+        pendingInfo.callsign = vehicleInfo.callsign;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+        pendingInfo.location = vehicleInfo.location;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::AltitudeAvailable) {
+        pendingInfo.altitude = vehicleInfo.altitude;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::HeadingAvailable) {
+        pendingInfo.heading = vehicleInfo.heading;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::AlertAvailable) {
+        pendingInfo.alert = vehicleInfo.alert;
+    }
+    pendingInfo.availableFlags |= vehicleInfo.availableFlags;
+}
+
+void ADSBVehicleManager::adsbVehicleUpdates(const QList<ADSBVehicle::VehicleInfo_t> rgVehicleInfo)
+{
+    for (const ADSBVehicle::VehicleInfo_t& vehicleInfo: rgVehicleInfo) {
+        adsbVehicleUpdate(vehicleInfo);
+    }
+}
+
+void ADSBVehicleManager::_publishUpdates(void)
+{
+    if (_pendingUpdates.isEmpty()) {
+        return;
+    }
+
+    QList<QObject*> rgNewVehicles;
+
+    for (auto iter = _pendingUpdates.constBegin(); iter != _pendingUpdates.constEnd(); iter++) {
+        const ADSBVehicle::VehicleInfo_t& vehicleInfo = iter.value();
+        ADSBVehicle* adsbVehicle = _adsbICAOMap.value(vehicleInfo.icaoAddress, nullptr);
+
+        if (adsbVehicle) {
+            adsbVehicle->update(vehicleInfo);
+        } else if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+            adsbVehicle = new ADSBVehicle(vehicleInfo, this);
+            _adsbICAOMap[vehicleInfo.icaoAddress] = adsbVehicle;
+            rgNewVehicles.append(adsbVehicle);
+        }
+
+        if (adsbVehicle && (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable)) {
+            _spatialIndex.update(vehicleInfo.icaoAddress, vehicleInfo.location);
+        }
+    }
+    _pendingUpdates.clear();
+
+    if (!rgNewVehicles.isEmpty()) {
+        _adsbVehicles.append(rgNewVehicles);
+    }
+
+    _updateCollisionAlerts();
+}
+
+/// Flags ADSB vehicles which are close to any of our own vehicles. This is combined with the alert reported by the
+/// ADSB source, which is never cleared here.
+void ADSBVehicleManager::_updateCollisionAlerts(void)
+{
+    QSet<uint32_t>              newAlertICAOs;
+    ADSBVehicleManagerSettings* settings            = _toolbox->settingsManager()->adsbVehicleManagerSettings();
+    const double                horizontalDistance  = settings->adsbAlertHorizontalDistance()->rawValue().toDouble();
+    const double                verticalDistance    = settings->adsbAlertVerticalDistance()->rawValue().toDouble();
+
+    QmlObjectListModel* vehicles = _toolbox->multiVehicleManager()->vehicles();
+    for (int i=0; i<vehicles->count(); i++) {
+        Vehicle* vehicle = vehicles->value<Vehicle*>(i);
+        const QGeoCoordinate coordinate = vehicle->coordinate();
+        if (!coordinate.isValid()) {
+            continue;
+        }
+        const double altitudeAMSL = vehicle->altitudeAMSL()->rawValue().toDouble();
+
+        for (uint32_t icaoAddress: _spatialIndex.query(coordinate, horizontalDistance)) {
+            ADSBVehicle* adsbVehicle = _adsbICAOMap.value(icaoAddress, nullptr);
+            if (!adsbVehicle) {
+                continue;
+            }
+            // Without altitude information on either side we can only go by horizontal distance
+            if (qIsNaN(adsbVehicle->altitude()) || qIsNaN(altitudeAMSL) || qAbs(adsbVehicle->altitude() - altitudeAMSL) <= verticalDistance) {
+                newAlertICAOs.insert(icaoAddress);
+            }
+        }
+    }
+
+    for (uint32_t icaoAddress: _alertICAOs) {
+        if (!newAlertICAOs.contains(icaoAddress)) {
+            ADSBVehicle* adsbVehicle = _adsbICAOMap.value(icaoAddress, nullptr);
+            if (adsbVehicle) {
+                adsbVehicle->setProximityAlert(false);
+            }
+        }
+    }
+    for (uint32_t icaoAddress: newAlertICAOs) {
+        _adsbICAOMap[icaoAddress]->setProximityAlert(true);
+    }
+    _alertICAOs = newAlertICAOs;
+}
+
+QList<ADSBVehicle*> ADSBVehicleManager::vehiclesNear(const QGeoCoordinate& coordinate, double radiusMeters) const
+{
+    QList<ADSBVehicle*> rgVehicles;
+
+    for (uint32_t icaoAddress: _spatialIndex.query(coordinate, radiusMeters)) {
+        ADSBVehicle* adsbVehicle = _adsbICAOMap.value(icaoAddress, nullptr);
+        if (adsbVehicle) {
+            rgVehicles.append(adsbVehicle);
         }
     }
+
+    return rgVehicles;
 }
 
 void ADSBVehicleManager::_tcpError(const QString errorMsg)
@@ -120,73 +244,98 @@ void ADSBTCPLink::_hardwareConnect()
 
 void ADSBTCPLink::_readBytes(void)
 {
-    if (_socket) {
-        QByteArray bytes = _socket->readLine();
-        _parseLine(QString::fromLocal8Bit(bytes));
+    if (!_socket) {
+        return;
+    }
+
+    // Parse everything which is available and hand it over to the main thread as a single batch
+    QList<ADSBVehicle::VehicleInfo_t> rgVehicleInfo;
+    while (_socket->canReadLine()) {
+        ADSBVehicle::VehicleInfo_t adsbInfo;
+        if (_parseLine(_socket->readLine(), adsbInfo)) {
+            rgVehicleInfo.append(adsbInfo);
+        }
+    }
+
+    if (!rgVehicleInfo.isEmpty()) {
+        emit adsbVehicleUpdates(rgVehicleInfo);
     }
 }
 
-void ADSBTCPLink::_parseLine(const QString& line)
+bool ADSBTCPLink::_parseLine(const QByteArray& line, ADSBVehicle::VehicleInfo_t& adsbInfo)
 {
-    if (line.startsWith(QStringLiteral("MSG"))) {
-        qCDebug(ADSBVehicleManagerLog) << "ADSB SBS-1" << line;
-
-        QStringList values = line.split(QStringLiteral(","));
+    if (!line.startsWith("MSG")) {
+        return false;
+    }
 
-        if (values[1] == QStringLiteral("3")) {
-            bool icaoOk, altOk, latOk, lonOk;
+    qCDebug(ADSBVehicleManagerLog) << "ADSB SBS-1" << line;
 
-            uint32_t    icaoAddress =   values[4].toUInt(&icaoOk, 16);
-            int         modeCAltitude = values[11].toInt(&altOk);
-            double      lat =           values[14].toDouble(&latOk);
-            double      lon =           values[15].toDouble(&lonOk);
-            QString     callsign =      values[10];
+    // Locate the comma separated fields in place instead of splitting into a list of strings
+    const char* rgFieldStart[_cMaxSBSFields];
+    int         rgFieldLength[_cMaxSBSFields];
+    int         cFields     = 0;
+    const char* data        = line.constData();
+    int         length      = line.length();
+    int         fieldStart  = 0;
 
-            if (!icaoOk || !altOk || !latOk || !lonOk) {
-                return;
-            }
-            if (lat == 0 && lon == 0) {
-                return;
-            }
+    while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r')) {
+        length--;
+    }
+    for (int i=0; i<=length && cFields<_cMaxSBSFields; i++) {
+        if (i == length || data[i] == ',') {
+            rgFieldStart[cFields]   = data + fieldStart;
+            rgFieldLength[cFields]  = i - fieldStart;
+            cFields++;
+            fieldStart = i + 1;
+        }
+    }
 
-            double altitude = modeCAltitude / 3.048;
-            QGeoCoordinate location(lat, lon);
+    auto field = [&](int index) {
+        return index < cFields ? QByteArray::fromRawData(rgFieldStart[index], rgFieldLength[index]) : QByteArray();
+    };
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.callsign = callsign;
-            adsbInfo.location = location;
-            adsbInfo.altitude = altitude;
-            adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
-        } else if (values[1] == QStringLiteral("4")) {
-            bool icaoOk, headingOk;
+    bool icaoOk;
+    adsbInfo.icaoAddress = field(4).toUInt(&icaoOk, 16);
+    if (!icaoOk) {
+        return false;
+    }
 
-            uint32_t    icaoAddress =   values[4].toUInt(&icaoOk, 16);
-            double      heading =       values[13].toDouble(&headingOk);
+    const QByteArray transmissionType = field(1);
+    if (transmissionType == "3") {
+        bool altOk, latOk, lonOk;
 
-            if (!icaoOk || !headingOk) {
-                return;
-            }
+        int     modeCAltitude = field(11).toInt(&altOk);
+        double  lat =           field(14).toDouble(&latOk);
+        double  lon =           field(15).toDouble(&lonOk);
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.heading = heading;
-            adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
-        } else if (values[1] == QStringLiteral("1")) {
-            bool icaoOk;
-
-            uint32_t icaoAddress = values[4].toUInt(&icaoOk, 16);
-            if (!icaoOk) {
-                return;
-            }
+        if (!altOk || !latOk || !lonOk) {
+            return false;
+        }
+        if (lat == 0 && lon == 0) {
+            return false;
+        }
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.callsign = values[10];
-            adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
+        adsbInfo.callsign = QString::fromLatin1(field(10)).trimmed();
+        adsbInfo.location = QGeoCoordinate(lat, lon);
+        adsbInfo.altitude = modeCAltitude * 0.3048; // Mode C altitude is in feet
+        adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable;
+        return true;
+    } else if (transmissionType == "4") {
+        bool headingOk;
+
+        double heading = field(13).toDouble(&headingOk);
+        if (!headingOk) {
+            return false;
         }
+
+        adsbInfo.heading = heading;
+        adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
+        return true;
+    } else if (transmissionType == "1") {
+        adsbInfo.callsign = QString::fromLatin1(field(10)).trimmed();
+        adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
+        return true;
     }
+
+    return false;
 }
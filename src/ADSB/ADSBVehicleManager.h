@@ -12,11 +12,14 @@
 #include "QGCToolbox.h"
 #include "QmlObjectListModel.h"
 #include "ADSBVehicle.h"
+#include "ADSBSpatialIndex.h"
 
 #include <QThread>
 #include <QTcpSocket>
 #include <QTimer>
 #include <QGeoCoordinate>
+#include <QHash>
+#include <QSet>
 
 class ADSBVehicleManagerSettings;
 
@@ -24,12 +27,15 @@ class ADSBTCPLink : public QThread
 {
     Q_OBJECT
 
+    friend class ADSBTest;
+
 public:
     ADSBTCPLink(const QString& hostAddress, int port, QObject* parent);
     ~ADSBTCPLink();
 
 signals:
-    void adsbVehicleUpdate(const ADSBVehicle::VehicleInfo_t vehicleInfo);
+    /// All complete lines available from the socket are parsed in one batch
+    void adsbVehicleUpdates(const QList<ADSBVehicle::VehicleInfo_t> rgVehicleInfo);
     void error(const QString errorMsg);
 
 protected:
@@ -40,7 +46,10 @@ private slots:
 
 private:
     void _hardwareConnect(void);
-    void _parseLine(const QString& line);
+
+    static bool _parseLine(const QByteArray& line, ADSBVehicle::VehicleInfo_t& adsbInfo);
+
+    static const int _cMaxSBSFields = 22;
 
     QString         _hostAddress;
     int             _port;
@@ -57,19 +66,33 @@ public:
 
     QmlObjectListModel* adsbVehicles(void) { return &_adsbVehicles; }
 
+    /// @return ADSB vehicles within radiusMeters of the specified coordinate
+    QList<ADSBVehicle*> vehiclesNear(const QGeoCoordinate& coordinate, double radiusMeters) const;
+
     // QGCTool overrides
     void setToolbox(QGCToolbox* toolbox) final;
 
 public slots:
+    /// Updates are coalesced per ICAO address and applied to the model every _publishIntervalMsecs
     void adsbVehicleUpdate  (const ADSBVehicle::VehicleInfo_t vehicleInfo);
+    void adsbVehicleUpdates (const QList<ADSBVehicle::VehicleInfo_t> rgVehicleInfo);
     void _tcpError          (const QString errorMsg);
 
 private slots:
-    void _cleanupStaleVehicles(void);
+    void _cleanupStaleVehicles  (void);
+    void _publishUpdates        (void);
 
 private:
-    QmlObjectListModel              _adsbVehicles;
-    QMap<uint32_t, ADSBVehicle*>    _adsbICAOMap;
-    QTimer                          _adsbVehicleCleanupTimer;
-    ADSBTCPLink*                    _tcpLink = nullptr;
+    void _updateCollisionAlerts (void);
+
+    QmlObjectListModel                          _adsbVehicles;
+    QHash<uint32_t, ADSBVehicle*>               _adsbICAOMap;
+    QHash<uint32_t, ADSBVehicle::VehicleInfo_t> _pendingUpdates;
+    QSet<uint32_t>                              _alertICAOs;        ///< Vehicles currently flagged with a collision alert
+    ADSBSpatialIndex                            _spatialIndex;
+    QTimer                                      _adsbVehicleCleanupTimer;
+    QTimer                                      _publishTimer;
+    ADSBTCPLink*                                _tcpLink = nullptr;
+
+    static const int _publishIntervalMsecs = 250;
 };
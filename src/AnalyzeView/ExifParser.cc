@@ -13,27 +13,70 @@ ExifParser::~ExifParser()
 
 }
 
+QByteArray ExifParser::readExifHeader(QIODevice& device)
+{
+    QByteArray header = device.read(2);
+    if (header != QByteArray("\xff\xd8", 2)) {
+        qWarning() << "Not a JPEG file";
+        return QByteArray();
+    }
+
+    // Walk the segments preceding the image data, each is: 0xff, marker, big endian length (including length bytes)
+    while (true) {
+        QByteArray segmentHeader = device.read(4);
+        if (segmentHeader.size() != 4 || static_cast<uint8_t>(segmentHeader[0]) != 0xff) {
+            break;
+        }
+        uint8_t     marker          = static_cast<uint8_t>(segmentHeader[1]);
+        uint16_t    segmentLength   = qFromBigEndian<quint16>(segmentHeader.constData() + 2);
+        if (marker == 0xda /* start of scan */ || segmentLength < 2) {
+            break;
+        }
+
+        header.append(segmentHeader);
+        QByteArray segmentData = device.read(segmentLength - 2);
+        if (segmentData.size() != segmentLength - 2) {
+            break;
+        }
+        header.append(segmentData);
+
+        if (marker == 0xe1 /* APP1 */) {
+            return header;
+        }
+    }
+
+    qWarning() << "No EXIF segment found";
+    return QByteArray();
+}
+
 double ExifParser::readTime(QByteArray& buf)
 {
     QByteArray tiffHeader("\x49\x49\x2A", 3);
     QByteArray createDateHeader("\x04\x90\x02", 3);
 
     // find header position
-    uint32_t tiffHeaderIndex = buf.indexOf(tiffHeader);
+    int tiffHeaderIndex = buf.indexOf(tiffHeader);
 
-    // find creation date header index
-    uint32_t createDateHeaderIndex = buf.indexOf(createDateHeader);
+    // find creation date header index, the field is followed by the string size and location
+    int createDateHeaderIndex = buf.indexOf(createDateHeader);
+    if (tiffHeaderIndex == -1 || createDateHeaderIndex == -1 || createDateHeaderIndex + 12 > buf.size()) {
+        qWarning() << "Could not find creation time and date";
+        return -1.0;
+    }
 
     // extract size of date-time string, -1 accounting for null-termination
-    uint32_t* sizeString = reinterpret_cast<uint32_t*>(buf.mid(createDateHeaderIndex + 4, 4).data());
-    uint32_t createDateStringSize = qFromLittleEndian(*sizeString) - 1;
+    qint64 createDateStringSize = static_cast<qint64>(qFromLittleEndian<quint32>(buf.constData() + createDateHeaderIndex + 4)) - 1;
 
     // extract location of date-time string
-    uint32_t* dataIndex = reinterpret_cast<uint32_t*>(buf.mid(createDateHeaderIndex + 8, 4).data());
-    uint32_t createDateStringDataIndex = qFromLittleEndian(*dataIndex) + tiffHeaderIndex;
+    qint64 createDateStringDataIndex = static_cast<qint64>(qFromLittleEndian<quint32>(buf.constData() + createDateHeaderIndex + 8)) + tiffHeaderIndex;
+
+    if (createDateStringSize < 1 || createDateStringDataIndex + createDateStringSize > buf.size()) {
+        qWarning() << "Creation time and date is outside of the EXIF header";
+        return -1.0;
+    }
 
     // read out data of create date-time field
-    QString createDate = buf.mid(createDateStringDataIndex, createDateStringSize);
+    QString createDate = QString::fromLatin1(buf.constData() + createDateStringDataIndex, static_cast<int>(createDateStringSize));
 
     QStringList createDateList = createDate.split(' ');
     if (createDateList.count() < 2) {
@@ -59,17 +102,28 @@ double ExifParser::readTime(QByteArray& buf)
 bool ExifParser::write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag)
 {
     QByteArray app1Header("\xff\xe1", 2);
-    uint32_t app1HeaderInd = buf.indexOf(app1Header);
-    uint16_t *conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(app1HeaderInd + 2, 2).data());
-    uint16_t app1Size = *conversionPointer;
-    uint16_t app1SizeEndian = qFromBigEndian(app1Size) + 0xa5;  // change wrong endian
+    int app1HeaderIndex = buf.indexOf(app1Header);
     QByteArray tiffHeader("\x49\x49\x2A", 3);
-    uint32_t tiffHeaderInd = buf.indexOf(tiffHeader);
-    conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(tiffHeaderInd + 8, 2).data());
-    uint16_t numberOfTiffFields  = *conversionPointer;
+    int tiffHeaderIndex = buf.indexOf(tiffHeader);
+    if (app1HeaderIndex == -1 || tiffHeaderIndex == -1 || app1HeaderIndex + 4 > buf.size() || tiffHeaderIndex + 10 > buf.size()) {
+        qWarning() << "Could not find EXIF header";
+        return false;
+    }
+    uint32_t app1HeaderInd = static_cast<uint32_t>(app1HeaderIndex);
+    uint32_t tiffHeaderInd = static_cast<uint32_t>(tiffHeaderIndex);
+    uint16_t app1SizeEndian = qFromBigEndian<quint16>(buf.constData() + app1HeaderInd + 2) + 0xa5;
+    uint16_t numberOfTiffFields  = qFromLittleEndian<quint16>(buf.constData() + tiffHeaderInd + 8);
     uint32_t nextIfdOffsetInd = tiffHeaderInd + 10 + 12 * (numberOfTiffFields);
-    conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(nextIfdOffsetInd, 2).data());
-    uint16_t nextIfdOffset = *conversionPointer;
+    // The next IFD offset is followed by the 12 bytes which are replaced below
+    if (static_cast<qint64>(nextIfdOffsetInd) + 16 > buf.size()) {
+        qWarning() << "EXIF header is truncated";
+        return false;
+    }
+    uint16_t nextIfdOffset = qFromLittleEndian<quint16>(buf.constData() + nextIfdOffsetInd);
+    if (static_cast<qint64>(tiffHeaderInd) + nextIfdOffset > buf.size()) {
+        qWarning() << "EXIF header is truncated";
+        return false;
+    }
 
     // Definition of useful unions and structs
     union char2uint32_u {
@@ -3,6 +3,7 @@
 
 #include <QGeoCoordinate>
 #include <QDebug>
+#include <QIODevice>
 
 #include "GeoTagController.h"
 
@@ -13,6 +14,11 @@ public:
     ~ExifParser();
     double readTime(QByteArray& buf);
     bool write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag);
+
+    /// Reads the start of a JPEG up to and including the APP1 (EXIF) segment. The image data itself is not read.
+    /// readTime and write only touch this region so the rest of the image can be streamed.
+    /// @return Header bytes, empty if the device does not contain an EXIF segment
+    static QByteArray readExifHeader(QIODevice& device);
 };
 
 #endif // EXIFPARSER_H
@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ExifParserTest.h"
+#include "ExifParser.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+const char* ExifParserTest::_createDate = "2020:05:17 12:34:56";
+
+/// Builds a JPEG whose APP1 segment holds a TIFF header with a single CreateDate field, followed by the image data
+QByteArray ExifParserTest::_buildImage(void)
+{
+    QByteArray tiff("II\x2A\x00", 4);
+    tiff.append("\x08\x00\x00\x00", 4);             // Offset of first IFD
+    tiff.append("\x01\x00", 2);                     // Field count
+    tiff.append("\x04\x90\x02\x00", 4);             // CreateDate, ASCII
+    tiff.append("\x14\x00\x00\x00", 4);             // String size including null termination
+    tiff.append("\x1a\x00\x00\x00", 4);             // String offset from TIFF header
+    tiff.append("\x00\x00\x00\x00", 4);             // Next IFD offset
+    tiff.append(_createDate, static_cast<int>(strlen(_createDate)) + 1);
+
+    QByteArray app1("Exif\x00\x00", 6);
+    app1.append(tiff);
+
+    QByteArray image("\xff\xd8", 2);
+    image.append("\xff\xe1", 2);
+    char segmentLength[2];
+    qToBigEndian<quint16>(static_cast<quint16>(app1.size() + 2), segmentLength);
+    image.append(segmentLength, 2);
+    image.append(app1);
+    image.append("\xff\xda\x00\x02", 4);            // Start of scan
+    image.append(QByteArray(64, '\x55'));
+    image.append("\xff\xd9", 2);
+
+    return image;
+}
+
+void ExifParserTest::_testReadTime(void)
+{
+    QByteArray  image = _buildImage();
+    QBuffer     buffer(&image);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QByteArray exifHeader = ExifParser::readExifHeader(buffer);
+    QVERIFY(!exifHeader.isEmpty());
+    QCOMPARE(exifHeader.indexOf("II\x2A"), static_cast<int>(_tiffHeaderOffset));
+
+    QDateTime expectedTime = QDateTime::fromString(_createDate, "yyyy:MM:dd hh:mm:ss");
+    QCOMPARE(ExifParser().readTime(exifHeader), expectedTime.toMSecsSinceEpoch() / 1000.0);
+}
+
+void ExifParserTest::_testNonExifImage(void)
+{
+    // JFIF image without an APP1 segment
+    QByteArray jfifImage("\xff\xd8\xff\xe0\x00\x10JFIF\x00\x01\x01\x00\x00\x01\x00\x01\x00\x00\xff\xda\x00\x02", 24);
+    jfifImage.append(QByteArray(64, '\x55'));
+    QBuffer jfifBuffer(&jfifImage);
+    QVERIFY(jfifBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(ExifParser::readExifHeader(jfifBuffer).isEmpty());
+
+    // Not a JPEG at all
+    QByteArray pngImage("\x89PNG\r\n\x1a\n", 8);
+    QBuffer pngBuffer(&pngImage);
+    QVERIFY(pngBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(ExifParser::readExifHeader(pngBuffer).isEmpty());
+
+    GeoTagWorker::cameraFeedbackPacket geotag = {};
+    for (QByteArray buf: { QByteArray(), jfifImage, pngImage }) {
+        QCOMPARE(ExifParser().readTime(buf), -1.0);
+        QCOMPARE(ExifParser().write(buf, geotag), false);
+    }
+}
+
+void ExifParserTest::_testTruncatedImage(void)
+{
+    const QByteArray image = _buildImage();
+
+    // The APP1 segment runs past the end of a truncated file
+    QByteArray truncatedImage = image.left(image.indexOf(_createDate));
+    QBuffer truncatedBuffer(&truncatedImage);
+    QVERIFY(truncatedBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(ExifParser::readExifHeader(truncatedBuffer).isEmpty());
+
+    // Cutting off any part of the fields or the date string must fail cleanly rather than read past the end
+    const int createDateEnd = image.indexOf(_createDate) + static_cast<int>(strlen(_createDate));
+    GeoTagWorker::cameraFeedbackPacket geotag = {};
+    for (int length=0; length<createDateEnd; length++) {
+        QByteArray buf = image.left(length);
+        QCOMPARE(ExifParser().readTime(buf), -1.0);
+        if (length < _tiffHeaderOffset + 38) {
+            // Fields up to the end of the bytes replaced by write
+            QCOMPARE(ExifParser().write(buf, geotag), false);
+        }
+    }
+}
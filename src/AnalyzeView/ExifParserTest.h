@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ExifParserTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testReadTime      (void);
+    void _testNonExifImage  (void);
+    void _testTruncatedImage(void);
+
+private:
+    QByteArray _buildImage(void);
+
+    static const char*  _createDate;
+    static const int    _tiffHeaderOffset = 12;     ///< Offset of the TIFF header from the start of the image
+};
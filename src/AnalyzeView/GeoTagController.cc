@@ -14,7 +14,9 @@
 #include <QDebug>
 #include <cfloat>
 #include <QDir>
+#include <QFileInfo>
 #include <QUrl>
+#include <QtConcurrent>
 
 #include "ExifParser.h"
 #include "ULogParser.h"
@@ -30,6 +32,7 @@ GeoTagController::GeoTagController()
     connect(&_worker, &GeoTagWorker::error,             this, &GeoTagController::_workerError);
     connect(&_worker, &GeoTagWorker::started,           this, &GeoTagController::inProgressChanged);
     connect(&_worker, &GeoTagWorker::finished,          this, &GeoTagController::inProgressChanged);
+    connect(&_worker, &GeoTagWorker::imagesPerSecondChanged, this, &GeoTagController::imagesPerSecondChanged);
 }
 
 GeoTagController::~GeoTagController()
@@ -134,7 +137,9 @@ void GeoTagController::_setErrorMessage(const QString& error)
 }
 
 GeoTagWorker::GeoTagWorker()
-    : _cancel(false)
+    : _cancel           (false)
+    , _cTasksComplete   (0)
+    , _imagesPerSecond  (0)
 {
 
 }
@@ -142,9 +147,14 @@ GeoTagWorker::GeoTagWorker()
 void GeoTagWorker::run()
 {
     _cancel = false;
+    _imagesPerSecond = 0;
+    emit imagesPerSecondChanged(0);
     emit progressChanged(1);
     double nSteps = 5;
 
+    QElapsedTimer runTimer;
+    runTimer.start();
+
     // Load Images
     _imageList.clear();
     QDir imageDirectory = QDir(_imageDirectory);
@@ -160,48 +170,46 @@ void GeoTagWorker::run()
     }
     emit progressChanged((100/nSteps));
 
-    // Parse EXIF
-    ExifParser exifParser;
+    // Parse EXIF. Only the EXIF header of each image is read and images are processed in parallel.
+    QVector<ImageTask_t> rgReadTasks(_imageList.count());
+    for (int i = 0; i < _imageList.count(); ++i) {
+        rgReadTasks[i].inputFile = _imageList.at(i).absoluteFilePath();
+    }
+    QFuture<void> readFuture = QtConcurrent::map(rgReadTasks, [this](ImageTask_t& task) { _readImageTime(task); });
+    if (!_waitForTasks(readFuture, rgReadTasks.count(), 100/nSteps, 100/nSteps)) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
     _imageTime.clear();
-    for (int i = 0; i < _imageList.size(); ++i) {
-        QFile file(_imageList.at(i).absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = file.readAll();
-        file.close();
-
-        _imageTime.append(exifParser.readTime(imageBuffer));
-
-        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
+    for (const ImageTask_t& task: rgReadTasks) {
+        if (!task.errorString.isEmpty()) {
+            emit error(task.errorString);
             return;
         }
+        _imageTime.append(task.imageTime);
     }
+    qCDebug(GeotaggingLog) << "EXIF read" << rgReadTasks.count() << "images" << runTimer.elapsed() << "msecs";
 
-    // Load log
+    // Load log and instantiate appropriate parser
     bool isULog = _logFile.endsWith(".ulg", Qt::CaseSensitive);
-    QFile file(_logFile);
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit error(tr("Geotagging failed. Couldn't open log file."));
-        return;
-    }
-    QByteArray log = file.readAll();
-    file.close();
-
-    // Instantiate appropriate parser
     _triggerList.clear();
     bool parseComplete = false;
     QString errorString;
     if (isULog) {
+        // ULog files are memory mapped by the parser, they can be far too large to read into memory
         ULogParser parser;
-        parseComplete = parser.getTagsFromLog(log, _triggerList, errorString);
+        parseComplete = parser.getTagsFromLog(_logFile, _triggerList, errorString);
 
     } else {
+        QFile file(_logFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit error(tr("Geotagging failed. Couldn't open log file."));
+            return;
+        }
+        QByteArray log = file.readAll();
+        file.close();
+
         PX4LogParser parser;
         parseComplete = parser.getTagsFromLog(log, _triggerList);
 
@@ -246,42 +254,31 @@ void GeoTagWorker::run()
     // Tag images
     int maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
     maxIndex = std::min(maxIndex, _imageList.count());
+    QVector<ImageTask_t> rgTagTasks(maxIndex);
     for(int i = 0; i < maxIndex; i++) {
         int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return;
         }
-        QFile fileRead(_imageList.at(_imageIndices[i]).absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
-
-        if (!exifParser.write(imageBuffer, _triggerList[_triggerIndices[i]])) {
-            emit error(tr("Geotagging failed. Couldn't write to image."));
-            return;
+        ImageTask_t& task = rgTagTasks[i];
+        task.inputFile  = _imageList.at(imageIndex).absoluteFilePath();
+        task.geotag     = _triggerList[_triggerIndices[i]];
+        if(_saveDirectory == "") {
+            task.outputFile = _imageDirectory + "/TAGGED/" + _imageList.at(imageIndex).fileName();
         } else {
-            QFile fileWrite;
-            if(_saveDirectory == "") {
-                fileWrite.setFileName(_imageDirectory + "/TAGGED/" + _imageList.at(_imageIndices[i]).fileName());
-            } else {
-                fileWrite.setFileName(_saveDirectory + "/" + _imageList.at(_imageIndices[i]).fileName());
-            }
-            if (!fileWrite.open(QFile::WriteOnly)) {
-                emit error(tr("Geotagging failed. Couldn't write to an image."));
-                return;
-            }
-            fileWrite.write(imageBuffer);
-            fileWrite.close();
+            task.outputFile = _saveDirectory + "/" + _imageList.at(imageIndex).fileName();
         }
-        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
+    }
+    QFuture<void> tagFuture = QtConcurrent::map(rgTagTasks, [this](ImageTask_t& task) { _tagImage(task); });
+    if (!_waitForTasks(tagFuture, rgTagTasks.count(), 4*(100/nSteps), 100/nSteps)) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
+    for (const ImageTask_t& task: rgTagTasks) {
+        if (!task.errorString.isEmpty()) {
+            emit error(task.errorString);
             return;
         }
     }
@@ -292,9 +289,81 @@ void GeoTagWorker::run()
         return;
     }
 
+    double elapsedSecs = runTimer.elapsed() / 1000.0;
+    _imagesPerSecond = elapsedSecs > 0 ? maxIndex / elapsedSecs : 0;
+    emit imagesPerSecondChanged(_imagesPerSecond);
+    qCDebug(GeotaggingLog) << "Tagged" << maxIndex << "images in" << elapsedSecs << "secs" << _imagesPerSecond << "images/sec";
+
     emit progressChanged(100);
 }
 
+/// Waits for the specified parallel tasks to complete while updating progress
+///     @return false: tagging was cancelled
+bool GeoTagWorker::_waitForTasks(QFuture<void>& future, int cTasks, double progressStart, double progressSpan)
+{
+    _cTasksComplete = 0;
+    while (!future.isFinished()) {
+        if (_cancel) {
+            future.cancel();
+            future.waitForFinished();
+            return false;
+        }
+        if (cTasks > 0) {
+            emit progressChanged(progressStart + (progressSpan * _cTasksComplete) / cTasks);
+        }
+        QThread::msleep(_progressIntervalMsecs);
+    }
+    return !_cancel;
+}
+
+void GeoTagWorker::_readImageTime(ImageTask_t& task)
+{
+    QFile file(task.inputFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        task.errorString = tr("Geotagging failed. Couldn't open an image.");
+    } else {
+        QByteArray exifHeader = ExifParser::readExifHeader(file);
+        task.imageTime = ExifParser().readTime(exifHeader);
+        if (task.imageTime < 0) {
+            task.errorString = tr("Geotagging failed. Couldn't read the creation time of image %1.").arg(QFileInfo(task.inputFile).fileName());
+        }
+    }
+    _cTasksComplete++;
+}
+
+/// The EXIF header is updated in memory, the remainder of the image is streamed through unchanged
+void GeoTagWorker::_tagImage(ImageTask_t& task)
+{
+    QFile fileRead(task.inputFile);
+    if (!fileRead.open(QIODevice::ReadOnly)) {
+        task.errorString = tr("Geotagging failed. Couldn't open an image.");
+    } else {
+        QByteArray exifHeader = ExifParser::readExifHeader(fileRead);
+        if (exifHeader.isEmpty() || !ExifParser().write(exifHeader, task.geotag)) {
+            task.errorString = tr("Geotagging failed. Couldn't write to image.");
+        } else {
+            QFile fileWrite(task.outputFile);
+            if (!fileWrite.open(QFile::WriteOnly)) {
+                task.errorString = tr("Geotagging failed. Couldn't write to an image.");
+            } else {
+                bool writeOk = fileWrite.write(exifHeader) == exifHeader.size();
+                while (writeOk && !fileRead.atEnd() && !_cancel) {
+                    QByteArray chunk = fileRead.read(_copyChunkSize);
+                    writeOk = fileWrite.write(chunk) == chunk.size();
+                }
+                if (!writeOk) {
+                    task.errorString = tr("Geotagging failed. Couldn't write to an image.");
+                }
+                if (!writeOk || !fileRead.atEnd()) {
+                    // Don't leave a partial image behind when the copy failed or tagging was cancelled
+                    fileWrite.remove();
+                }
+            }
+        }
+    }
+    _cTasksComplete++;
+}
+
 bool GeoTagWorker::triggerFiltering()
 {
     _imageIndices.clear();
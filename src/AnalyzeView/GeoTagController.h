@@ -20,6 +20,9 @@
 #include <QElapsedTimer>
 #include <QDebug>
 #include <QGeoCoordinate>
+#include <QFuture>
+
+#include <atomic>
 
 class GeoTagWorker : public QThread
 {
@@ -38,6 +41,9 @@ public:
 
     void cancelTagging      () { _cancel = true; }
 
+    /// @return Tagging throughput of the last run (read + write), 0 if not available
+    double imagesPerSecond  () const { return _imagesPerSecond; }
+
     struct cameraFeedbackPacket {
         double timestamp;
         double timestampUTC;
@@ -57,11 +63,26 @@ signals:
     void error              (QString errorMsg);
     void taggingComplete    ();
     void progressChanged    (double progress);
+    void imagesPerSecondChanged(double imagesPerSecond);
 
 private:
+    /// Per image state for the parallel EXIF read and tag passes
+    struct ImageTask_t {
+        QString                 inputFile;
+        QString                 outputFile;
+        double                  imageTime;
+        cameraFeedbackPacket    geotag;
+        QString                 errorString;
+    };
+
     bool triggerFiltering();
+    bool _waitForTasks      (QFuture<void>& future, int cTasks, double progressStart, double progressSpan);
+    void _readImageTime     (ImageTask_t& task);
+    void _tagImage          (ImageTask_t& task);
 
-    bool                    _cancel;
+    std::atomic<bool>       _cancel;
+    std::atomic<int>        _cTasksComplete;
+    std::atomic<double>     _imagesPerSecond;
     QString                 _logFile;
     QString                 _imageDirectory;
     QString                 _saveDirectory;
@@ -71,6 +92,9 @@ private:
     QList<int>              _imageIndices;
     QList<int>              _triggerIndices;
 
+    static const int        _progressIntervalMsecs  = 100;
+    static const qint64     _copyChunkSize          = 1024 * 1024;
+
 };
 
 /// Controller for GeoTagPage.qml. Supports geotagging images based on logfile camera tags.
@@ -94,6 +118,9 @@ public:
     /// true: Currently in the process of tagging
     Q_PROPERTY(bool     inProgress      READ inProgress     NOTIFY inProgressChanged)
 
+    /// Images tagged per second in the last tagging run, 0 if not available
+    Q_PROPERTY(double   imagesPerSecond READ imagesPerSecond NOTIFY imagesPerSecondChanged)
+
     Q_INVOKABLE void startTagging();
     Q_INVOKABLE void cancelTagging() { _worker.cancelTagging(); }
 
@@ -102,6 +129,7 @@ public:
     QString saveDirectory       () const { return _worker.saveDirectory(); }
     double  progress            () const { return _progress; }
     bool    inProgress          () const { return _worker.isRunning(); }
+    double  imagesPerSecond     () const { return _worker.imagesPerSecond(); }
     QString errorMessage        () const { return _errorMessage; }
 
     void    setLogFile          (QString file);
@@ -115,6 +143,7 @@ signals:
     void progressChanged        (double progress);
     void inProgressChanged      ();
     void errorMessageChanged    (QString errorMessage);
+    void imagesPerSecondChanged (double imagesPerSecond);
 
 private slots:
     void _workerProgressChanged (double progress);
@@ -52,6 +52,14 @@ AnalyzePage {
                 Layout.alignment:   Qt.AlignVCenter
             }
             //-----------------------------------------------------------------
+            QGCLabel {
+                text:               qsTr("Tagged %1 images/sec").arg(geoController.imagesPerSecond.toFixed(1))
+                visible:            geoController.imagesPerSecond > 0 && geoController.errorMessage === ""
+                horizontalAlignment:Text.AlignHCenter
+                Layout.alignment:   Qt.AlignHCenter
+                Layout.columnSpan:  2
+            }
+            //-----------------------------------------------------------------
             QGCLabel {
                 text:               geoController.errorMessage
                 color:              "red"
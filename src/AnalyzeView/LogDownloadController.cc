@@ -21,22 +21,31 @@
 
 #include <QDebug>
 #include <QSettings>
+#include <QStandardPaths>
+#include <QFileInfo>
 #include <QUrl>
 #include <QBitArray>
 #include <QtCore/qmath.h>
 
 #define kTimeOutMilliseconds 500
 #define kGUIRateMilliseconds 17
-#define kTableBins           512
-#define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kWriteBufferSize     (64 * 1024)
+#define kMaxMergeBins        16     // Received runs up to this many bins between holes are requested again to cover several holes with one request
 
 QGC_LOGGING_CATEGORY(LogDownloadLog, "LogDownloadLog")
 
+const char* LogDownloadController::_px4FtpLogDirectory = "/fs/microsd/log";
+const char* LogDownloadController::_apmFtpLogDirectory = "/APM/LOGS";
+
 //-----------------------------------------------------------------------------
 struct LogDownloadData {
     LogDownloadData(QGCLogEntry* entry);
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
+    QBitArray     bin_table;            // One bit per MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bin for the whole log
+    uint32_t      bins_received;
+    uint32_t      first_missing_bin;    // All bins prior to this one have been received
+    uint32_t      request_end;          // End offset of the outstanding LOG_REQUEST_DATA window
+    QByteArray    write_buffer;         // Contiguous data which has not been written to the file yet
+    uint32_t      write_buffer_offset;
     QFile         file;
     QString       filename;
     uint          ID;
@@ -45,41 +54,42 @@ struct LogDownloadData {
     size_t        rate_bytes;
     qreal         rate_avg;
     QElapsedTimer elapsed;
+    bool          ftp;                  // true: Log is being transferred using MAVLink FTP
 
-    void advanceChunk()
+    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the file
+    uint32_t numBins() const
     {
-           current_chunk++;
-           chunk_table = QBitArray(chunkBins(), false);
+        return qCeil(entry->size() / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN));
     }
 
-    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const
+    bool complete() const
     {
-        return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
-                    kTableBins);
+        return bins_received == static_cast<uint32_t>(bin_table.size());
     }
 
-    // The number of kChunkSize chunks in the file
-    uint32_t numChunks() const
+    bool flushWriteBuffer()
     {
-        return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
-    }
-
-    // True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const
-    {
-        return chunk_table == QBitArray(chunk_table.size(), val);
+        if (write_buffer.isEmpty()) {
+            return true;
+        }
+        bool result = file.seek(write_buffer_offset) && file.write(write_buffer) == write_buffer.size();
+        write_buffer.clear();
+        return result;
     }
-
 };
 
 //----------------------------------------------------------------------------------------
 LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
+    : bins_received(0)
+    , first_missing_bin(0)
+    , request_end(0)
+    , write_buffer_offset(0)
+    , ID(entry_->id())
     , entry(entry_)
     , written(0)
     , rate_bytes(0)
     , rate_avg(0)
+    , ftp(false)
 {
 
 }
@@ -111,6 +121,7 @@ LogDownloadController::LogDownloadController(void)
     , _downloadingLogs(false)
     , _retries(0)
     , _apmOneBased(0)
+    , _ftpLogFilesValid(false)
 {
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &LogDownloadController::_setActiveVehicle);
@@ -315,7 +326,7 @@ void LogDownloadController::_updateDataRate(void)
 void
 LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, uint8_t count, const uint8_t* data)
 {
-    if(!_uas || uas != _uas || !_downloadData) {
+    if(!_uas || uas != _uas || !_downloadData || _downloadData->ftp) {
         return;
     }
     //-- APM "Fix"
@@ -330,75 +341,59 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
         return;
     }
 
-    bool result = false;
-    uint32_t timeout_time = kTimeOutMilliseconds;
-    if(ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qWarning() << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
-            return;
-        }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qWarning() << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
-        if (_downloadData->file.pos() != ofs) {
-            // Seek to correct position
-            if (!_downloadData->file.seek(ofs)) {
-                qWarning() << "Error while seeking log file offset";
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (bin >= static_cast<uint32_t>(_downloadData->bin_table.size())) {
+        qWarning() << "Received log offset greater than expected";
+        _downloadData->entry->setStatus(tr("Error"));
+        return;
+    }
+
+    //-- reset retries
+    _retries = 0;
+    //-- Reset timer
+    _timer.start(kTimeOutMilliseconds);
+
+    // Data can arrive for any offset, duplicates from overlapping requests are dropped
+    if (!_downloadData->bin_table.testBit(bin)) {
+        _downloadData->bin_table.setBit(bin);
+        _downloadData->bins_received++;
+
+        //-- Buffer contiguous data so the file is written in large blocks
+        if (ofs != _downloadData->write_buffer_offset + static_cast<uint32_t>(_downloadData->write_buffer.size()) ||
+                _downloadData->write_buffer.size() >= kWriteBufferSize) {
+            if (!_downloadData->flushWriteBuffer()) {
+                qWarning() << "Error while writing log file chunk";
+                _downloadData->entry->setStatus(tr("Error"));
                 return;
             }
+            _downloadData->write_buffer_offset = ofs;
         }
+        _downloadData->write_buffer.append(reinterpret_cast<const char*>(data), count);
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-            result = true;
-            //-- reset retries
-            _retries = 0;
-            //-- Reset timer
-            _timer.start(timeout_time);
-            //-- Do we have it all?
-            if(_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                //-- Check for more
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
-            qWarning() << "Error while writing log file chunk";
+        _downloadData->written += count;
+        _downloadData->rate_bytes += count;
+        _updateDataRate();
+
+        while (_downloadData->first_missing_bin < static_cast<uint32_t>(_downloadData->bin_table.size()) &&
+               _downloadData->bin_table.testBit(_downloadData->first_missing_bin)) {
+            _downloadData->first_missing_bin++;
         }
-    } else {
-        qWarning() << "Received log offset greater than expected";
-    }
-    if(!result) {
-        _downloadData->entry->setStatus(tr("Error"));
     }
-}
-
 
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_logComplete() const
-{
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    //-- Do we have it all?
+    if(_downloadData->complete()) {
+        if (!_downloadData->flushWriteBuffer()) {
+            qWarning() << "Error while writing log file chunk";
+            _downloadData->entry->setStatus(tr("Error"));
+            return;
+        }
+        _downloadData->entry->setStatus(tr("Downloaded"));
+        //-- Check for more
+        _receivedAllData();
+    } else if (ofs + count >= _downloadData->request_end) {
+        // The vehicle has streamed the whole window, go straight to the next one instead of waiting for the timeout
+        _requestMissingData();
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -408,9 +403,17 @@ LogDownloadController::_receivedAllData()
     _timer.stop();
     //-- Anything queued up for download?
     if(_prepareLogDownload()) {
-        //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer.start(kTimeOutMilliseconds);
+        if (_downloadData->complete()) {
+            //-- Empty log, nothing to request
+            _downloadData->entry->setStatus(tr("Downloaded"));
+            _receivedAllData();
+        } else if (_ftpLogDownloadSupported()) {
+            _ftpStartLogDownload();
+        } else {
+            //-- Request Log
+            _requestMissingData();
+            _timer.start(kTimeOutMilliseconds);
+        }
     } else {
         _resetSelection();
         _setDownloading(false);
@@ -421,11 +424,9 @@ LogDownloadController::_receivedAllData()
 void
 LogDownloadController::_findMissingData()
 {
-    if (_logComplete()) {
+    if (_downloadData->complete()) {
          _receivedAllData();
          return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
     }
 
     _retries++;
@@ -441,25 +442,264 @@ LogDownloadController::_findMissingData()
     }
 #endif
 
+    _requestMissingData();
+}
+
+//----------------------------------------------------------------------------------------
+/// Requests the next window of missing data starting at the first hole. A new LOG_REQUEST_DATA replaces
+/// the previous one on the vehicle, so a single request spans as many holes as possible. Short runs of
+/// already received data between holes are simply requested again.
+void
+LogDownloadController::_requestMissingData()
+{
     _updateDataRate();
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
+    const uint32_t numBins  = static_cast<uint32_t>(_downloadData->bin_table.size());
+    const uint32_t start    = _downloadData->first_missing_bin;
+    uint32_t       end      = start;
+    uint32_t       receivedRun = 0;
+
+    for (uint32_t bin = start; bin < numBins; bin++) {
+        if (_downloadData->bin_table.testBit(bin)) {
+            if (++receivedRun > kMaxMergeBins) {
+                break;
+            }
+        } else {
+            receivedRun = 0;
+            end = bin + 1;
         }
     }
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
+    const uint32_t pos = start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    const uint32_t len = qMin(end * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN, _downloadData->entry->size()) - pos;
+
+    _downloadData->request_end = pos + len;
+    _requestLogData(_downloadData->ID, pos, len, _retries);
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadController::_ftpLogDownloadSupported() const
+{
+    if (!_vehicle || !(_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP)) {
+        return false;
+    }
+    if (_vehicle->firmwareType() != MAV_AUTOPILOT_PX4 && _vehicle->firmwareType() != MAV_AUTOPILOT_ARDUPILOTMEGA) {
+        return false;
+    }
+    //-- Don't bother if a previous listing didn't turn up any logs
+    return !_ftpLogFilesValid || !_ftpLogFiles.isEmpty();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpStartLogDownload()
+{
+    _downloadData->ftp = true;
+    if (_ftpLogFilesValid) {
+        _ftpDownloadLogFile();
+        return;
+    }
+
+    //-- Find out where the logs live on the vehicle first
+    _ftpLogFiles.clear();
+    _ftpPendingDirs.clear();
+    _ftpPendingDirs.append(_vehicle->firmwareType() == MAV_AUTOPILOT_PX4 ? _px4FtpLogDirectory : _apmFtpLogDirectory);
+    connect(_vehicle->ftpManager(), &FTPManager::listDirectoryComplete, this, &LogDownloadController::_ftpListDirectoryComplete);
+    _ftpListNextDirectory();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpListNextDirectory()
+{
+    if (_ftpPendingDirs.isEmpty()) {
+        _ftpDisconnect();
+        _ftpLogFilesValid = true;
+        qCDebug(LogDownloadLog) << "FTP log files found:" << _ftpLogFiles.count();
+        _ftpDownloadLogFile();
+        return;
+    }
+
+    _ftpCurrentDir = _ftpPendingDirs.takeFirst();
+    if (!_vehicle->ftpManager()->listDirectory(_ftpCurrentDir)) {
+        _ftpDisconnect();
+        _ftpFallbackToLogRequest();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpListDirectoryComplete(const QString& dirPath, const QStringList& dirList, const QString& errorMsg)
+{
+    if (dirPath != _ftpCurrentDir) {
+        // Some other client's listing
+        return;
+    }
+    if (!_downloadData) {
+        _ftpDisconnect();
+        return;
+    }
+    if (!errorMsg.isEmpty()) {
+        qCDebug(LogDownloadLog) << "FTP list directory failed" << _ftpCurrentDir << errorMsg;
+    }
+
+    // PX4 keeps logs in one sub directory per day/session, ArduPilot keeps them all in a single directory
+    const bool      px4         = _vehicle->firmwareType() == MAV_AUTOPILOT_PX4;
+    const QString   logSuffix   = px4 ? QStringLiteral(".ulg") : QStringLiteral(".bin");
+    QStringList     sortedList  = dirList;
+
+    sortedList.sort();
+    for (const QString& dirEntry: sortedList) {
+        if (dirEntry.startsWith('F')) {
+            QStringList fileInfo = dirEntry.mid(1).split('\t');
+            if (fileInfo[0].endsWith(logSuffix, Qt::CaseInsensitive)) {
+                FtpLogFile_t logFile;
+                logFile.path = _ftpCurrentDir + "/" + fileInfo[0];
+                logFile.size = fileInfo.count() > 1 ? fileInfo[1].toUInt() : 0;
+                _ftpLogFiles.append(logFile);
+            }
+        } else if (px4 && dirEntry.startsWith('D') && _ftpCurrentDir == _px4FtpLogDirectory) {
+            QString dirName = dirEntry.mid(1);
+            if (dirName != "." && dirName != "..") {
+                _ftpPendingDirs.append(_ftpCurrentDir + "/" + dirName);
+            }
         }
     }
 
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+    _ftpListNextDirectory();
+}
+
+//----------------------------------------------------------------------------------------
+/// Matches the log entry being downloaded against the log files found on the vehicle. ArduPilot file names
+/// contain the log number. PX4 file names don't, so the file at the log index is used if its size matches,
+/// otherwise the only file with a matching size.
+QString
+LogDownloadController::_ftpLogFilePath() const
+{
+    const uint logSize = _downloadData->entry->size();
+
+    if (_vehicle->firmwareType() == MAV_AUTOPILOT_ARDUPILOTMEGA) {
+        const uint logNum = _downloadData->ID + _apmOneBased;
+        for (const FtpLogFile_t& logFile: _ftpLogFiles) {
+            bool ok = false;
+            if (QFileInfo(logFile.path).completeBaseName().toUInt(&ok) == logNum && ok && logFile.size == logSize) {
+                return logFile.path;
+            }
+        }
+        return QString();
+    }
+
+    if (_downloadData->ID < static_cast<uint>(_ftpLogFiles.count()) && _ftpLogFiles[_downloadData->ID].size == logSize) {
+        return _ftpLogFiles[_downloadData->ID].path;
+    }
+    QString matchedPath;
+    for (const FtpLogFile_t& logFile: _ftpLogFiles) {
+        if (logFile.size == logSize) {
+            if (!matchedPath.isEmpty()) {
+                // Ambiguous
+                return QString();
+            }
+            matchedPath = logFile.path;
+        }
+    }
+    return matchedPath;
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDownloadLogFile()
+{
+    QString logFilePath = _ftpLogFilePath();
+    if (logFilePath.isEmpty()) {
+        qCDebug(LogDownloadLog) << "No FTP log file matches log" << _downloadData->ID;
+        _ftpFallbackToLogRequest();
+        return;
+    }
+
+    qCDebug(LogDownloadLog) << "FTP download of log" << _downloadData->ID << logFilePath;
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QString     toDir       = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    //-- Other clients share the FTP queue, remember which transfer is ours
+    _ftpLogPathOnVehicle    = logFilePath;
+    _ftpDownloadFile        = QDir(toDir).absoluteFilePath(QFileInfo(logFilePath).fileName());
+    connect(ftpManager, &FTPManager::downloadComplete, this, &LogDownloadController::_ftpDownloadComplete);
+    connect(ftpManager, &FTPManager::commandProgress,  this, &LogDownloadController::_ftpDownloadProgress);
+    if (!ftpManager->download(logFilePath, toDir)) {
+        _ftpDisconnect();
+        _ftpFallbackToLogRequest();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDownloadProgress(float value)
+{
+    if (!_downloadData || _vehicle->ftpManager()->currentDownloadPath() != _ftpLogPathOnVehicle) {
+        // Progress of some other client's transfer
+        return;
+    }
+    const uint bytes = static_cast<uint>(value * _downloadData->entry->size());
+    if (bytes > _downloadData->written) {
+        _downloadData->rate_bytes += bytes - _downloadData->written;
+        _downloadData->written = bytes;
+    }
+    _updateDataRate();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDownloadComplete(const QString& file, const QString& errorMsg)
+{
+    if (file != _ftpDownloadFile) {
+        // Some other client's download completed, ours is still queued
+        return;
+    }
+    _ftpDisconnect();
+    _ftpLogPathOnVehicle.clear();
+    _ftpDownloadFile.clear();
+    if (!_downloadData) {
+        return;
+    }
+
+    if (!errorMsg.isEmpty()) {
+        qCDebug(LogDownloadLog) << "FTP log download failed, falling back to LOG_REQUEST_DATA" << errorMsg;
+        _ftpFallbackToLogRequest();
+        return;
+    }
+
+    //-- Replace the preallocated log file with the downloaded one
+    const QString logFile = _downloadData->file.fileName();
+    _downloadData->file.close();
+    _downloadData->file.remove();
+    if (QFile::rename(file, logFile)) {
+        _downloadData->written = _downloadData->entry->size();
+        _downloadData->entry->setStatus(tr("Downloaded"));
+    } else {
+        qWarning() << "Failed to move downloaded log file" << file << logFile;
+        QFile::remove(file);
+        _downloadData->entry->setStatus(tr("Error"));
+    }
+    //-- Check for more
+    _receivedAllData();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpFallbackToLogRequest()
+{
+    _downloadData->ftp = false;
+    _requestMissingData();
+    _timer.start(kTimeOutMilliseconds);
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDisconnect()
+{
+    if (_vehicle) {
+        disconnect(_vehicle->ftpManager(), nullptr, this, nullptr);
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -492,6 +732,8 @@ void
 LogDownloadController::refresh(void)
 {
     _logEntriesModel.clear();
+    //-- Log files on the vehicle may have changed
+    _ftpLogFilesValid = false;
     //-- Get first 50 entries
     _requestLogList(0, 49);
 }
@@ -633,8 +875,7 @@ LogDownloadController::_prepareLogDownload()
         if(!_downloadData->file.resize(entry->size())) {
             qWarning() << "Failed to allocate space for log file:" <<  _downloadData->filename;
         } else {
-            _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
+            _downloadData->bin_table = QBitArray(_downloadData->numBins(), false);
             _downloadData->elapsed.start();
             result = true;
         }
@@ -702,6 +943,15 @@ LogDownloadController::cancel(void)
         _receivedAllEntries();
     }
     if(_downloadData) {
+        if (_downloadData->ftp) {
+            _ftpDisconnect();
+            //-- Only our own request is dequeued or aborted, other clients' transfers keep going
+            if (!_ftpLogPathOnVehicle.isEmpty()) {
+                _vehicle->ftpManager()->cancelDownload(_ftpLogPathOnVehicle, QFileInfo(_ftpDownloadFile).absolutePath());
+            }
+            _ftpLogPathOnVehicle.clear();
+            _ftpDownloadFile.clear();
+        }
         _downloadData->entry->setStatus(tr("Canceled"));
         if (_downloadData->file.exists()) {
             _downloadData->file.remove();
@@ -113,6 +113,8 @@ class LogDownloadController : public QObject
 {
     Q_OBJECT
 
+    friend class LogDownloadControllerTest;
+
 public:
     LogDownloadController(void);
 
@@ -142,22 +144,36 @@ private slots:
     void _logEntry          (UASInterface *uas, uint32_t time_utc, uint32_t size, uint16_t id, uint16_t num_logs, uint16_t last_log_num);
     void _logData           (UASInterface *uas, uint32_t ofs, uint16_t id, uint8_t count, const uint8_t *data);
     void _processDownload   ();
+    void _ftpListDirectoryComplete  (const QString& dirPath, const QStringList& dirList, const QString& errorMsg);
+    void _ftpDownloadComplete       (const QString& file, const QString& errorMsg);
+    void _ftpDownloadProgress       (float value);
 
 private:
+    typedef struct {
+        QString path;
+        uint    size;
+    } FtpLogFile_t;
+
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
-    bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
     void _receivedAllData   ();
     void _resetSelection    (bool canceled = false);
     void _findMissingData   ();
+    void _requestMissingData();
     void _requestLogList    (uint32_t start, uint32_t end);
     void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
     bool _prepareLogDownload();
     void _setDownloading    (bool active);
     void _setListing        (bool active);
     void _updateDataRate    ();
+    bool _ftpLogDownloadSupported   () const;
+    void _ftpStartLogDownload       ();
+    void _ftpListNextDirectory      ();
+    void _ftpDownloadLogFile        ();
+    void _ftpFallbackToLogRequest   ();
+    void _ftpDisconnect             ();
+    QString _ftpLogFilePath         () const;
 
     QGCLogEntry* _getNextSelected();
 
@@ -171,6 +187,15 @@ private:
     int                 _retries;
     int                 _apmOneBased;
     QString             _downloadPath;
+    bool                _ftpLogFilesValid;      ///< true: _ftpLogFiles holds the result of listing the vehicle log directories
+    QList<FtpLogFile_t> _ftpLogFiles;           ///< Log files found on the vehicle using MAVLink FTP, in log id order
+    QStringList         _ftpPendingDirs;
+    QString             _ftpCurrentDir;
+    QString             _ftpLogPathOnVehicle;   ///< Log file being downloaded using MAVLink FTP
+    QString             _ftpDownloadFile;       ///< Local file the FTP download of _ftpLogPathOnVehicle completes to
+
+    static const char*  _px4FtpLogDirectory;
+    static const char*  _apmFtpLogDirectory;
 };
 
 #endif
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogDownloadControllerTest.h"
+#include "LogDownloadController.h"
+#include "MockLink.h"
+#include "MockLinkFTP.h"
+#include "FTPManager.h"
+
+#include <QDir>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+void LogDownloadControllerTest::cleanup(void)
+{
+    _disconnectMockLink();
+}
+
+QGCLogEntry* LogDownloadControllerTest::_refreshAndSelectFirstLog(LogDownloadController* controller)
+{
+    QSignalSpy requestingListSpy(controller, &LogDownloadController::requestingListChanged);
+
+    controller->refresh();
+    if (!QTest::qWaitFor([&]() { return requestingListSpy.count() != 0 && !controller->requestingList(); }, 10000)) {
+        return nullptr;
+    }
+
+    QGCLogModel* model = controller->model();
+    if (model->count() == 0) {
+        return nullptr;
+    }
+    QGCLogEntry* entry = (*model)[0];
+    entry->setSelected(true);
+    return entry;
+}
+
+/// LOG_DATA packets are dropped on the first pass. Once the vehicle has streamed the whole request the controller
+/// must ask for a single window spanning the holes instead of one request per hole.
+void LogDownloadControllerTest::_windowedLogRequestTest(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    LogDownloadController* controller = new LogDownloadController();
+    QGCLogEntry* entry = _refreshAndSelectFirstLog(controller);
+    QVERIFY(entry);
+
+    const uint32_t binSize = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    _mockLink->setLogDownloadDropOffsets({ 2 * binSize, 6 * binSize });
+
+    QTemporaryDir downloadDir;
+    QVERIFY(downloadDir.isValid());
+    QSignalSpy downloadingLogsSpy(controller, &LogDownloadController::downloadingLogsChanged);
+
+    controller->downloadToDirectory(downloadDir.path());
+    QTRY_VERIFY_WITH_TIMEOUT(downloadingLogsSpy.count() > 1 && !controller->downloadingLogs(), 10000);
+    QCOMPARE(entry->status(), LogDownloadController::tr("Downloaded"));
+
+    // Whole log first, then bins 2 through 6 in one request
+    const QList<QPair<uint32_t, uint32_t>> requests = _mockLink->logDownloadRequests();
+    QCOMPARE(requests.count(), 2);
+    QCOMPARE(requests[0].first,     0u);
+    QCOMPARE(requests[0].second,    static_cast<uint32_t>(entry->size()));
+    QCOMPARE(requests[1].first,     2 * binSize);
+    QCOMPARE(requests[1].second,    5 * binSize);
+
+    const QString downloadFile = QDir(downloadDir.path()).filePath("log_0_UnknownDate.ulg");
+    QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+
+    delete controller;
+}
+
+/// Another client's FTP download is in progress when the log download is queued behind it. The log download must
+/// ignore the progress and completion of the other transfer.
+void LogDownloadControllerTest::_ftpSharedQueueTest(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    LogDownloadController* controller = new LogDownloadController();
+    QGCLogEntry* entry = _refreshAndSelectFirstLog(controller);
+    QVERIFY(entry);
+
+    // The log file listing is filled in directly, MockLinkFTP only serves files named by size
+    const QString sizePrefix = MockLinkFTP::sizeFilenamePrefix;
+    LogDownloadController::FtpLogFile_t logFile;
+    logFile.path = sizePrefix + QString::number(entry->size());
+    logFile.size = entry->size();
+    controller->_ftpLogFiles.append(logFile);
+    controller->_ftpLogFilesValid = true;
+
+    QTemporaryDir logDir;
+    QTemporaryDir otherDir;
+    QVERIFY(logDir.isValid());
+    QVERIFY(otherDir.isValid());
+
+    QSignalSpy downloadingLogsSpy(controller, &LogDownloadController::downloadingLogsChanged);
+    controller->_downloadPath = logDir.path() + QDir::separator();
+    controller->_setDownloading(true);
+    QVERIFY(controller->_prepareLogDownload());
+
+    // The other transfer starts first, the log download queues up behind it
+    const int       otherSize   = static_cast<int>(entry->size()) * 2;
+    const QString   otherFile   = QDir(otherDir.path()).absoluteFilePath(sizePrefix + QString::number(otherSize));
+    QSignalSpy      otherSpy(_vehicle->ftpManager(), &FTPManager::downloadComplete);
+    QVERIFY(_vehicle->ftpManager()->download(sizePrefix + QString::number(otherSize), otherDir.path()));
+    controller->_ftpStartLogDownload();
+    downloadingLogsSpy.clear();
+
+    QTRY_VERIFY_WITH_TIMEOUT(downloadingLogsSpy.count() != 0 && !controller->downloadingLogs(), 10000);
+    QCOMPARE(otherSpy.count(), 2);
+    QCOMPARE(otherSpy[0][0].toString(), otherFile);
+
+    // The log holds the log data, the other client's file is untouched
+    QCOMPARE(entry->status(), LogDownloadController::tr("Downloaded"));
+    const QString downloadFile = QDir(logDir.path()).filePath("log_0_UnknownDate.ulg");
+    QCOMPARE(QFileInfo(downloadFile).size(), static_cast<qint64>(entry->size()));
+    QVERIFY(QFile::exists(otherFile));
+    QCOMPARE(QFileInfo(otherFile).size(), static_cast<qint64>(otherSize));
+
+    delete controller;
+}
+
+/// Cancelling a log download which is still queued behind another client's transfer must remove it from the queue,
+/// so no file is written for it later.
+void LogDownloadControllerTest::_ftpCancelQueuedTest(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    LogDownloadController* controller = new LogDownloadController();
+    QGCLogEntry* entry = _refreshAndSelectFirstLog(controller);
+    QVERIFY(entry);
+
+    const QString sizePrefix    = MockLinkFTP::sizeFilenamePrefix;
+    const QString logFileName   = sizePrefix + QString::number(entry->size());
+    const QString orphanFile    = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(logFileName);
+    LogDownloadController::FtpLogFile_t logFile;
+    logFile.path = logFileName;
+    logFile.size = entry->size();
+    controller->_ftpLogFiles.append(logFile);
+    controller->_ftpLogFilesValid = true;
+    QFile::remove(orphanFile);
+
+    QTemporaryDir logDir;
+    QTemporaryDir otherDir;
+    QVERIFY(logDir.isValid());
+    QVERIFY(otherDir.isValid());
+
+    controller->_downloadPath = logDir.path() + QDir::separator();
+    controller->_setDownloading(true);
+    QVERIFY(controller->_prepareLogDownload());
+
+    const int   otherSize = 4 * 1024;
+    QSignalSpy  otherSpy(_vehicle->ftpManager(), &FTPManager::downloadComplete);
+    QVERIFY(_vehicle->ftpManager()->download(sizePrefix + QString::number(otherSize), otherDir.path()));
+    controller->_ftpStartLogDownload();
+    controller->cancel();
+
+    QCOMPARE(entry->status(), LogDownloadController::tr("Canceled"));
+    QCOMPARE(controller->downloadingLogs(), false);
+
+    // Only the other transfer completes, the cancelled one never starts
+    QVERIFY(otherSpy.wait(10000));
+    QCOMPARE(otherSpy.wait(500), false);
+    QCOMPARE(otherSpy.count(), 1);
+    QVERIFY(otherSpy[0][1].toString().isEmpty());
+    QVERIFY(!QFile::exists(orphanFile));
+
+    delete controller;
+}
+
+/// The log directory listing must only consume its own results from the shared FTP queue. The listed file can't be
+/// served by MockLinkFTP, so the download then falls back to LOG_REQUEST_DATA.
+void LogDownloadControllerTest::_ftpListOwnershipTest(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    LogDownloadController* controller = new LogDownloadController();
+    QGCLogEntry* entry = _refreshAndSelectFirstLog(controller);
+    QVERIFY(entry);
+
+    const QString logFileName = QStringLiteral("12_34_56.ulg");
+    _mockLink->mockLinkFTP()->setFileList({ QStringLiteral("F%1\t%2").arg(logFileName).arg(entry->size()) });
+
+    QTemporaryDir logDir;
+    QVERIFY(logDir.isValid());
+
+    QSignalSpy downloadingLogsSpy(controller, &LogDownloadController::downloadingLogsChanged);
+    QSignalSpy listSpy(_vehicle->ftpManager(), &FTPManager::listDirectoryComplete);
+    controller->_downloadPath = logDir.path() + QDir::separator();
+    controller->_setDownloading(true);
+    QVERIFY(controller->_prepareLogDownload());
+
+    // Some other client lists a directory first, the vehicle returns the same entries for it
+    QVERIFY(_vehicle->ftpManager()->listDirectory(QStringLiteral("/other")));
+    controller->_ftpStartLogDownload();
+    downloadingLogsSpy.clear();
+
+    QTRY_VERIFY_WITH_TIMEOUT(downloadingLogsSpy.count() != 0 && !controller->downloadingLogs(), 10000);
+    QCOMPARE(listSpy.count(), 2);
+    QCOMPARE(listSpy[0][0].toString(), QStringLiteral("/other"));
+
+    QCOMPARE(controller->_ftpLogFiles.count(), 1);
+    QCOMPARE(controller->_ftpLogFiles[0].path, QString(LogDownloadController::_px4FtpLogDirectory) + "/" + logFileName);
+    QCOMPARE(entry->status(), LogDownloadController::tr("Downloaded"));
+    const QString downloadFile = QDir(logDir.path()).filePath("log_0_UnknownDate.ulg");
+    QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+
+    delete controller;
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LogDownloadController;
+class QGCLogEntry;
+
+class LogDownloadControllerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _windowedLogRequestTest    (void);
+    void _ftpSharedQueueTest        (void);
+    void _ftpCancelQueuedTest       (void);
+    void _ftpListOwnershipTest      (void);
+
+    // Overrides from UnitTest
+    void cleanup(void) override;
+
+private:
+    QGCLogEntry* _refreshAndSelectFirstLog(LogDownloadController* controller);
+};
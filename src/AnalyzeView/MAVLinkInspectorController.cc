@@ -26,6 +26,7 @@ QGCMAVLinkMessageField::QGCMAVLinkMessageField(QGCMAVLinkMessage *parent, QStrin
     , _type(type)
     , _name(name)
     , _msg(parent)
+    , _values(_maxSamples)
 {
     qCDebug(MAVLinkInspectorLog) << "Field:" << name << type;
 }
@@ -38,7 +39,8 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
-        _dataIndex = 0;
+        _values.clear();
+        _seriesDirty = false;
         _msg->updateFieldSelection();
     }
 }
@@ -49,8 +51,9 @@ QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
         _values.clear();
+        _plotPoints.clear();
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->replace(_plotPoints);
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -93,59 +96,52 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
         _value = newValue;
         emit valueChanged();
     }
+    appendSample(v);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::appendSample(qreal v)
+{
     if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
-        } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
-        }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
-            }
-        }
+        // Series and range are published by the chart at its refresh rate, not per message
+        _values.append(QGC::bootTimeMilliseconds(), v);
+        _seriesDirty = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Auto range support
+///     @return true: min/max changed
+bool
+QGCMAVLinkMessageField::updateRange()
+{
+    if(_values.isEmpty()) {
+        return false;
+    }
+    bool changed = false;
+    qreal vmin = _values.minValue();
+    qreal vmax = _values.maxValue();
+    if(std::abs(_rangeMin - vmin) > 0.000001) {
+        _rangeMin = vmin;
+        changed = true;
     }
+    if(std::abs(_rangeMax - vmax) > 0.000001) {
+        _rangeMax = vmax;
+        changed = true;
+    }
+    return changed;
 }
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateSeries()
-{
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
-        }
+QGCMAVLinkMessageField::updateSeries(qreal xMin, int maxPoints)
+{
+    if (_pSeries && _seriesDirty && _values.count() > 1) {
+        _seriesDirty = false;
+        _values.decimate(_plotPoints, xMin, maxPoints);
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
+        lineSeries->replace(_plotPoints);
     }
 }
 
@@ -215,6 +211,9 @@ QGCMAVLinkMessage::updateFreq()
     _messageHz = (0.2 * _messageHz) + (0.8 * msgCount);
     _lastCount = _count;
     emit freqChanged();
+    if(msgCount) {
+        emit countChanged();
+    }
 }
 
 void QGCMAVLinkMessage::setSelected(bool sel)
@@ -233,11 +232,35 @@ QGCMAVLinkMessage::update(mavlink_message_t* message)
     _count++;
     _message = *message;
 
-    if (_selected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
+    if (_selected || _fieldSelected) {
+        // Don't decode fields unless displayed or charted to reduce perf hit of message processing
         _updateFields();
     }
-    emit countChanged();
+    // countChanged is signalled from updateFreq to keep per message cost down on busy links
+}
+
+//-----------------------------------------------------------------------------
+/// Decodes a numeric field. The string representation is only built when requested.
+///     @param value First element of array fields
+template<typename T>
+static void
+_decodeNumericField(const uint8_t* m, unsigned int offset, unsigned int array_length, bool formatValue, QString& string, qreal& value)
+{
+    T n;
+    memcpy(&n, m + offset, sizeof(T));
+    value = static_cast<qreal>(n);
+    if (formatValue) {
+        if (array_length > 0) {
+            QStringList rgValues;
+            for (unsigned int j = 0; j < array_length; ++j) {
+                memcpy(&n, m + offset + (j * sizeof(T)), sizeof(T));
+                rgValues.append(QString::number(n));
+            }
+            string = rgValues.join(QStringLiteral(", "));
+        } else {
+            string = QString::number(n);
+        }
+    }
 }
 
 void QGCMAVLinkMessage::_updateFields(void)
@@ -251,218 +274,77 @@ void QGCMAVLinkMessage::_updateFields(void)
         qWarning() << QStringLiteral("QGCMAVLinkMessage::update msgInfo field count mismatch msgid(%1)").arg(_message.msgid);
         return;
     }
-    uint8_t* m = reinterpret_cast<uint8_t*>(&_message.payload64[0]);
+    //-- Only the message expanded in the UI needs string values, otherwise only charted fields are decoded
+    const bool formatValue = _selected;
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
     for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
         QGCMAVLinkMessageField* f = qobject_cast<QGCMAVLinkMessageField*>(_fields.get(static_cast<int>(i)));
-        if(f) {
-            const unsigned int offset = msgInfo->fields[i].wire_offset;
-            const unsigned int array_length = msgInfo->fields[i].array_length;
-            static const unsigned int array_buffer_length = (MAVLINK_MAX_PAYLOAD_LEN + MAVLINK_NUM_CHECKSUM_BYTES + 7);
-            switch (msgInfo->fields[i].type) {
-            case MAVLINK_TYPE_CHAR:
-                f->setSelectable(false);
-                if (array_length > 0) {
-                    char* str = reinterpret_cast<char*>(m + offset);
-                    // Enforce null termination
-                    str[array_length - 1] = '\0';
-                    QString v(str);
-                    f->updateValue(v, 0);
-                } else {
-                    // Single char
-                    char b = *(reinterpret_cast<char*>(m + offset));
-                    QString v(b);
-                    f->updateValue(v, 0);
-                }
-                break;
-            case MAVLINK_TYPE_UINT8_T:
-                if (array_length > 0) {
-                    uint8_t* nums = m + offset;
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint8_t u = *(m + offset);
-                    f->updateValue(QString::number(u), static_cast<qreal>(u));
-                }
-                break;
-            case MAVLINK_TYPE_INT8_T:
-                if (array_length > 0) {
-                    int8_t* nums = reinterpret_cast<int8_t*>(m + offset);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int8_t n = *(reinterpret_cast<int8_t*>(m + offset));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_UINT16_T:
-                if (array_length > 0) {
-                    uint16_t nums[array_buffer_length / sizeof(uint16_t)];
-                    memcpy(nums, m + offset,  sizeof(uint16_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint16_t n;
-                    memcpy(&n, m + offset, sizeof(uint16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_INT16_T:
-                if (array_length > 0) {
-                    int16_t nums[array_buffer_length / sizeof(int16_t)];
-                    memcpy(nums, m + offset,  sizeof(int16_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int16_t n;
-                    memcpy(&n, m + offset, sizeof(int16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_UINT32_T:
-                if (array_length > 0) {
-                    uint32_t nums[array_buffer_length / sizeof(uint32_t)];
-                    memcpy(nums, m + offset,  sizeof(uint32_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint32_t n;
-                    memcpy(&n, m + offset, sizeof(uint32_t));
-                    //-- Special case
-                    if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
-                        QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n),Qt::UTC,0);
-                        f->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
-                    } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
-                    }
-                }
-                break;
-            case MAVLINK_TYPE_INT32_T:
-                if (array_length > 0) {
-                    int32_t nums[array_buffer_length / sizeof(int32_t)];
-                    memcpy(nums, m + offset,  sizeof(int32_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int32_t n;
-                    memcpy(&n, m + offset, sizeof(int32_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_FLOAT:
-                if (array_length > 0) {
-                    float nums[array_buffer_length / sizeof(float)];
-                    memcpy(nums, m + offset,  sizeof(float) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                       string += tmp.arg(static_cast<double>(nums[j]));
-                    }
-                    string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    float fv;
-                    memcpy(&fv, m + offset, sizeof(float));
-                    f->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
-                }
-                break;
-            case MAVLINK_TYPE_DOUBLE:
-                if (array_length > 0) {
-                    double nums[array_buffer_length / sizeof(double)];
-                    memcpy(nums, m + offset,  sizeof(double) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    double d;
-                    memcpy(&d, m + offset, sizeof(double));
-                    f->updateValue(QString::number(d), static_cast<qreal>(d));
-                }
-                break;
-            case MAVLINK_TYPE_UINT64_T:
-                if (array_length > 0) {
-                    uint64_t nums[array_buffer_length / sizeof(uint64_t)];
-                    memcpy(nums, m + offset,  sizeof(uint64_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint64_t n;
-                    memcpy(&n, m + offset, sizeof(uint64_t));
-                    //-- Special case
-                    if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
-                        QDateTime d = QDateTime::fromMSecsSinceEpoch(n/1000,Qt::UTC,0);
-                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
-                    } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
-                    }
-                }
-                break;
-            case MAVLINK_TYPE_INT64_T:
-                if (array_length > 0) {
-                    int64_t nums[array_buffer_length / sizeof(int64_t)];
-                    memcpy(nums, m + offset,  sizeof(int64_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int64_t n;
-                    memcpy(&n, m + offset, sizeof(int64_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
+        if(!f || (!formatValue && !f->selected())) {
+            continue;
+        }
+        const unsigned int offset = msgInfo->fields[i].wire_offset;
+        const unsigned int array_length = msgInfo->fields[i].array_length;
+        QString string;
+        qreal   value = 0;
+        switch (msgInfo->fields[i].type) {
+        case MAVLINK_TYPE_CHAR:
+            f->setSelectable(false);
+            if (array_length > 0) {
+                // Strings are not necessarily null terminated
+                const char* str = reinterpret_cast<const char*>(m + offset);
+                string = QString::fromLatin1(str, static_cast<int>(qstrnlen(str, array_length)));
+            } else {
+                // Single char
+                string = QChar(*(reinterpret_cast<const char*>(m + offset)));
             }
+            break;
+        case MAVLINK_TYPE_UINT8_T:
+            _decodeNumericField<uint8_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_INT8_T:
+            _decodeNumericField<int8_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_UINT16_T:
+            _decodeNumericField<uint16_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_INT16_T:
+            _decodeNumericField<int16_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_UINT32_T:
+            _decodeNumericField<uint32_t>(m, offset, array_length, formatValue, string, value);
+            //-- Special case
+            if(formatValue && array_length == 0 && _message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
+                QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(value),Qt::UTC,0);
+                string = d.toString("HH:mm:ss");
+            }
+            break;
+        case MAVLINK_TYPE_INT32_T:
+            _decodeNumericField<int32_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_FLOAT:
+            _decodeNumericField<float>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_DOUBLE:
+            _decodeNumericField<double>(m, offset, array_length, formatValue, string, value);
+            break;
+        case MAVLINK_TYPE_UINT64_T:
+            _decodeNumericField<uint64_t>(m, offset, array_length, formatValue, string, value);
+            //-- Special case
+            if(formatValue && array_length == 0 && _message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
+                uint64_t n;
+                memcpy(&n, m + offset, sizeof(uint64_t));
+                QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n/1000),Qt::UTC,0);
+                string = d.toString("yyyy MM dd HH:mm:ss");
+            }
+            break;
+        case MAVLINK_TYPE_INT64_T:
+            _decodeNumericField<int64_t>(m, offset, array_length, formatValue, string, value);
+            break;
+        }
+        if(formatValue) {
+            f->updateValue(string, value);
+        } else {
+            f->appendSample(value);
         }
     }
 }
@@ -485,15 +367,15 @@ QGCMAVLinkSystem::~QGCMAVLinkSystem()
 QGCMAVLinkMessage*
 QGCMAVLinkSystem::findMessage(uint32_t id, uint8_t cid)
 {
-    for(int i = 0; i < _messages.count(); i++) {
-        QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(_messages.get(i));
-        if(m) {
-            if(m->id() == id && m->cid() == cid) {
-                return m;
-            }
-        }
-    }
-    return nullptr;
+    return _messageMap.value(_messageKey(id, cid), nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkSystem::clearMessages()
+{
+    _messageMap.clear();
+    _messages.clearAndDeleteContents();
 }
 
 //-----------------------------------------------------------------------------
@@ -562,6 +444,7 @@ QGCMAVLinkSystem::append(QGCMAVLinkMessage* message)
         message->setSelected(true);
     }
     _messages.append(message);
+    _messageMap[_messageKey(message->id(), message->cid())] = message;
     //-- Sort messages by id and then cid
     if (_messages.count() > 0) {
         _messages.beginReset();
@@ -644,13 +527,23 @@ MAVLinkChartController::updateXRange()
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+MAVLinkChartController::setPlotWidth(int plotWidth)
+{
+    if(_plotWidth != plotWidth) {
+        _plotWidth = plotWidth;
+        emit plotWidthChanged();
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkChartController::updateYRange()
 {
     if(_chartFields.count()) {
         qreal vmin  = std::numeric_limits<qreal>::max();
-        qreal vmax  = std::numeric_limits<qreal>::min();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
         for(int i = 0; i < _chartFields.count(); i++) {
             QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
             QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
@@ -675,13 +568,23 @@ void
 MAVLinkChartController::_refreshSeries()
 {
     updateXRange();
+    //-- Two points (min/max) per pixel is all the plot can show
+    qreal   xMin        = static_cast<qreal>(_rangeXMin.toMSecsSinceEpoch());
+    int     maxPoints   = qMax(_plotWidth, 1) * 2;
+    bool    rangeChanged = false;
     for(int i = 0; i < _chartFields.count(); i++) {
         QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
         QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
         if(pField) {
-            pField->updateSeries();
+            pField->updateSeries(xMin, maxPoints);
+            if(_rangeYIndex == 0 && pField->updateRange()) {
+                rangeChanged = true;
+            }
         }
     }
+    if(rangeChanged) {
+        updateYRange();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -839,7 +742,7 @@ MAVLinkInspectorController::_vehicleAdded(Vehicle* vehicle)
 {
     QGCMAVLinkSystem* v = _findVehicle(static_cast<uint8_t>(vehicle->id()));
     if(v) {
-        v->messages()->clearAndDeleteContents();
+        v->clearMessages();
     } else {
         v = new QGCMAVLinkSystem(this, static_cast<uint8_t>(vehicle->id()));
         _systems.append(v);
@@ -854,6 +757,9 @@ MAVLinkInspectorController::_vehicleRemoved(Vehicle* vehicle)
 {
     QGCMAVLinkSystem* v = _findVehicle(static_cast<uint8_t>(vehicle->id()));
     if(v) {
+        if(_lastSystem == v) {
+            _lastSystem = nullptr;
+        }
         v->deleteLater();
         _systems.removeOne(v);
         QString vs = tr("System %1").arg(vehicle->id());
@@ -867,7 +773,7 @@ void
 MAVLinkInspectorController::_receiveMessage(LinkInterface*, mavlink_message_t message)
 {
     QGCMAVLinkMessage* m = nullptr;
-    QGCMAVLinkSystem* v = _findVehicle(message.sysid);
+    QGCMAVLinkSystem* v = _lastSystem && _lastSystem->id() == message.sysid ? _lastSystem : _findVehicle(message.sysid);
     if(!v) {
         v = new QGCMAVLinkSystem(this, message.sysid);
         _systems.append(v);
@@ -880,6 +786,7 @@ MAVLinkInspectorController::_receiveMessage(LinkInterface*, mavlink_message_t me
     } else {
         m = v->findMessage(message.msgid, message.compid);
     }
+    _lastSystem = v;
     if(!m) {
         m = new QGCMAVLinkMessage(this, &message);
         v->append(m);
@@ -15,6 +15,7 @@
 
 #include "MAVLinkProtocol.h"
 #include "Vehicle.h"
+#include "TimeSeriesRingBuffer.h"
 
 #include <QObject>
 #include <QString>
@@ -53,17 +54,18 @@ public:
     bool            selectable      () const{ return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
     qreal           rangeMin        () const{ return _rangeMin; }
     qreal           rangeMax        () const{ return _rangeMax; }
     int             chartIndex      ();
 
     void            setSelectable   (bool sel);
     void            updateValue     (QString newValue, qreal v);
+    void            appendSample    (qreal v);
 
     void            addSeries       (MAVLinkChartController* chart, QAbstractSeries* series);
     void            delSeries       ();
-    void            updateSeries    ();
+    void            updateSeries    (qreal xMin, int maxPoints);
+    bool            updateRange     ();
 
 signals:
     void            seriesChanged       ();
@@ -75,14 +77,17 @@ private:
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
+    bool        _seriesDirty= false;        ///< New samples since last series update
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    TimeSeriesRingBuffer _values;
+    QVector<QPointF>    _plotPoints;        ///< Reused buffer for decimated series points
+
+    static const int    _maxSamples = 50 * 60;  ///< Arbitrary limit of 1 minute of data at 50Hz
 };
 
 //-----------------------------------------------------------------------------
@@ -160,6 +165,7 @@ public:
     QGCMAVLinkMessage*  findMessage     (uint32_t id, uint8_t cid);
     int                 findMessage     (QGCMAVLinkMessage* message);
     void                append          (QGCMAVLinkMessage* message);
+    void                clearMessages   ();
 
 signals:
     void compIDsChanged                 ();
@@ -169,11 +175,14 @@ private:
     void _checkCompID                   (QGCMAVLinkMessage *message);
     void _resetSelection                ();
 
+    static quint32 _messageKey          (uint32_t id, uint8_t cid) { return (id << 8) | cid; }
+
 private:
     quint8              _id;
     QList<int>          _compIDs;
     QStringList         _compIDsStr;
     QmlObjectListModel  _messages;      //-- List of QGCMAVLinkMessage
+    QHash<quint32, QGCMAVLinkMessage*> _messageMap;    //-- Lookup by msgid/compid for the receive path
     int                 _selected = 0;
 };
 
@@ -190,6 +199,7 @@ public:
     Q_PROPERTY(qreal        rangeYMin           READ rangeYMin              NOTIFY rangeYMinChanged)
     Q_PROPERTY(qreal        rangeYMax           READ rangeYMax              NOTIFY rangeYMaxChanged)
     Q_PROPERTY(int          chartIndex          READ chartIndex             CONSTANT)
+    Q_PROPERTY(int          plotWidth           READ plotWidth              WRITE setPlotWidth      NOTIFY plotWidthChanged)    ///< Width of plot area in pixels, used to decimate series
 
     Q_PROPERTY(quint32      rangeYIndex         READ rangeYIndex            WRITE setRangeYIndex    NOTIFY rangeYIndexChanged)
     Q_PROPERTY(quint32      rangeXIndex         READ rangeXIndex            WRITE setRangeXIndex    NOTIFY rangeXIndexChanged)
@@ -207,8 +217,10 @@ public:
     quint32                 rangeXIndex         () const{ return _rangeXIndex; }
     quint32                 rangeYIndex         () const{ return _rangeYIndex; }
     int                     chartIndex          () const{ return _index; }
+    int                     plotWidth           () const{ return _plotWidth; }
 
     void                    setRangeXIndex      (quint32 t);
+    void                    setPlotWidth        (int plotWidth);
     void                    setRangeYIndex      (quint32 r);
     void                    updateXRange        ();
     void                    updateYRange        ();
@@ -221,6 +233,7 @@ signals:
     void rangeYMaxChanged   ();
     void rangeYIndexChanged ();
     void rangeXIndexChanged ();
+    void plotWidthChanged   ();
 
 private slots:
     void _refreshSeries     ();
@@ -234,6 +247,7 @@ private:
     qreal               _rangeYMax           = 1;
     quint32             _rangeXIndex         = 0;                    ///< 5 Seconds
     quint32             _rangeYIndex         = 0;                    ///< Auto Range
+    int                 _plotWidth           = 1000;
     QVariantList        _chartFields;
     MAVLinkInspectorController* _controller  = nullptr;
 };
@@ -306,6 +320,7 @@ private:
     QStringList         _timeScales;
     QStringList         _rangeList;
     QGCMAVLinkSystem*   _activeSystem           = nullptr;
+    QGCMAVLinkSystem*   _lastSystem             = nullptr;  ///< System of last received message, avoids lookup for the common single vehicle case
     QTimer              _updateFrequencyTimer;
     QStringList         _systemNames;
     QmlObjectListModel  _systems;                           ///< List of QGCMAVLinkSystem
@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTraceController.h"
+#include "TelemetryTracer.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+
+#include <QFile>
+
+TelemetryTraceController::TelemetryTraceController(void)
+    : _enabled(TelemetryTracer::enabled())
+{
+    _refreshTimer.setInterval(_refreshIntervalMSecs);
+    connect(&_refreshTimer, &QTimer::timeout, this, &TelemetryTraceController::_refreshStages);
+
+    _refreshStages();
+    if (_enabled) {
+        _refreshTimer.start();
+    }
+}
+
+void TelemetryTraceController::setEnabled(bool enabled)
+{
+    if (enabled != _enabled) {
+        _enabled = enabled;
+        qgcApp()->toolbox()->linkManager()->setTelemetryTracingEnabled(enabled);
+        if (enabled) {
+            _refreshTimer.start();
+        } else {
+            _refreshTimer.stop();
+        }
+        _refreshStages();
+        emit enabledChanged(enabled);
+    }
+}
+
+void TelemetryTraceController::reset(void)
+{
+    TelemetryTracer::reset();
+    _refreshStages();
+}
+
+bool TelemetryTraceController::exportChromeTrace(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qgcApp()->showAppMessage(tr("Unable to save telemetry trace '%1': %2").arg(filename).arg(file.errorString()));
+        return false;
+    }
+    file.write(TelemetryTracer::chromeTraceJson());
+    return true;
+}
+
+void TelemetryTraceController::_refreshStages(void)
+{
+    _stages = TelemetryTracer::stageStatistics();
+    emit stagesChanged();
+}
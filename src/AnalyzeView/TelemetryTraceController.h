@@ -0,0 +1,51 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QVariantList>
+
+/// Controller for TelemetryTracePage.qml
+class TelemetryTraceController : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryTraceController(void);
+
+    Q_PROPERTY(bool         enabled READ enabled    WRITE setEnabled    NOTIFY enabledChanged)
+    Q_PROPERTY(QVariantList stages  READ stages                         NOTIFY stagesChanged)
+
+    /// Clears all collected statistics and trace events
+    Q_INVOKABLE void reset(void);
+
+    /// Writes the buffered trace events in Chrome trace event format
+    ///     @return false: unable to write file
+    Q_INVOKABLE bool exportChromeTrace(const QString& filename);
+
+    bool            enabled     (void) const { return _enabled; }
+    QVariantList    stages      (void) const { return _stages; }
+    void            setEnabled  (bool enabled);
+
+signals:
+    void enabledChanged (bool enabled);
+    void stagesChanged  (void);
+
+private slots:
+    void _refreshStages(void);
+
+private:
+    bool            _enabled;
+    QVariantList    _stages;
+    QTimer          _refreshTimer;
+
+    static const int _refreshIntervalMSecs = 1000;
+};
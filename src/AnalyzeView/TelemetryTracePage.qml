@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick          2.3
+import QtQuick.Controls 1.3
+import QtQuick.Layouts  1.2
+
+import QGroundControl               1.0
+import QGroundControl.Palette       1.0
+import QGroundControl.Controls      1.0
+import QGroundControl.ScreenTools   1.0
+import QGroundControl.Controllers   1.0
+
+AnalyzePage {
+    id:                 telemetryTracePage
+    pageComponent:      pageComponent
+    pageDescription:    qsTr("Measures latency through each stage of the telemetry receive path, from bytes arriving at the link to the resulting value change. Tracing adds a small overhead and should only be enabled while diagnosing.")
+    allowPopout:        true
+
+    property real _margins: ScreenTools.defaultFontPixelWidth
+
+    TelemetryTraceController {
+        id: controller
+    }
+
+    Component {
+        id: pageComponent
+
+        ColumnLayout {
+            width:      availableWidth
+            spacing:    _margins
+
+            RowLayout {
+                spacing: _margins
+
+                QGCCheckBox {
+                    text:       qsTr("Enable Tracing")
+                    checked:    controller.enabled
+                    onClicked:  controller.enabled = checked
+                }
+
+                QGCButton {
+                    text:       qsTr("Reset")
+                    onClicked:  controller.reset()
+                }
+
+                QGCButton {
+                    text:       qsTr("Export Chrome Trace")
+                    onClicked: {
+                        fileDialog.title =          qsTr("Export Chrome Trace")
+                        fileDialog.selectExisting = false
+                        fileDialog.openForSave()
+                    }
+                }
+            }
+
+            GridLayout {
+                columns:        9
+                rowSpacing:     0
+                columnSpacing:  _margins * 2
+
+                QGCLabel { text: qsTr("Stage") }
+                QGCLabel { text: qsTr("Count");     Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("Min");       Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("Mean");      Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("P50");       Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("P90");       Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("P99");       Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("P99.9");     Layout.alignment: Qt.AlignRight }
+                QGCLabel { text: qsTr("Max (ms)");  Layout.alignment: Qt.AlignRight }
+
+                Repeater {
+                    model: controller.stages
+
+                    delegate: Repeater {
+                        property var stage: modelData
+
+                        model: [
+                            stage.name,
+                            stage.count,
+                            stage.minMs.toFixed(3),
+                            stage.meanMs.toFixed(3),
+                            stage.p50Ms.toFixed(3),
+                            stage.p90Ms.toFixed(3),
+                            stage.p99Ms.toFixed(3),
+                            stage.p999Ms.toFixed(3),
+                            stage.maxMs.toFixed(3)
+                        ]
+
+                        QGCLabel {
+                            text:               modelData
+                            Layout.alignment:   index === 0 ? Qt.AlignLeft : Qt.AlignRight
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    QGCFileDialog {
+        id:             fileDialog
+        folder:         QGroundControl.settingsManager.appSettings.logSavePath
+        nameFilters:    [ qsTr("Chrome Trace (*.json)"), qsTr("All Files (*)") ]
+
+        onAcceptedForSave: {
+            controller.exportChromeTrace(file)
+            close()
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TimeSeriesRingBuffer.h"
+
+TimeSeriesRingBuffer::TimeSeriesRingBuffer(int capacity)
+    : _points(qMax(capacity, 1))
+{
+
+}
+
+void TimeSeriesRingBuffer::append(qreal x, qreal y)
+{
+    _points[_head] = QPointF(x, y);
+    _head = (_head + 1) % _points.count();
+    if (_count < _points.count()) {
+        _count++;
+    }
+
+    // Drop samples which have fallen out of the window
+    const quint64 seq = _seq++;
+    if (seq >= static_cast<quint64>(_points.count())) {
+        const quint64 oldestSeq = seq - static_cast<quint64>(_points.count()) + 1;
+        while (!_minDeque.empty() && _minDeque.front().first < oldestSeq) {
+            _minDeque.pop_front();
+        }
+        while (!_maxDeque.empty() && _maxDeque.front().first < oldestSeq) {
+            _maxDeque.pop_front();
+        }
+    }
+
+    // A new sample makes any older sample with a larger (min) or smaller (max) value irrelevant
+    while (!_minDeque.empty() && _minDeque.back().second >= y) {
+        _minDeque.pop_back();
+    }
+    _minDeque.push_back(SeqValue_t(seq, y));
+    while (!_maxDeque.empty() && _maxDeque.back().second <= y) {
+        _maxDeque.pop_back();
+    }
+    _maxDeque.push_back(SeqValue_t(seq, y));
+}
+
+void TimeSeriesRingBuffer::clear(void)
+{
+    _head   = 0;
+    _count  = 0;
+    _seq    = 0;
+    _minDeque.clear();
+    _maxDeque.clear();
+}
+
+/// @return Index of first sample with x >= the specified value. Samples are appended in time order.
+int TimeSeriesRingBuffer::_lowerBound(qreal x) const
+{
+    int low     = 0;
+    int high    = _count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (at(mid).x() < x) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void TimeSeriesRingBuffer::decimate(QVector<QPointF>& points, qreal xMin, int maxPoints) const
+{
+    points.clear();
+
+    const int start     = _lowerBound(xMin);
+    const int cSamples  = _count - start;
+    if (cSamples <= 0) {
+        return;
+    }
+
+    if (maxPoints < 2 || cSamples <= maxPoints) {
+        points.reserve(cSamples);
+        for (int i=start; i<_count; i++) {
+            points.append(at(i));
+        }
+        return;
+    }
+
+    const int       cBuckets    = maxPoints / 2;
+    const double    bucketSize  = static_cast<double>(cSamples) / cBuckets;
+    points.reserve(cBuckets * 2);
+    for (int bucket=0; bucket<cBuckets; bucket++) {
+        const int bucketStart   = start + static_cast<int>(bucket * bucketSize);
+        const int bucketEnd     = qMin(start + static_cast<int>((bucket + 1) * bucketSize), _count);
+        if (bucketStart >= bucketEnd) {
+            continue;
+        }
+
+        int minIndex = bucketStart;
+        int maxIndex = bucketStart;
+        for (int i=bucketStart + 1; i<bucketEnd; i++) {
+            const qreal y = at(i).y();
+            if (y < at(minIndex).y()) {
+                minIndex = i;
+            }
+            if (y > at(maxIndex).y()) {
+                maxIndex = i;
+            }
+        }
+
+        // Keep time ordering within the bucket
+        points.append(at(qMin(minIndex, maxIndex)));
+        if (minIndex != maxIndex) {
+            points.append(at(qMax(minIndex, maxIndex)));
+        }
+    }
+}
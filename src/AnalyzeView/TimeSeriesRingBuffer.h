@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+
+#include <deque>
+
+/// Fixed capacity ring buffer of (time, value) samples. Once full the oldest sample is overwritten.
+/// The minimum and maximum of the buffered values are tracked incrementally using monotonic deques,
+/// so append and min/max are amortized O(1) instead of a rescan of the full buffer.
+class TimeSeriesRingBuffer
+{
+public:
+    TimeSeriesRingBuffer(int capacity);
+
+    void    append      (qreal x, qreal y);
+    void    clear       (void);
+
+    int     count       (void) const { return _count; }
+    int     capacity    (void) const { return _points.count(); }
+    bool    isEmpty     (void) const { return _count == 0; }
+
+    /// @param index 0 is the oldest sample
+    const QPointF& at   (int index) const { return _points[(_first() + index) % _points.count()]; }
+
+    /// Minimum/maximum value of all buffered samples. Only valid if !isEmpty().
+    qreal   minValue    (void) const { return _minDeque.front().second; }
+    qreal   maxValue    (void) const { return _maxDeque.front().second; }
+
+    /// Copies the samples with x >= xMin into points, reduced to at most maxPoints. Reduction is done by
+    /// splitting the samples into buckets and keeping the min and max sample of each bucket, which keeps
+    /// spikes visible when plotting.
+    ///     @param maxPoints Typically twice the pixel width of the plot
+    void    decimate    (QVector<QPointF>& points, qreal xMin, int maxPoints) const;
+
+private:
+    int     _first      (void) const { return _count < _points.count() ? 0 : _head; }
+    int     _lowerBound (qreal x) const;
+
+    typedef std::pair<quint64, qreal> SeqValue_t;   ///< Sample sequence number and value
+
+    QVector<QPointF>        _points;
+    int                     _head   = 0;            ///< Index next sample is written to
+    int                     _count  = 0;
+    quint64                 _seq    = 0;            ///< Sequence number of next sample
+    std::deque<SeqValue_t>  _minDeque;              ///< Increasing values, front is window minimum
+    std::deque<SeqValue_t>  _maxDeque;              ///< Decreasing values, front is window maximum
+};
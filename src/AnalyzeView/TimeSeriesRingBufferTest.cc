@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TimeSeriesRingBufferTest.h"
+#include "TimeSeriesRingBuffer.h"
+
+void TimeSeriesRingBufferTest::_capacityTest(void)
+{
+    TimeSeriesRingBuffer buffer(5);
+    QCOMPARE(buffer.capacity(), 5);
+    QCOMPARE(buffer.count(), 0);
+    QVERIFY(buffer.isEmpty());
+
+    for (int i=0; i<5; i++) {
+        buffer.append(i, i);
+        QCOMPARE(buffer.count(), i + 1);
+    }
+    buffer.append(5, 5);
+    QCOMPARE(buffer.count(), 5);
+    QCOMPARE(buffer.capacity(), 5);
+
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    QCOMPARE(buffer.capacity(), 5);
+
+    // Invalid capacity still holds a single sample
+    TimeSeriesRingBuffer zeroBuffer(0);
+    QCOMPARE(zeroBuffer.capacity(), 1);
+    zeroBuffer.append(1, 10);
+    zeroBuffer.append(2, 20);
+    QCOMPARE(zeroBuffer.count(), 1);
+    QCOMPARE(zeroBuffer.at(0), QPointF(2, 20));
+    QCOMPARE(zeroBuffer.minValue(), 20.0);
+    QCOMPARE(zeroBuffer.maxValue(), 20.0);
+}
+
+void TimeSeriesRingBufferTest::_wraparoundTest(void)
+{
+    TimeSeriesRingBuffer buffer(5);
+
+    // Wrap around more than once so the head passes through every slot
+    for (int i=0; i<13; i++) {
+        buffer.append(i, i * 10);
+
+        const int cExpected = qMin(i + 1, 5);
+        QCOMPARE(buffer.count(), cExpected);
+        for (int j=0; j<cExpected; j++) {
+            const int x = i - cExpected + 1 + j;
+            QCOMPARE(buffer.at(j), QPointF(x, x * 10));
+        }
+    }
+
+    // Buffer starts over from the first slot after a clear
+    buffer.clear();
+    buffer.append(100, 1);
+    buffer.append(101, 2);
+    QCOMPARE(buffer.count(), 2);
+    QCOMPARE(buffer.at(0), QPointF(100, 1));
+    QCOMPARE(buffer.at(1), QPointF(101, 2));
+    QCOMPARE(buffer.minValue(), 1.0);
+    QCOMPARE(buffer.maxValue(), 2.0);
+}
+
+void TimeSeriesRingBufferTest::_minMaxTest(void)
+{
+    const int               capacity = 7;
+    TimeSeriesRingBuffer    buffer(capacity);
+
+    // Deterministic sequence with repeated values, runs and spikes which fall out of the window
+    quint32 state = 12345;
+    for (int i=0; i<200; i++) {
+        state = state * 1103515245 + 12345;
+        qreal y = static_cast<qreal>((state >> 16) % 21) - 10;
+        if (i % 50 == 0) {
+            y = 1000;
+        } else if (i % 50 == 25) {
+            y = -1000;
+        }
+        buffer.append(i, y);
+
+        qreal minValue = buffer.at(0).y();
+        qreal maxValue = buffer.at(0).y();
+        for (int j=1; j<buffer.count(); j++) {
+            minValue = qMin(minValue, buffer.at(j).y());
+            maxValue = qMax(maxValue, buffer.at(j).y());
+        }
+        QCOMPARE(buffer.minValue(), minValue);
+        QCOMPARE(buffer.maxValue(), maxValue);
+    }
+}
+
+void TimeSeriesRingBufferTest::_rangeQueryTest(void)
+{
+    TimeSeriesRingBuffer    buffer(10);
+    QVector<QPointF>        points;
+
+    buffer.decimate(points, 0, 100);
+    QVERIFY(points.isEmpty());
+
+    // x = 5..14 are buffered, the oldest samples are in the upper half of the storage
+    for (int i=0; i<15; i++) {
+        buffer.append(i, -i);
+    }
+
+    buffer.decimate(points, 0, 100);
+    QCOMPARE(points.count(), 10);
+    for (int i=0; i<points.count(); i++) {
+        QCOMPARE(points[i], QPointF(i + 5, -(i + 5)));
+    }
+
+    // Lower bound is inclusive, both before and after the wrap point
+    buffer.decimate(points, 7, 100);
+    QCOMPARE(points.count(), 8);
+    QCOMPARE(points.first(), QPointF(7, -7));
+    QCOMPARE(points.last(), QPointF(14, -14));
+
+    buffer.decimate(points, 11.5, 100);
+    QCOMPARE(points.count(), 3);
+    QCOMPARE(points.first(), QPointF(12, -12));
+
+    buffer.decimate(points, 14, 100);
+    QCOMPARE(points.count(), 1);
+    QCOMPARE(points.first(), QPointF(14, -14));
+
+    buffer.decimate(points, 15, 100);
+    QVERIFY(points.isEmpty());
+}
+
+void TimeSeriesRingBufferTest::_decimateTest(void)
+{
+    TimeSeriesRingBuffer    buffer(100);
+    QVector<QPointF>        points;
+
+    for (int i=0; i<150; i++) {
+        qreal y = 0;
+        if (i == 120) {
+            y = 10;
+        } else if (i == 130) {
+            y = -10;
+        }
+        buffer.append(i, y);
+    }
+
+    // Exactly maxPoints samples are copied as is
+    buffer.decimate(points, 0, 100);
+    QCOMPARE(points.count(), 100);
+
+    // Reduced output stays in time order and keeps the spikes
+    buffer.decimate(points, 0, 10);
+    QVERIFY(points.count() <= 10);
+    QVERIFY(points.count() >= 5);
+    bool foundMax = false;
+    bool foundMin = false;
+    for (int i=0; i<points.count(); i++) {
+        if (i > 0) {
+            QVERIFY(points[i].x() > points[i - 1].x());
+        }
+        QVERIFY(points[i].x() >= 50);
+        foundMax |= points[i] == QPointF(120, 10);
+        foundMin |= points[i] == QPointF(130, -10);
+    }
+    QVERIFY(foundMax);
+    QVERIFY(foundMin);
+
+    // Range and reduction combined
+    buffer.decimate(points, 125, 4);
+    QVERIFY(points.count() <= 4);
+    QVERIFY(points.first().x() >= 125);
+    QVERIFY(points.contains(QPointF(130, -10)));
+    QVERIFY(!points.contains(QPointF(120, 10)));
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TimeSeriesRingBufferTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _capacityTest      (void);
+    void _wraparoundTest    (void);
+    void _minMaxTest        (void);
+    void _rangeQueryTest    (void);
+    void _decimateTest      (void);
+};
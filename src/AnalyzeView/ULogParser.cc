@@ -1,4 +1,5 @@
 #include "ULogParser.h"
+#include "ULogReader.h"
 #include <math.h>
 #include <QDateTime>
 
@@ -12,173 +13,71 @@ ULogParser::~ULogParser()
 
 }
 
-int ULogParser::sizeOfType(QString& typeName)
+bool ULogParser::getTagsFromLog(const QString& logFile, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage)
 {
-    if (typeName == QLatin1String("int8_t") || typeName == QLatin1String("uint8_t")) {
-        return 1;
-
-    } else if (typeName == QLatin1String("int16_t") || typeName == QLatin1String("uint16_t")) {
-        return 2;
-
-    } else if (typeName == QLatin1String("int32_t") || typeName == QLatin1String("uint32_t")) {
-        return 4;
-
-    } else if (typeName == QLatin1String("int64_t") || typeName == QLatin1String("uint64_t")) {
-        return 8;
-
-    } else if (typeName == QLatin1String("float")) {
-        return 4;
-
-    } else if (typeName == QLatin1String("double")) {
-        return 8;
-
-    } else if (typeName == QLatin1String("char") || typeName == QLatin1String("bool")) {
-        return 1;
-    }
-
-    qWarning() << "Unknown type in ULog : " << typeName;
-    return 0;
-}
-
-int ULogParser::sizeOfFullType(QString& typeNameFull)
-{
-    int arraySize;
-    QString typeName = extractArraySize(typeNameFull, arraySize);
-    return sizeOfType(typeName) * arraySize;
-}
-
-QString ULogParser::extractArraySize(QString &typeNameFull, int &arraySize)
-{
-    int startPos = typeNameFull.indexOf('[');
-    int endPos = typeNameFull.indexOf(']');
-
-    if (startPos == -1 || endPos == -1) {
-        arraySize = 1;
-        return typeNameFull;
-    }
-
-    arraySize = typeNameFull.midRef(startPos + 1, endPos - startPos - 1).toInt();
-    return typeNameFull.mid(0, startPos);
-}
-
-bool ULogParser::parseFieldFormat(QString& fields)
-{
-    int prevFieldEnd = 0;
-    int fieldEnd = fields.indexOf(';');
-    int offset = 0;
-
-    while (fieldEnd != -1) {
-        int spacePos = fields.indexOf(' ', prevFieldEnd);
-
-        if (spacePos != -1) {
-            QString typeNameFull = fields.mid(prevFieldEnd, spacePos - prevFieldEnd);
-            QString fieldName = fields.mid(spacePos + 1, fieldEnd - spacePos - 1);
-
-            if (!fieldName.contains(QLatin1String("_padding"))) {
-                _cameraCaptureOffsets.insert(fieldName, offset);
-                offset += sizeOfFullType(typeNameFull);
-            }
-        }
+    errorMessage.clear();
 
-        prevFieldEnd = fieldEnd + 1;
-        fieldEnd = fields.indexOf(';', prevFieldEnd);
+    ULogReader reader;
+    if (!reader.open(logFile, errorMessage)) {
+        return false;
     }
-    return false;
+    return getTagsFromLog(reader, cameraFeedback, errorMessage);
 }
 
-bool ULogParser::getTagsFromLog(QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage)
+bool ULogParser::getTagsFromLog(const ULogReader& reader, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback, QString& errorMessage)
 {
     errorMessage.clear();
 
-    //verify it's an ULog file
-    if(!log.contains(_ULogMagic)) {
-        errorMessage = tr("Could not detect ULog file header magic");
+    // Only instance 0 is used. Further instances come from additional cameras, each with its own sequence numbering and
+    // its own set of images, so merging them would pair images with triggers from the wrong camera.
+    const ULogReader::Topic_t* topic = reader.topic(QStringLiteral("camera_capture"), 0 /* multiId */);
+    const int cMessages = reader.messageCount(topic);
+    if (cMessages == 0) {
+        errorMessage = tr("Could not detect camera_capture packets in ULog");
         return false;
     }
 
-    int index = ULOG_FILE_HEADER_LEN;
-    bool geotagFound = false;
-
-    while(index < log.count() - 1) {
-
-        ULogMessageHeader header;
-        memset(&header, 0, sizeof(header));
-        memcpy(&header, log.data() + index, ULOG_MSG_HEADER_LEN);
-
-        switch (header.msgType) {
-            case (int)ULogMessageType::FORMAT:
-            {
-                ULogMessageFormat format_msg;
-                memset(&format_msg, 0, sizeof(format_msg));
-                memcpy(&format_msg, log.data() + index, ULOG_MSG_HEADER_LEN + header.msgSize);
-
-                QString fmt(format_msg.format);
-                int posSeparator = fmt.indexOf(':');
-                QString messageName = fmt.left(posSeparator);
-                QString messageFields = fmt.mid(posSeparator + 1, header.msgSize - posSeparator - 1);
-
-                if(messageName == QLatin1String("camera_capture")) {
-                    parseFieldFormat(messageFields);
-                }
-                break;
-            }
-
-            case (int)ULogMessageType::ADD_LOGGED_MSG:
-            {
-                ULogMessageAddLogged addLoggedMsg;
-                memset(&addLoggedMsg, 0, sizeof(addLoggedMsg));
-                memcpy(&addLoggedMsg, log.data() + index, ULOG_MSG_HEADER_LEN + header.msgSize);
-
-                QString messageName(addLoggedMsg.msgName);
-
-                if(messageName.contains(QLatin1String("camera_capture"))) {
-                    _cameraCaptureMsgID = addLoggedMsg.msgID;
-                    geotagFound = true;
-                }
-
-                break;
-            }
-
-            case (int)ULogMessageType::DATA:
-            {
-                uint16_t msgID = -1;
-                memcpy(&msgID, log.data() + index + ULOG_MSG_HEADER_LEN, 2);
-
-                if (geotagFound && msgID == _cameraCaptureMsgID) {
-
-                    // Completely dynamic parsing, so that changing/reordering the message format will not break the parser
-                    GeoTagWorker::cameraFeedbackPacket feedback;
-                    memset(&feedback, 0, sizeof(feedback));
-                    memcpy(&feedback.timestamp, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("timestamp")), 8);
-                    feedback.timestamp /= 1.0e6; // to seconds
-                    memcpy(&feedback.timestampUTC, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("timestamp_utc")), 8);
-                    feedback.timestampUTC /= 1.0e6; // to seconds
-                    memcpy(&feedback.imageSequence, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("seq")), 4);
-                    memcpy(&feedback.latitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("lat")), 8);
-                    memcpy(&feedback.longitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("lon")), 8);
-                    feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
-                    memcpy(&feedback.altitude, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("alt")), 4);
-                    memcpy(&feedback.groundDistance, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("ground_distance")), 4);
-                    memcpy(&feedback.captureResult, log.data() + index + 5 + _cameraCaptureOffsets.value(QStringLiteral("result")), 1);
-
-                    cameraFeedback.append(feedback);
-
-                }
+    // Completely dynamic parsing, so that changing/reordering the message format will not break the parser
+    const ULogReader::Field_t* timestampField       = ULogReader::field(topic, QStringLiteral("timestamp"));
+    const ULogReader::Field_t* timestampUTCField    = ULogReader::field(topic, QStringLiteral("timestamp_utc"));
+    const ULogReader::Field_t* seqField             = ULogReader::field(topic, QStringLiteral("seq"));
+    const ULogReader::Field_t* latField             = ULogReader::field(topic, QStringLiteral("lat"));
+    const ULogReader::Field_t* lonField             = ULogReader::field(topic, QStringLiteral("lon"));
+    const ULogReader::Field_t* altField             = ULogReader::field(topic, QStringLiteral("alt"));
+    const ULogReader::Field_t* groundDistanceField  = ULogReader::field(topic, QStringLiteral("ground_distance"));
+    const ULogReader::Field_t* qField               = ULogReader::field(topic, QStringLiteral("q"));
+    const ULogReader::Field_t* resultField          = ULogReader::field(topic, QStringLiteral("result"));
+
+    if (!timestampField || !seqField || !latField || !lonField || !altField) {
+        errorMessage = tr("Unsupported camera_capture format in ULog");
+        return false;
+    }
 
-                break;
+    cameraFeedback.reserve(cameraFeedback.count() + cMessages);
+    for (int i=0; i<cMessages; i++) {
+        GeoTagWorker::cameraFeedbackPacket feedback;
+        memset(&feedback, 0, sizeof(feedback));
+
+        feedback.timestamp      = reader.fieldValue(topic, i, timestampField) / 1.0e6; // to seconds
+        feedback.timestampUTC   = timestampUTCField ? reader.fieldValue(topic, i, timestampUTCField) / 1.0e6 : 0;
+        feedback.imageSequence  = static_cast<uint32_t>(reader.fieldValue(topic, i, seqField));
+        feedback.latitude       = reader.fieldValue(topic, i, latField);
+        feedback.longitude      = reader.fieldValue(topic, i, lonField);
+        feedback.longitude      = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
+        feedback.altitude       = static_cast<float>(reader.fieldValue(topic, i, altField));
+        if (groundDistanceField) {
+            feedback.groundDistance = static_cast<float>(reader.fieldValue(topic, i, groundDistanceField));
+        }
+        if (qField) {
+            for (int j=0; j<4 && j<qField->arraySize; j++) {
+                feedback.attitudeQuaternion[j] = static_cast<float>(reader.fieldValue(topic, i, qField, j));
             }
-
-            default:
-                break;
+        }
+        if (resultField) {
+            feedback.captureResult = static_cast<uint8_t>(reader.fieldValue(topic, i, resultField));
         }
 
-        index += (3 + header.msgSize);
-
-    }
-
-    if (cameraFeedback.count() == 0) {
-        errorMessage = tr("Could not detect camera_capture packets in ULog");
-        return false;
+        cameraFeedback.append(feedback);
     }
 
     return true;
@@ -0,0 +1,380 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReader.h"
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(ULogReaderLog, "ULogReaderLog")
+
+const char ULogReader::_ulogMagic[7] = { 'U', 'L', 'o', 'g', 0x01, 0x12, 0x35 };
+
+ULogReader::ULogReader(void)
+{
+
+}
+
+ULogReader::~ULogReader()
+{
+    close();
+}
+
+bool ULogReader::open(const QString& logFile, QString& errorMessage)
+{
+    close();
+
+    _file.setFileName(logFile);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorMessage = tr("Unable to open log file: %1").arg(_file.errorString());
+        return false;
+    }
+
+    _size = _file.size();
+    _data = _size > 0 ? _file.map(0, _size) : nullptr;
+    if (!_data) {
+        errorMessage = tr("Unable to map log file: %1").arg(_file.errorString());
+        close();
+        return false;
+    }
+
+    if (!_index(errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ULogReader::open(const QByteArray& log, QString& errorMessage)
+{
+    close();
+
+    _data = reinterpret_cast<const uchar*>(log.constData());
+    _size = log.size();
+
+    if (!_index(errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ULogReader::close(void)
+{
+    if (_file.isOpen()) {
+        if (_data) {
+            _file.unmap(const_cast<uchar*>(_data));
+        }
+        _file.close();
+    }
+    _data           = nullptr;
+    _size           = 0;
+    _startTimestamp = 0;
+    _dropoutCount   = 0;
+    _formats.clear();
+    _topics.clear();
+    _msgIdToTopic.clear();
+}
+
+/// Single pass over the log which collects formats and subscriptions and records the offset of every data message
+bool ULogReader::_index(QString& errorMessage)
+{
+    if (_size < _fileHeaderLen || memcmp(_data, _ulogMagic, sizeof(_ulogMagic)) != 0) {
+        errorMessage = tr("Could not detect ULog file header magic");
+        return false;
+    }
+    _startTimestamp = qFromLittleEndian<quint64>(_data + 8);
+
+    qint64 index = _fileHeaderLen;
+    while (index + _msgHeaderLen <= _size) {
+        const uint16_t  msgSize = qFromLittleEndian<quint16>(_data + index);
+        const uint8_t   msgType = _data[index + 2];
+        const uchar*    payload = _data + index + _msgHeaderLen;
+
+        if (index + _msgHeaderLen + msgSize > _size) {
+            qCDebug(ULogReaderLog) << "Truncated message at end of log" << index;
+            break;
+        }
+
+        switch (msgType) {
+        case 'D':
+            if (msgSize >= 2) {
+                auto iter = _msgIdToTopic.constFind(qFromLittleEndian<quint16>(payload));
+                if (iter != _msgIdToTopic.constEnd()) {
+                    _topics[iter.value()].messageOffsets.append(index + _msgHeaderLen + 2);
+                }
+            }
+            break;
+        case 'F':
+        {
+            const QString format    = QString::fromLatin1(reinterpret_cast<const char*>(payload), static_cast<int>(qstrnlen(reinterpret_cast<const char*>(payload), msgSize)));
+            const int posSeparator  = format.indexOf(':');
+            if (posSeparator > 0) {
+                _formats.insert(format.left(posSeparator), format.mid(posSeparator + 1));
+            }
+            break;
+        }
+        case 'A':
+            if (msgSize > 3) {
+                const uint8_t   multiId = payload[0];
+                const uint16_t  msgId   = qFromLittleEndian<quint16>(payload + 1);
+                const QString   name    = QString::fromLatin1(reinterpret_cast<const char*>(payload + 3), static_cast<int>(qstrnlen(reinterpret_cast<const char*>(payload + 3), msgSize - 3)));
+
+                int topicIndex = -1;
+                for (int i=0; i<_topics.count(); i++) {
+                    if (_topics[i].multiId == multiId && _topics[i].name == name) {
+                        topicIndex = i;
+                        break;
+                    }
+                }
+                if (topicIndex == -1) {
+                    Topic_t topic;
+                    topic.name              = name;
+                    topic.multiId           = multiId;
+                    topic.messageSize       = 0;
+                    topic.timestampField    = -1;
+                    topic.layoutValid       = false;
+                    _topics.append(topic);
+                    topicIndex = _topics.count() - 1;
+                }
+                _msgIdToTopic[msgId] = topicIndex;
+            }
+            break;
+        case 'R':
+            if (msgSize >= 2) {
+                _msgIdToTopic.remove(qFromLittleEndian<quint16>(payload));
+            }
+            break;
+        case 'O':
+            _dropoutCount++;
+            break;
+        default:
+            break;
+        }
+
+        index += _msgHeaderLen + msgSize;
+    }
+
+    // Formats may reference nested formats which are defined later, so layouts are only resolved once all are known
+    for (Topic_t& topic: _topics) {
+        if (!_resolveLayout(topic)) {
+            qCWarning(ULogReaderLog) << "Unable to resolve format for topic" << topic.name;
+        }
+        topic.messageOffsets.squeeze();
+    }
+
+    qCDebug(ULogReaderLog) << "Indexed" << _topics.count() << "topics" << _size << "bytes";
+    return true;
+}
+
+bool ULogReader::_resolveLayout(Topic_t& topic)
+{
+    int offset = 0;
+
+    topic.fields.clear();
+    topic.layoutValid = _appendFormatFields(topic.name, QString(), offset, topic.fields, 0);
+    topic.messageSize = offset;
+    for (int i=0; i<topic.fields.count(); i++) {
+        if (topic.fields[i].name == QLatin1String("timestamp")) {
+            topic.timestampField = i;
+            break;
+        }
+    }
+    return topic.layoutValid;
+}
+
+bool ULogReader::_appendFormatFields(const QString& formatName, const QString& prefix, int& offset, QVector<Field_t>& fields, int depth)
+{
+    auto iter = _formats.constFind(formatName);
+    if (iter == _formats.constEnd() || depth > _maxNestingDepth) {
+        return false;
+    }
+
+    const QStringList fieldDefs = iter.value().split(';', Qt::SkipEmptyParts);
+    for (const QString& fieldDef: fieldDefs) {
+        const int spacePos = fieldDef.indexOf(' ');
+        if (spacePos == -1) {
+            continue;
+        }
+
+        QString     typeName    = fieldDef.left(spacePos);
+        QString     fieldName   = fieldDef.mid(spacePos + 1);
+        int         arraySize   = 1;
+        const int   bracketPos  = typeName.indexOf('[');
+        if (bracketPos != -1) {
+            arraySize = typeName.midRef(bracketPos + 1, typeName.indexOf(']') - bracketPos - 1).toInt();
+            typeName.truncate(bracketPos);
+        }
+
+        FieldType_t type;
+        if (_fieldTypeFromString(typeName, type)) {
+            // Padding takes up space in the message but is not a usable field
+            if (!fieldName.startsWith(QLatin1String("_padding"))) {
+                fields.append({ prefix + fieldName, type, offset, arraySize });
+            }
+            offset += sizeOfType(type) * arraySize;
+        } else {
+            // Nested type
+            for (int i=0; i<arraySize; i++) {
+                const QString nestedPrefix = arraySize == 1 ? QStringLiteral("%1%2.").arg(prefix, fieldName) : QStringLiteral("%1%2[%3].").arg(prefix, fieldName).arg(i);
+                if (!_appendFormatFields(typeName, nestedPrefix, offset, fields, depth + 1)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ULogReader::_fieldTypeFromString(const QString& typeName, FieldType_t& type) const
+{
+    static const QHash<QString, FieldType_t> rgTypes = {
+        { QStringLiteral("int8_t"),     FieldTypeInt8 },
+        { QStringLiteral("uint8_t"),    FieldTypeUInt8 },
+        { QStringLiteral("int16_t"),    FieldTypeInt16 },
+        { QStringLiteral("uint16_t"),   FieldTypeUInt16 },
+        { QStringLiteral("int32_t"),    FieldTypeInt32 },
+        { QStringLiteral("uint32_t"),   FieldTypeUInt32 },
+        { QStringLiteral("int64_t"),    FieldTypeInt64 },
+        { QStringLiteral("uint64_t"),   FieldTypeUInt64 },
+        { QStringLiteral("float"),      FieldTypeFloat },
+        { QStringLiteral("double"),     FieldTypeDouble },
+        { QStringLiteral("bool"),       FieldTypeBool },
+        { QStringLiteral("char"),       FieldTypeChar },
+    };
+
+    auto iter = rgTypes.constFind(typeName);
+    if (iter == rgTypes.constEnd()) {
+        return false;
+    }
+    type = iter.value();
+    return true;
+}
+
+int ULogReader::sizeOfType(FieldType_t type)
+{
+    switch (type) {
+    case FieldTypeInt8:
+    case FieldTypeUInt8:
+    case FieldTypeBool:
+    case FieldTypeChar:
+        return 1;
+    case FieldTypeInt16:
+    case FieldTypeUInt16:
+        return 2;
+    case FieldTypeInt32:
+    case FieldTypeUInt32:
+    case FieldTypeFloat:
+        return 4;
+    case FieldTypeInt64:
+    case FieldTypeUInt64:
+    case FieldTypeDouble:
+        return 8;
+    }
+    return 0;
+}
+
+QStringList ULogReader::topicNames(void) const
+{
+    QStringList names;
+    for (const Topic_t& topic: _topics) {
+        if (!names.contains(topic.name)) {
+            names.append(topic.name);
+        }
+    }
+    return names;
+}
+
+const ULogReader::Topic_t* ULogReader::topic(const QString& name, uint8_t multiId) const
+{
+    for (const Topic_t& topic: _topics) {
+        if (topic.multiId == multiId && topic.name == name) {
+            return topic.layoutValid ? &topic : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+const ULogReader::Field_t* ULogReader::field(const Topic_t* topic, const QString& fieldName)
+{
+    if (topic) {
+        for (const Field_t& field: topic->fields) {
+            if (field.name == fieldName) {
+                return &field;
+            }
+        }
+    }
+    return nullptr;
+}
+
+int ULogReader::messageDataSize(const Topic_t* topic, int messageIndex) const
+{
+    // The message header sits immediately in front of the msg_id which precedes the payload
+    const qint64 payloadOffset = topic->messageOffsets[messageIndex];
+    return qFromLittleEndian<quint16>(_data + payloadOffset - 2 - _msgHeaderLen) - 2;
+}
+
+double ULogReader::fieldValue(const Topic_t* topic, int messageIndex, const Field_t* field, int arrayIndex) const
+{
+    switch (field->type) {
+    case FieldTypeInt8:
+        return fieldValueRaw<qint8>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeUInt8:
+    case FieldTypeBool:
+    case FieldTypeChar:
+        return fieldValueRaw<quint8>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeInt16:
+        return fieldValueRaw<qint16>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeUInt16:
+        return fieldValueRaw<quint16>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeInt32:
+        return fieldValueRaw<qint32>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeUInt32:
+        return fieldValueRaw<quint32>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeInt64:
+        return fieldValueRaw<qint64>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeUInt64:
+        return fieldValueRaw<quint64>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeFloat:
+        return fieldValueRaw<float>(topic, messageIndex, field, arrayIndex);
+    case FieldTypeDouble:
+        return fieldValueRaw<double>(topic, messageIndex, field, arrayIndex);
+    }
+    return 0;
+}
+
+quint64 ULogReader::timestamp(const Topic_t* topic, int messageIndex) const
+{
+    if (topic->timestampField == -1) {
+        return 0;
+    }
+    return fieldValueRaw<quint64>(topic, messageIndex, &topic->fields[topic->timestampField]);
+}
+
+bool ULogReader::timeSeries(const QString& topicName, const QString& fieldName, QVector<quint64>& timestamps, QVector<double>& values, uint8_t multiId) const
+{
+    timestamps.clear();
+    values.clear();
+
+    const Topic_t* logTopic = topic(topicName, multiId);
+    const Field_t* logField = field(logTopic, fieldName);
+    if (!logField) {
+        return false;
+    }
+
+    const int cMessages = messageCount(logTopic);
+    timestamps.reserve(cMessages);
+    values.reserve(cMessages);
+    for (int i=0; i<cMessages; i++) {
+        timestamps.append(timestamp(logTopic, i));
+        values.append(fieldValue(logTopic, i, logField));
+    }
+
+    return true;
+}
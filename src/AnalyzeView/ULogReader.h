@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QCoreApplication>
+#include <QtEndian>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ULogReaderLog)
+
+/// Read only access to a ULog file. The file is memory mapped and a single pass is made over it to build
+/// a per-topic index of data message offsets. Field values are decoded straight from the mapped memory
+/// so the log is never copied into RAM, which allows multi GB logs to be read on memory constrained machines.
+class ULogReader
+{
+    Q_DECLARE_TR_FUNCTIONS(ULogReader)
+
+public:
+    ULogReader(void);
+    ~ULogReader();
+
+    typedef enum {
+        FieldTypeInt8,
+        FieldTypeUInt8,
+        FieldTypeInt16,
+        FieldTypeUInt16,
+        FieldTypeInt32,
+        FieldTypeUInt32,
+        FieldTypeInt64,
+        FieldTypeUInt64,
+        FieldTypeFloat,
+        FieldTypeDouble,
+        FieldTypeBool,
+        FieldTypeChar,
+    } FieldType_t;
+
+    /// A single field within a topic. Nested types are flattened to "parent.child" names.
+    struct Field_t {
+        QString     name;
+        FieldType_t type;
+        int         offset;         ///< Offset of field from start of message payload (after msg_id)
+        int         arraySize;      ///< 1 for non-array fields
+    };
+
+    /// A logged topic instance (topic name + multi id)
+    struct Topic_t {
+        QString             name;
+        uint8_t             multiId;
+        QVector<Field_t>    fields;
+        int                 messageSize;        ///< Size of message payload as specified by the format
+        QVector<qint64>     messageOffsets;     ///< File offset of the payload of each data message for this topic
+        int                 timestampField;     ///< Index of timestamp in fields, -1 if none
+        bool                layoutValid;
+    };
+
+    /// Maps and indexes the specified file
+    ///     @return false: open failed, errorMessage set
+    bool open(const QString& logFile, QString& errorMessage);
+
+    /// Indexes a log which is already in memory. The buffer must remain valid while the reader is open.
+    ///     @return false: open failed, errorMessage set
+    bool open(const QByteArray& log, QString& errorMessage);
+
+    void close(void);
+
+    bool        isOpen          (void) const { return _data != nullptr; }
+    qint64      size            (void) const { return _size; }
+    quint64     startTimestamp  (void) const { return _startTimestamp; }
+    int         dropoutCount    (void) const { return _dropoutCount; }
+    QStringList topicNames      (void) const;
+
+    /// @return Topic instance, nullptr if not in the log
+    const Topic_t* topic(const QString& name, uint8_t multiId = 0) const;
+
+    /// @return Field within topic, nullptr if not found
+    static const Field_t* field(const Topic_t* topic, const QString& fieldName);
+
+    int messageCount(const Topic_t* topic) const { return topic ? topic->messageOffsets.count() : 0; }
+
+    /// @return Pointer to the payload of the specified message within the mapped log
+    const uchar* messageData(const Topic_t* topic, int messageIndex) const { return _data + topic->messageOffsets[messageIndex]; }
+
+    /// @return Actual payload size of the specified message. May be smaller than Topic_t::messageSize if trailing padding was stripped.
+    int messageDataSize(const Topic_t* topic, int messageIndex) const;
+
+    /// Decodes a field value directly from the mapped log
+    ///     @return Field value, 0 if message too short
+    double fieldValue(const Topic_t* topic, int messageIndex, const Field_t* field, int arrayIndex = 0) const;
+
+    /// Decodes a field value as type T without any conversion. T must match the field type size.
+    template<typename T>
+    T fieldValueRaw(const Topic_t* topic, int messageIndex, const Field_t* field, int arrayIndex = 0) const
+    {
+        const int offset = field->offset + (arrayIndex * static_cast<int>(sizeof(T)));
+        if (offset + static_cast<int>(sizeof(T)) > messageDataSize(topic, messageIndex)) {
+            return T();
+        }
+        return qFromLittleEndian<T>(messageData(topic, messageIndex) + offset);
+    }
+
+    /// @return Message timestamp in microseconds (first field of every ULog topic)
+    quint64 timestamp(const Topic_t* topic, int messageIndex) const;
+
+    /// Extracts a single field as a time series across all messages of the topic
+    ///     @return false: topic or field not found
+    bool timeSeries(const QString& topicName, const QString& fieldName, QVector<quint64>& timestamps, QVector<double>& values, uint8_t multiId = 0) const;
+
+    static int sizeOfType(FieldType_t type);
+
+private:
+    bool    _index                  (QString& errorMessage);
+    bool    _resolveLayout          (Topic_t& topic);
+    bool    _appendFormatFields     (const QString& formatName, const QString& prefix, int& offset, QVector<Field_t>& fields, int depth);
+    bool    _fieldTypeFromString    (const QString& typeName, FieldType_t& type) const;
+
+    QFile                       _file;
+    const uchar*                _data           = nullptr;
+    qint64                      _size           = 0;
+    quint64                     _startTimestamp = 0;
+    int                         _dropoutCount   = 0;
+    QHash<QString, QString>     _formats;           ///< Format name to field definition string
+    QVector<Topic_t>            _topics;
+    QHash<uint16_t, int>        _msgIdToTopic;      ///< Currently subscribed msg id to index in _topics
+
+    static const int        _fileHeaderLen      = 16;
+    static const int        _msgHeaderLen       = 3;
+    static const int        _maxNestingDepth    = 8;
+    static const char       _ulogMagic[7];
+};
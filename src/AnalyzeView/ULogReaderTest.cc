@@ -0,0 +1,243 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReaderTest.h"
+#include "ULogReader.h"
+#include "ULogParser.h"
+
+#include <QTemporaryFile>
+
+void ULogReaderTest::_appendMessage(QByteArray& log, char msgType, const QByteArray& payload)
+{
+    _appendValue<uint16_t>(log, static_cast<uint16_t>(payload.size()));
+    log.append(msgType);
+    log.append(payload);
+}
+
+void ULogReaderTest::_appendFormat(QByteArray& log, const char* format)
+{
+    _appendMessage(log, 'F', QByteArray(format));
+}
+
+void ULogReaderTest::_appendAddLogged(QByteArray& log, uint8_t multiId, uint16_t msgId, const char* name)
+{
+    QByteArray payload;
+    _appendValue<uint8_t>(payload, multiId);
+    _appendValue<uint16_t>(payload, msgId);
+    payload.append(name);
+    _appendMessage(log, 'A', payload);
+}
+
+void ULogReaderTest::_appendData(QByteArray& log, uint16_t msgId, const QByteArray& data)
+{
+    QByteArray payload;
+    _appendValue<uint16_t>(payload, msgId);
+    payload.append(data);
+    _appendMessage(log, 'D', payload);
+}
+
+/// Builds a small ULog with a nested topic, a multi instance topic, a resubscribed topic and camera_capture messages
+QByteArray ULogReaderTest::_buildLog(void)
+{
+    QByteArray log;
+    log.append("ULog\x01\x12\x35", 7);
+    _appendValue<uint8_t>(log, 1);              // version
+    _appendValue<uint64_t>(log, 123456);        // start timestamp
+
+    // Nested format is defined after the format which references it
+    _appendFormat(log, "sensor:uint64_t timestamp;float value;vec2 pos;int16_t[3] arr;uint8_t[2] _padding0;");
+    _appendFormat(log, "vec2:float x;float y;");
+    _appendFormat(log, "camera_capture:uint64_t timestamp;uint64_t timestamp_utc;uint32_t seq;double lat;double lon;float alt;float ground_distance;float[4] q;uint8_t result;uint8_t[3] _padding0;");
+
+    _appendAddLogged(log, 0, 3, "sensor");
+    _appendAddLogged(log, 1, 4, "sensor");
+    _appendAddLogged(log, 0, 5, "camera_capture");
+
+    for (int i=0; i<_cDataMessages; i++) {
+        QByteArray data;
+        _appendValue<uint64_t>(data, 1000 * (i + 1));
+        _appendValue<float>(data, i * 0.5f);
+        _appendValue<float>(data, i);
+        _appendValue<float>(data, -i);
+        _appendValue<int16_t>(data, -1);
+        _appendValue<int16_t>(data, static_cast<int16_t>(i));
+        _appendValue<int16_t>(data, 7);
+        // Trailing padding stripped as the logger does
+        _appendData(log, 3, data);
+
+        // Second instance has a constant pos.x
+        data.replace(12, sizeof(float), QByteArray(4, 0));
+        _appendData(log, 4, data);
+    }
+
+    // Resubscribe first instance with a different msg id
+    QByteArray remove;
+    _appendValue<uint16_t>(remove, 3);
+    _appendMessage(log, 'R', remove);
+    _appendAddLogged(log, 0, 9, "sensor");
+    QByteArray data;
+    _appendValue<uint64_t>(data, 99000);
+    _appendValue<float>(data, 99);
+    _appendData(log, 9, data);
+    _appendData(log, 3, data);      // No longer subscribed, must be ignored
+
+    for (int i=0; i<3; i++) {
+        QByteArray data;
+        _appendValue<uint64_t>(data, 2000000 * (i + 1));
+        _appendValue<uint64_t>(data, 0);
+        _appendValue<uint32_t>(data, i);
+        _appendValue<double>(data, 47.5 + i);
+        _appendValue<double>(data, 368.0);      // Wrapped longitude
+        _appendValue<float>(data, 100);
+        _appendValue<float>(data, 20);
+        for (int j=0; j<4; j++) {
+            _appendValue<float>(data, j);
+        }
+        _appendValue<uint8_t>(data, 1);
+        _appendData(log, 5, data);
+    }
+
+    _appendMessage(log, 'O', QByteArray(2, 0));
+
+    // Truncated message at end of log must be ignored
+    log.append("\x20\x00", 2);
+
+    return log;
+}
+
+void ULogReaderTest::_testIndex(void)
+{
+    QByteArray  log = _buildLog();
+    ULogReader  reader;
+    QString     errorMessage;
+
+    QVERIFY(reader.open(log, errorMessage));
+    QCOMPARE(reader.startTimestamp(), 123456ull);
+    QCOMPARE(reader.dropoutCount(), 1);
+    QCOMPARE(reader.topicNames(), QStringList({ "sensor", "camera_capture" }));
+
+    const ULogReader::Topic_t* sensor0 = reader.topic("sensor", 0);
+    const ULogReader::Topic_t* sensor1 = reader.topic("sensor", 1);
+    QVERIFY(sensor0);
+    QVERIFY(sensor1);
+    QVERIFY(!reader.topic("sensor", 2));
+    QVERIFY(!reader.topic("missing"));
+    QCOMPARE(reader.messageCount(sensor0), _cDataMessages + 1);
+    QCOMPARE(reader.messageCount(sensor1), _cDataMessages);
+    QCOMPARE(sensor0->messageSize, 8 + 4 + 8 + 6 + 2);
+}
+
+void ULogReaderTest::_testFieldAccess(void)
+{
+    QByteArray  log = _buildLog();
+    ULogReader  reader;
+    QString     errorMessage;
+
+    QVERIFY(reader.open(log, errorMessage));
+    const ULogReader::Topic_t* sensor = reader.topic("sensor");
+
+    const ULogReader::Field_t* valueField   = ULogReader::field(sensor, "value");
+    const ULogReader::Field_t* xField       = ULogReader::field(sensor, "pos.x");
+    const ULogReader::Field_t* yField       = ULogReader::field(sensor, "pos.y");
+    const ULogReader::Field_t* arrField     = ULogReader::field(sensor, "arr");
+    QVERIFY(valueField);
+    QVERIFY(xField);
+    QVERIFY(yField);
+    QVERIFY(arrField);
+    QVERIFY(!ULogReader::field(sensor, "_padding0"));
+    QCOMPARE(arrField->arraySize, 3);
+    QCOMPARE(arrField->type, ULogReader::FieldTypeInt16);
+
+    QCOMPARE(reader.timestamp(sensor, 4), 5000ull);
+    QCOMPARE(reader.fieldValue(sensor, 4, valueField), 2.0);
+    QCOMPARE(reader.fieldValue(sensor, 4, xField), 4.0);
+    QCOMPARE(reader.fieldValue(sensor, 4, yField), -4.0);
+    QCOMPARE(reader.fieldValue(sensor, 4, arrField, 0), -1.0);
+    QCOMPARE(reader.fieldValue(sensor, 4, arrField, 1), 4.0);
+    QCOMPARE(reader.fieldValueRaw<int16_t>(sensor, 4, arrField, 2), static_cast<int16_t>(7));
+
+    // Last message is short, fields past its end decode as 0
+    const int lastIndex = reader.messageCount(sensor) - 1;
+    QCOMPARE(reader.messageDataSize(sensor, lastIndex), 12);
+    QCOMPARE(reader.fieldValue(sensor, lastIndex, valueField), 99.0);
+    QCOMPARE(reader.fieldValue(sensor, lastIndex, xField), 0.0);
+}
+
+void ULogReaderTest::_testTimeSeries(void)
+{
+    QByteArray          log = _buildLog();
+    ULogReader          reader;
+    QString             errorMessage;
+    QVector<quint64>    timestamps;
+    QVector<double>     values;
+
+    QVERIFY(reader.open(log, errorMessage));
+    QVERIFY(reader.timeSeries("sensor", "pos.x", timestamps, values, 1));
+    QCOMPARE(timestamps.count(), _cDataMessages);
+    QCOMPARE(values.count(), _cDataMessages);
+    for (int i=0; i<_cDataMessages; i++) {
+        QCOMPARE(timestamps[i], static_cast<quint64>(1000 * (i + 1)));
+        QCOMPARE(values[i], 0.0);
+    }
+
+    QVERIFY(!reader.timeSeries("sensor", "missing", timestamps, values));
+    QVERIFY(timestamps.isEmpty());
+}
+
+void ULogReaderTest::_testMappedFile(void)
+{
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.write(_buildLog());
+    tempFile.close();
+
+    ULogReader  reader;
+    QString     errorMessage;
+    QVERIFY(reader.open(tempFile.fileName(), errorMessage));
+    QVERIFY(reader.isOpen());
+    QCOMPARE(reader.messageCount(reader.topic("sensor", 1)), _cDataMessages);
+    reader.close();
+    QVERIFY(!reader.isOpen());
+}
+
+void ULogReaderTest::_testCameraCapture(void)
+{
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.write(_buildLog());
+    tempFile.close();
+
+    ULogParser                                  parser;
+    QList<GeoTagWorker::cameraFeedbackPacket>   feedback;
+    QString                                     errorMessage;
+
+    QVERIFY(parser.getTagsFromLog(tempFile.fileName(), feedback, errorMessage));
+    QCOMPARE(feedback.count(), 3);
+    for (int i=0; i<feedback.count(); i++) {
+        QCOMPARE(feedback[i].timestamp, 2.0 * (i + 1));
+        QCOMPARE(feedback[i].imageSequence, static_cast<uint32_t>(i));
+        QCOMPARE(feedback[i].latitude, 47.5 + i);
+        QCOMPARE(feedback[i].longitude, 8.0);
+        QCOMPARE(feedback[i].altitude, 100.0f);
+        QCOMPARE(feedback[i].attitudeQuaternion[3], 3.0f);
+        QCOMPARE(feedback[i].captureResult, static_cast<uint8_t>(1));
+    }
+}
+
+void ULogReaderTest::_testBadMagic(void)
+{
+    QByteArray log = _buildLog();
+    log[0] = 'X';
+
+    ULogReader  reader;
+    QString     errorMessage;
+    QVERIFY(!reader.open(log, errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+    QVERIFY(!reader.isOpen());
+}
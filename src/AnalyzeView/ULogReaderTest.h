@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ULogReaderTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testIndex         (void);
+    void _testFieldAccess   (void);
+    void _testTimeSeries    (void);
+    void _testMappedFile    (void);
+    void _testCameraCapture (void);
+    void _testBadMagic      (void);
+
+private:
+    QByteArray  _buildLog       (void);
+    void        _appendMessage  (QByteArray& log, char msgType, const QByteArray& payload);
+    void        _appendFormat   (QByteArray& log, const char* format);
+    void        _appendAddLogged(QByteArray& log, uint8_t multiId, uint16_t msgId, const char* name);
+    void        _appendData     (QByteArray& log, uint16_t msgId, const QByteArray& data);
+
+    template<typename T>
+    static void _appendValue(QByteArray& bytes, T value)
+    {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static const int _cDataMessages = 10;
+};
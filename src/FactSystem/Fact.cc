@@ -12,6 +12,7 @@
 #include "QGCMAVLink.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
+#include "TelemetryTracer.h"
 
 #include <QtQml>
 #include <QQmlEngine>
@@ -673,9 +674,15 @@ void Fact::setSendValueChangedSignals (bool sendValueChangedSignals)
 void Fact::_sendValueChangedSignal(QVariant value)
 {
     if (_sendValueChangedSignals) {
+        TelemetryTracer::recordEndToEnd(TelemetryTracer::originNsecs());
+        TelemetryTracer::Scope traceScope(TelemetryTracer::StageFactValueChanged);
         emit valueChanged(value);
         _deferredValueChangeSignal = false;
     } else {
+        if (!_deferredValueChangeSignal) {
+            // End to end latency for deferred signals includes the time spent waiting for the FactGroup update timer
+            _deferredTraceOriginNsecs = TelemetryTracer::originNsecs();
+        }
         _deferredValueChangeSignal = true;
     }
 }
@@ -684,6 +691,9 @@ void Fact::sendDeferredValueChangedSignal(void)
 {
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
+        TelemetryTracer::recordEndToEnd(_deferredTraceOriginNsecs);
+        _deferredTraceOriginNsecs = 0;
+        TelemetryTracer::Scope traceScope(TelemetryTracer::StageFactValueChanged);
         emit valueChanged(cookedValue());
     }
 }
@@ -211,4 +211,5 @@ protected:
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    qint64                      _deferredTraceOriginNsecs = 0;  ///< TelemetryTracer origin of the first change held back by a deferred signal
 };
@@ -12,6 +12,9 @@
 #include "MultiVehicleManager.h"
 #include "QGCApplication.h"
 #include "ParameterManager.h"
+#include "CompInfoParam.h"
+
+#include <QTemporaryFile>
 
 /// Test failure modes which should still lead to param load success
 void ParameterManagerTest::_noFailureWorker(MockConfiguration::FailureMode_t failureMode)
@@ -138,3 +141,63 @@ void ParameterManagerTest::_requestListMissingParamFail(void)
     // User should have been notified
     checkExpectedMessageBox();
 }
+
+/// Indexed names from the json metadata must match the full parameter name and substitute the index into the description
+void ParameterManagerTest::_indexedNameMetaData(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    QTemporaryFile jsonFile;
+    QVERIFY(jsonFile.open());
+    jsonFile.write(
+        "{ \"version\": 1, \"parameters\": ["
+        "{ \"name\": \"SER_BAUD\",          \"type\": \"Int32\", \"shortDesc\": \"Plain\" },"
+        "{ \"name\": \"SER_{n}_BAUD\",      \"type\": \"Int32\", \"shortDesc\": \"Serial {n} baud\" },"
+        "{ \"name\": \"MOT_{n}_FUNC_{n}\",  \"type\": \"Int32\", \"shortDesc\": \"Motor {n} function\" },"
+        "{ \"name\": \"RC.{n}\",            \"type\": \"Int32\", \"shortDesc\": \"Dot {n}\" },"
+        "{ \"name\": \"CAL_{n}_ID\",        \"type\": \"Int32\", \"shortDesc\": \"First {n}\" },"
+        "{ \"name\": \"CAL_{n}{n}_ID\",     \"type\": \"Int32\", \"shortDesc\": \"Second {n}\" }"
+        "] }");
+    jsonFile.close();
+
+    CompInfoParam compInfoParam(MAV_COMP_ID_AUTOPILOT1, _vehicle);
+    compInfoParam.setJson(jsonFile.fileName(), QString());
+
+    // Exact name
+    FactMetaData* metaData = compInfoParam.factMetaDataForName("SER_BAUD", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("Plain"));
+
+    // Indexed name, index substituted into the description
+    metaData = compInfoParam.factMetaDataForName("SER_12_BAUD", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->name(), QStringLiteral("SER_12_BAUD"));
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("Serial 12 baud"));
+
+    // Lookups are remembered
+    QCOMPARE(compInfoParam.factMetaDataForName("SER_12_BAUD", FactMetaData::valueTypeInt32), metaData);
+
+    // Multiple indices use the first one
+    metaData = compInfoParam.factMetaDataForName("MOT_2_FUNC_7", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("Motor 2 function"));
+
+    // A later indexed name wins when more than one matches
+    metaData = compInfoParam.factMetaDataForName("CAL_12_ID", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("Second 1"));
+    metaData = compInfoParam.factMetaDataForName("CAL_3_ID", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("First 3"));
+
+    // Regex special characters in the name are matched literally
+    metaData = compInfoParam.factMetaDataForName("RC.4", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->shortDescription(), QStringLiteral("Dot 4"));
+
+    // Partial and non-numeric matches fall back to default meta data
+    for (const char* name: { "RCX4", "SER_1_BAUDX", "XSER_1_BAUD", "SER__BAUD", "SER_A_BAUD" }) {
+        metaData = compInfoParam.factMetaDataForName(name, FactMetaData::valueTypeInt32);
+        QVERIFY2(metaData->shortDescription().isEmpty(), name);
+        QCOMPARE(metaData->name(), QString());
+        QCOMPARE(compInfoParam.factMetaDataForName(name, FactMetaData::valueTypeInt32), metaData);
+    }
+    metaData = compInfoParam.factMetaDataForName("SER_1_BAUDX", FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->group(), QStringLiteral("SER"));
+
+    _disconnectMockLink();
+}
@@ -11,6 +11,7 @@
 #include "SettingsFact.h"
 #include "QGCCorePlugin.h"
 #include "QGCApplication.h"
+#include "SettingsFactWriter.h"
 
 #include <QSettings>
 
@@ -42,13 +43,18 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
             _rawValue = rawDefaultValue;
         } else {
             if (_visible) {
+                // A value which has not been written out yet takes precedence over what is in QSettings
+                QVariant savedValue;
+                if (!SettingsFactWriter::instance()->pendingValue(_settingsGroup, _name, savedValue)) {
+                    savedValue = settings.value(_name, rawDefaultValue);
+                }
                 QVariant typedValue;
                 QString errorString;
-                metaData->convertAndValidateRaw(settings.value(_name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
+                metaData->convertAndValidateRaw(savedValue, true /* conertOnly */, typedValue, errorString);
                 _rawValue = typedValue;
             } else {
                 // Setting is not visible, force to default value always
-                settings.setValue(_name, rawDefaultValue);
+                SettingsFactWriter::instance()->setValue(_settingsGroup, _name, rawDefaultValue);
                 _rawValue = rawDefaultValue;
             }
         }
@@ -74,11 +80,6 @@ const SettingsFact& SettingsFact::operator=(const SettingsFact& other)
 
 void SettingsFact::_rawValueChanged(QVariant value)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
-
-    settings.setValue(_name, value);
+    // Writes are batched and done on a background thread so rapid changes (sliders, calibration) don't stall the ui
+    SettingsFactWriter::instance()->setValue(_settingsGroup, _name, value);
 }
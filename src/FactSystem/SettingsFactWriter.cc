@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsFactWriter.h"
+
+#include <QSettings>
+
+QGC_LOGGING_CATEGORY(SettingsFactWriterLog, "SettingsFactWriterLog")
+
+SettingsFactWriter* SettingsFactWriter::instance(void)
+{
+    static SettingsFactWriter* writer = new SettingsFactWriter();
+    return writer;
+}
+
+SettingsFactWriter::SettingsFactWriter(void)
+{
+    _thread.setObjectName(QStringLiteral("SettingsFactWriter"));
+
+    // The timer is created without a parent so it can be moved to the writer thread along with us
+    _flushTimer = new QTimer();
+    _flushTimer->setSingleShot(true);
+    _flushTimer->setInterval(flushIntervalMSecs);
+    connect(_flushTimer, &QTimer::timeout, this, &SettingsFactWriter::_flush);
+    connect(this, &SettingsFactWriter::_startFlushTimer, _flushTimer, static_cast<void (QTimer::*)()>(&QTimer::start), Qt::QueuedConnection);
+    connect(&_thread, &QThread::finished, _flushTimer, &QTimer::deleteLater);
+
+    moveToThread(&_thread);
+    _flushTimer->moveToThread(&_thread);
+    _thread.start(QThread::LowPriority);
+}
+
+QString SettingsFactWriter::_key(const QString& settingsGroup, const QString& name)
+{
+    return settingsGroup.isEmpty() ? name : QStringLiteral("%1/%2").arg(settingsGroup, name);
+}
+
+void SettingsFactWriter::setValue(const QString& settingsGroup, const QString& name, const QVariant& value)
+{
+    bool startTimer;
+    bool shutdown;
+    {
+        QMutexLocker lock(&_pendingMutex);
+        startTimer = _pendingValues.isEmpty();
+        shutdown = _shutdown;
+        _pendingValues[_key(settingsGroup, name)] = value;
+    }
+
+    if (shutdown) {
+        _flush();
+    } else if (startTimer) {
+        emit _startFlushTimer();
+    }
+}
+
+bool SettingsFactWriter::pendingValue(const QString& settingsGroup, const QString& name, QVariant& value) const
+{
+    QMutexLocker lock(&_pendingMutex);
+
+    auto iter = _pendingValues.constFind(_key(settingsGroup, name));
+    if (iter == _pendingValues.constEnd()) {
+        return false;
+    }
+    value = iter.value();
+    return true;
+}
+
+void SettingsFactWriter::flush(void)
+{
+    _flush();
+}
+
+void SettingsFactWriter::_flush(void)
+{
+    QMutexLocker flushLock(&_flushMutex);
+
+    QHash<QString, QVariant> pendingValues;
+    {
+        QMutexLocker lock(&_pendingMutex);
+        pendingValues.swap(_pendingValues);
+    }
+
+    if (pendingValues.isEmpty()) {
+        return;
+    }
+
+    qCDebug(SettingsFactWriterLog) << "Writing" << pendingValues.count() << "settings";
+
+    QSettings settings;
+    for (auto iter = pendingValues.constBegin(); iter != pendingValues.constEnd(); iter++) {
+        settings.setValue(iter.key(), iter.value());
+    }
+    settings.sync();
+}
+
+void SettingsFactWriter::shutdown(void)
+{
+    {
+        QMutexLocker lock(&_pendingMutex);
+        _shutdown = true;
+    }
+
+    if (_thread.isRunning()) {
+        _thread.quit();
+        _thread.wait();
+    }
+
+    // Write anything still outstanding from the calling thread
+    _flush();
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCLoggingCategory.h"
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QHash>
+#include <QVariant>
+
+Q_DECLARE_LOGGING_CATEGORY(SettingsFactWriterLog)
+
+/// Write-behind persistence for SettingsFact values.
+///
+/// Value changes are coalesced per key and written to QSettings from a background thread once the flush timer fires.
+/// Until then the pending value is visible through pendingValue so newly created SettingsFacts see the latest value.
+/// Code which reads a SettingsFact key directly through QSettings must call flush first, otherwise it can see the previous
+/// value for up to flushIntervalMSecs. All public methods are thread safe.
+class SettingsFactWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SettingsFactWriter* instance(void);
+
+    /// Queues a value to be written to QSettings
+    void setValue(const QString& settingsGroup, const QString& name, const QVariant& value);
+
+    /// Returns the latest queued value which has not yet been written to QSettings
+    ///     @return false: no pending value for this key
+    bool pendingValue(const QString& settingsGroup, const QString& name, QVariant& value) const;
+
+    /// Synchronously writes all pending values to QSettings from the calling thread
+    void flush(void);
+
+    /// Synchronously writes all pending values and stops the background thread. Called at application shutdown.
+    /// Values set after shutdown are written immediately.
+    void shutdown(void);
+
+    static const int flushIntervalMSecs = 500;
+
+signals:
+    void _startFlushTimer(void);
+
+private slots:
+    void _flush(void);
+
+private:
+    SettingsFactWriter(void);
+
+    static QString _key(const QString& settingsGroup, const QString& name);
+
+    mutable QMutex              _pendingMutex;
+    QMutex                      _flushMutex;        ///< Serializes flushes so an older batch can never overwrite a newer one
+    QHash<QString, QVariant>    _pendingValues;     ///< Key is "group/name" as used by QSettings
+    QThread                     _thread;
+    QTimer*                     _flushTimer = nullptr;
+    bool                        _shutdown   = false;
+};
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsFactWriterTest.h"
+#include "SettingsFactWriter.h"
+#include "SettingsFact.h"
+#include "AppSettings.h"
+
+#include <QSettings>
+
+const char* SettingsFactWriterTest::_settingsGroup = "SettingsFactWriterTest";
+
+SettingsFactWriterTest::SettingsFactWriterTest(void)
+{
+
+}
+
+void SettingsFactWriterTest::cleanup(void)
+{
+    SettingsFactWriter::instance()->flush();
+
+    QSettings settings;
+    settings.remove(_settingsGroup);
+    settings.remove(AppSettings::qLocaleLanguageName);
+
+    UnitTest::cleanup();
+}
+
+void SettingsFactWriterTest::_flushTest(void)
+{
+    FactMetaData* metaData = new FactMetaData(FactMetaData::valueTypeInt32, "flushValue", this);
+    metaData->setRawDefaultValue(0);
+    SettingsFact fact(_settingsGroup, metaData);
+
+    fact.setRawValue(42);
+
+    // The write is still pending until the writer is flushed
+    QVariant pendingValue;
+    QVERIFY(SettingsFactWriter::instance()->pendingValue(_settingsGroup, "flushValue", pendingValue));
+    QCOMPARE(pendingValue.toInt(), 42);
+
+    SettingsFactWriter::instance()->flush();
+    QVERIFY(!SettingsFactWriter::instance()->pendingValue(_settingsGroup, "flushValue", pendingValue));
+
+    QSettings settings;
+    settings.beginGroup(_settingsGroup);
+    QCOMPARE(settings.value("flushValue").toInt(), 42);
+}
+
+void SettingsFactWriterTest::_backgroundFlushTest(void)
+{
+    FactMetaData* metaData = new FactMetaData(FactMetaData::valueTypeInt32, "backgroundValue", this);
+    metaData->setRawDefaultValue(0);
+    SettingsFact fact(_settingsGroup, metaData);
+
+    // Only the latest of a burst of changes needs to be written
+    for (int i=1; i<=10; i++) {
+        fact.setRawValue(i);
+    }
+
+    QVERIFY(QTest::qWaitFor([&]() {
+        QSettings settings;
+        settings.beginGroup(_settingsGroup);
+        return settings.value("backgroundValue").toInt() == 10;
+    }, SettingsFactWriter::flushIntervalMSecs * 4));
+}
+
+// A language change made through the Fact must be seen by the direct QSettings read used to load translations
+void SettingsFactWriterTest::_languageTest(void)
+{
+    SettingsFactWriter::instance()->setValue(QString(), AppSettings::qLocaleLanguageName, QLocale::French);
+    QCOMPARE(AppSettings::_qLocaleLanguageID(), QLocale::French);
+
+    SettingsFactWriter::instance()->setValue(QString(), AppSettings::qLocaleLanguageName, QLocale::German);
+    QCOMPARE(AppSettings::_qLocaleLanguageID(), QLocale::German);
+}
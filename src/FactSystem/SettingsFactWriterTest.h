@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for SettingsFactWriter. Verifies values written through SettingsFact reach QSettings.
+class SettingsFactWriterTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    SettingsFactWriterTest(void);
+
+protected:
+    void cleanup(void) final;
+
+private slots:
+    void _flushTest             (void);
+    void _backgroundFlushTest   (void);
+    void _languageTest          (void);
+
+private:
+    static const char* _settingsGroup;
+};
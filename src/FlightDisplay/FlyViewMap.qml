@@ -236,18 +236,32 @@ FlightMap {
         z:          QGroundControl.zOrderTrajectoryLines
         visible:    !pipMode
 
+        // Trail detail is reduced to what is visible at the current zoom level
+        property int _lodZoomLevel: Math.floor(_root.zoomLevel)
+
+        on_LodZoomLevelChanged: reloadPath()
+
+        function reloadPath() {
+            path = _activeVehicle ? _activeVehicle.trajectoryPoints.listForZoom(_lodZoomLevel) : []
+        }
+
         Connections {
             target:                 QGroundControl.multiVehicleManager
             function onActiveVehicleChanged(activeVehicle) {
-                trajectoryPolyline.path = _activeVehicle ? _activeVehicle.trajectoryPoints.list() : []
+                trajectoryPolyline.reloadPath()
             }
         }
 
         Connections {
             target:                 _activeVehicle ? _activeVehicle.trajectoryPoints : null
-            onPointAdded:           trajectoryPolyline.addCoordinate(coordinate)
+            onPointsAdded: {
+                for (var i = 0; i < coordinates.length; i++) {
+                    trajectoryPolyline.addCoordinate(coordinates[i])
+                }
+            }
             onUpdateLastPoint:      trajectoryPolyline.replaceCoordinate(trajectoryPolyline.pathLength() - 1, coordinate)
             onPointsCleared:        trajectoryPolyline.path = []
+            onPointsReplaced:       trajectoryPolyline.reloadPath()
         }
     }
 
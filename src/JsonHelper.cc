@@ -21,6 +21,8 @@
 #include <QRegularExpressionMatch>
 #include <QFile>
 #include <QTranslator>
+#include <QReadWriteLock>
+#include <QtConcurrent>
 
 const char* JsonHelper::jsonVersionKey                      = "version";
 const char* JsonHelper::jsonGroundStationKey                = "groundStation";
@@ -29,6 +31,10 @@ const char* JsonHelper::jsonFileTypeKey                     = "fileType";
 const char* JsonHelper::_translateKeysKey                   = "translateKeys";
 const char* JsonHelper::_arrayIDKeysKey                     = "_arrayIDKeys";
 
+QMutex                      JsonHelper::_internalJsonFileCacheMutex;
+QHash<QString, QJsonObject> JsonHelper::_internalJsonFileCache;
+quint32                     JsonHelper::_internalJsonFileCacheGeneration = 0;
+
 bool JsonHelper::validateRequiredKeys(const QJsonObject& jsonObject, const QStringList& keys, QString& errorString)
 {
     QString missingKeys;
@@ -322,13 +328,19 @@ QJsonObject JsonHelper::_translateRoot(QJsonObject& jsonObject, const QString& t
     return _translateObject(jsonObject, translateContext, translateKeys);
 }
 
-QJsonObject JsonHelper::openInternalQGCJsonFile(const QString&  jsonFilename,
-                                                const QString&  expectedFileType,
-                                                int             minSupportedVersion,
-                                                int             maxSupportedVersion,
-                                                int             &version,
-                                                QString&        errorString)
+/// Reads, parses and translates an internal json file. Results are cached by filename so each file is only parsed once.
+/// Thread safe.
+QJsonObject JsonHelper::_loadInternalQGCJsonFile(const QString& jsonFilename, QString& errorString)
 {
+    quint32 cacheGeneration;
+    {
+        QMutexLocker lock(&_internalJsonFileCacheMutex);
+        if (_internalJsonFileCache.contains(jsonFilename)) {
+            return _internalJsonFileCache[jsonFilename];
+        }
+        cacheGeneration = _internalJsonFileCacheGeneration;
+    }
+
     QFile jsonFile(jsonFilename);
     if (!jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         errorString = tr("Unable to open file: '%1', error: %2").arg(jsonFilename).arg(jsonFile.errorString());
@@ -350,15 +362,75 @@ QJsonObject JsonHelper::openInternalQGCJsonFile(const QString&  jsonFilename,
     }
 
     QJsonObject jsonObject = doc.object();
+    QStringList translateKeys = _addDefaultLocKeys(jsonObject);
+    QString context = QFileInfo(jsonFile).fileName();
+    {
+        QReadLocker translatorLock(&qgcApp()->qgcJSONTranslatorLock());
+        jsonObject = _translateRoot(jsonObject, context, translateKeys);
+    }
+
+    // The cache may have been cleared for a new translator while this file was being translated with the old one
+    QMutexLocker lock(&_internalJsonFileCacheMutex);
+    if (cacheGeneration == _internalJsonFileCacheGeneration) {
+        _internalJsonFileCache[jsonFilename] = jsonObject;
+    }
+
+    return jsonObject;
+}
+
+QJsonObject JsonHelper::openInternalQGCJsonFile(const QString&  jsonFilename,
+                                                const QString&  expectedFileType,
+                                                int             minSupportedVersion,
+                                                int             maxSupportedVersion,
+                                                int             &version,
+                                                QString&        errorString)
+{
+    QJsonObject jsonObject = _loadInternalQGCJsonFile(jsonFilename, errorString);
+    if (!errorString.isEmpty()) {
+        return QJsonObject();
+    }
+
     bool success = validateInternalQGCJsonFile(jsonObject, expectedFileType, minSupportedVersion, maxSupportedVersion, version, errorString);
     if (!success) {
         errorString = tr("Json file: '%1'. %2").arg(jsonFilename).arg(errorString);
         return QJsonObject();
     }
 
-    QStringList translateKeys = _addDefaultLocKeys(jsonObject);
-    QString context = QFileInfo(jsonFile).fileName();
-    return _translateRoot(jsonObject, context, translateKeys);
+    return jsonObject;
+}
+
+void JsonHelper::preloadInternalQGCJsonFiles(const QStringList& jsonFilenames)
+{
+    quint32 cacheGeneration;
+    {
+        QMutexLocker lock(&_internalJsonFileCacheMutex);
+        cacheGeneration = _internalJsonFileCacheGeneration;
+    }
+
+    for (const QString& jsonFilename: jsonFilenames) {
+        QtConcurrent::run([jsonFilename, cacheGeneration] {
+            {
+                // Skip preloads which were still waiting for a thread when the cache was cleared
+                QMutexLocker lock(&_internalJsonFileCacheMutex);
+                if (cacheGeneration != _internalJsonFileCacheGeneration) {
+                    return;
+                }
+            }
+            QString errorString;
+            _loadInternalQGCJsonFile(jsonFilename, errorString);
+            if (!errorString.isEmpty()) {
+                qWarning() << "Internal Error: " << errorString;
+            }
+        });
+    }
+}
+
+void JsonHelper::clearInternalQGCJsonFileCache(void)
+{
+    QMutexLocker lock(&_internalJsonFileCacheMutex);
+    _internalJsonFileCache.clear();
+    // Loads which are still in flight no longer store their results
+    _internalJsonFileCacheGeneration++;
 }
 
 void JsonHelper::saveQGCJsonFileHeader(QJsonObject&     jsonObject,
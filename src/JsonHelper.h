@@ -13,6 +13,8 @@
 #include <QVariantList>
 #include <QGeoCoordinate>
 #include <QCoreApplication>
+#include <QMutex>
+#include <QHash>
 
 /// @file
 /// @author Don Gagne <don@thegagnes.com>
@@ -76,6 +78,14 @@ public:
                                                int                 &version,            ///< returned file version
                                                QString&            errorString);        ///< returned error string if validation fails
 
+    /// Parses the specified internal QGC json files in parallel on the global thread pool. Subsequent calls to
+    /// openInternalQGCJsonFile for these files are then served from the parsed file cache.
+    static void preloadInternalQGCJsonFiles(const QStringList& jsonFilenames);
+
+    /// Clears the parsed file cache used by openInternalQGCJsonFile. Must be called when the json translator changes.
+    /// Preloads which are still in flight are discarded.
+    static void clearInternalQGCJsonFileCache(void);
+
     /// Validates that the specified keys are in the object
     /// @return false: validation failed, errorString set
     static bool validateRequiredKeys(const QJsonObject& jsonObject, ///< json object to validate
@@ -174,6 +184,7 @@ private:
                                    bool                     writeAltitude,
                                    QJsonValue&              jsonValue,
                                    bool                     geoJsonFormat);
+    static QJsonObject _loadInternalQGCJsonFile(const QString& jsonFilename, QString& errorString);
     static QStringList _addDefaultLocKeys(QJsonObject& jsonObject);
     static QJsonObject _translateRoot(QJsonObject& jsonObject, const QString& translateContext, const QStringList& translateKeys);
     static QJsonObject _translateObject(QJsonObject& jsonObject, const QString& translateContext, const QStringList& translateKeys);
@@ -181,4 +192,8 @@ private:
 
     static const char*  _translateKeysKey;
     static const char*  _arrayIDKeysKey;
+
+    static QMutex                       _internalJsonFileCacheMutex;
+    static QHash<QString, QJsonObject>  _internalJsonFileCache;     ///< Parsed and translated internal json files keyed by filename
+    static quint32                      _internalJsonFileCacheGeneration;   ///< Incremented each time the cache is cleared
 };
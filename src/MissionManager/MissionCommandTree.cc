@@ -15,6 +15,7 @@
 #include "MissionCommandUIInfo.h"
 #include "MissionCommandList.h"
 #include "SettingsManager.h"
+#include "JsonHelper.h"
 
 #include <QQmlEngine>
 
@@ -43,22 +44,49 @@ void MissionCommandTree::setToolbox(QGCToolbox* toolbox)
         _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassRoverBoat]    = new MissionCommandList(":/unittest/UT-MavCmdInfoRover.json", false, this);
     } else {
 #endif
-        // Load all levels of hierarchy
+        // Find the files for all levels of hierarchy. The override files are only loaded when a vehicle of that type needs them.
+        // In the meantime they are parsed on the thread pool so the json is ready by the time they are loaded.
+        QStringList overrideFiles;
         for (const QGCMAVLink::FirmwareClass_t firmwareClass: _toolbox->firmwarePluginManager()->supportedFirmwareClasses()) {
             FirmwarePlugin* plugin = _toolbox->firmwarePluginManager()->firmwarePluginForAutopilot(QGCMAVLink::firmwareClassToAutopilot(firmwareClass), MAV_TYPE_QUADROTOR);
 
             for (const QGCMAVLink::VehicleClass_t vehicleClass: QGCMAVLink::allVehicleClasses()) {
                 QString overrideFile = plugin->missionCommandOverrides(vehicleClass);
                 if (!overrideFile.isEmpty()) {
-                    _staticCommandTree[firmwareClass][vehicleClass] = new MissionCommandList(overrideFile, firmwareClass == QGCMAVLink::FirmwareClassGeneric && vehicleClass == QGCMAVLink::VehicleClassGeneric /* baseCommandList */, this);
+                    _staticCommandTreeFiles[firmwareClass][vehicleClass] = overrideFile;
+                    if (firmwareClass != QGCMAVLink::FirmwareClassGeneric || vehicleClass != QGCMAVLink::VehicleClassGeneric) {
+                        overrideFiles.append(overrideFile);
+                    }
                 }
             }
         }
+        JsonHelper::preloadInternalQGCJsonFiles(overrideFiles);
+
+        // The base command list is needed immediately for command name lookups
+        _staticCommandList(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric);
 #ifdef UNITTEST_BUILD
     }
 #endif
 }
 
+/// Returns the command list for the specified level of the hierarchy, loading it if needed.
+///     @return nullptr if there is no command list for this level
+MissionCommandList* MissionCommandTree::_staticCommandList(QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass)
+{
+    if (_staticCommandTree.contains(firmwareClass) && _staticCommandTree[firmwareClass].contains(vehicleClass)) {
+        return _staticCommandTree[firmwareClass][vehicleClass];
+    }
+
+    MissionCommandList* commandList = nullptr;
+    if (_staticCommandTreeFiles.contains(firmwareClass) && _staticCommandTreeFiles[firmwareClass].contains(vehicleClass)) {
+        bool baseCommandList = firmwareClass == QGCMAVLink::FirmwareClassGeneric && vehicleClass == QGCMAVLink::VehicleClassGeneric;
+        commandList = new MissionCommandList(_staticCommandTreeFiles[firmwareClass].take(vehicleClass), baseCommandList, this);
+    }
+    _staticCommandTree[firmwareClass][vehicleClass] = commandList;
+
+    return commandList;
+}
+
 /// Add the next level of the hierarchy to a collapsed tree.
 ///     @param cmdList          List of mission commands to collapse into ui info
 ///     @param collapsedTree    Tree we are collapsing into
@@ -96,20 +124,20 @@ void MissionCommandTree::_buildAllCommands(Vehicle* vehicle, QGCMAVLink::Vehicle
     QMap<MAV_CMD, MissionCommandUIInfo*>& collapsedTree = _allCommands[firmwareClass][vehicleClass];
 
     // Base of the tree is all commands
-    _collapseHierarchy(_staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassGeneric], collapsedTree);
+    _collapseHierarchy(_staticCommandList(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), collapsedTree);
 
     // Add the overrides for specific vehicle types
     if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
-        _collapseHierarchy(_staticCommandTree[QGCMAVLink::FirmwareClassGeneric][vehicleClass], collapsedTree);
+        _collapseHierarchy(_staticCommandList(QGCMAVLink::FirmwareClassGeneric, vehicleClass), collapsedTree);
     }
 
     // Add the overrides for specific firmware class, all vehicles
     if (firmwareClass != QGCMAVLink::FirmwareClassGeneric) {
-        _collapseHierarchy(_staticCommandTree[firmwareClass][QGCMAVLink::VehicleClassGeneric], collapsedTree);
+        _collapseHierarchy(_staticCommandList(firmwareClass, QGCMAVLink::VehicleClassGeneric), collapsedTree);
 
         // Add overrides for specific vehicle class
         if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
-            _collapseHierarchy(_staticCommandTree[firmwareClass][vehicleClass], collapsedTree);
+            _collapseHierarchy(_staticCommandList(firmwareClass, vehicleClass), collapsedTree);
         }
     }
 
@@ -75,6 +75,7 @@ private:
     void                        _buildAllCommands               (Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode);
     QStringList                 _availableCategoriesForVehicle  (Vehicle* vehicle);
     void                        _firmwareAndVehicleClassInfo    (Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode, QGCMAVLink::FirmwareClass_t& firmwareClass, QGCMAVLink::VehicleClass_t& vehicleClass) const;
+    MissionCommandList*         _staticCommandList              (QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass);
 
 private:
     QString             _allCommandsCategory;   ///< Category which contains all available commands
@@ -82,9 +83,12 @@ private:
     SettingsManager*    _settingsManager;
     bool                _unitTest;              ///< true: running in unit test mode
 
-    /// Full hierarchy
+    /// Full hierarchy. Only the base command list is loaded up front, the overrides are loaded from _staticCommandTreeFiles on first use.
     QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, MissionCommandList*>>                    _staticCommandTree;
 
+    /// Override json files for the full hierarchy which have not yet been loaded into _staticCommandTree
+    QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, QString>>                                _staticCommandTreeFiles;
+
     /// Collapsed hierarchy for specific vehicle type
     QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, QMap<MAV_CMD, MissionCommandUIInfo*>>>   _allCommands;
 
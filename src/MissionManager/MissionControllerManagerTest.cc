@@ -26,9 +26,9 @@ void MissionControllerManagerTest::cleanup(void)
     UnitTest::cleanup();
 }
 
-void MissionControllerManagerTest::_initForFirmwareType(MAV_AUTOPILOT firmwareType)
+void MissionControllerManagerTest::_initForFirmwareType(MAV_AUTOPILOT firmwareType, bool ftpCapability)
 {
-    _connectMockLink(firmwareType);
+    _connectMockLink(firmwareType, MockConfiguration::FailNone, ftpCapability);
     
     // Wait for the Mission Manager to finish it's initial load
     
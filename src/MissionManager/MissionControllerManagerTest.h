@@ -30,7 +30,7 @@ protected slots:
     void cleanup(void);
     
 protected:
-    void _initForFirmwareType(MAV_AUTOPILOT firmwareType);
+    void _initForFirmwareType(MAV_AUTOPILOT firmwareType, bool ftpCapability = false);
     void _checkInProgressValues(bool inProgress);
     
     MissionManager* _missionManager;
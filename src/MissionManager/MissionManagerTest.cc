@@ -11,6 +11,10 @@
 #include "MissionManagerTest.h"
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
+#include "MockLinkFTP.h"
+
+#include <QTemporaryDir>
+#include <QtEndian>
 
 const MissionManagerTest::TestCase_t MissionManagerTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -360,3 +364,118 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+void MissionManagerTest::_testLoadPlanFile(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString planFile = tempDir.filePath(QStringLiteral("mission.dat"));
+
+    // Build a plan file in the ArduPilot @MISSION format: header followed by packed items
+    const int       itemCount = 3;
+    QByteArray      bytes(PlanManager::_ftpPlanHeaderSize, 0);
+    uchar*          header = reinterpret_cast<uchar*>(bytes.data());
+    qToLittleEndian<quint16>(PlanManager::_ftpPlanMagic,   header);
+    qToLittleEndian<quint16>(MAV_MISSION_TYPE_MISSION,      header + 2);
+    qToLittleEndian<quint16>(0,                             header + 6);
+    qToLittleEndian<quint16>(itemCount,                     header + 8);
+    for (int i=0; i<itemCount; i++) {
+        mavlink_mission_item_int_t missionItem;
+        memset(&missionItem, 0, sizeof(missionItem));
+        missionItem.seq             = 99;   // Sequence number comes from file position
+        missionItem.frame           = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+        missionItem.command         = i == itemCount - 1 ? MAV_CMD_DO_JUMP : MAV_CMD_NAV_WAYPOINT;
+        missionItem.param1          = i == itemCount - 1 ? 1 : 0;
+        missionItem.x               = 473769000 + i;
+        missionItem.y               = 85417000;
+        missionItem.z               = 10 * i;
+        missionItem.autocontinue    = 1;
+        bytes.append(reinterpret_cast<const char*>(&missionItem), sizeof(missionItem));
+    }
+
+    QFile file(planFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(bytes);
+    file.close();
+
+    QString errorMsg;
+    QVERIFY(_missionManager->_loadPlanFile(planFile, errorMsg));
+    QCOMPARE(_missionManager->missionItems().count(), itemCount);
+    for (int i=0; i<itemCount; i++) {
+        const MissionItem* item = _missionManager->missionItems()[i];
+        QCOMPARE(item->sequenceNumber(), i);
+        QCOMPARE(item->frame(), MAV_FRAME_GLOBAL_RELATIVE_ALT);
+    }
+    QCOMPARE(_missionManager->missionItems()[1]->coordinate().latitude(), 47.3769001);
+    QCOMPARE(_missionManager->missionItems()[1]->coordinate().altitude(), 10.0);
+    // PX4 does not send home to the vehicle so DO_JUMP targets are shifted by one
+    QCOMPARE(_missionManager->missionItems()[2]->param1(), 2.0);
+
+    // Truncated and foreign files must be rejected
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(bytes.left(bytes.count() - 1));
+    file.close();
+    QVERIFY(!_missionManager->_loadPlanFile(planFile, errorMsg));
+
+    qToLittleEndian<quint16>(MAV_MISSION_TYPE_FENCE, reinterpret_cast<uchar*>(bytes.data()) + 2);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(bytes);
+    file.close();
+    QVERIFY(!_missionManager->_loadPlanFile(planFile, errorMsg));
+}
+
+void MissionManagerTest::_testFtpPlanDownloadAPM(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA, true /* ftpCapability */);
+    QVERIFY(_missionManager->_ftpPlanDownloadSupported());
+
+    // Each full FTP download ends with a session reset, a CRC cache hit never opens a session
+    QSignalSpy spyReset(_mockLink->mockLinkFTP(), &MockLinkFTP::resetCommandReceived);
+
+    // The plan changed on the vehicle, so the copy cached during the initial connect is stale
+    _roundTripItems(MockLinkMissionItemHandler::FailNone, MAV_MISSION_ERROR, false);
+    QCOMPARE(spyReset.count(), 1);
+    QVERIFY(!_missionManager->_ftpPlanUnsupported);
+    QVERIFY(_mockLink->missionItemReadRequests().isEmpty());
+
+    // Nothing changed on the vehicle, the cached copy passes the CRC check
+    _missionManager->loadFromVehicle();
+    QVERIFY(_missionManager->inProgress());
+    _multiSpyMissionManager->clearAllSignals();
+    _multiSpyMissionManager->waitForSignalByIndex(inProgressChangedSignalIndex, _missionManagerSignalWaitTime);
+    QCOMPARE(_multiSpyMissionManager->checkSignalByMask(newMissionItemsAvailableSignalMask | inProgressChangedSignalMask), true);
+    _checkInProgressValues(false);
+    _multiSpyMissionManager->clearAllSignals();
+
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(_missionManager->missionItems().count(), static_cast<int>(_cTestCases) + 1);
+    QVERIFY(_mockLink->missionItemReadRequests().isEmpty());
+}
+
+void MissionManagerTest::_testFtpPlanFallbackAPM(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA, true /* ftpCapability */);
+
+    // Older firmware without @MISSION support: the FTP download fails and the mission protocol is used instead
+    _mockLink->mockLinkFTP()->setErrorMode(MockLinkFTP::errModeNakResponse);
+    _roundTripItems(MockLinkMissionItemHandler::FailNone, MAV_MISSION_ERROR, false);
+
+    QVERIFY(_missionManager->_ftpPlanUnsupported);
+    QVERIFY(!_missionManager->_ftpPlanDownloadSupported());
+    QCOMPARE(_mockLink->missionItemReadRequests().count(), static_cast<int>(_cTestCases) + 1);
+}
+
+void MissionManagerTest::_testWindowedReadAPM(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    // Item 2 is lost the first time, everything past it is still read through the window
+    _mockLink->setMissionItemReadDropSequenceNumbers({ 2 });
+    _roundTripItems(MockLinkMissionItemHandler::FailNone, MAV_MISSION_ERROR, false);
+
+    // Five requests go out together, each arriving item opens the window by one, the retry only re-requests the lost item
+    const QList<uint16_t> expectedRequests = { 0, 1, 2, 3, 4, 5, 6, 2 };
+    QCOMPARE(_mockLink->missionItemReadRequests(), expectedRequests);
+}
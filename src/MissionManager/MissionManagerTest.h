@@ -31,6 +31,10 @@ private slots:
     //void _testWriteFailureHandlingAPM(void);
     void _testReadFailureHandlingPX4(void);
     //void _testReadFailureHandlingAPM(void);
+    void _testLoadPlanFile(void);
+    void _testFtpPlanDownloadAPM(void);
+    void _testFtpPlanFallbackAPM(void);
+    void _testWindowedReadAPM(void);
     //void _testErrorAckFailureStrings(void);
 
 private:
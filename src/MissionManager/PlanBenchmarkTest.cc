@@ -0,0 +1,246 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PlanBenchmarkTest.h"
+#include "PlanMasterController.h"
+#include "MissionController.h"
+#include "MissionManager.h"
+#include "SimpleMissionItem.h"
+#include "SurveyComplexItem.h"
+#include "TerrainQuery.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+#include <algorithm>
+
+PlanBenchmarkTest::PlanBenchmarkTest(void)
+{
+
+}
+
+void PlanBenchmarkTest::init(void)
+{
+    UnitTest::init();
+
+    _masterController = new PlanMasterController(this);
+    _masterController->setFlyView(false);
+    _masterController->start();
+}
+
+void PlanBenchmarkTest::cleanup(void)
+{
+    delete _masterController;
+    _masterController = nullptr;
+
+    UnitTest::cleanup();
+}
+
+/// Writes out all collected results once the full benchmark run is complete
+void PlanBenchmarkTest::cleanupTestCase(void)
+{
+    _results.write(objectName());
+}
+
+void PlanBenchmarkTest::_addResult(const QString& benchmarkName, const QList<qint64>& rgNsecs, const QVariantMap& extra)
+{
+    QVERIFY(!rgNsecs.isEmpty());
+
+    QList<qint64> sortedNsecs = rgNsecs;
+    std::sort(sortedNsecs.begin(), sortedNsecs.end());
+
+    qint64 totalNsecs = 0;
+    for (qint64 nsecs: sortedNsecs) {
+        totalNsecs += nsecs;
+    }
+
+    const double nsecsPerMsec = 1000000.0;
+
+    QJsonObject result = QJsonObject::fromVariantMap(extra);
+    result["name"]          = benchmarkName;
+    result["iterations"]    = sortedNsecs.count();
+    result["minMs"]         = sortedNsecs.first() / nsecsPerMsec;
+    result["maxMs"]         = sortedNsecs.last() / nsecsPerMsec;
+    result["medianMs"]      = sortedNsecs[sortedNsecs.count() / 2] / nsecsPerMsec;
+    result["meanMs"]        = (totalNsecs / sortedNsecs.count()) / nsecsPerMsec;
+    _results.append(result);
+
+    qDebug() << "Benchmark" << benchmarkName << "median(ms)" << result["medianMs"].toDouble() << "min(ms)" << result["minMs"].toDouble();
+}
+
+void PlanBenchmarkTest::_loadWorker(const QString& benchmarkName, const QString& filename, int expectedMinItemCount)
+{
+    QList<qint64>   rgNsecs;
+    QElapsedTimer   timer;
+
+    for (int i=0; i<_iterations; i++) {
+        _masterController->removeAll();
+        qgcApp()->processEvents();
+
+        timer.start();
+        _masterController->loadFromFile(filename);
+        // Flush the queued recalc signals so the full load cost is measured
+        qgcApp()->processEvents();
+        rgNsecs.append(timer.nsecsElapsed());
+
+        QVERIFY(_masterController->missionController()->visualItems()->count() >= expectedMinItemCount);
+    }
+
+    _addResult(benchmarkName, rgNsecs, { { "itemCount", _masterController->missionController()->visualItems()->count() } });
+}
+
+void PlanBenchmarkTest::_benchLoad100Waypoints(void)
+{
+    _loadWorker(QStringLiteral("load100Waypoints"), QStringLiteral(":/unittest/100Waypoints.mission"), 100);
+}
+
+void PlanBenchmarkTest::_benchLoad800Waypoints(void)
+{
+    _loadWorker(QStringLiteral("load800Waypoints"), QStringLiteral(":/unittest/800Waypoints.mission"), 800);
+}
+
+void PlanBenchmarkTest::_benchEdit800Waypoints(void)
+{
+    _masterController->loadFromFile(QStringLiteral(":/unittest/800Waypoints.mission"));
+    qgcApp()->processEvents();
+
+    QmlObjectListModel* visualItems = _masterController->missionController()->visualItems();
+    QVERIFY(visualItems->count() >= 800);
+
+    QList<qint64>   rgNsecs;
+    QElapsedTimer   timer;
+
+    for (int i=0; i<_iterations; i++) {
+        timer.start();
+        for (int j=1; j<visualItems->count(); j++) {
+            SimpleMissionItem* simpleItem = visualItems->value<SimpleMissionItem*>(j);
+            if (simpleItem && simpleItem->specifiesCoordinate()) {
+                simpleItem->setCoordinate(simpleItem->coordinate().atDistanceAndAzimuth(1, i % 2 ? 90 : -90));
+            }
+        }
+        qgcApp()->processEvents();
+        rgNsecs.append(timer.nsecsElapsed());
+    }
+
+    _addResult(QStringLiteral("edit800WaypointsMoveAll"), rgNsecs, { { "itemCount", visualItems->count() } });
+}
+
+/// Creates a square survey of the specified size with the specified transect spacing. The survey is not added to the mission.
+SurveyComplexItem* PlanBenchmarkTest::_createLargeSurvey(const QGeoCoordinate& origin, double edgeDistance, double transectSpacing)
+{
+    SurveyComplexItem* surveyItem = new SurveyComplexItem(_masterController, false /* flyView */, QString() /* kmlFile */);
+
+    QList<QGeoCoordinate> polyVertices;
+    polyVertices.append(origin);
+    polyVertices.append(polyVertices[0].atDistanceAndAzimuth(edgeDistance, 90));
+    polyVertices.append(polyVertices[1].atDistanceAndAzimuth(edgeDistance, 180));
+    polyVertices.append(polyVertices[2].atDistanceAndAzimuth(edgeDistance, -90.0));
+
+    surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(transectSpacing);
+    surveyItem->cameraCalc()->adjustedFootprintFrontal()->setRawValue(transectSpacing);
+    surveyItem->surveyAreaPolygon()->appendVertices(polyVertices);
+
+    return surveyItem;
+}
+
+void PlanBenchmarkTest::_benchSurveyTransects(void)
+{
+    // 3km square with 10m spacing generates ~300 transects
+    SurveyComplexItem* surveyItem = _createLargeSurvey(QGeoCoordinate(47.633550640000003, -122.08982199), 3000, 10);
+    QVERIFY(surveyItem->_transectCount() > 250);
+
+    QList<qint64>   rgNsecs;
+    QElapsedTimer   timer;
+
+    for (int i=0; i<_iterations; i++) {
+        // Changing the grid angle forces a full transect rebuild
+        timer.start();
+        surveyItem->gridAngle()->setRawValue((i + 1) * 15);
+        rgNsecs.append(timer.nsecsElapsed());
+    }
+
+    _addResult(QStringLiteral("surveyTransectGeneration"), rgNsecs, { { "transectCount", surveyItem->_transectCount() } });
+
+    delete surveyItem;
+}
+
+void PlanBenchmarkTest::_benchSurveyTerrainAdjust(void)
+{
+    // Survey sits on top of the unit test hill region so terrain adjustment has real work to do
+    QGeoCoordinate origin = UnitTestTerrainQuery::hillRegion.topLeft().atDistanceAndAzimuth(500, 135);
+    SurveyComplexItem* surveyItem = _createLargeSurvey(origin, 3000, 25);
+
+    QList<qint64>   rgNsecs;
+    QElapsedTimer   timer;
+    const int       terrainWaitMsecs = 30000;
+
+    for (int i=0; i<_iterations; i++) {
+        QSignalSpy spyReady(surveyItem, &VisualMissionItem::readyForSaveStateChanged);
+
+        timer.start();
+        if (i == 0) {
+            surveyItem->cameraCalc()->setDistanceMode(QGroundControlQmlGlobal::AltitudeModeCalcAboveTerrain);
+        } else {
+            surveyItem->gridAngle()->setRawValue(i * 15);
+        }
+        while (surveyItem->readyForSaveState() != VisualMissionItem::ReadyForSave) {
+            QVERIFY(spyReady.wait(terrainWaitMsecs));
+        }
+        rgNsecs.append(timer.nsecsElapsed());
+    }
+
+    _addResult(QStringLiteral("surveyTerrainAdjust"), rgNsecs, { { "transectCount", surveyItem->_transectCount() } });
+
+    delete surveyItem;
+}
+
+void PlanBenchmarkTest::_benchUploadDownload800(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    // Re-create the master controller so it tracks the newly connected vehicle
+    delete _masterController;
+    _masterController = new PlanMasterController(this);
+    _masterController->setFlyView(false);
+    _masterController->start();
+    QVERIFY(!_masterController->offline());
+
+    MissionManager* missionManager = _vehicle->missionManager();
+    const int       transferWaitMsecs = 120000;
+
+    QList<qint64>   rgUploadNsecs;
+    QList<qint64>   rgDownloadNsecs;
+    QElapsedTimer   timer;
+
+    for (int i=0; i<_iterations; i++) {
+        _masterController->loadFromFile(QStringLiteral(":/unittest/800Waypoints.mission"));
+        qgcApp()->processEvents();
+
+        QSignalSpy spySendComplete(missionManager, &MissionManager::sendComplete);
+        timer.start();
+        _masterController->sendToVehicle();
+        QVERIFY(spySendComplete.wait(transferWaitMsecs));
+        rgUploadNsecs.append(timer.nsecsElapsed());
+        QCOMPARE(spySendComplete.takeFirst().at(0).toBool(), false /* error */);
+
+        QSignalSpy spyNewItems(missionManager, &MissionManager::newMissionItemsAvailable);
+        timer.start();
+        _masterController->loadFromVehicle();
+        QVERIFY(spyNewItems.wait(transferWaitMsecs));
+        rgDownloadNsecs.append(timer.nsecsElapsed());
+        QVERIFY(missionManager->missionItems().count() >= 800);
+    }
+
+    QVariantMap extra = { { "itemCount", missionManager->missionItems().count() } };
+    _addResult(QStringLiteral("upload800Waypoints"),    rgUploadNsecs,      extra);
+    _addResult(QStringLiteral("download800Waypoints"),  rgDownloadNsecs,    extra);
+}
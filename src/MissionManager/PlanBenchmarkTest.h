@@ -0,0 +1,55 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "BenchmarkResults.h"
+
+class PlanMasterController;
+class SurveyComplexItem;
+
+/// Performance benchmarks for plan load, edit, transect generation, terrain adjustment and vehicle transfer.
+///
+/// This is a standalone test which is only run when specifically requested from the command line:
+///     QGroundControl --unittest:PlanBenchmarkTest
+///
+/// Results are written to the shared benchmark results file, see BenchmarkResults.
+class PlanBenchmarkTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    PlanBenchmarkTest(void);
+
+protected:
+    void init   (void) final;
+    void cleanup(void) final;
+
+private slots:
+    void cleanupTestCase(void);
+
+    void _benchLoad100Waypoints         (void);
+    void _benchLoad800Waypoints         (void);
+    void _benchEdit800Waypoints         (void);
+    void _benchSurveyTransects          (void);
+    void _benchSurveyTerrainAdjust      (void);
+    void _benchUploadDownload800        (void);
+
+private:
+    void                _loadWorker         (const QString& benchmarkName, const QString& filename, int expectedMinItemCount);
+    SurveyComplexItem*  _createLargeSurvey  (const QGeoCoordinate& origin, double edgeDistance, double transectSpacing);
+    void                _addResult          (const QString& benchmarkName, const QList<qint64>& rgNsecs, const QVariantMap& extra = QVariantMap());
+
+    PlanMasterController* _masterController = nullptr;
+
+    BenchmarkResults _results;
+
+    static const int    _iterations = 5;
+};
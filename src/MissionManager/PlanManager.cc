@@ -14,6 +14,14 @@
 #include "QGCApplication.h"
 #include "MissionCommandTree.h"
 #include "MissionCommandUIInfo.h"
+#include "FTPManager.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QtEndian>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
@@ -27,6 +35,8 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
     , _resumeMission            (false)
     , _lastMissionRequest       (-1)
     , _missionItemCountToRead   (-1)
+    , _lastReadRequested        (-1)
+    , _ftpPlanUnsupported       (false)
     , _currentMissionIndex      (-1)
     , _lastCurrentIndex         (-1)
 {
@@ -136,10 +146,141 @@ void PlanManager::loadFromVehicle(void)
 
     _retryCount = 0;
     _setTransactionInProgress(TransactionRead);
+    if (_ftpPlanDownloadSupported() && _startFtpPlanDownload()) {
+        return;
+    }
+    _connectToMavlink();
+    _requestList();
+}
+
+QDir PlanManager::planCacheDir(void)
+{
+    const QString spath(QFileInfo(QSettings().fileName()).dir().absolutePath());
+    return spath + QDir::separator() + "PlanCache";
+}
+
+QString PlanManager::_ftpPlanFileName(void) const
+{
+    switch (_planType) {
+    case MAV_MISSION_TYPE_MISSION:
+        return QStringLiteral("mission.dat");
+    case MAV_MISSION_TYPE_FENCE:
+        return QStringLiteral("fence.dat");
+    case MAV_MISSION_TYPE_RALLY:
+        return QStringLiteral("rally.dat");
+    default:
+        return QString();
+    }
+}
+
+/// ArduPilot exposes the plan as a virtual file through MAVLink FTP. This transfers in a fraction of the time of the
+/// item by item protocol and lets FTPManager skip the transfer completely if the cached copy has a matching CRC32.
+bool PlanManager::_ftpPlanDownloadSupported(void) const
+{
+    return !_ftpPlanUnsupported &&
+            _vehicle->apmFirmware() &&
+            (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP) &&
+            !_ftpPlanFileName().isEmpty();
+}
+
+bool PlanManager::_startFtpPlanDownload(void)
+{
+    QDir cacheDir(planCacheDir().filePath(QString::number(_vehicle->id())));
+    if (!cacheDir.mkpath(cacheDir.absolutePath())) {
+        qCWarning(PlanManagerLog) << "Unable to create plan cache directory" << cacheDir.absolutePath();
+        return false;
+    }
+
+    _clearMissionItems();
+    emit progressPct(0);
+
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    connect(ftpManager, &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+    if (!ftpManager->download(QStringLiteral("@MISSION/%1").arg(_ftpPlanFileName()), cacheDir.absolutePath(), true /* skipIfUnchanged */)) {
+        disconnect(ftpManager, &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+        return false;
+    }
+    _ftpDownloadFile = cacheDir.absoluteFilePath(_ftpPlanFileName());
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_startFtpPlanDownload %1").arg(_planTypeString()) << _ftpDownloadFile;
+
+    return true;
+}
+
+void PlanManager::_ftpDownloadComplete(const QString& file, const QString& errorMsg)
+{
+    if (file != _ftpDownloadFile) {
+        // Completion of some other FTPManager client's download
+        return;
+    }
+
+    disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &PlanManager::_ftpDownloadComplete);
+    _ftpDownloadFile.clear();
+
+    if (_transactionInProgress != TransactionRead) {
+        return;
+    }
+
+    QString loadError = errorMsg;
+    if (loadError.isEmpty() && _loadPlanFile(file, loadError)) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 count:").arg(_planTypeString()) << _missionItems.count();
+        _finishTransaction(true);
+        return;
+    }
+
+    // Older firmware without @MISSION support lands here. Fall back to the mission protocol and don't try FTP again.
+    qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 FTP plan download failed, using mission protocol:").arg(_planTypeString()) << loadError;
+    _ftpPlanUnsupported = true;
+    QFile::remove(file);
     _connectToMavlink();
     _requestList();
 }
 
+/// Loads the mission items from a plan file in the ArduPilot @MISSION format
+///     @return false: file is not valid, errorMsg set
+bool PlanManager::_loadPlanFile(const QString& filename, QString& errorMsg)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMsg = file.errorString();
+        return false;
+    }
+
+    const QByteArray    bytes       = file.readAll();
+    const uchar*        data        = reinterpret_cast<const uchar*>(bytes.constData());
+    const int           itemSize    = static_cast<int>(sizeof(mavlink_mission_item_int_t));
+
+    if (bytes.size() < _ftpPlanHeaderSize) {
+        errorMsg = tr("Plan file is too short");
+        return false;
+    }
+
+    const quint16 magic     = qFromLittleEndian<quint16>(data);
+    const quint16 dataType  = qFromLittleEndian<quint16>(data + 2);
+    const quint16 start     = qFromLittleEndian<quint16>(data + 6);
+    const quint16 itemCount = qFromLittleEndian<quint16>(data + 8);
+
+    if (magic != _ftpPlanMagic || dataType != _planType) {
+        errorMsg = tr("Plan file has incorrect header magic:type %1:%2").arg(magic).arg(dataType);
+        return false;
+    }
+    if (start != 0 || bytes.size() < _ftpPlanHeaderSize + (itemCount * itemSize)) {
+        errorMsg = tr("Plan file is truncated start:count %1:%2").arg(start).arg(itemCount);
+        return false;
+    }
+
+    _clearMissionItems();
+    _missionItemCountToRead = itemCount;
+    for (int i=0; i<itemCount; i++) {
+        mavlink_mission_item_int_t missionItem;
+        memcpy(&missionItem, data + _ftpPlanHeaderSize + (i * itemSize), itemSize);
+        missionItem.seq = static_cast<uint16_t>(i);
+        _missionItems.append(_createMissionItem(missionItem));
+    }
+
+    return true;
+}
+
 /// Internal call to request list of mission items. May be called during a retry sequence.
 void PlanManager::_requestList(void)
 {
@@ -147,6 +288,7 @@ void PlanManager::_requestList(void)
 
     _itemIndicesToRead.clear();
     _clearMissionItems();
+    _lastReadRequested = -1;
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -196,7 +338,7 @@ void PlanManager::_ackTimeout(void)
         } else {
             _retryCount++;
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
-            _requestNextMissionItem();
+            _requestNextMissionItem(true /* resendOutstanding */);
         }
         break;
     case AckMissionRequest:
@@ -340,18 +482,40 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
             _itemIndicesToRead << i;
         }
         _missionItemCountToRead = missionCount.count;
-        _requestNextMissionItem();
+        _requestNextMissionItem(false /* resendOutstanding */);
     }
 }
 
-void PlanManager::_requestNextMissionItem(void)
+/// PX4 only accepts mission item requests in sequence, ArduPilot answers each request independently so a window of
+/// requests can be kept in flight to hide link latency.
+int PlanManager::_readWindowSize(void) const
+{
+    return _vehicle->apmFirmware() ? _apmReadWindowSize : 1;
+}
+
+/// Requests the items within the read window which have not been requested yet.
+///     @param resendOutstanding true: Also re-request items in the window which are still outstanding (retry)
+void PlanManager::_requestNextMissionItem(bool resendOutstanding)
 {
     if (_itemIndicesToRead.count() == 0) {
         _sendError(InternalError, tr("Internal Error: Call to Vehicle _requestNextMissionItem with no more indices to read"));
         return;
     }
 
-    qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
+    const int windowCount = qMin(_readWindowSize(), _itemIndicesToRead.count());
+    for (int i=0; i<windowCount; i++) {
+        const int seq = _itemIndicesToRead[i];
+        if (resendOutstanding || seq > _lastReadRequested) {
+            _sendMissionRequest(seq);
+            _lastReadRequested = qMax(_lastReadRequested, seq);
+        }
+    }
+    _startAckTimeout(AckMissionItem);
+}
+
+void PlanManager::_sendMissionRequest(int seq)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionRequest %1 sequenceNumber:retry").arg(_planTypeString()) << seq << _retryCount;
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -364,43 +528,17 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  seq,
                                                   _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
 }
 
-void PlanManager::_handleMissionItem(const mavlink_message_t& message)
+/// Creates a MissionItem from the vehicle representation of the item, converting to the frames and sequence
+/// numbering used internally.
+MissionItem* PlanManager::_createMissionItem(const mavlink_mission_item_int_t& missionItem)
 {
-    MAV_CMD     command;
-    MAV_FRAME   frame;
-    double      param1;
-    double      param2;
-    double      param3;
-    double      param4;
-    double      param5;
-    double      param6;
-    double      param7;
-    bool        autoContinue;
-    bool        isCurrentItem;
-    int         seq;
-
-    mavlink_mission_item_int_t missionItem;
-    mavlink_msg_mission_item_int_decode(&message, &missionItem);
-
-    command =       (MAV_CMD)missionItem.command,
-            frame =         (MAV_FRAME)missionItem.frame,
-            param1 =        missionItem.param1;
-    param2 =        missionItem.param2;
-    param3 =        missionItem.param3;
-    param4 =        missionItem.param4;
-    param5 =        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7;
-    param6 =        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7;
-    param7 =        (double)missionItem.z;
-    autoContinue =  missionItem.autocontinue;
-    isCurrentItem = missionItem.current;
-    seq =           missionItem.seq;
+    MAV_FRAME frame = (MAV_FRAME)missionItem.frame;
 
     // We don't support editing ALT_INT frames so change on the way in.
     if (frame == MAV_FRAME_GLOBAL_INT) {
@@ -409,6 +547,37 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
         frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
     }
 
+    MissionItem* item = new MissionItem(missionItem.seq,
+                                        (MAV_CMD)missionItem.command,
+                                        frame,
+                                        missionItem.param1,
+                                        missionItem.param2,
+                                        missionItem.param3,
+                                        missionItem.param4,
+                                        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7,
+                                        missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7,
+                                        (double)missionItem.z,
+                                        missionItem.autocontinue,
+                                        missionItem.current,
+                                        this);
+
+    if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
+        // Home is in position 0
+        item->setParam1((int)item->param1() + 1);
+    }
+
+    return item;
+}
+
+void PlanManager::_handleMissionItem(const mavlink_message_t& message)
+{
+    mavlink_mission_item_int_t missionItem;
+    mavlink_msg_mission_item_int_decode(&message, &missionItem);
+
+    const int   seq             = missionItem.seq;
+    const int   command         = missionItem.command;
+    const bool  isCurrentItem   = missionItem.current;
+
     bool ardupilotHomePositionUpdate = false;
     if (!_checkForExpectedAck(AckMissionItem)) {
         if (_vehicle->apmFirmware() && seq ==  0 && _planType == MAV_MISSION_TYPE_MISSION) {
@@ -422,7 +591,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 seq:command:current:ardupilotHomePositionUpdate").arg(_planTypeString()) << seq << command << isCurrentItem << ardupilotHomePositionUpdate;
 
     if (ardupilotHomePositionUpdate) {
-        QGeoCoordinate newHomePosition(param5, param6, param7);
+        QGeoCoordinate newHomePosition(missionItem.x * 1e-7, missionItem.y * 1e-7, missionItem.z);
         _vehicle->_setHomePosition(newHomePosition);
         return;
     }
@@ -430,26 +599,12 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
 
-        MissionItem* item = new MissionItem(seq,
-                                            command,
-                                            frame,
-                                            param1,
-                                            param2,
-                                            param3,
-                                            param4,
-                                            param5,
-                                            param6,
-                                            param7,
-                                            autoContinue,
-                                            isCurrentItem,
-                                            this);
-
-        if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
-            // Home is in position 0
-            item->setParam1((int)item->param1() + 1);
-        }
-
-        _missionItems.append(item);
+        // With a read window items may arrive out of order, keep the list sorted by sequence number
+        MissionItem* item = _createMissionItem(missionItem);
+        auto insertPos = std::upper_bound(_missionItems.begin(), _missionItems.end(), item, [](const MissionItem* a, const MissionItem* b) {
+            return a->sequenceNumber() < b->sequenceNumber();
+        });
+        _missionItems.insert(insertPos, item);
     } else {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 mission item received item index which was not requested, disregrarding:").arg(_planTypeString()) << seq;
         // We have to put the ack timeout back since it was removed above
@@ -457,13 +612,13 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
         return;
     }
 
-    emit progressPct((double)seq / (double)_missionItemCountToRead);
+    emit progressPct((double)(_missionItemCountToRead - _itemIndicesToRead.count()) / (double)_missionItemCountToRead);
     
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
         _readTransactionComplete();
     } else {
-        _requestNextMissionItem();
+        _requestNextMissionItem(false /* resendOutstanding */);
     }
 }
 
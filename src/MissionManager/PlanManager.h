@@ -12,6 +12,7 @@
 #include <QObject>
 #include <QLoggingCategory>
 #include <QTimer>
+#include <QDir>
 
 #include "MissionItem.h"
 #include "QGCMAVLink.h"
@@ -56,6 +57,10 @@ public:
     ///     Signals removeAllComplete when done
     void removeAll(void);
 
+    /// Directory which holds plans downloaded from vehicles using MAVLink FTP. The CRC32 of a cached plan file is
+    /// used as its identity, a matching plan on the vehicle is not transferred again.
+    static QDir planCacheDir(void);
+
     /// Error codes returned in error signal
     typedef enum {
         InternalError,
@@ -75,6 +80,8 @@ public:
     // When actively retrying to request mission items, use a shorter timeout instead.
     static const int _retryTimeoutMilliseconds = 250;
     static const int _maxRetryCount = 5;
+    // Number of MISSION_REQUEST_INT messages which are kept outstanding while reading from ArduPilot
+    static const int _apmReadWindowSize = 5;
 
 signals:
     void newMissionItemsAvailable   (bool removeAllRequested);
@@ -91,6 +98,7 @@ signals:
 private slots:
     void _mavlinkMessageReceived(const mavlink_message_t& message);
     void _ackTimeout(void);
+    void _ftpDownloadComplete(const QString& file, const QString& errorMsg);
 
 protected:
     typedef enum {
@@ -116,7 +124,14 @@ protected:
     void _handleMissionItem(const mavlink_message_t& message);
     void _handleMissionRequest(const mavlink_message_t& message);
     void _handleMissionAck(const mavlink_message_t& message);
-    void _requestNextMissionItem(void);
+    void _requestNextMissionItem(bool resendOutstanding);
+    void _sendMissionRequest(int seq);
+    int  _readWindowSize(void) const;
+    MissionItem* _createMissionItem(const mavlink_mission_item_int_t& missionItem);
+    bool _ftpPlanDownloadSupported(void) const;
+    bool _startFtpPlanDownload(void);
+    bool _loadPlanFile(const QString& filename, QString& errorMsg);
+    QString _ftpPlanFileName(void) const;
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -148,6 +163,9 @@ protected:
     QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
     int                 _missionItemCountToRead;///< Count of all mission items to read
+    int                 _lastReadRequested;     ///< Highest sequence number requested so far during a read
+    QString             _ftpDownloadFile;       ///< Local path of plan file FTP download in progress, empty for none
+    bool                _ftpPlanUnsupported;    ///< true: Previous FTP plan download failed, use mission protocol only
 
     QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
     QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
@@ -156,4 +174,10 @@ protected:
 
 private:
     void _setTransactionInProgress(TransactionType_t type);
+
+    // ArduPilot @MISSION/<type>.dat file layout: header followed by packed mavlink_mission_item_int_t structs
+    static const uint16_t   _ftpPlanMagic       = 0x763d;
+    static const int        _ftpPlanHeaderSize  = 10;
+
+    friend class MissionManagerTest;
 };
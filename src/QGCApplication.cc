@@ -43,6 +43,8 @@
 #include "QGCPalette.h"
 #include "QGCMapPalette.h"
 #include "QGCLoggingCategory.h"
+#include "JsonHelper.h"
+#include "SettingsFactWriter.h"
 #include "ParameterEditorController.h"
 #include "ESP8266ComponentController.h"
 #include "ScreenToolsController.h"
@@ -59,6 +61,7 @@
 #include "QmlObjectListModel.h"
 #include "QGCGeoBoundingCube.h"
 #include "MissionManager.h"
+#include "PlanManager.h"
 #include "QGroundControlQmlGlobal.h"
 #include "FlightMapSettings.h"
 #include "FlightPathSegment.h"
@@ -90,6 +93,7 @@
 #include "QGCFileDownload.h"
 #include "FirmwareImage.h"
 #include "MavlinkConsoleController.h"
+#include "TelemetryTraceController.h"
 #include "GeoTagController.h"
 #include "LogReplayLink.h"
 #include "VehicleObjectAvoidance.h"
@@ -316,6 +320,8 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     if (fClearCache) {
         QDir dir(ParameterManager::parameterCacheDir());
         dir.removeRecursively();
+        QDir planDir(PlanManager::planCacheDir());
+        planDir.removeRecursively();
         QFile airframe(cachedAirframeMetaDataFile());
         airframe.remove();
         QFile parameter(cachedParameterMetaDataFile());
@@ -398,8 +404,11 @@ void QGCApplication::setLanguage()
         }
     }
     qCDebug(LocalizationLog) << "Loading localizations for" << _locale.name();
+    QWriteLocker jsonTranslatorLock(&_qgcTranslatorJSONLock);
     _app->removeTranslator(&_qgcTranslatorJSON);
     _app->removeTranslator(&_qgcTranslatorSourceCode);
+    // Previously parsed json files were translated with the old translator
+    JsonHelper::clearInternalQGCJsonFileCache();
     _app->removeTranslator(&_qgcTranslatorQtLibs);
     if (_locale.name() != "en_US") {
         QLocale::setDefault(_locale);
@@ -419,6 +428,7 @@ void QGCApplication::setLanguage()
             qCWarning(LocalizationLog) << "Error loading json localization for" << _locale.name();
         }
     }
+    jsonTranslatorLock.unlock();
     if(_qmlAppEngine)
         _qmlAppEngine->retranslate();
     emit languageChanged(_locale);
@@ -430,6 +440,9 @@ void QGCApplication::_shutdown()
     delete _qmlAppEngine;
     delete _toolbox;
     delete _gpsRtkFactGroup;
+
+    // Make sure all outstanding settings changes make it to disk
+    SettingsFactWriter::instance()->shutdown();
 }
 
 QGCApplication::~QGCApplication()
@@ -526,6 +539,7 @@ void QGCApplication::_initCommon()
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
     qmlRegisterType<MAVLinkInspectorController>     (kQGCControllers,                       1, 0, "MAVLinkInspectorController");
 #endif
+    qmlRegisterType<TelemetryTraceController>       (kQGCControllers,                       1, 0, "TelemetryTraceController");
 
     // Register Qml Singletons
     qmlRegisterSingletonType<QGroundControlQmlGlobal>   ("QGroundControl",                          1, 0, "QGroundControl",         qgroundcontrolQmlGlobalSingletonFactory);
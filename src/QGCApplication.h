@@ -16,6 +16,7 @@
 #include <QSet>
 #include <QMetaMethod>
 #include <QMetaObject>
+#include <QReadWriteLock>
 
 // These private headers are require to implement the signal compress support below
 #include <private/qthread_p.h>
@@ -92,6 +93,10 @@ public:
 
     QTranslator& qgcJSONTranslator(void) { return _qgcTranslatorJSON; }
 
+    /// Json files are translated on worker threads. They hold this for reading while using qgcJSONTranslator,
+    /// setLanguage holds it for writing while reloading the translator.
+    QReadWriteLock& qgcJSONTranslatorLock(void) { return _qgcTranslatorJSONLock; }
+
     void            setLanguage();
     QQuickWindow*   mainRootWindow();
     uint64_t        msecsSinceBoot(void) { return _msecsElapsedTime.elapsed(); }
@@ -211,6 +216,7 @@ private:
     bool                _bluetoothAvailable     = false;
     QTranslator         _qgcTranslatorSourceCode;           ///< translations for source code C++/Qml
     QTranslator         _qgcTranslatorJSON;                 ///< translations for json files
+    QReadWriteLock      _qgcTranslatorJSONLock;
     QTranslator         _qgcTranslatorQtLibs;               ///< tranlsations for Qt libraries
     QLocale             _locale;
     bool                _error                  = false;
@@ -23,6 +23,14 @@ ChartView {
     property var chartController:   null
     property var seriesColors:      ["#00E04B","#DE8500","#F32836","#BFBFBF","#536DFF","#EECC44"]
 
+    // Series are decimated to the plot width
+    Binding {
+        target:     chartController
+        property:   "plotWidth"
+        value:      Math.round(chartView.plotArea.width)
+        when:       chartController !== null
+    }
+
     function addDimension(field) {
         if(!chartController) {
             chartController = controller.createChart()
@@ -63,6 +63,10 @@ void ParameterEditorController::_buildListsForComponent(int compId)
         }
 
         group->facts.append(fact);
+
+        if (compId == _vehicle->defaultComponentId()) {
+            _searchIndex.addFact(fact);
+        }
     }
 }
 
@@ -121,6 +125,10 @@ void ParameterEditorController::_factAdded(int compId, Fact* fact)
     bool                        inserted = false;
     ParameterEditorCategory*    category = nullptr;
 
+    if (compId == _vehicle->defaultComponentId()) {
+        _searchIndex.addFact(fact);
+    }
+
     if (_mapCategoryName2Category.contains(fact->category())) {
         category = _mapCategoryName2Category[fact->category()];
     } else {
@@ -185,18 +193,12 @@ QStringList ParameterEditorController::searchParameters(const QString& searchTex
 {
     QStringList list;
 
-    for(const QString &paramName: _parameterMgr->parameterNames(_vehicle->defaultComponentId())) {
-        if (searchText.isEmpty()) {
-            list += paramName;
-        } else {
-            Fact* fact = _parameterMgr->getParameter(_vehicle->defaultComponentId(), paramName);
-
-            if (searchInName && fact->name().contains(searchText, Qt::CaseInsensitive)) {
-                list += paramName;
-            } else if (searchInDescriptions && (fact->shortDescription().contains(searchText, Qt::CaseInsensitive) || fact->longDescription().contains(searchText, Qt::CaseInsensitive))) {
-                list += paramName;
-            }
-        }
+    QStringList rgSearchTerms;
+    if (!searchText.isEmpty()) {
+        rgSearchTerms.append(searchText);
+    }
+    for (Fact* fact: _searchIndex.search(rgSearchTerms, searchInName, searchInDescriptions)) {
+        list += fact->name();
     }
     list.sort();
 
@@ -379,20 +381,9 @@ void ParameterEditorController::_searchTextChanged(void)
         _searchParameters.beginReset();
         _searchParameters.clear();
 
-        for (const QString &paraName: _parameterMgr->parameterNames(_vehicle->defaultComponentId())) {
-            Fact* fact = _parameterMgr->getParameter(_vehicle->defaultComponentId(), paraName);
-            bool matched = _shouldShow(fact);
-            // All of the search items must match in order for the parameter to be added to the list
-            if (matched) {
-                for (const auto& searchItem : rgSearchStrings) {
-                    if (!fact->name().contains(searchItem, Qt::CaseInsensitive) &&
-                            !fact->shortDescription().contains(searchItem, Qt::CaseInsensitive) &&
-                            !fact->longDescription().contains(searchItem, Qt::CaseInsensitive)) {
-                        matched = false;
-                    }
-                }
-            }
-            if (matched) {
+        // All of the search items must match in order for the parameter to be added to the list
+        for (Fact* fact: _searchIndex.search(rgSearchStrings)) {
+            if (_shouldShow(fact)) {
                 _searchParameters.append(fact);
             }
         }
@@ -17,6 +17,7 @@
 #include "FactPanelController.h"
 #include "QmlObjectListModel.h"
 #include "ParameterManager.h"
+#include "ParameterSearchIndex.h"
 
 class ParameterEditorGroup : public QObject
 {
@@ -152,4 +153,5 @@ private:
     QmlObjectListModel          _searchParameters;
     QmlObjectListModel*         _parameters             = nullptr;
     QMap<QString, ParameterEditorCategory*> _mapCategoryName2Category;
+    ParameterSearchIndex        _searchIndex;           ///< Search index for default component parameters
 };
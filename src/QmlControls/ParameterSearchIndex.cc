@@ -0,0 +1,164 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterSearchIndex.h"
+#include "Fact.h"
+
+#include <QSet>
+
+#include <algorithm>
+#include <numeric>
+
+void ParameterSearchIndex::clear(void)
+{
+    _entries.clear();
+    _indexedFacts.clear();
+    _nameTrigrams.clear();
+    _descriptionTrigrams.clear();
+}
+
+void ParameterSearchIndex::addFact(Fact* fact)
+{
+    if (!fact || _indexedFacts.contains(fact)) {
+        return;
+    }
+
+    Entry_t entry;
+    entry.fact              = fact;
+    entry.name              = fact->name();
+    entry.lowerName         = entry.name.toLower();
+    entry.lowerDescriptions = QStringLiteral("%1\n%2").arg(fact->shortDescription(), fact->longDescription()).toLower();
+
+    int entryIndex = _entries.count();
+    _addTrigrams(_nameTrigrams,         entry.lowerName,            entryIndex);
+    _addTrigrams(_descriptionTrigrams,  entry.lowerDescriptions,    entryIndex);
+
+    _entries.append(entry);
+    _indexedFacts.insert(fact);
+}
+
+quint64 ParameterSearchIndex::_trigramKey(const QString& lowerText, int index)
+{
+    return (static_cast<quint64>(lowerText[index].unicode()) << 32) |
+            (static_cast<quint64>(lowerText[index + 1].unicode()) << 16) |
+            static_cast<quint64>(lowerText[index + 2].unicode());
+}
+
+void ParameterSearchIndex::_addTrigrams(TrigramIndex_t& trigramIndex, const QString& lowerText, int entryIndex)
+{
+    QSet<quint64> trigrams;
+    for (int i=0; i<lowerText.length() - 2; i++) {
+        trigrams.insert(_trigramKey(lowerText, i));
+    }
+
+    // Entries are only ever appended so posting lists stay sorted
+    for (quint64 trigram: trigrams) {
+        trigramIndex[trigram].append(entryIndex);
+    }
+}
+
+/// @return Sorted indices of all entries
+QVector<int> ParameterSearchIndex::_allEntries(void) const
+{
+    QVector<int> entries(_entries.count());
+    std::iota(entries.begin(), entries.end(), 0);
+    return entries;
+}
+
+/// Intersects the posting lists for all trigrams in the term
+///     @return Sorted entry indices which may contain the term
+QVector<int> ParameterSearchIndex::_trigramCandidates(const TrigramIndex_t& trigramIndex, const QString& lowerTerm)
+{
+    QVector<const QVector<int>*> rgPostingLists;
+    for (int i=0; i<lowerTerm.length() - 2; i++) {
+        auto iter = trigramIndex.constFind(_trigramKey(lowerTerm, i));
+        if (iter == trigramIndex.constEnd()) {
+            return QVector<int>();
+        }
+        rgPostingLists.append(&iter.value());
+    }
+
+    // Start from the shortest list to keep the intersection small
+    std::sort(rgPostingLists.begin(), rgPostingLists.end(), [](const QVector<int>* a, const QVector<int>* b) { return a->count() < b->count(); });
+
+    QVector<int> candidates = *rgPostingLists[0];
+    for (int i=1; i<rgPostingLists.count() && !candidates.isEmpty(); i++) {
+        QVector<int> intersection;
+        std::set_intersection(candidates.constBegin(), candidates.constEnd(), rgPostingLists[i]->constBegin(), rgPostingLists[i]->constEnd(), std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    return candidates;
+}
+
+/// @return Sorted entry indices which contain the term
+QVector<int> ParameterSearchIndex::_termMatches(const QString& lowerTerm, bool searchInName, bool searchInDescriptions) const
+{
+    QVector<int> candidates;
+
+    if (lowerTerm.length() < 3) {
+        // Too short for the trigram index, check everything
+        candidates = _allEntries();
+    } else {
+        QVector<int> nameCandidates;
+        QVector<int> descriptionCandidates;
+        if (searchInName) {
+            nameCandidates = _trigramCandidates(_nameTrigrams, lowerTerm);
+        }
+        if (searchInDescriptions) {
+            descriptionCandidates = _trigramCandidates(_descriptionTrigrams, lowerTerm);
+        }
+        std::set_union(nameCandidates.constBegin(), nameCandidates.constEnd(), descriptionCandidates.constBegin(), descriptionCandidates.constEnd(), std::back_inserter(candidates));
+    }
+
+    // Trigram hits are only candidates, verify the full term
+    QVector<int> matches;
+    for (int entryIndex: candidates) {
+        const Entry_t& entry = _entries[entryIndex];
+        if ((searchInName && entry.lowerName.contains(lowerTerm)) || (searchInDescriptions && entry.lowerDescriptions.contains(lowerTerm))) {
+            matches.append(entryIndex);
+        }
+    }
+
+    return matches;
+}
+
+QList<Fact*> ParameterSearchIndex::search(const QStringList& rgSearchTerms, bool searchInName, bool searchInDescriptions) const
+{
+    QVector<int> matches;
+
+    if (rgSearchTerms.isEmpty()) {
+        matches = _allEntries();
+    } else {
+        // All of the search terms must match
+        for (int i=0; i<rgSearchTerms.count(); i++) {
+            QVector<int> termMatches = _termMatches(rgSearchTerms[i].toLower(), searchInName, searchInDescriptions);
+            if (i == 0) {
+                matches.swap(termMatches);
+            } else {
+                QVector<int> intersection;
+                std::set_intersection(matches.constBegin(), matches.constEnd(), termMatches.constBegin(), termMatches.constEnd(), std::back_inserter(intersection));
+                matches.swap(intersection);
+            }
+            if (matches.isEmpty()) {
+                break;
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [this](int a, int b) { return _entries[a].name < _entries[b].name; });
+
+    QList<Fact*> facts;
+    facts.reserve(matches.count());
+    for (int entryIndex: matches) {
+        facts.append(_entries[entryIndex].fact);
+    }
+
+    return facts;
+}
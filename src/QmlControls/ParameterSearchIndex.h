@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+class Fact;
+
+/// Inverted trigram index over parameter names and descriptions.
+///
+/// Provides the same case insensitive substring matching as QString::contains without walking every
+/// Fact on every search. Search terms of three or more characters are resolved through the trigram posting
+/// lists and only the resulting candidates are verified. Facts can be added incrementally as they show up.
+class ParameterSearchIndex
+{
+public:
+    void clear      (void);
+    void addFact    (Fact* fact);
+    int  count      (void) const { return _entries.count(); }
+
+    /// Returns the facts which contain all of the search terms, ordered by name. No search terms returns all facts.
+    ///     @param searchInName         true: match search terms against the fact name
+    ///     @param searchInDescriptions true: match search terms against the short and long descriptions
+    QList<Fact*> search(const QStringList& rgSearchTerms, bool searchInName = true, bool searchInDescriptions = true) const;
+
+private:
+    typedef struct {
+        Fact*   fact;
+        QString name;
+        QString lowerName;
+        QString lowerDescriptions;  ///< Short and long description separated by a newline
+    } Entry_t;
+
+    typedef QHash<quint64, QVector<int>> TrigramIndex_t;
+
+    static quint64      _trigramKey         (const QString& lowerText, int index);
+    static void         _addTrigrams        (TrigramIndex_t& trigramIndex, const QString& lowerText, int entryIndex);
+    static QVector<int> _trigramCandidates  (const TrigramIndex_t& trigramIndex, const QString& lowerTerm);
+    QVector<int>        _termMatches        (const QString& lowerTerm, bool searchInName, bool searchInDescriptions) const;
+    QVector<int>        _allEntries         (void) const;
+
+    QVector<Entry_t>    _entries;
+    QSet<Fact*>         _indexedFacts;
+    TrigramIndex_t      _nameTrigrams;
+    TrigramIndex_t      _descriptionTrigrams;
+};
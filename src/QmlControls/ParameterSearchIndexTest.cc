@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterSearchIndexTest.h"
+#include "ParameterSearchIndex.h"
+#include "Fact.h"
+
+Fact* ParameterSearchIndexTest::_newFact(const QString& name, const QString& shortDescription, const QString& longDescription)
+{
+    FactMetaData* metaData = new FactMetaData(FactMetaData::valueTypeFloat, name, this);
+    metaData->setShortDescription(shortDescription);
+    metaData->setLongDescription(longDescription);
+
+    Fact* fact = new Fact(1, name, FactMetaData::valueTypeFloat, this);
+    fact->setMetaData(metaData);
+    return fact;
+}
+
+void ParameterSearchIndexTest::_prefixSearchTest(void)
+{
+    ParameterSearchIndex index;
+
+    Fact* mcRollP   = _newFact("MC_ROLL_P",     "Roll P gain");
+    Fact* mcRollI   = _newFact("MC_ROLL_I",     "Roll I gain");
+    Fact* mcPitchP  = _newFact("MC_PITCH_P",    "Pitch P gain");
+    Fact* mpcXyP    = _newFact("MPC_XY_P",      "Proportional gain for horizontal position error");
+    for (Fact* fact: { mpcXyP, mcPitchP, mcRollI, mcRollP }) {
+        index.addFact(fact);
+    }
+    QCOMPARE(index.count(), 4);
+
+    // Results are ordered by name, matching is case insensitive
+    QCOMPARE(index.search({ "MC_" }),           QList<Fact*>({ mcPitchP, mcRollI, mcRollP }));
+    QCOMPARE(index.search({ "mc_roll" }),       QList<Fact*>({ mcRollI, mcRollP }));
+    QCOMPARE(index.search({ "MC_ROLL_P" }),     QList<Fact*>({ mcRollP }));
+    QCOMPARE(index.search({ "MP" }),            QList<Fact*>({ mpcXyP }));
+    QCOMPARE(index.search({ "M" }),             QList<Fact*>({ mcPitchP, mcRollI, mcRollP, mpcXyP }));
+    QCOMPARE(index.search({}),                  QList<Fact*>({ mcPitchP, mcRollI, mcRollP, mpcXyP }));
+    QVERIFY(index.search({ "MC_YAW" }).isEmpty());
+}
+
+void ParameterSearchIndexTest::_substringSearchTest(void)
+{
+    ParameterSearchIndex index;
+
+    Fact* mcRollP   = _newFact("MC_ROLL_P",     "Roll P gain",  "Roll rate proportional gain");
+    Fact* mcPitchP  = _newFact("MC_PITCH_P",    "Pitch P gain", "Pitch rate proportional gain");
+    Fact* batCap    = _newFact("BAT1_CAPACITY", "Battery capacity");
+    for (Fact* fact: { mcRollP, mcPitchP, batCap }) {
+        index.addFact(fact);
+    }
+
+    // Substrings in the middle of names and in the descriptions
+    QCOMPARE(index.search({ "OLL" }),                   QList<Fact*>({ mcRollP }));
+    QCOMPARE(index.search({ "_P" }),                    QList<Fact*>({ mcPitchP, mcRollP }));
+    QCOMPARE(index.search({ "capacity" }),              QList<Fact*>({ batCap }));
+    QCOMPARE(index.search({ "proportional" }),          QList<Fact*>({ mcPitchP, mcRollP }));
+    QCOMPARE(index.search({ "proportional", "roll" }),  QList<Fact*>({ mcRollP }));
+    QVERIFY(index.search({ "proportional", "battery" }).isEmpty());
+
+    // All trigrams of the term are present in the descriptions, but the term itself is not
+    QVERIFY(index.search({ "roll gain" }).isEmpty());
+
+    // Restricting where to search
+    QVERIFY(index.search({ "proportional" }, true /* searchInName */, false /* searchInDescriptions */).isEmpty());
+    QCOMPARE(index.search({ "MC_" }, false /* searchInName */, true /* searchInDescriptions */), QList<Fact*>());
+    QCOMPARE(index.search({ "roll" }, false /* searchInName */, true /* searchInDescriptions */), QList<Fact*>({ mcRollP }));
+}
+
+void ParameterSearchIndexTest::_addTest(void)
+{
+    ParameterSearchIndex index;
+
+    Fact* mcRollP   = _newFact("MC_ROLL_P",     "Roll P gain");
+    Fact* mcRollI   = _newFact("MC_ROLL_I",     "Roll I gain");
+    Fact* mcRollD   = _newFact("MC_ROLL_D",     "Roll D gain");
+
+    index.addFact(mcRollP);
+    index.addFact(mcRollP);
+    QCOMPARE(index.count(), 1);
+    QCOMPARE(index.search({ "roll" }), QList<Fact*>({ mcRollP }));
+
+    // Facts which show up later are found without rebuilding the index
+    index.addFact(mcRollI);
+    index.addFact(mcRollD);
+    QCOMPARE(index.count(), 3);
+    QCOMPARE(index.search({ "roll" }), QList<Fact*>({ mcRollD, mcRollI, mcRollP }));
+    QCOMPARE(index.search({ "_I" }),   QList<Fact*>({ mcRollI }));
+    QCOMPARE(index.search({}),         QList<Fact*>({ mcRollD, mcRollI, mcRollP }));
+
+    index.clear();
+    QCOMPARE(index.count(), 0);
+    QVERIFY(index.search({ "roll" }).isEmpty());
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class Fact;
+
+class ParameterSearchIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _prefixSearchTest      (void);
+    void _substringSearchTest   (void);
+    void _addTest               (void);
+
+private:
+    Fact* _newFact(const QString& name, const QString& shortDescription, const QString& longDescription = QString());
+};
@@ -11,6 +11,7 @@
 #include "QGCPalette.h"
 #include "QGCApplication.h"
 #include "ParameterManager.h"
+#include "SettingsFactWriter.h"
 
 #include <QQmlEngine>
 #include <QtQml>
@@ -84,7 +85,7 @@ DECLARE_SETTINGGROUP(App, "")
     // Mobile builds always use the runtime generated location for savePath.
     bool userHasModifiedSavePath = false;
 #else
-    bool userHasModifiedSavePath = !savePathFact->rawValue().toString().isEmpty() || !_nameToMetaDataMap[savePathName]->rawDefaultValue().toString().isEmpty();
+    bool userHasModifiedSavePath = !savePathFact->rawValue().toString().isEmpty() || !_metaDataForFact(savePathName)->rawDefaultValue().toString().isEmpty();
 #endif
 
     if (!userHasModifiedSavePath) {
@@ -329,6 +330,9 @@ void AppSettings::firstRunPromptIdsMarkIdAsShown(int id)
 /// prior to loading any json files.
 QLocale::Language AppSettings::_qLocaleLanguageID(void)
 {
+    // Language changes made through the Fact may not have been written out yet
+    SettingsFactWriter::instance()->flush();
+
     QSettings settings;
 
     if (settings.childKeys().contains("language")) {
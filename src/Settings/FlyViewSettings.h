@@ -29,4 +29,5 @@ public:
     DEFINE_SETTINGFACT(keepMapCenteredOnVehicle)
     DEFINE_SETTINGFACT(showSimpleCameraControl)
     DEFINE_SETTINGFACT(showObstacleDistanceOverlay)
+    DEFINE_SETTINGFACT(maxTrajectoryPoints)
 };
@@ -23,13 +23,25 @@ SettingsGroup::SettingsGroup(const QString& name, const QString& settingsGroup,
     , _settingsGroup(settingsGroup)
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+}
+
+void SettingsGroup::_loadMetaData(void)
+{
+    if (!_metaDataLoaded) {
+        _nameToMetaDataMap = FactMetaData::createMapFromJsonFile(QString(kJsonFile).arg(_name), this);
+        _metaDataLoaded = true;
+    }
+}
 
-    _nameToMetaDataMap = FactMetaData::createMapFromJsonFile(QString(kJsonFile).arg(name), this);
+FactMetaData* SettingsGroup::_metaDataForFact(const QString& factName)
+{
+    _loadMetaData();
+    return _nameToMetaDataMap.value(factName, nullptr);
 }
 
 SettingsFact* SettingsGroup::_createSettingsFact(const QString& factName)
 {
-    FactMetaData* m = _nameToMetaDataMap[factName];
+    FactMetaData* m = _metaDataForFact(factName);
     if(!m) {
         qCritical() << "Fact name " << factName << "not found in" << QString(kJsonFile).arg(_name);
         exit(-1);
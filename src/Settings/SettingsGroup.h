@@ -70,11 +70,16 @@ signals:
 
 protected:
     SettingsFact*   _createSettingsFact(const QString& factName);
+    FactMetaData*   _metaDataForFact   (const QString& factName);
     bool            _visible;
     QString         _name;
     QString         _settingsGroup;
 
-    QMap<QString, FactMetaData*> _nameToMetaDataMap;
+private:
+    void            _loadMetaData      (void);
+
+    bool                            _metaDataLoaded = false;    ///< Meta data json is not loaded until the first fact is requested
+    QMap<QString, FactMetaData*>    _nameToMetaDataMap;
 };
 
 #endif
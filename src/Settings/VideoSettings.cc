@@ -67,7 +67,7 @@ DECLARE_SETTINGGROUP(Video, "Video")
         videoSourceCookedList.append( VideoSettings::tr(videoSource.toString().toStdString().c_str()) );
     }
 
-    _nameToMetaDataMap[videoSourceName]->setEnumInfo(videoSourceCookedList, videoSourceList);
+    _metaDataForFact(videoSourceName)->setEnumInfo(videoSourceCookedList, videoSourceList);
 
     const QVariantList removeForceVideoDecodeList{
 #ifdef Q_OS_LINUX
@@ -85,7 +85,7 @@ DECLARE_SETTINGGROUP(Video, "Video")
     };
 
     for(const auto& value : removeForceVideoDecodeList) {
-        _nameToMetaDataMap[forceVideoDecoderName]->removeEnumInfo(value);
+        _metaDataForFact(forceVideoDecoderName)->removeEnumInfo(value);
     }
 
     // Set default value for videoSource
@@ -95,9 +95,9 @@ DECLARE_SETTINGGROUP(Video, "Video")
 void VideoSettings::_setDefaults()
 {
     if (_noVideo) {
-        _nameToMetaDataMap[videoSourceName]->setRawDefaultValue(videoSourceNoVideo);
+        _metaDataForFact(videoSourceName)->setRawDefaultValue(videoSourceNoVideo);
     } else {
-        _nameToMetaDataMap[videoSourceName]->setRawDefaultValue(videoDisabled);
+        _metaDataForFact(videoSourceName)->setRawDefaultValue(videoDisabled);
     }
 }
 
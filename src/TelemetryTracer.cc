@@ -0,0 +1,378 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTracer.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QtAlgorithms>
+#include <QtMath>
+
+#include <limits>
+#include <memory>
+#include <vector>
+#include <string.h>
+
+std::atomic<bool> TelemetryTracer::_enabled(false);
+
+//-----------------------------------------------------------------------------
+// TraceHistogram
+
+int TraceHistogram::bucketIndex(quint64 value)
+{
+    if (value < static_cast<quint64>(subBucketCount)) {
+        return static_cast<int>(value);
+    }
+
+    const int msb   = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+    const int shift = msb - subBucketBits;
+    const int sub   = static_cast<int>((value >> shift) & (subBucketCount - 1));
+
+    return ((msb - subBucketBits + 1) * subBucketCount) + sub;
+}
+
+quint64 TraceHistogram::bucketLowerBound(int index)
+{
+    if (index < subBucketCount) {
+        return static_cast<quint64>(index);
+    }
+
+    const int msb = (index / subBucketCount) - 1 + subBucketBits;
+    const int sub = index % subBucketCount;
+
+    return static_cast<quint64>(subBucketCount + sub) << (msb - subBucketBits);
+}
+
+void TraceHistogram::record(quint64 value)
+{
+    _buckets[bucketIndex(value)]++;
+    _count++;
+    _total += value;
+    _min = qMin(_min, value);
+    _max = qMax(_max, value);
+}
+
+void TraceHistogram::merge(const TraceHistogram& other)
+{
+    if (other._count == 0) {
+        return;
+    }
+    for (int i=0; i<bucketCount; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count  += other._count;
+    _total  += other._total;
+    _min    = qMin(_min, other._min);
+    _max    = qMax(_max, other._max);
+}
+
+void TraceHistogram::reset(void)
+{
+    memset(_buckets, 0, sizeof(_buckets));
+    _count  = 0;
+    _total  = 0;
+    _min    = std::numeric_limits<quint64>::max();
+    _max    = 0;
+}
+
+quint64 TraceHistogram::valueAtPercentile(double percentile) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+
+    const quint64 target = qMax(static_cast<quint64>(1), static_cast<quint64>(qCeil((qBound(0.0, percentile, 100.0) / 100.0) * _count)));
+
+    quint64 cumulative = 0;
+    for (int i=0; i<bucketCount; i++) {
+        cumulative += _buckets[i];
+        if (cumulative >= target) {
+            const quint64 upperBound = i + 1 < bucketCount ? bucketLowerBound(i + 1) - 1 : std::numeric_limits<quint64>::max();
+            return qMin(upperBound, _max);
+        }
+    }
+    return _max;
+}
+
+//-----------------------------------------------------------------------------
+// Per thread buffers
+
+namespace {
+
+struct TraceEvent_t {
+    qint64  startNsecs;
+    qint64  durationNsecs;
+    quint32 arg;
+    quint8  stage;
+};
+
+/// Written only by the owning thread. The mutex is uncontended except while statistics or a trace are being collected.
+struct ThreadBuffer_t {
+    QMutex                  mutex;
+    int                     tid         = 0;
+    QString                 threadName;
+    bool                    orphaned    = false;    ///< Owning thread has exited
+    TraceHistogram          histograms[TelemetryTracer::StageCount];
+    QVector<TraceEvent_t>   events;
+    int                     nextEvent   = 0;
+    bool                    wrapped     = false;
+
+    void clear(void) {
+        for (TraceHistogram& histogram: histograms) {
+            histogram.reset();
+        }
+        nextEvent   = 0;
+        wrapped     = false;
+    }
+};
+
+struct Registry_t {
+    QMutex                                          mutex;
+    std::vector<std::unique_ptr<ThreadBuffer_t>>    buffers;
+    int                                             nextTid = 1;
+};
+
+Registry_t& registry(void)
+{
+    static Registry_t registry;
+    return registry;
+}
+
+/// Marks the buffer as orphaned when the owning thread exits so reset() can release it
+struct ThreadBufferHolder_t {
+    ThreadBuffer_t* buffer = nullptr;
+
+    ~ThreadBufferHolder_t() {
+        if (buffer) {
+            QMutexLocker locker(&buffer->mutex);
+            buffer->orphaned = true;
+        }
+    }
+};
+
+thread_local ThreadBufferHolder_t   threadBufferHolder;
+thread_local qint64                 threadOriginNsecs = 0;
+
+ThreadBuffer_t* threadBuffer(void)
+{
+    if (!threadBufferHolder.buffer) {
+        Registry_t& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+
+        std::unique_ptr<ThreadBuffer_t> buffer(new ThreadBuffer_t);
+        buffer->tid = reg.nextTid++;
+        buffer->events.resize(TelemetryTracer::eventBufferSize);
+
+        QThread* thread = QThread::currentThread();
+        buffer->threadName = thread->objectName();
+        if (buffer->threadName.isEmpty()) {
+            if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+                buffer->threadName = QStringLiteral("Main");
+            } else {
+                buffer->threadName = QStringLiteral("%1 %2").arg(thread->metaObject()->className()).arg(buffer->tid);
+            }
+        }
+
+        threadBufferHolder.buffer = buffer.get();
+        reg.buffers.push_back(std::move(buffer));
+    }
+    return threadBufferHolder.buffer;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+// TelemetryTracer
+
+void TelemetryTracer::setEnabled(bool enabled)
+{
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 TelemetryTracer::nowNsecs(void)
+{
+    static const QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    // Never return 0 since Scope uses it to mean not started
+    return clock.nsecsElapsed() + 1;
+}
+
+void TelemetryTracer::record(Stage_t stage, qint64 startNsecs, qint64 durationNsecs, quint32 arg)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    ThreadBuffer_t* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+
+    buffer->histograms[stage].record(static_cast<quint64>(qMax(static_cast<qint64>(0), durationNsecs)));
+
+    TraceEvent_t& event     = buffer->events[buffer->nextEvent];
+    event.startNsecs        = startNsecs;
+    event.durationNsecs     = durationNsecs;
+    event.arg               = arg;
+    event.stage             = static_cast<quint8>(stage);
+    if (++buffer->nextEvent == eventBufferSize) {
+        buffer->nextEvent   = 0;
+        buffer->wrapped     = true;
+    }
+}
+
+qint64 TelemetryTracer::originNsecs(void)
+{
+    return threadOriginNsecs;
+}
+
+void TelemetryTracer::setOriginNsecs(qint64 originNsecs)
+{
+    threadOriginNsecs = originNsecs;
+}
+
+void TelemetryTracer::recordEndToEnd(qint64 originNsecs)
+{
+    if (originNsecs && enabled()) {
+        record(StageEndToEnd, originNsecs, nowNsecs() - originNsecs);
+    }
+}
+
+void TelemetryTracer::reset(void)
+{
+    Registry_t& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    auto it = reg.buffers.begin();
+    while (it != reg.buffers.end()) {
+        ThreadBuffer_t* buffer = it->get();
+        buffer->mutex.lock();
+        if (buffer->orphaned) {
+            buffer->mutex.unlock();
+            it = reg.buffers.erase(it);
+        } else {
+            buffer->clear();
+            buffer->mutex.unlock();
+            it++;
+        }
+    }
+}
+
+TraceHistogram TelemetryTracer::histogram(Stage_t stage)
+{
+    TraceHistogram merged;
+
+    Registry_t& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const std::unique_ptr<ThreadBuffer_t>& buffer: reg.buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        merged.merge(buffer->histograms[stage]);
+    }
+
+    return merged;
+}
+
+QVariantList TelemetryTracer::stageStatistics(void)
+{
+    const double nsecsPerMsec = 1000000.0;
+
+    QVariantList rgStages;
+    for (int stage=0; stage<StageCount; stage++) {
+        TraceHistogram merged = histogram(static_cast<Stage_t>(stage));
+
+        QVariantMap stageMap;
+        stageMap[QStringLiteral("name")]    = stageName(static_cast<Stage_t>(stage));
+        stageMap[QStringLiteral("count")]   = merged.count();
+        stageMap[QStringLiteral("minMs")]   = merged.min() / nsecsPerMsec;
+        stageMap[QStringLiteral("meanMs")]  = merged.mean() / nsecsPerMsec;
+        stageMap[QStringLiteral("p50Ms")]   = merged.valueAtPercentile(50) / nsecsPerMsec;
+        stageMap[QStringLiteral("p90Ms")]   = merged.valueAtPercentile(90) / nsecsPerMsec;
+        stageMap[QStringLiteral("p99Ms")]   = merged.valueAtPercentile(99) / nsecsPerMsec;
+        stageMap[QStringLiteral("p999Ms")]  = merged.valueAtPercentile(99.9) / nsecsPerMsec;
+        stageMap[QStringLiteral("maxMs")]   = merged.max() / nsecsPerMsec;
+        rgStages.append(stageMap);
+    }
+
+    return rgStages;
+}
+
+QByteArray TelemetryTracer::chromeTraceJson(void)
+{
+    QJsonArray rgTraceEvents;
+
+    Registry_t& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const std::unique_ptr<ThreadBuffer_t>& buffer: reg.buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+
+        QJsonObject threadNameEvent;
+        threadNameEvent["name"] = "thread_name";
+        threadNameEvent["ph"]   = "M";
+        threadNameEvent["pid"]  = 1;
+        threadNameEvent["tid"]  = buffer->tid;
+        threadNameEvent["args"] = QJsonObject({ { "name", buffer->threadName } });
+        rgTraceEvents.append(threadNameEvent);
+
+        const int eventCount = buffer->wrapped ? static_cast<int>(eventBufferSize) : buffer->nextEvent;
+        const int firstEvent = buffer->wrapped ? buffer->nextEvent : 0;
+        for (int i=0; i<eventCount; i++) {
+            const TraceEvent_t& event = buffer->events[(firstEvent + i) % eventBufferSize];
+            const Stage_t       stage = static_cast<Stage_t>(event.stage);
+
+            QJsonObject traceEvent;
+            traceEvent["name"]  = stageName(stage);
+            traceEvent["cat"]   = "telemetry";
+            traceEvent["ph"]    = "X";
+            traceEvent["pid"]   = 1;
+            traceEvent["tid"]   = buffer->tid;
+            traceEvent["ts"]    = event.startNsecs / 1000.0;
+            traceEvent["dur"]   = event.durationNsecs / 1000.0;
+            if (stage == StageLinkQueue || stage == StageProtocolReceive) {
+                traceEvent["args"] = QJsonObject({ { "bytes", static_cast<qint64>(event.arg) } });
+            } else if (stage == StageVehicleMessage || stage == StageFactGroupFanOut) {
+                traceEvent["args"] = QJsonObject({ { "msgid", static_cast<qint64>(event.arg) } });
+            }
+            rgTraceEvents.append(traceEvent);
+        }
+    }
+
+    QJsonObject jsonRoot;
+    jsonRoot["traceEvents"]     = rgTraceEvents;
+    jsonRoot["displayTimeUnit"] = "ns";
+
+    return QJsonDocument(jsonRoot).toJson(QJsonDocument::Compact);
+}
+
+QString TelemetryTracer::stageName(Stage_t stage)
+{
+    switch (stage) {
+    case StageLinkQueue:
+        return tr("Link Queue");
+    case StageProtocolReceive:
+        return tr("Protocol Receive");
+    case StageVehicleMessage:
+        return tr("Vehicle Message");
+    case StageFactGroupFanOut:
+        return tr("FactGroup Fan Out");
+    case StageFactValueChanged:
+        return tr("Fact Value Changed");
+    case StageEndToEnd:
+        return tr("End To End");
+    case StageCount:
+        break;
+    }
+    return QString();
+}
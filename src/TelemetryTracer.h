@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QVariantList>
+#include <QCoreApplication>
+
+#include <atomic>
+
+/// Log-linear latency histogram in the style of HdrHistogram. Each power of two range is split into
+/// 16 linear sub buckets which bounds the relative error of any reported value to ~6% while covering
+/// the full 64 bit nanosecond range in a fixed, allocation free table.
+class TraceHistogram
+{
+public:
+    TraceHistogram(void) { reset(); }
+
+    void    record      (quint64 value);
+    void    merge       (const TraceHistogram& other);
+    void    reset       (void);
+
+    quint64 count       (void) const { return _count; }
+    quint64 min         (void) const { return _count ? _min : 0; }
+    quint64 max         (void) const { return _max; }
+    double  mean        (void) const { return _count ? static_cast<double>(_total) / _count : 0; }
+
+    /// @param percentile 0.0 - 100.0
+    /// @return Upper bound of the bucket which contains the specified percentile, 0 if empty
+    quint64 valueAtPercentile(double percentile) const;
+
+    static int      bucketIndex     (quint64 value);
+    static quint64  bucketLowerBound(int index);
+
+    static const int subBucketBits  = 4;
+    static const int subBucketCount = 1 << subBucketBits;
+    static const int bucketCount    = (64 - subBucketBits + 1) * subBucketCount;
+
+private:
+    quint64 _buckets[bucketCount];
+    quint64 _count;
+    quint64 _total;
+    quint64 _min;
+    quint64 _max;
+};
+
+/// Low overhead tracing of the telemetry receive path:
+///     link bytesReceived -> MAVLinkProtocol::receiveBytes -> Vehicle::_mavlinkMessageReceived -> FactGroup::handleMessage -> Fact::valueChanged
+///
+/// Tracing is off by default and is toggled at runtime through LinkManager::setTelemetryTracingEnabled, which also connects
+/// the link side timing of bytesReceived only while tracing is on. When off each trace point costs a single relaxed atomic load.
+/// When on, every thread records into its own buffer (per stage histograms plus a ring of recent events) so trace points
+/// never contend with each other. Buffers are only read when statistics or a Chrome trace are requested.
+///
+/// Durations recorded for nested stages are inclusive of the stages below them.
+class TelemetryTracer
+{
+    Q_DECLARE_TR_FUNCTIONS(TelemetryTracer)
+
+public:
+    typedef enum {
+        StageLinkQueue,             ///< Link emitting bytesReceived to MAVLinkProtocol::receiveBytes starting (cross thread queue wait)
+        StageProtocolReceive,       ///< MAVLinkProtocol::receiveBytes, parse plus synchronous message dispatch
+        StageVehicleMessage,        ///< Vehicle::_mavlinkMessageReceived
+        StageFactGroupFanOut,       ///< FactGroup::handleMessage calls for a single message
+        StageFactValueChanged,      ///< Fact::valueChanged emit, includes all connected slots and QML bindings
+        StageEndToEnd,              ///< Bytes arriving at the link to the resulting Fact::valueChanged
+        StageCount
+    } Stage_t;
+
+    static bool enabled(void) { return _enabled.load(std::memory_order_relaxed); }
+
+    /// @return Monotonic time in nanoseconds used for all trace timestamps
+    static qint64 nowNsecs(void);
+
+    /// Records a completed stage on the calling thread
+    ///     @param arg Stage specific value shown in the trace: byte count for link/protocol stages, message id for vehicle/fact group stages
+    static void record(Stage_t stage, qint64 startNsecs, qint64 durationNsecs, quint32 arg = 0);
+
+    /// Time at which the bytes currently being processed on this thread arrived at the link, 0 if none.
+    /// Set by MAVLinkProtocol::receiveBytes for the duration of the synchronous dispatch.
+    static qint64   originNsecs     (void);
+    static void     setOriginNsecs  (qint64 originNsecs);
+
+    /// Records the end to end latency from the specified origin
+    ///     @param originNsecs Usually originNsecs(), may be a saved origin for deferred updates. 0 records nothing.
+    static void recordEndToEnd(qint64 originNsecs);
+
+    /// Clears all histograms and events and releases buffers of threads which have exited
+    static void reset(void);
+
+    /// @return One entry per stage: name, count, minMs, meanMs, p50Ms, p90Ms, p99Ms, p999Ms, maxMs
+    static QVariantList stageStatistics(void);
+
+    /// @return Merged histogram for the stage across all threads
+    static TraceHistogram histogram(Stage_t stage);
+
+    /// @return Buffered events in Chrome trace event format (chrome://tracing, Perfetto)
+    static QByteArray chromeTraceJson(void);
+
+    static QString stageName(Stage_t stage);
+
+    /// Times a scope and records it as the specified stage. Does nothing if tracing was disabled when the scope was entered.
+    class Scope
+    {
+    public:
+        Scope(Stage_t stage, quint32 arg = 0)
+            : _stage        (stage)
+            , _arg          (arg)
+            , _startNsecs   (TelemetryTracer::enabled() ? TelemetryTracer::nowNsecs() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (_startNsecs) {
+                TelemetryTracer::record(_stage, _startNsecs, TelemetryTracer::nowNsecs() - _startNsecs, _arg);
+            }
+        }
+
+        void setArg(quint32 arg) { _arg = arg; }
+
+    private:
+        Stage_t _stage;
+        quint32 _arg;
+        qint64  _startNsecs;
+    };
+
+    static const int eventBufferSize = 8192;    ///< Events retained per thread for trace export
+
+private:
+    /// Only LinkManager::setTelemetryTracingEnabled may toggle tracing, so the link side timing always follows it
+    static void setEnabled(bool enabled);
+
+    static std::atomic<bool> _enabled;
+
+    friend class LinkManager;
+    friend class TelemetryTracerTest;   // Unit test
+};
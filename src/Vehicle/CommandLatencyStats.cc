@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CommandLatencyStats.h"
+
+#include <QtMath>
+
+CommandLatencyStats::CommandLatencyStats(void)
+    : _sampleCount  (0)
+    , _srttMSecs    (0)
+    , _rttVarMSecs  (0)
+    , _minRttMSecs  (0)
+    , _maxRttMSecs  (0)
+    , _histogram    (bucketLimitsMSecs().count() + 1, 0)
+{
+
+}
+
+const QVector<int>& CommandLatencyStats::bucketLimitsMSecs(void)
+{
+    static const QVector<int> limits = { 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+    return limits;
+}
+
+void CommandLatencyStats::addSample(int rttMSecs)
+{
+    rttMSecs = qMax(0, rttMSecs);
+
+    if (_sampleCount == 0) {
+        _srttMSecs      = rttMSecs;
+        _rttVarMSecs    = rttMSecs / 2.0;
+        _minRttMSecs    = rttMSecs;
+        _maxRttMSecs    = rttMSecs;
+    } else {
+        _rttVarMSecs    = ((1.0 - _beta) * _rttVarMSecs) + (_beta * qAbs(_srttMSecs - rttMSecs));
+        _srttMSecs      = ((1.0 - _alpha) * _srttMSecs) + (_alpha * rttMSecs);
+        _minRttMSecs    = qMin(_minRttMSecs, rttMSecs);
+        _maxRttMSecs    = qMax(_maxRttMSecs, rttMSecs);
+    }
+    _sampleCount++;
+
+    const QVector<int>& limits = bucketLimitsMSecs();
+    int bucket = 0;
+    while (bucket < limits.count() && rttMSecs >= limits[bucket]) {
+        bucket++;
+    }
+    _histogram[bucket]++;
+}
+
+int CommandLatencyStats::ackTimeoutMSecs(int defaultMSecs, int minMSecs, int maxMSecs) const
+{
+    if (_sampleCount == 0) {
+        return defaultMSecs;
+    }
+    const int timeout = qCeil(_srttMSecs + (_k * _rttVarMSecs));
+    return qBound(minMSecs, timeout, maxMSecs);
+}
+
+QVariantMap CommandLatencyStats::toVariantMap(void) const
+{
+    QVariantList histogram;
+    for (int count: _histogram) {
+        histogram.append(count);
+    }
+    QVariantList limits;
+    for (int limit: bucketLimitsMSecs()) {
+        limits.append(limit);
+    }
+
+    QVariantMap map;
+    map["samples"]          = _sampleCount;
+    map["srttMSecs"]        = _srttMSecs;
+    map["rttVarMSecs"]      = _rttVarMSecs;
+    map["minMSecs"]         = _minRttMSecs;
+    map["maxMSecs"]         = _maxRttMSecs;
+    map["bucketLimitsMSecs"]= limits;
+    map["histogram"]        = histogram;
+    return map;
+}
@@ -0,0 +1,49 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVariantMap>
+#include <QVector>
+
+/// Round trip time statistics for COMMAND_LONG/COMMAND_INT to COMMAND_ACK on a single link. The smoothed estimate
+/// uses the TCP retransmit timer algorithm (RFC 6298) and a fixed bucket histogram is kept for diagnostics.
+class CommandLatencyStats
+{
+public:
+    CommandLatencyStats(void);
+
+    void addSample(int rttMSecs);
+
+    int     sampleCount         (void) const { return _sampleCount; }
+    double  smoothedRttMSecs    (void) const { return _srttMSecs; }
+    double  rttVarianceMSecs    (void) const { return _rttVarMSecs; }
+
+    /// @return Ack timeout derived from the RTT estimate, defaultMSecs if there are no samples yet
+    int ackTimeoutMSecs(int defaultMSecs, int minMSecs, int maxMSecs) const;
+
+    /// @return Sample counts per bucket. Bucket i counts samples below bucketLimitsMSecs()[i], the last bucket counts everything above.
+    const QVector<int>& histogram(void) const { return _histogram; }
+
+    static const QVector<int>& bucketLimitsMSecs(void);
+
+    QVariantMap toVariantMap(void) const;
+
+private:
+    int             _sampleCount;
+    double          _srttMSecs;
+    double          _rttVarMSecs;
+    int             _minRttMSecs;
+    int             _maxRttMSecs;
+    QVector<int>    _histogram;
+
+    static constexpr double _alpha  = 1.0 / 8.0;
+    static constexpr double _beta   = 1.0 / 4.0;
+    static const int        _k      = 4;
+};
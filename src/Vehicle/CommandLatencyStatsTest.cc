@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CommandLatencyStatsTest.h"
+#include "CommandLatencyStats.h"
+
+void CommandLatencyStatsTest::_firstSampleTest(void)
+{
+    CommandLatencyStats stats;
+
+    // No estimate yet
+    QCOMPARE(stats.sampleCount(), 0);
+    QCOMPARE(stats.ackTimeoutMSecs(1200, 100, 5000), 1200);
+
+    // RFC 6298 2.2: SRTT = R, RTTVAR = R/2
+    stats.addSample(100);
+    QCOMPARE(stats.sampleCount(), 1);
+    QCOMPARE(stats.smoothedRttMSecs(), 100.0);
+    QCOMPARE(stats.rttVarianceMSecs(), 50.0);
+    // RTO = SRTT + 4 * RTTVAR
+    QCOMPARE(stats.ackTimeoutMSecs(1200, 100, 5000), 300);
+
+    const QVariantMap map = stats.toVariantMap();
+    QCOMPARE(map["minMSecs"].toInt(), 100);
+    QCOMPARE(map["maxMSecs"].toInt(), 100);
+}
+
+void CommandLatencyStatsTest::_laterSamplesTest(void)
+{
+    CommandLatencyStats stats;
+
+    // RFC 6298 2.3: RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|, then SRTT = 7/8 * SRTT + 1/8 * R
+    stats.addSample(100);
+    stats.addSample(200);
+    QCOMPARE(stats.rttVarianceMSecs(), 62.5);
+    QCOMPARE(stats.smoothedRttMSecs(), 112.5);
+    QCOMPARE(stats.ackTimeoutMSecs(1200, 100, 5000), 363);
+
+    // RTTVAR must be updated with the previous SRTT
+    stats.addSample(40);
+    QCOMPARE(stats.rttVarianceMSecs(), (0.75 * 62.5) + (0.25 * 72.5));
+    QCOMPARE(stats.smoothedRttMSecs(), (0.875 * 112.5) + (0.125 * 40));
+    QCOMPARE(stats.sampleCount(), 3);
+
+    const QVariantMap map = stats.toVariantMap();
+    QCOMPARE(map["samples"].toInt(), 3);
+    QCOMPARE(map["minMSecs"].toInt(), 40);
+    QCOMPARE(map["maxMSecs"].toInt(), 200);
+
+    // Negative elapsed times are treated as zero
+    stats.addSample(-5);
+    QCOMPARE(stats.toVariantMap()["minMSecs"].toInt(), 0);
+}
+
+void CommandLatencyStatsTest::_timeoutClampTest(void)
+{
+    CommandLatencyStats fastStats;
+    fastStats.addSample(2);
+    QCOMPARE(fastStats.ackTimeoutMSecs(1200, 100, 5000), 100);
+
+    CommandLatencyStats slowStats;
+    slowStats.addSample(4000);
+    QCOMPARE(slowStats.ackTimeoutMSecs(1200, 100, 5000), 5000);
+
+    // Fractional estimates round up so the timeout is never shorter than the estimate
+    CommandLatencyStats roundStats;
+    roundStats.addSample(101);
+    roundStats.addSample(100);
+    // 100.875 + 4 * 38.125 = 253.375
+    QCOMPARE(roundStats.ackTimeoutMSecs(1200, 100, 5000), 254);
+}
+
+void CommandLatencyStatsTest::_histogramTest(void)
+{
+    CommandLatencyStats stats;
+    const QVector<int>& limits = CommandLatencyStats::bucketLimitsMSecs();
+
+    QCOMPARE(stats.histogram().count(), limits.count() + 1);
+
+    // Bucket limits are exclusive upper bounds, the last bucket takes everything above the highest limit
+    stats.addSample(0);
+    stats.addSample(limits[0] - 1);
+    stats.addSample(limits[0]);
+    stats.addSample(limits.last());
+    stats.addSample(limits.last() * 10);
+
+    QCOMPARE(stats.histogram()[0], 2);
+    QCOMPARE(stats.histogram()[1], 1);
+    QCOMPARE(stats.histogram()[limits.count()], 2);
+
+    int total = 0;
+    for (int count: stats.histogram()) {
+        total += count;
+    }
+    QCOMPARE(total, stats.sampleCount());
+}
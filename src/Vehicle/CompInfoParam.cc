@@ -83,6 +83,72 @@ void CompInfoParam::setJson(const QString& metadataJsonFileName, const QString&
             _nameToMetaDataMap[newMetaData->name()] = newMetaData;
         }
     }
+
+    _buildIndexedNameRegex();
+}
+
+/// Compiles all of the indexed names into a single anchored regex of the form ^(?:NAME_A(\d+)_X|NAME_B(\d+)|...)$.
+/// This way looking up a parameter name is a single match instead of compiling and matching a regex per indexed name.
+void CompInfoParam::_buildIndexedNameRegex(void)
+{
+    if (_indexedNameMetaDataList.isEmpty()) {
+        _indexedNameRegex = QRegularExpression();
+        return;
+    }
+
+    // Alternation is ordered from last to first. This matches the previous behavior where a later indexed name wins
+    // if more than one matches.
+    QStringList rgAlternatives;
+    for (int i=_indexedNameMetaDataList.count()-1; i>=0; i--) {
+        QStringList rgLiteralParts = _indexedNameMetaDataList[i].first.split(_indexedNameTag);
+        for (QString& literalPart: rgLiteralParts) {
+            literalPart = QRegularExpression::escape(literalPart);
+        }
+        // Only the first index is captured, additional indices are matched but not used
+        QString alternative = rgLiteralParts.takeFirst() + QStringLiteral("(\\d+)");
+        alternative += rgLiteralParts.join(QStringLiteral("(?:\\d+)"));
+        rgAlternatives.append(alternative);
+    }
+
+    _indexedNameRegex = QRegularExpression(QStringLiteral("^(?:%1)$").arg(rgAlternatives.join('|')));
+    _indexedNameRegex.optimize();
+    if (!_indexedNameRegex.isValid()) {
+        qCWarning(CompInfoParamLog) << "Indexed name regex is invalid" << _indexedNameRegex.errorString();
+    }
+}
+
+/// @return Newly created meta data for the matching indexed name, nullptr for no match
+FactMetaData* CompInfoParam::_indexedNameMetaData(const QString& name)
+{
+    if (_indexedNameMetaDataList.isEmpty() || !_indexedNameRegex.isValid()) {
+        return nullptr;
+    }
+
+    QRegularExpressionMatch match = _indexedNameRegex.match(name);
+    if (!match.hasMatch()) {
+        return nullptr;
+    }
+
+    for (int captureIndex=1; captureIndex<=_indexedNameMetaDataList.count(); captureIndex++) {
+        if (match.capturedStart(captureIndex) != -1) {
+            const RegexFactMetaDataPair_t&  pair    = _indexedNameMetaDataList[_indexedNameMetaDataList.count() - captureIndex];
+            QString                         index   = match.captured(captureIndex);
+
+            FactMetaData* factMetaData = new FactMetaData(*pair.second, this);
+            factMetaData->setName(name);
+
+            QString shortDescription = factMetaData->shortDescription();
+            shortDescription.replace(_indexedNameTag, index);
+            factMetaData->setShortDescription(shortDescription);
+            QString longDescription = factMetaData->shortDescription();
+            longDescription.replace(_indexedNameTag, index);
+            factMetaData->setLongDescription(longDescription);
+
+            return factMetaData;
+        }
+    }
+
+    return nullptr;
 }
 
 FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaData::ValueType_t type)
@@ -101,29 +167,7 @@ FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaDa
             factMetaData = _nameToMetaDataMap[name];
         } else {
             // We didn't get any direct matches. Try an indexed name.
-            for (int i=0; i<_indexedNameMetaDataList.count(); i++) {
-                const RegexFactMetaDataPair_t& pair = _indexedNameMetaDataList[i];
-
-                QString indexedName = pair.first;
-                QString indexedRegex("(\\d+)");
-                indexedName.replace(_indexedNameTag, indexedRegex);
-
-                QRegularExpression      regex(indexedName);
-                QRegularExpressionMatch match = regex.match(name);
-
-                QStringList captured = match.capturedTexts();
-                if (captured.count() == 2) {
-                    factMetaData = new FactMetaData(*pair.second, this);
-                    factMetaData->setName(name);
-
-                    QString shortDescription = factMetaData->shortDescription();
-                    shortDescription.replace(_indexedNameTag, captured[1]);
-                    factMetaData->setShortDescription(shortDescription);
-                    QString longDescription = factMetaData->shortDescription();
-                    longDescription.replace(_indexedNameTag, captured[1]);
-                    factMetaData->setLongDescription(longDescription);
-                }
-            }
+            factMetaData = _indexedNameMetaData(name);
 
             if (!factMetaData) {
                 factMetaData = new FactMetaData(type, this);
@@ -135,6 +179,7 @@ FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaDa
                     factMetaData->setCategory(tr("Component %1").arg(compId));
                 }
             }
+            // Both indexed matches and misses are remembered so each name only goes through the regex once
             _nameToMetaDataMap[name] = factMetaData;
         }
     }
@@ -15,6 +15,7 @@
 #include "FactMetaData.h"
 
 #include <QObject>
+#include <QRegularExpression>
 
 class FactMetaData;
 class Vehicle;
@@ -41,12 +42,15 @@ private:
 
     static FirmwarePlugin*  _anyVehicleTypeFirmwarePlugin   (MAV_AUTOPILOT firmwareType);
     static QString          _parameterMetaDataFile          (Vehicle* vehicle, MAV_AUTOPILOT firmwareType, int& majorVersion, int& minorVersion);
+    void                    _buildIndexedNameRegex          (void);
+    FactMetaData*           _indexedNameMetaData            (const QString& name);
 
     typedef QPair<QString /* indexed name */, FactMetaData*> RegexFactMetaDataPair_t;
 
     bool                                _noJsonMetadata             = true;
     FactMetaData::NameToMetaDataMap_t   _nameToMetaDataMap;
     QList<RegexFactMetaDataPair_t>      _indexedNameMetaDataList;
+    QRegularExpression                  _indexedNameRegex;          ///< All indexed names combined into a single regex, alternatives are in reverse list order so capture group i is _indexedNameMetaDataList[count - i]
     QObject*                            _opaqueParameterMetaData    = nullptr;
 
     static const char* _cachedMetaDataFilePrefix;
@@ -20,6 +20,7 @@
 #include "QGCApplication.h"
 
 #include <QStandardPaths>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonArray>
 
@@ -313,6 +314,11 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileNa
 {
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadComplete fileName:errorMsg" << fileName << errorMsg;
 
+    if (QFileInfo(fileName).fileName() != _currentFtpFileName) {
+        // Completion of some other queued FTP download
+        return;
+    }
+
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::commandProgress, this, &RequestMetaDataTypeStateMachine::_ftpDownloadProgress);
     if (errorMsg.isEmpty()) {
@@ -371,6 +377,7 @@ void RequestMetaDataTypeStateMachine::_requestFile(const QString& cacheFileTag,
         if (cachedFile.isEmpty()) {
             qCDebug(ComponentInformationManagerLog) << "Downloading json" << uri;
             if (_uriIsMAVLinkFTP(uri)) {
+                _currentFtpFileName = QFileInfo(uri).fileName();
                 connect(ftpManager, &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
                 if (ftpManager->download(uri, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
                     _downloadStartTime.start();
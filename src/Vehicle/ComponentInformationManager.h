@@ -66,6 +66,7 @@ private:
     QString*                        _currentFileName            = nullptr;
     QString                         _currentCacheFileTag;
     bool                            _currentFileValidCrc        = false;
+    QString                         _currentFtpFileName;                ///< File name of the FTP download we are waiting for
 
     QElapsedTimer                   _downloadStartTime;
 
@@ -14,6 +14,7 @@
 #include "QGCApplication.h"
 
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
 #include <string>
 
@@ -34,15 +35,81 @@ FTPManager::FTPManager(Vehicle* vehicle)
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
-bool FTPManager::download(const QString& fromURI, const QString& toDir)
+bool FTPManager::download(const QString& fromURI, const QString& toDir, bool skipIfUnchanged)
 {
-    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir;
+    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "skipIfUnchanged:" << skipIfUnchanged;
 
-    if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
+    return _queueOperation(OperationDownload, fromURI, toDir, skipIfUnchanged);
+}
+
+bool FTPManager::upload(const QString& toURI, const QString& fromFile)
+{
+    qCDebug(FTPManagerLog) << "upload fromFile:" << fromFile << "to:" << toURI;
+
+    if (!QFileInfo(fromFile).isFile()) {
+        qCWarning(FTPManagerLog) << "upload file does not exist" << fromFile;
         return false;
     }
 
+    return _queueOperation(OperationUpload, toURI, fromFile, false /* skipIfUnchanged */);
+}
+
+bool FTPManager::listDirectory(const QString& dirURI)
+{
+    qCDebug(FTPManagerLog) << "listDirectory dirURI:" << dirURI;
+
+    return _queueOperation(OperationListDirectory, dirURI, QString(), false /* skipIfUnchanged */);
+}
+
+bool FTPManager::_queueOperation(Operation_t operation, const QString& uri, const QString& localPath, bool skipIfUnchanged)
+{
+    QueuedOperation_t queuedOperation;
+
+    queuedOperation.operation       = operation;
+    queuedOperation.localPath       = localPath;
+    queuedOperation.skipIfUnchanged = skipIfUnchanged;
+    if (!_parseURI(uri, queuedOperation.pathOnVehicle, queuedOperation.compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    _operationQueue.enqueue(queuedOperation);
+    if (_currentOperation != OperationNone) {
+        qCDebug(FTPManagerLog) << "Operation queued behind current operation - queue depth" << _operationQueue.count();
+    }
+    _startNextOperation();
+
+    return true;
+}
+
+void FTPManager::_startNextOperation(void)
+{
+    if (_currentOperation != OperationNone || _operationQueue.isEmpty()) {
+        return;
+    }
+
+    QueuedOperation_t queuedOperation = _operationQueue.dequeue();
+
+    _currentOperation   = queuedOperation.operation;
+    _ftpCompId          = queuedOperation.compId;
+
+    switch (queuedOperation.operation) {
+    case OperationDownload:
+        _startDownload(queuedOperation);
+        break;
+    case OperationUpload:
+        _startUpload(queuedOperation);
+        break;
+    case OperationListDirectory:
+        _startListDirectory(queuedOperation);
+        break;
+    case OperationNone:
+        break;
+    }
+}
+
+void FTPManager::_startDownload(const QueuedOperation_t& queuedOperation)
+{
     static const StateFunctions_t rgDownloadStateMachine[] = {
         { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
         { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
@@ -50,45 +117,95 @@ bool FTPManager::download(const QString& fromURI, const QString& toDir)
         { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
         { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
     };
+
+    _downloadState.reset();
+    _downloadState.toDir.setPath(queuedOperation.localPath);
+    _downloadState.fullPathOnVehicle    = queuedOperation.pathOnVehicle;
+    _downloadState.fileName             = _fileNameFromPath(_downloadState.fullPathOnVehicle);
+    _downloadState.skipIfUnchanged      = queuedOperation.skipIfUnchanged;
+
+    qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
+
+    if (_downloadState.skipIfUnchanged && QFile::exists(_downloadState.toDir.filePath(_downloadState.fileName))) {
+        // Compare against the vehicle copy first, the download is skipped if nothing changed
+        _rgStateMachine.append({ &FTPManager::_calcFileCrc32Begin, &FTPManager::_calcFileCrc32AckOrNak, &FTPManager::_calcFileCrc32Timeout });
+    }
     for (size_t i=0; i<sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]); i++) {
         _rgStateMachine.append(rgDownloadStateMachine[i]);
     }
 
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
+    _startStateMachine();
+}
 
-    if (!_parseURI(fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
-        qCWarning(FTPManagerLog) << "_parseURI failed";
-        return false;
+void FTPManager::_startUpload(const QueuedOperation_t& queuedOperation)
+{
+    static const StateFunctions_t rgUploadStateMachine[] = {
+        { &FTPManager::_createFileBegin,            &FTPManager::_createFileAckOrNak,           &FTPManager::_createFileTimeout },
+        { &FTPManager::_writeFileBegin,             &FTPManager::_writeFileAckOrNak,            &FTPManager::_writeFileTimeout },
+        { &FTPManager::_terminateSessionBegin,      &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
+        { &FTPManager::_uploadCompleteNoError,      nullptr,                                    nullptr },
+    };
+
+    _uploadState.reset();
+    _uploadState.fullPathOnVehicle = queuedOperation.pathOnVehicle;
+    _uploadState.file.setFileName(queuedOperation.localPath);
+    _terminateRetryCount = 0;
+
+    if (!_uploadState.file.open(QFile::ReadOnly)) {
+        qCWarning(FTPManagerLog) << "_startUpload: open failed" << _uploadState.file.errorString();
+        _uploadComplete(tr("Upload failed: %1").arg(_uploadState.file.errorString()));
+        return;
     }
+    _uploadState.fileSize = static_cast<uint32_t>(_uploadState.file.size());
 
-    // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
-    // routines because this path does not exist locally.
-    int lastDirSlashIndex;
-    for (lastDirSlashIndex=_downloadState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
-        if (_downloadState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
-            break;
-        }
+    for (size_t i=0; i<sizeof(rgUploadStateMachine)/sizeof(rgUploadStateMachine[0]); i++) {
+        _rgStateMachine.append(rgUploadStateMachine[i]);
     }
-    lastDirSlashIndex++; // move past slash
 
-    _downloadState.fileName = _downloadState.fullPathOnVehicle.right(_downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
+    _startStateMachine();
+}
 
-    qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
+void FTPManager::_startListDirectory(const QueuedOperation_t& queuedOperation)
+{
+    static const StateFunctions_t rgListDirectoryStateMachine[] = {
+        { &FTPManager::_listDirectoryBegin,             &FTPManager::_listDirectoryAckOrNak,    &FTPManager::_listDirectoryTimeout },
+        { &FTPManager::_listDirectoryCompleteNoError,   nullptr,                                nullptr },
+    };
 
-    _startStateMachine();
+    _listDirectoryState.reset();
+    _listDirectoryState.fullPathOnVehicle = queuedOperation.pathOnVehicle;
 
-    return true;
+    for (size_t i=0; i<sizeof(rgListDirectoryStateMachine)/sizeof(rgListDirectoryStateMachine[0]); i++) {
+        _rgStateMachine.append(rgListDirectoryStateMachine[i]);
+    }
+
+    _startStateMachine();
 }
 
 void FTPManager::cancel()
 {
-    if (!_downloadState.inProgress()) {
+    switch (_currentOperation) {
+    case OperationNone:
+        return;
+    case OperationDownload:
+        if (!_downloadState.inProgress()) {
+            return;
+        }
+        break;
+    case OperationUpload:
+        if (!_uploadState.inProgress()) {
+            return;
+        }
+        break;
+    case OperationListDirectory:
+        // No session to terminate
+        _listDirectoryComplete("Aborted");
         return;
     }
 
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
+    _pipelinedRequests.clear();
     static const StateFunctions_t rgTerminateStateMachine[] = {
         { &FTPManager::_terminateSessionBegin,       &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
         { &FTPManager::_terminateComplete,               nullptr,                                    nullptr },
@@ -96,14 +213,56 @@ void FTPManager::cancel()
     for (size_t i=0; i<sizeof(rgTerminateStateMachine)/sizeof(rgTerminateStateMachine[0]); i++) {
         _rgStateMachine.append(rgTerminateStateMachine[i]);
     }
-    _downloadState.retryCount = 0;
+    _terminateRetryCount = 0;
     _startStateMachine();
 }
 
+bool FTPManager::cancelDownload(const QString& fromURI, const QString& toDir)
+{
+    QString pathOnVehicle;
+    uint8_t compId;
+
+    if (!_parseURI(fromURI, pathOnVehicle, compId)) {
+        return false;
+    }
+    const QString localDir = QDir(toDir).absolutePath();
+
+    for (int i=0; i<_operationQueue.count(); i++) {
+        const QueuedOperation_t& queuedOperation = _operationQueue[i];
+        if (queuedOperation.operation == OperationDownload && queuedOperation.pathOnVehicle == pathOnVehicle &&
+                queuedOperation.compId == compId && QDir(queuedOperation.localPath).absolutePath() == localDir) {
+            qCDebug(FTPManagerLog) << "cancelDownload: removed from queue" << pathOnVehicle;
+            _operationQueue.removeAt(i);
+            return true;
+        }
+    }
+
+    if (_currentOperation != OperationDownload || _downloadState.fullPathOnVehicle != pathOnVehicle ||
+            _ftpCompId != compId || _downloadState.toDir.absolutePath() != localDir) {
+        return false;
+    }
+
+    qCDebug(FTPManagerLog) << "cancelDownload: aborting current download" << pathOnVehicle;
+    if (_downloadState.inProgress()) {
+        cancel();
+    } else {
+        // Still opening the file or comparing CRCs. The open may already have been acked by the vehicle, so reset the
+        // sessions instead of leaving a session open which the vehicle never hears about again.
+        _ackOrNakTimeoutTimer.stop();
+        _rgStateMachine.clear();
+        _pipelinedRequests.clear();
+        _rgStateMachine.append({ &FTPManager::_resetSessionsBegin,  &FTPManager::_resetSessionsAckOrNak,   &FTPManager::_resetSessionsTimeout });
+        _rgStateMachine.append({ &FTPManager::_terminateComplete,   nullptr,                                nullptr });
+        _startStateMachine();
+    }
+
+    return true;
+}
+
 void FTPManager::_terminateSessionBegin(void)
 {
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = _currentSessionId();
     request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
     _sendRequestExpectAck(&request);
 }
@@ -126,12 +285,12 @@ void FTPManager::_terminateSessionAckOrNak(const MavlinkFTP::Request *ackOrNak)
 
 void FTPManager::_terminateSessionTimeout(void)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (++_terminateRetryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(_currentOperation == OperationUpload ? tr("Upload failed") : tr("Download failed"));
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_terminateRetryCount);
         _terminateSessionBegin();
     }
 
@@ -139,7 +298,41 @@ void FTPManager::_terminateSessionTimeout(void)
 
 void FTPManager::_terminateComplete(void)
 {
-    _downloadComplete("Aborted");
+    _operationComplete("Aborted");
+}
+
+/// Completes whichever operation is currently in progress
+///     @param errorMsg Error message, empty if no error
+void FTPManager::_operationComplete(const QString& errorMsg)
+{
+    switch (_currentOperation) {
+    case OperationDownload:
+        _downloadComplete(errorMsg);
+        break;
+    case OperationUpload:
+        _uploadComplete(errorMsg);
+        break;
+    case OperationListDirectory:
+        _listDirectoryComplete(errorMsg);
+        break;
+    case OperationNone:
+        break;
+    }
+}
+
+/// Cleanup common to all operations. The next queued operation is started once the completion signal
+/// for this one has been delivered.
+void FTPManager::_finishOperation(void)
+{
+    _ackOrNakTimeoutTimer.stop();
+    _rgStateMachine.clear();
+    _pipelinedRequests.clear();
+    _currentStateMachineIndex   = -1;
+    _currentOperation           = OperationNone;
+
+    if (!_operationQueue.isEmpty()) {
+        QTimer::singleShot(0, this, &FTPManager::_startNextOperation);
+    }
 }
 
 /// Closes out a download session by writing the file and doing cleanup.
@@ -148,12 +341,9 @@ void FTPManager::_downloadComplete(const QString& errorMsg)
 {
     qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
     
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
+    QString downloadFilePath = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
 
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    _currentStateMachineIndex = -1;
+    _finishOperation();
     if (_downloadState.file.isOpen()) {
         _downloadState.file.close();
         if (!errorMsg.isEmpty()) {
@@ -164,6 +354,34 @@ void FTPManager::_downloadComplete(const QString& errorMsg)
     emit downloadComplete(downloadFilePath, errorMsg);
 }
 
+/// Closes out an upload session and does cleanup.
+///     @param errorMsg Error message, empty if no error
+void FTPManager::_uploadComplete(const QString& errorMsg)
+{
+    qCDebug(FTPManagerLog) << QString("_uploadComplete: errorMsg(%1)").arg(errorMsg);
+
+    QString uploadFilePath = _uploadState.fullPathOnVehicle;
+
+    _finishOperation();
+    _uploadState.sessionOpen = false;
+    _uploadState.file.close();
+
+    emit uploadComplete(uploadFilePath, errorMsg);
+}
+
+///     @param errorMsg Error message, empty if no error
+void FTPManager::_listDirectoryComplete(const QString& errorMsg)
+{
+    qCDebug(FTPManagerLog) << QString("_listDirectoryComplete: errorMsg(%1)").arg(errorMsg) << _listDirectoryState.rgEntries;
+
+    QString     dirPath = _listDirectoryState.fullPathOnVehicle;
+    QStringList dirList = _listDirectoryState.rgEntries;
+
+    _finishOperation();
+
+    emit listDirectoryComplete(dirPath, dirList, errorMsg);
+}
+
 void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL || message.compid != _ftpCompId) {
@@ -185,9 +403,10 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
-    // Ignore old/reordered packets (handle wrap-around properly)
+    // Ignore old/reordered packets (handle wrap-around properly). While requests are pipelined, acks for sequence numbers
+    // before the last one sent are expected. Those are matched against the outstanding requests instead.
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+    if (_pipelinedRequests.isEmpty() && (uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
         qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
@@ -241,6 +460,62 @@ QString FTPManager::_errorMsgFromNak(const MavlinkFTP::Request* nak)
     return errorMsg;
 }
 
+void FTPManager::_calcFileCrc32Begin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCalcFileCRC32;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_calcFileCrc32AckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCalcFileCRC32) {
+        qCDebug(FTPManagerLog) << "_calcFileCrc32AckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_calcFileCrc32AckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        uint32_t localCrc = 0;
+
+        if (ackOrNak->hdr.size == sizeof(uint32_t) && _localFileCrc32(_downloadState.toDir.filePath(_downloadState.fileName), localCrc) && localCrc == ackOrNak->crc32) {
+            qCDebug(FTPManagerLog) << "_calcFileCrc32AckOrNak: local file unchanged, skipping download - crc" << localCrc;
+            _downloadComplete(QString());
+            return;
+        }
+        qCDebug(FTPManagerLog) << "_calcFileCrc32AckOrNak: crc mismatch vehicle:local" << ackOrNak->crc32 << localCrc;
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        // Not all firmwares support CRC32, fall back to a full download
+        qCDebug(FTPManagerLog) << "_calcFileCrc32AckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+    }
+
+    _advanceStateMachine();
+}
+
+void FTPManager::_calcFileCrc32Timeout(void)
+{
+    if (++_downloadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_calcFileCrc32Timeout retries exceeded, falling back to full download");
+        _downloadState.retryCount = 0;
+        _advanceStateMachine();
+    } else {
+        // Try again using the same sequence number
+        qCDebug(FTPManagerLog) << QString("_calcFileCrc32Timeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        _expectedIncomingSeqNumber -= 2;
+        _calcFileCrc32Begin();
+    }
+}
+
 void FTPManager::_openFileROBegin(void)
 {
     MavlinkFTP::Request request{};
@@ -416,31 +691,32 @@ void FTPManager::_burstReadFileTimeout(void)
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
+void FTPManager::_fillMissingBlocksWorker(void)
 {
-    if (_downloadState.rgMissingData.count()) {
+    // Keep the pipeline full with reads for the remaining holes
+    while (_pipelinedRequests.count() < _maxPipelinedRequests && _downloadState.rgMissingData.count()) {
         MavlinkFTP::Request request{};
         MissingData_t&      missingData = _downloadState.rgMissingData.first();
 
         uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: offset:cBytesToRead" << missingData.offset << cBytesToRead;
 
         request.hdr.session                 = _downloadState.sessionId;
         request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
         request.hdr.offset                  = missingData.offset;
         request.hdr.size                    = cBytesToRead;
 
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
+        missingData.offset          += cBytesToRead;
+        missingData.cBytesMissing   -= cBytesToRead;
+        if (missingData.cBytesMissing == 0) {
+            _downloadState.rgMissingData.removeFirst();
         }
-        _downloadState.expectedOffset = request.hdr.offset;
 
-        _sendRequestExpectAck(&request);
-    } else {
+        _sendPipelinedRequest(&request);
+    }
+
+    if (_pipelinedRequests.isEmpty()) {
         // We should have the full file now
         if (_downloadState.bytesWritten == _downloadState.fileSize) {
             _advanceStateMachine();
@@ -453,44 +729,37 @@ void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
 
 void FTPManager::_fillMissingBlocksBegin(void)
 {
-    _fillMissingBlocksWorker(true /* firstRequest */);
+    _fillMissingBlocksWorker();
 }
 
 void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
-
-    if (requestOpCode != MavlinkFTP::kCmdReadFile) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
-        return;
-    }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+    PipelinedRequest_t* pipelinedRequest = _pipelinedRequestForAck(ackOrNak, MavlinkFTP::kCmdReadFile);
+    if (!pipelinedRequest) {
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
+        MavlinkFTP::RequestHeader requestHdr = pipelinedRequest->request.hdr;
+
+        if (ackOrNak->hdr.offset != requestHdr.offset || ackOrNak->hdr.size == 0 || ackOrNak->hdr.size > requestHdr.size) {
+            if (++pipelinedRequest->retryCount > _maxRetry) {
                 qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
                 _downloadComplete(tr("Download failed"));
                 return;
             }
 
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
+            // Ask for the same block again
+            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(pipelinedRequest->retryCount).arg(requestHdr.offset);
+            _sendRequest(&pipelinedRequest->request);
+            _ackOrNakTimeoutTimer.start();
             return;
         }
 
+        _pipelinedRequests.remove(ackOrNak->hdr.seqNumber);
+
         _downloadState.file.seek(ackOrNak->hdr.offset);
         int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
         if (bytesWritten != ackOrNak->hdr.size) {
@@ -499,48 +768,262 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         }
         _downloadState.bytesWritten += ackOrNak->hdr.size;
 
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+        if (ackOrNak->hdr.size < requestHdr.size) {
+            // Short read, the remainder goes back on the missing list
+            MissingData_t missingData;
+            missingData.offset          = requestHdr.offset + ackOrNak->hdr.size;
+            missingData.cBytesMissing   = requestHdr.size - ackOrNak->hdr.size;
+            _downloadState.rgMissingData.prepend(missingData);
+        }
+
+        if (!_pipelinedRequests.isEmpty()) {
+            // Still making progress, give the remaining requests a fresh timeout
+            _ackOrNakTimeoutTimer.start();
         }
 
         // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
+        _fillMissingBlocksWorker();
 
         // Emit progress last, as cancel could be called in there
         if (_downloadState.fileSize != 0) {
             emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        _pipelinedRequests.remove(ackOrNak->hdr.seqNumber);
+
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
         if (errorCode == MavlinkFTP::kErrEOF) {
+            // Completion or failure is decided once all outstanding reads have drained
             qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.bytesWritten == _downloadState.fileSize) {
-                // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
-                return;
-            }
+            _fillMissingBlocksWorker();
+            return;
         }
 
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
         _downloadComplete(tr("Download failed"));
     }
-
 }
 
 void FTPManager::_fillMissingBlocksTimeout(void)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (_resendPipelinedRequests()) {
+        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: resent outstanding reads - count(%1)").arg(_pipelinedRequests.count());
+    } else {
         qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
         _downloadComplete(tr("Download failed"));
+    }
+}
+
+void FTPManager::_createFileBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCreateFile;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _uploadState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_createFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCreateFile) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack - sessionId" << ackOrNak->hdr.session;
+        _uploadState.sessionId      = ackOrNak->hdr.session;
+        _uploadState.sessionOpen    = true;
+        _advanceStateMachine();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _uploadComplete(tr("Upload failed: %1").arg(_errorMsgFromNak(ackOrNak)));
+    }
+}
+
+void FTPManager::_createFileTimeout(void)
+{
+    qCDebug(FTPManagerLog) << "_createFileTimeout";
+    _uploadComplete(tr("Upload failed"));
+}
+
+void FTPManager::_writeFileWorker(void)
+{
+    // Keep the pipeline full with writes for the remainder of the file
+    while (_pipelinedRequests.count() < _maxPipelinedRequests && _uploadState.nextOffset < _uploadState.fileSize) {
+        MavlinkFTP::Request request{};
+
+        uint32_t cBytesToWrite = qMin((uint32_t)sizeof(request.data), _uploadState.fileSize - _uploadState.nextOffset);
+
+        _uploadState.file.seek(_uploadState.nextOffset);
+        if (_uploadState.file.read((char*)request.data, cBytesToWrite) != cBytesToWrite) {
+            _uploadComplete(tr("Upload failed: Error reading file"));
+            return;
+        }
+
+        qCDebug(FTPManagerLog) << "_writeFileWorker: offset:cBytesToWrite" << _uploadState.nextOffset << cBytesToWrite;
+
+        request.hdr.session = _uploadState.sessionId;
+        request.hdr.opcode  = MavlinkFTP::kCmdWriteFile;
+        request.hdr.offset  = _uploadState.nextOffset;
+        request.hdr.size    = cBytesToWrite;
+
+        _uploadState.nextOffset += cBytesToWrite;
+
+        _sendPipelinedRequest(&request);
+    }
+
+    if (_pipelinedRequests.isEmpty() && _uploadState.nextOffset >= _uploadState.fileSize) {
+        _advanceStateMachine();
+    }
+}
+
+void FTPManager::_writeFileBegin(void)
+{
+    _writeFileWorker();
+}
+
+void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    PipelinedRequest_t* pipelinedRequest = _pipelinedRequestForAck(ackOrNak, MavlinkFTP::kCmdWriteFile);
+    if (!pipelinedRequest) {
+        return;
+    }
+
+    uint8_t cBytesWritten = pipelinedRequest->request.hdr.size;
+    _pipelinedRequests.remove(ackOrNak->hdr.seqNumber);
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << cBytesWritten;
+
+        _uploadState.bytesAcked += cBytesWritten;
+
+        if (!_pipelinedRequests.isEmpty()) {
+            // Still making progress, give the remaining requests a fresh timeout
+            _ackOrNakTimeoutTimer.start();
+        }
+
+        _writeFileWorker();
+
+        // Emit progress last, as cancel could be called in there
+        if (_uploadState.fileSize != 0) {
+            emit commandProgress((float)(_uploadState.bytesAcked) / (float)_uploadState.fileSize);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _uploadComplete(tr("Upload failed: %1").arg(_errorMsgFromNak(ackOrNak)));
+    }
+}
+
+void FTPManager::_writeFileTimeout(void)
+{
+    if (_resendPipelinedRequests()) {
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout: resent outstanding writes - count(%1)").arg(_pipelinedRequests.count());
+    } else {
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout retries exceeded");
+        _uploadComplete(tr("Upload failed"));
+    }
+}
+
+void FTPManager::_listDirectoryWorker(bool firstRequest)
+{
+    qCDebug(FTPManagerLog) << "_listDirectoryWorker: entryOffset:firstRequest:retryCount" << _listDirectoryState.entryOffset << firstRequest << _listDirectoryState.retryCount;
+
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
+    request.hdr.offset  = _listDirectoryState.entryOffset;
+    _fillRequestDataWithString(&request, _listDirectoryState.fullPathOnVehicle);
+
+    if (firstRequest) {
+        _listDirectoryState.retryCount = 0;
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
+        // Must used same sequence number as previous request
+        _expectedIncomingSeqNumber -= 2;
+    }
+
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_listDirectoryBegin(void)
+{
+    _listDirectoryWorker(true /* firstRequest */);
+}
+
+void FTPManager::_listDirectoryAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdListDirectory) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        // Entries are null terminated strings packed into the data
+        const char* data            = (const char*)ackOrNak->data;
+        int         cbData          = qMin((int)ackOrNak->hdr.size, (int)sizeof(ackOrNak->data));
+        int         entryStart      = 0;
+        uint32_t    previousOffset  = _listDirectoryState.entryOffset;
+
+        for (int i=0; i<cbData; i++) {
+            if (data[i] == '\0') {
+                if (i > entryStart) {
+                    QString entry = QString::fromUtf8(&data[entryStart], i - entryStart);
+                    _listDirectoryState.entryOffset++;
+                    // Skip entries are placeholders for entries the vehicle could not describe, they still count towards the offset
+                    if (!entry.startsWith('S')) {
+                        _listDirectoryState.rgEntries.append(entry);
+                    }
+                }
+                entryStart = i + 1;
+            }
+        }
+
+        if (_listDirectoryState.entryOffset == previousOffset) {
+            // Nothing new returned, we are done
+            _advanceStateMachine();
+        } else {
+            _listDirectoryWorker(true /* firstRequest */);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode == MavlinkFTP::kErrEOF) {
+            // All entries have been returned
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak EOF";
+            _advanceStateMachine();
+        } else {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _listDirectoryComplete(tr("List directory failed: %1").arg(_errorMsgFromNak(ackOrNak)));
+        }
+    }
+}
+
+void FTPManager::_listDirectoryTimeout(void)
+{
+    if (++_listDirectoryState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout retries exceeded");
+        _listDirectoryComplete(tr("List directory failed"));
+    } else {
+        // Try again
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1) entryOffset(%2)").arg(_listDirectoryState.retryCount).arg(_listDirectoryState.entryOffset);
+        _listDirectoryWorker(false /* firstReqeust */);
     }
 }
 
@@ -571,15 +1054,16 @@ void FTPManager::_resetSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Ack";
         _advanceStateMachine();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        // A failed reset doesn't fail the operation, move on to its completion state
         qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(QString());
+        _advanceStateMachine();
     }
 }
 
 void FTPManager::_resetSessionsTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_resetSessionsTimeout";
-    _downloadComplete(QString());
+    _advanceStateMachine();
 }
 
 void FTPManager::_emitErrorMessage(const QString& msg)
@@ -592,17 +1076,82 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
     _ackOrNakTimeoutTimer.start();
     
+    if (_vehicle->vehicleLinkManager()->primaryLink().expired()) {
+        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        return;
+    }
+
+    request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
+    _expectedIncomingSeqNumber += 2;
+
+    _sendRequest(request);
+}
+
+/// Sends a request without waiting for the acks of previously sent requests. The ack is matched back to the
+/// request through its sequence number, see _pipelinedRequestForAck.
+void FTPManager::_sendPipelinedRequest(MavlinkFTP::Request* request)
+{
+    request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;
+    _expectedIncomingSeqNumber += 2;
+
+    PipelinedRequest_t pipelinedRequest;
+    pipelinedRequest.request    = *request;
+    pipelinedRequest.retryCount = 0;
+    _pipelinedRequests[_expectedIncomingSeqNumber] = pipelinedRequest;
+
+    _ackOrNakTimeoutTimer.start();
+    _sendRequest(request);
+}
+
+/// Resends all outstanding pipelined requests using their original sequence numbers
+/// @return false: retries exceeded for one of the requests
+bool FTPManager::_resendPipelinedRequests(void)
+{
+    for (PipelinedRequest_t& pipelinedRequest: _pipelinedRequests) {
+        if (++pipelinedRequest.retryCount > _maxRetry) {
+            return false;
+        }
+        _sendRequest(&pipelinedRequest.request);
+    }
+    _ackOrNakTimeoutTimer.start();
+
+    return true;
+}
+
+/// @return Outstanding pipelined request the ack/nak is a response to, nullptr if there is none
+FTPManager::PipelinedRequest_t* FTPManager::_pipelinedRequestForAck(const MavlinkFTP::Request* ackOrNak, MavlinkFTP::OpCode_t expectedReqOpCode)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != expectedReqOpCode) {
+        qCDebug(FTPManagerLog) << "_pipelinedRequestForAck: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return nullptr;
+    }
+
+    auto iter = _pipelinedRequests.find(ackOrNak->hdr.seqNumber);
+    if (iter == _pipelinedRequests.end()) {
+        // Duplicate response to a resent request, or a response which arrived after we gave up on it
+        qCDebug(FTPManagerLog) << "_pipelinedRequestForAck: Disregarding due to no outstanding request for sequence" << ackOrNak->hdr.seqNumber;
+        return nullptr;
+    }
+    if (ackOrNak->hdr.session != iter->request.hdr.session) {
+        qCDebug(FTPManagerLog) << "_pipelinedRequestForAck: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << iter->request.hdr.session;
+        return nullptr;
+    }
+
+    return &iter.value();
+}
+
+/// Sends the request on the primary link as is, the sequence number must already be set
+void FTPManager::_sendRequest(MavlinkFTP::Request* request)
+{
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
-        request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
-        _expectedIncomingSeqNumber += 2;
-
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -617,6 +1166,48 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
     }
 }
 
+uint8_t FTPManager::_currentSessionId(void) const
+{
+    return _currentOperation == OperationUpload ? _uploadState.sessionId : _downloadState.sessionId;
+}
+
+/// Strips the directory from a fully qualified vehicle path. We can't use the usual QDir
+/// routines because this path does not exist locally.
+QString FTPManager::_fileNameFromPath(const QString& fullPath)
+{
+    int lastDirSlashIndex;
+    for (lastDirSlashIndex=fullPath.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
+        if (fullPath[lastDirSlashIndex] == '/') {
+            break;
+        }
+    }
+    lastDirSlashIndex++; // move past slash
+
+    return fullPath.right(fullPath.size() - lastDirSlashIndex);
+}
+
+/// Calculates the CRC32 of a local file the same way kCmdCalcFileCRC32 does on the vehicle
+/// @return false: unable to read file
+bool FTPManager::_localFileCrc32(const QString& filePath, uint32_t& crc)
+{
+    QFile file(filePath);
+
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    crc = 0;
+    while (!file.atEnd()) {
+        QByteArray bytes = file.read(8192);
+        if (bytes.isEmpty()) {
+            return false;
+        }
+        crc = QGC::crc32(reinterpret_cast<const quint8*>(bytes.constData()), static_cast<unsigned>(bytes.size()), crc);
+    }
+
+    return true;
+}
+
 bool FTPManager::_parseURI(const QString& uri, QString& parsedURI, uint8_t& compId)
 {
     parsedURI   = uri;
@@ -13,6 +13,7 @@
 #include <QDir>
 #include <QTimer>
 #include <QQueue>
+#include <QMap>
 
 #include "UASInterface.h"
 #include "QGCLoggingCategory.h"
@@ -31,22 +32,54 @@ class FTPManager : public QObject
 public:
     FTPManager(Vehicle* vehicle);
 
-	/// Downloads the specified file.
-    ///     @param fromURI  File to download from vehicle, fully qualified path. May be in the format "mftp://[;comp=<id>]..." where the component id is specified.
-    ///                     If component id is not specified MAV_COMP_ID_AUTOPILOT1 is used.
-    ///     @param toDir    Local directory to download file to
-    /// @return true: download has started, false: error, no download
+	/// Downloads the specified file. If another operation is in progress the download is queued and started
+    /// once all previously requested operations have completed.
+    ///     @param fromURI          File to download from vehicle, fully qualified path. May be in the format "mftp://[;comp=<id>]..." where the component id is specified.
+    ///                             If component id is not specified MAV_COMP_ID_AUTOPILOT1 is used.
+    ///     @param toDir            Local directory to download file to
+    ///     @param skipIfUnchanged  true: If the file already exists in toDir and its CRC32 matches the vehicle copy the transfer is skipped
+    /// @return true: download has started or is queued, false: error, no download
     /// Signals downloadComplete, commandError, commandProgress
-    bool download(const QString& fromURI, const QString& toDir);
+    bool download(const QString& fromURI, const QString& toDir, bool skipIfUnchanged = false);
 
-    /// Cancel the current operation
-    /// This will emit downloadComplete() when done, and if there's currently a download in progress
+    /// Uploads the specified file. Queued in the same way as download.
+    ///     @param toURI    File to create on vehicle, fully qualified path. Same format as download fromURI.
+    ///     @param fromFile Local file to upload
+    /// @return true: upload has started or is queued, false: error, no upload
+    /// Signals uploadComplete, commandProgress
+    bool upload(const QString& toURI, const QString& fromFile);
+
+    /// Lists the contents of the specified directory. Queued in the same way as download.
+    ///     @param dirURI   Directory on vehicle, fully qualified path. Same format as download fromURI.
+    /// @return true: list has started or is queued, false: error
+    /// Signals listDirectoryComplete
+    bool listDirectory(const QString& dirURI);
+
+    /// Cancel the current operation. Queued operations are not affected.
+    /// This will emit the completion signal for the operation which was in progress.
     void cancel();
 
+    /// Cancels a single download requested through download(). A queued download is removed from the queue without
+    /// signalling. If the download is the current operation it is aborted, including while the file is still being
+    /// opened or its CRC compared, and downloadComplete is signalled with an error.
+    ///     @param fromURI  Same value as passed to download
+    ///     @param toDir    Same value as passed to download
+    /// @return true: matching download was found and cancelled
+    bool cancelDownload(const QString& fromURI, const QString& toDir);
+
+    /// @return Path on vehicle of the download in progress, empty if no download is in progress. Since all clients share
+    ///         one operation queue this tells commandProgress receivers whether the progress is for their own download.
+    QString currentDownloadPath() const { return _currentOperation == OperationDownload ? _downloadState.fullPathOnVehicle : QString(); }
+
     static const char* mavlinkFTPScheme;
 
 signals:
-    void downloadComplete(const QString& file, const QString& errorMsg);
+    void downloadComplete       (const QString& file, const QString& errorMsg);
+    void uploadComplete         (const QString& file, const QString& errorMsg);
+
+    /// @param dirPath Directory on vehicle which was listed, component id stripped
+    /// @param dirList Directory entries as returned by the vehicle: "F<name>\t<size>" for files, "D<name>" for directories
+    void listDirectoryComplete  (const QString& dirPath, const QStringList& dirList, const QString& errorMsg);
     
     // Signals associated with all commands
     
@@ -73,11 +106,32 @@ private:
         StateTimeoutFn  timeoutFn;
     };
 
+    typedef enum {
+        OperationNone,
+        OperationDownload,
+        OperationUpload,
+        OperationListDirectory,
+    } Operation_t;
+
+    struct QueuedOperation_t {
+        Operation_t operation;
+        QString     pathOnVehicle;      ///< Fully qualified path on vehicle with component id stripped
+        uint8_t     compId;
+        QString     localPath;          ///< Download: directory to download to, Upload: file to upload from
+        bool        skipIfUnchanged;
+    };
+
     struct MissingData_t {
         uint32_t offset;
         uint32_t cBytesMissing;
     };
 
+    /// A request which was sent without waiting for the previous one to be acked
+    struct PipelinedRequest_t {
+        MavlinkFTP::Request request;
+        int                 retryCount;
+    };
+
     struct DownloadState_t {
         uint8_t                 sessionId;
         uint32_t                expectedOffset;         ///< offset which should be coming next
@@ -89,6 +143,7 @@ private:
         uint32_t                fileSize;               ///< Size of file being downloaded
         QFile                   file;
         int                     retryCount;
+        bool                    skipIfUnchanged;        ///< true: Check CRC32 of existing local file before downloading
 
         bool inProgress() const { return fileSize > 0; }
 
@@ -98,6 +153,7 @@ private:
             bytesWritten    = 0;
             retryCount      = 0;
             fileSize        = 0;
+            skipIfUnchanged = false;
             fullPathOnVehicle.clear();
             fileName.clear();
             rgMissingData.clear();
@@ -105,10 +161,56 @@ private:
         }
     };
 
+    struct UploadState_t {
+        uint8_t                 sessionId;
+        bool                    sessionOpen;
+        QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
+        QFile                   file;                   ///< Local file being uploaded
+        uint32_t                fileSize;
+        uint32_t                nextOffset;             ///< Offset of next chunk to send
+        uint32_t                bytesAcked;
+
+        bool inProgress() const { return sessionOpen; }
+
+        void reset() {
+            sessionId       = 0;
+            sessionOpen     = false;
+            fileSize        = 0;
+            nextOffset      = 0;
+            bytesAcked      = 0;
+            fullPathOnVehicle.clear();
+            file.close();
+        }
+    };
+
+    struct ListDirectoryState_t {
+        QString                 fullPathOnVehicle;      ///< Fully qualified path to directory on vehicle
+        QStringList             rgEntries;
+        uint32_t                entryOffset;            ///< Number of entries (including skipped ones) received so far
+        int                     retryCount;
+
+        void reset() {
+            entryOffset     = 0;
+            retryCount      = 0;
+            fullPathOnVehicle.clear();
+            rgEntries.clear();
+        }
+    };
+
 
     void    _mavlinkMessageReceived     (const mavlink_message_t& message);
+    bool    _queueOperation             (Operation_t operation, const QString& uri, const QString& localPath, bool skipIfUnchanged);
+    void    _startNextOperation         (void);
+    void    _startDownload              (const QueuedOperation_t& queuedOperation);
+    void    _startUpload                (const QueuedOperation_t& queuedOperation);
+    void    _startListDirectory         (const QueuedOperation_t& queuedOperation);
+    void    _operationComplete          (const QString& errorMsg);
+    void    _finishOperation            (void);
     void    _startStateMachine          (void);
     void    _advanceStateMachine        (void);
+    void    _calcFileCrc32Begin         (void);
+    void    _calcFileCrc32AckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _calcFileCrc32Timeout       (void);
     void    _openFileROBegin            (void);
     void    _openFileROAckOrNak         (const MavlinkFTP::Request* ackOrNak);
     void    _openFileROTimeout          (void);
@@ -118,33 +220,63 @@ private:
     void    _fillMissingBlocksBegin     (void);
     void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
     void    _fillMissingBlocksTimeout   (void);
+    void    _createFileBegin            (void);
+    void    _createFileAckOrNak         (const MavlinkFTP::Request* ackOrNak);
+    void    _createFileTimeout          (void);
+    void    _writeFileBegin             (void);
+    void    _writeFileAckOrNak          (const MavlinkFTP::Request* ackOrNak);
+    void    _writeFileTimeout           (void);
+    void    _listDirectoryBegin         (void);
+    void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _listDirectoryTimeout       (void);
     void    _resetSessionsBegin         (void);
     void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
+    void    _sendPipelinedRequest       (MavlinkFTP::Request* request);
+    bool    _resendPipelinedRequests    (void);
+    void    _sendRequest                (MavlinkFTP::Request* request);
+    PipelinedRequest_t* _pipelinedRequestForAck(const MavlinkFTP::Request* ackOrNak, MavlinkFTP::OpCode_t expectedReqOpCode);
     void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
     void    _downloadComplete           (const QString& errorMsg);
+    void    _uploadCompleteNoError      (void) { _uploadComplete(QString()); }
+    void    _uploadComplete             (const QString& errorMsg);
+    void    _listDirectoryCompleteNoError(void) { _listDirectoryComplete(QString()); }
+    void    _listDirectoryComplete      (const QString& errorMsg);
     void    _emitErrorMessage           (const QString& msg);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
+    void    _fillMissingBlocksWorker    (void);
     void    _burstReadFileWorker        (bool firstRequest);
+    void    _writeFileWorker            (void);
+    void    _listDirectoryWorker        (bool firstRequest);
     bool    _parseURI                   (const QString& uri, QString& parsedURI, uint8_t& compId);
+    uint8_t _currentSessionId           (void) const;
+
+    static QString  _fileNameFromPath   (const QString& fullPath);
+    static bool     _localFileCrc32     (const QString& filePath, uint32_t& crc);
 
     void    _terminateSessionBegin      (void);
     void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
     void    _terminateSessionTimeout    (void);
     void    _terminateComplete          (void);
 
-    Vehicle*                _vehicle;
-    uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
-    QList<StateFunctions_t> _rgStateMachine;
-    DownloadState_t         _downloadState;
-    QTimer                  _ackOrNakTimeoutTimer;
-    int                     _currentStateMachineIndex   = -1;
-    uint16_t                _expectedIncomingSeqNumber  = 0;
-    
+    Vehicle*                    _vehicle;
+    uint8_t                     _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
+    QList<StateFunctions_t>     _rgStateMachine;
+    QQueue<QueuedOperation_t>   _operationQueue;
+    Operation_t                 _currentOperation           = OperationNone;
+    DownloadState_t             _downloadState;
+    UploadState_t               _uploadState;
+    ListDirectoryState_t        _listDirectoryState;
+    QMap<uint16_t, PipelinedRequest_t> _pipelinedRequests;  ///< Outstanding pipelined requests keyed by expected ack sequence number
+    QTimer                      _ackOrNakTimeoutTimer;
+    int                         _currentStateMachineIndex   = -1;
+    uint16_t                    _expectedIncomingSeqNumber  = 0;
+    int                         _terminateRetryCount        = 0;
+
     static const int _ackOrNakTimeoutMsecs  = 1000;
     static const int _maxRetry              = 3;
+    static const int _maxPipelinedRequests  = 4;    ///< ArduPilot only queues a handful of incoming FTP requests, don't overrun it
 };
 
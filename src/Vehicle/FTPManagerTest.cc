@@ -12,6 +12,7 @@
 #include "QGCApplication.h"
 #include "MockLink.h"
 #include "FTPManager.h"
+#include "QGCTemporaryFile.h"
 
 const FTPManagerTest::TestCase_t FTPManagerTest::_rgTestCases[] = {
     {  "/general.json" },
@@ -120,6 +121,199 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testQueuedDownloads(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager*         ftpManager  = _vehicle->ftpManager();
+    const QList<int>    rgFileSizes = { 1024, 2 * 1024, 3 * 1024 };
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // All downloads are requested up front, the later ones are queued behind the first
+    for (int fileSize: rgFileSizes) {
+        QString filename = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+        QVERIFY(ftpManager->download(filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+    }
+
+    while (spyDownloadComplete.count() < rgFileSizes.count()) {
+        QVERIFY(spyDownloadComplete.wait(10000));
+    }
+
+    // Downloads complete in the order they were requested
+    for (int fileSize: rgFileSizes) {
+        // void downloadComplete   (const QString& file, const QString& errorMsg);
+        QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+        QVERIFY(arguments[1].toString().isEmpty());
+        _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+    }
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testCancelQueuedDownload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager          = _vehicle->ftpManager();
+    QString     toDir               = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    int         fileSize            = 3 * 1024;
+    QString     filename            = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+    QString     cancelledFilename   = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(1024);
+
+    QFile::remove(QDir(toDir).filePath(cancelledFilename));
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    QVERIFY(ftpManager->download(filename, toDir));
+    QVERIFY(ftpManager->download(cancelledFilename, toDir));
+
+    // Only the matching request is removed from the queue
+    QCOMPARE(ftpManager->cancelDownload(cancelledFilename, QStringLiteral("/some/other/dir")), false);
+    QCOMPARE(ftpManager->cancelDownload(cancelledFilename, toDir), true);
+    QCOMPARE(ftpManager->cancelDownload(cancelledFilename, toDir), false);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.wait(500), false);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+    QVERIFY(!QFile::exists(QDir(toDir).filePath(cancelledFilename)));
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testCancelOpeningDownload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QString     toDir       = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    int         fileSize    = 2 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+
+    QFile::remove(QDir(toDir).filePath(filename));
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // The open request has been sent but not yet acked, cancel still aborts the download
+    QVERIFY(ftpManager->download(filename, toDir));
+    QVERIFY(ftpManager->currentDownloadPath() == filename);
+    QCOMPARE(ftpManager->cancelDownload(filename, toDir), true);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+    QVERIFY(!spyDownloadComplete.takeFirst()[1].toString().isEmpty());
+    QVERIFY(!QFile::exists(QDir(toDir).filePath(filename)));
+
+    // Sessions were reset so the next download works normally
+    QVERIFY(ftpManager->download(filename, toDir));
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testSkipIfUnchanged(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 2 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+    QString     toDir       = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+    QSignalSpy spyProgress(ftpManager, &FTPManager::commandProgress);
+
+    // First download transfers the file
+    QFile::remove(QDir(toDir).filePath(filename));
+    QVERIFY(ftpManager->download(filename, toDir, true /* skipIfUnchanged */));
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QVERIFY(spyDownloadComplete.takeFirst()[1].toString().isEmpty());
+    QVERIFY(spyProgress.count() > 0);
+
+    // Second download finds the local file matches the vehicle CRC and doesn't transfer anything
+    spyProgress.clear();
+    QVERIFY(ftpManager->download(filename, toDir, true /* skipIfUnchanged */));
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(spyProgress.count(), 0);
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testUpload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager      = _vehicle->ftpManager();
+    QString     vehicleFilename = QStringLiteral("/upload.bin");
+    QByteArray  fileContents;
+
+    // Large enough to require multiple pipelined writes
+    for (int i=0; i<5 * 1024; i++) {
+        fileContents.append(static_cast<char>(i % 251));
+    }
+
+    QGCTemporaryFile tmpFile("FTPManagerTestUpload");
+    QVERIFY(tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    tmpFile.write(fileContents);
+    tmpFile.close();
+
+    QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+
+    QVERIFY(ftpManager->upload(vehicleFilename, tmpFile.fileName()));
+    QCOMPARE(spyUploadComplete.wait(10000), true);
+    QCOMPARE(spyUploadComplete.count(), 1);
+
+    // void uploadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyUploadComplete.takeFirst();
+    QCOMPARE(arguments[0].toString(), vehicleFilename);
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(_mockLink->mockLinkFTP()->uploadedFile(vehicleFilename), fileContents);
+
+    tmpFile.remove();
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testListDirectory(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QStringList rgEntries   = { QStringLiteral("Ffile1.bin\t1024"), QStringLiteral("Ffile2.bin\t42"), QStringLiteral("Dlogs") };
+
+    _mockLink->mockLinkFTP()->setFileList(rgEntries);
+
+    QSignalSpy spyListComplete(ftpManager, &FTPManager::listDirectoryComplete);
+
+    QVERIFY(ftpManager->listDirectory(QStringLiteral("/")));
+    QCOMPARE(spyListComplete.wait(10000), true);
+    QCOMPARE(spyListComplete.count(), 1);
+
+    // void listDirectoryComplete  (const QString& dirPath, const QStringList& dirList, const QString& errorMsg);
+    QList<QVariant> arguments = spyListComplete.takeFirst();
+    QCOMPARE(arguments[0].toString(), QStringLiteral("/"));
+    QCOMPARE(arguments[1].toStringList(), rgEntries);
+    QVERIFY(arguments[2].toString().isEmpty());
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
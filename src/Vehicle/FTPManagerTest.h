@@ -17,6 +17,12 @@ class FTPManagerTest : public UnitTest
 
 private slots:
     void _testLostPackets           (void);
+    void _testQueuedDownloads       (void);
+    void _testCancelQueuedDownload  (void);
+    void _testCancelOpeningDownload (void);
+    void _testSkipIfUnchanged       (void);
+    void _testUpload                (void);
+    void _testListDirectory         (void);
 
     // Overrides from UnitTest
     void cleanup(void) override;
@@ -15,6 +15,9 @@
 #include "ParameterManager.h"
 #include "ComponentInformationManager.h"
 #include "MissionManager.h"
+#ifndef NO_SERIAL_LINK
+#include "SerialLink.h"
+#endif
 
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "InitialConnectStateMachineLog")
 
@@ -40,6 +43,28 @@ const int InitialConnectStateMachine::_rgProgressWeights[] = {
     1, //_stateSignalInitialConnectComplete
 };
 
+// Phases which must be complete before a phase can start
+const uint32_t InitialConnectStateMachine::_rgPhaseDependencies[] = {
+    0,                                          // PhaseAutopilotVersion
+    _phaseBit(PhaseAutopilotVersion),           // PhaseProtocolVersion: only one REQUEST_MESSAGE to the autopilot at a time
+    _phaseBit(PhaseProtocolVersion),            // PhaseCompInfo
+    _phaseBit(PhaseCompInfo),                   // PhaseParameters: parameter meta data may come from component information
+    _phaseBit(PhaseProtocolVersion),            // PhaseMission: needs capabilities and protocol version only
+    _phaseBit(PhaseMission),                    // PhaseGeoFence: shares the mission protocol
+    _phaseBit(PhaseGeoFence),                   // PhaseRallyPoints: shares the mission protocol
+    _phaseBit(PhaseSignalInitialConnectComplete) - 1,   // PhaseSignalInitialConnectComplete: everything else
+};
+
+const char* InitialConnectStateMachine::_rgPhaseNames[] = {
+    "AutopilotVersion",
+    "ProtocolVersion",
+    "CompInfo",
+    "Parameters",
+    "Mission",
+    "GeoFence",
+    "RallyPoints",
+    "SignalInitialConnectComplete",
+};
 
 const int InitialConnectStateMachine::_cStates = sizeof(InitialConnectStateMachine::_rgStates) / sizeof(InitialConnectStateMachine::_rgStates[0]);
 
@@ -48,10 +73,16 @@ InitialConnectStateMachine::InitialConnectStateMachine(Vehicle* vehicle)
 {
     static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == sizeof(_rgProgressWeights)/sizeof(_rgProgressWeights[0]),
             "array size mismatch");
+    static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == PhaseCount, "array size mismatch");
+    static_assert(sizeof(_rgPhaseDependencies)/sizeof(_rgPhaseDependencies[0]) == PhaseCount, "array size mismatch");
+    static_assert(sizeof(_rgPhaseNames)/sizeof(_rgPhaseNames[0]) == PhaseCount, "array size mismatch");
 
     _progressWeightTotal = 0;
     for (int i = 0; i < _cStates; ++i) {
         _progressWeightTotal += _rgProgressWeights[i];
+        _rgPhaseProgress[i]     = 0;
+        _rgPhaseStartMsecs[i]   = -1;
+        _rgPhaseEndMsecs[i]     = -1;
     }
 }
 
@@ -67,28 +98,143 @@ const InitialConnectStateMachine::StateFn* InitialConnectStateMachine::rgStates(
 
 void InitialConnectStateMachine::statesCompleted(void) const
 {
-
+    _logTimings();
 }
 
 void InitialConnectStateMachine::advance()
 {
-    StateMachine::advance();
+    if (!_active) {
+        return;
+    }
+
+    if (_startedPhases == 0) {
+        _slowLink = _isSlowLink();
+        _connectTimer.start();
+        qCDebug(InitialConnectStateMachineLog) << "Starting initial connect, slow link:" << _slowLink;
+    }
+
+    for (int phase = 0; phase < PhaseCount; phase++) {
+        const uint32_t dependencies = _phaseDependencies(phase);
+
+        if ((_startedPhases & _phaseBit(phase)) || (_completedPhases & dependencies) != dependencies) {
+            continue;
+        }
+
+        qCDebug(InitialConnectStateMachineLog) << "Starting phase" << _rgPhaseNames[phase] << _connectTimer.elapsed() << "msecs";
+        _startedPhases |= _phaseBit(phase);
+        _rgPhaseStartMsecs[phase] = _connectTimer.elapsed();
+        _stateIndex = phase;
+
+        // State functions may complete synchronously, which will recurse back into here to start the next phases
+        (*_rgStates[phase])(this);
+        if (!_active) {
+            return;
+        }
+    }
+}
+
+void InitialConnectStateMachine::phaseComplete(Phase_t phase)
+{
+    if (!_active || (_completedPhases & _phaseBit(phase))) {
+        return;
+    }
+
+    if (!(_startedPhases & _phaseBit(phase))) {
+        // Completion signalled before the phase was scheduled, don't request it again
+        qCDebug(InitialConnectStateMachineLog) << "Phase completed before start" << _rgPhaseNames[phase];
+        _startedPhases |= _phaseBit(phase);
+        _rgPhaseStartMsecs[phase] = _connectTimer.elapsed();
+    }
+
+    _completedPhases |= _phaseBit(phase);
+    _rgPhaseEndMsecs[phase] = _connectTimer.elapsed();
+    _rgPhaseProgress[phase] = 1;
+    qCDebug(InitialConnectStateMachineLog) << "Phase complete" << _rgPhaseNames[phase] << _rgPhaseEndMsecs[phase] - _rgPhaseStartMsecs[phase] << "msecs";
+
+    if (phase == PhaseParameters) {
+        disconnect(_vehicle->_parameterManager, &ParameterManager::loadProgressChanged, this, &InitialConnectStateMachine::_parametersProgressUpdate);
+    }
+
+    if (_completedPhases == _phaseBit(PhaseCount) - 1) {
+        _active = false;
+        _totalMsecs = _connectTimer.elapsed();
+        statesCompleted();
+    } else {
+        advance();
+    }
+
+    emit progressUpdate(_progress());
+}
+
+qint64 InitialConnectStateMachine::phaseDurationMsecs(Phase_t phase) const
+{
+    if (!(_completedPhases & _phaseBit(phase))) {
+        return -1;
+    }
+    return _rgPhaseEndMsecs[phase] - _rgPhaseStartMsecs[phase];
+}
+
+void InitialConnectStateMachine::_compInfoProgressUpdate(float progressValue)
+{
+    _rgPhaseProgress[PhaseCompInfo] = progressValue;
     emit progressUpdate(_progress());
 }
 
-void InitialConnectStateMachine::gotProgressUpdate(float progressValue)
+void InitialConnectStateMachine::_parametersProgressUpdate(float progressValue)
+{
+    _rgPhaseProgress[PhaseParameters] = progressValue;
+    emit progressUpdate(_progress());
+}
+
+float InitialConnectStateMachine::_progress(void) const
+{
+    float progressWeight = 0;
+    for (int i = 0; i < _cStates; ++i) {
+        progressWeight += _rgProgressWeights[i] * _rgPhaseProgress[i];
+    }
+    return progressWeight / (float)_progressWeightTotal;
+}
+
+uint32_t InitialConnectStateMachine::_phaseDependencies(int phase) const
+{
+    uint32_t dependencies = _rgPhaseDependencies[phase];
+
+    // Parameter and plan download together can saturate a slow radio link, causing retries which make the total time longer
+    if (_slowLink && phase == PhaseMission) {
+        dependencies |= _phaseBit(PhaseParameters);
+    }
+
+    return dependencies;
+}
+
+bool InitialConnectStateMachine::_isSlowLink(void) const
 {
-    emit progressUpdate(_progress(progressValue));
+#ifndef NO_SERIAL_LINK
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+
+    if (sharedLink) {
+        SharedLinkConfigurationPtr config = sharedLink->linkConfiguration();
+        if (config) {
+            SerialConfiguration* serialConfig = qobject_cast<SerialConfiguration*>(config.get());
+            if (serialConfig && !serialConfig->usbDirect() && serialConfig->baud() <= _slowLinkBaud) {
+                return true;
+            }
+        }
+    }
+#endif
+
+    return false;
 }
 
-float InitialConnectStateMachine::_progress(float subProgress)
+void InitialConnectStateMachine::_logTimings(void) const
 {
-    int progressWeight = 0;
-    for (int i = 0; i < _stateIndex && i < _cStates; ++i) {
-        progressWeight += _rgProgressWeights[i];
+    qCDebug(InitialConnectStateMachineLog) << "Initial connect complete" << _totalMsecs << "msecs";
+    for (int phase = 0; phase < PhaseCount; phase++) {
+        qCDebug(InitialConnectStateMachineLog) << QStringLiteral("    %1 start:%2 duration:%3 msecs")
+                                                  .arg(_rgPhaseNames[phase], -30)
+                                                  .arg(_rgPhaseStartMsecs[phase])
+                                                  .arg(_rgPhaseEndMsecs[phase] - _rgPhaseStartMsecs[phase]);
     }
-    int currentWeight = _stateIndex < _cStates ? _rgProgressWeights[_stateIndex] : 1;
-    return (progressWeight + currentWeight * subProgress) / (float)_progressWeightTotal;
 }
 
 void InitialConnectStateMachine::_stateRequestAutopilotVersion(StateMachine* stateMachine)
@@ -99,11 +245,11 @@ void InitialConnectStateMachine::_stateRequestAutopilotVersion(StateMachine* sta
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->phaseComplete(PhaseAutopilotVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->phaseComplete(PhaseAutopilotVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:AUTOPILOT_VERSION";
             vehicle->requestMessage(_autopilotVersionRequestMessageHandler,
@@ -200,7 +346,7 @@ void InitialConnectStateMachine::_autopilotVersionRequestMessageHandler(void* re
         vehicle->_setCapabilities(assumedCapabilities);
     }
 
-    connectMachine->advance();
+    connectMachine->phaseComplete(PhaseAutopilotVersion);
 }
 
 void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stateMachine)
@@ -211,11 +357,11 @@ void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stat
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->phaseComplete(PhaseProtocolVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->phaseComplete(PhaseProtocolVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:PROTOCOL_VERSION";
             vehicle->requestMessage(_protocolVersionRequestMessageHandler,
@@ -266,8 +412,9 @@ void InitialConnectStateMachine::_protocolVersionRequestMessageHandler(void* res
         vehicle->_setMaxProtoVersionFromBothSources();
     }
 
-    connectMachine->advance();
+    connectMachine->phaseComplete(PhaseProtocolVersion);
 }
+
 void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
@@ -275,7 +422,7 @@ void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachin
 
     qCDebug(InitialConnectStateMachineLog) << "_stateRequestCompInfo";
     connect(vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
+            &InitialConnectStateMachine::_compInfoProgressUpdate);
     vehicle->_componentInformationManager->requestAllComponentInformation(_stateRequestCompInfoComplete, connectMachine);
 }
 
@@ -283,9 +430,9 @@ void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllC
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(requestAllCompleteFnData);
     disconnect(connectMachine->_vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate,
-            connectMachine, &InitialConnectStateMachine::gotProgressUpdate);
+            connectMachine, &InitialConnectStateMachine::_compInfoProgressUpdate);
 
-    connectMachine->advance();
+    connectMachine->phaseComplete(PhaseCompInfo);
 }
 
 void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMachine)
@@ -295,7 +442,7 @@ void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMach
 
     qCDebug(InitialConnectStateMachineLog) << "_stateRequestParameters";
     connect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
+            &InitialConnectStateMachine::_parametersProgressUpdate);
     vehicle->_parameterManager->refreshAllParameters();
 }
 
@@ -305,12 +452,9 @@ void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->phaseComplete(PhaseMission);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
@@ -330,7 +474,7 @@ void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachin
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->phaseComplete(PhaseGeoFence);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
@@ -355,7 +499,7 @@ void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMac
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->phaseComplete(PhaseRallyPoints);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
@@ -376,7 +520,7 @@ void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    connectMachine->advance();
+    connectMachine->phaseComplete(PhaseSignalInitialConnectComplete);
     qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
     emit vehicle->initialConnectComplete();
 }
@@ -14,10 +14,15 @@
 #include "QGCLoggingCategory.h"
 #include "Vehicle.h"
 
+#include <QElapsedTimer>
+
 Q_DECLARE_LOGGING_CATEGORY(InitialConnectStateMachineLog)
 
 class Vehicle;
 
+/// Runs the initial connect sequence as a set of phases with dependencies between them. Phases which talk to
+/// different microservices run concurrently, for example the mission/fence/rally download runs alongside the
+/// parameter download. On slow serial links the plan download waits for parameters to keep the link from being swamped.
 class InitialConnectStateMachine : public StateMachine
 {
     Q_OBJECT
@@ -25,18 +30,44 @@ class InitialConnectStateMachine : public StateMachine
 public:
     InitialConnectStateMachine(Vehicle* vehicle);
 
+    typedef enum {
+        PhaseAutopilotVersion,
+        PhaseProtocolVersion,
+        PhaseCompInfo,
+        PhaseParameters,
+        PhaseMission,
+        PhaseGeoFence,
+        PhaseRallyPoints,
+        PhaseSignalInitialConnectComplete,
+        PhaseCount
+    } Phase_t;
+
     // Overrides from StateMachine
     int             stateCount      (void) const final;
     const StateFn*  rgStates        (void) const final;
     void            statesCompleted (void) const final;
 
+    /// Starts all phases whose dependencies have completed
     void advance() override;
 
+    /// Signals completion of a phase which finishes asynchronously
+    void phaseComplete(Phase_t phase);
+
+    /// @return Time from start of initial connect to the start of the specified phase in msecs, -1 if not started
+    qint64 phaseStartMsecs(Phase_t phase) const { return _rgPhaseStartMsecs[phase]; }
+
+    /// @return Time taken by the specified phase in msecs, -1 if it has not completed
+    qint64 phaseDurationMsecs(Phase_t phase) const;
+
+    /// @return Time taken by the full sequence in msecs, -1 if it has not completed
+    qint64 totalDurationMsecs(void) const { return _active ? -1 : _totalMsecs; }
+
 signals:
     void progressUpdate(float progress);
 
 private slots:
-    void gotProgressUpdate(float progressValue);
+    void _compInfoProgressUpdate    (float progressValue);
+    void _parametersProgressUpdate  (float progressValue);
 
 private:
     static void _stateRequestAutopilotVersion           (StateMachine* stateMachine);
@@ -52,13 +83,29 @@ private:
     static void _autopilotVersionRequestMessageHandler  (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
     static void _protocolVersionRequestMessageHandler   (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
 
-    float _progress(float subProgress = 0.f);
+    static constexpr uint32_t _phaseBit(int phase) { return 1u << phase; }
+
+    float       _progress           (void) const;
+    uint32_t    _phaseDependencies  (int phase) const;
+    bool        _isSlowLink         (void) const;
+    void        _logTimings         (void) const;
 
     Vehicle* _vehicle;
 
     static const StateFn    _rgStates[];
     static const int        _rgProgressWeights[];
+    static const uint32_t   _rgPhaseDependencies[];
+    static const char*      _rgPhaseNames[];
     static const int        _cStates;
-
-    int _progressWeightTotal;
+    static const int        _slowLinkBaud = 57600;  ///< Serial links at or below this rate are treated as slow
+
+    int             _progressWeightTotal;
+    uint32_t        _startedPhases      = 0;
+    uint32_t        _completedPhases    = 0;
+    bool            _slowLink           = false;
+    float           _rgPhaseProgress    [PhaseCount];
+    qint64          _rgPhaseStartMsecs  [PhaseCount];
+    qint64          _rgPhaseEndMsecs    [PhaseCount];
+    qint64          _totalMsecs         = -1;
+    QElapsedTimer   _connectTimer;
 };
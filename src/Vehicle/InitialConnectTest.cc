@@ -12,6 +12,7 @@
 #include "QGCApplication.h"
 #include "LinkManager.h"
 #include "MockLink.h"
+#include "InitialConnectStateMachine.h"
 
 void InitialConnectTest::_performTestCases(void)
 {
@@ -59,3 +60,24 @@ void InitialConnectTest::_boardVendorProductId(void)
 
     _linkManager->disconnectAll();
 }
+
+void InitialConnectTest::_concurrentPhases(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    InitialConnectStateMachine* stateMachine = _vehicle->_initialConnectStateMachine;
+    QVERIFY(!stateMachine->active());
+    QVERIFY(stateMachine->totalDurationMsecs() >= 0);
+
+    for (int phase = 0; phase < InitialConnectStateMachine::PhaseCount; phase++) {
+        QVERIFY(stateMachine->phaseDurationMsecs(static_cast<InitialConnectStateMachine::Phase_t>(phase)) >= 0);
+    }
+
+    // Plan download is not serialized behind the parameter download on a fast link
+    const qint64 missionStart   = stateMachine->phaseStartMsecs(InitialConnectStateMachine::PhaseMission);
+    const qint64 paramsStart    = stateMachine->phaseStartMsecs(InitialConnectStateMachine::PhaseParameters);
+    const qint64 paramsDuration = stateMachine->phaseDurationMsecs(InitialConnectStateMachine::PhaseParameters);
+    QVERIFY(missionStart < paramsStart + paramsDuration);
+
+    _disconnectMockLink();
+}
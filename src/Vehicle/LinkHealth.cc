@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkHealth.h"
+
+#include <QtMath>
+
+LinkHealth::LinkHealth(void)
+{
+    _lastSeqByCompId.fill(-1);
+}
+
+void LinkHealth::messageReceived(const mavlink_message_t& message, qint64 nowMSecs)
+{
+    int frameBytes = message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        frameBytes = message.len + MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + MAVLINK_NUM_CHECKSUM_BYTES;
+    } else if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        frameBytes += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+
+    _lastReceiveMSecs = nowMSecs;
+    _windowBytes += frameBytes;
+    _windowReceived++;
+
+    int16_t& lastSeq = _lastSeqByCompId[message.compid];
+    if (lastSeq != -1) {
+        const int gap = (message.seq - lastSeq) & 0xFF;
+        if (gap > 1 && gap <= _maxSeqGap) {
+            _windowLost += gap - 1;
+        }
+    }
+    lastSeq = message.seq;
+}
+
+void LinkHealth::addRttSample(double rttMSecs)
+{
+    rttMSecs = qMax(0.0, rttMSecs);
+
+    if (_rttSampleCount == 0) {
+        _srttMSecs = rttMSecs;
+    } else {
+        _jitterMSecs    += (qAbs(rttMSecs - _lastRttMSecs) - _jitterMSecs) * _jitterGain;
+        _srttMSecs      = ((1.0 - _rttAlpha) * _srttMSecs) + (_rttAlpha * rttMSecs);
+    }
+    _lastRttMSecs = rttMSecs;
+    _rttSampleCount++;
+}
+
+void LinkHealth::updateWindow(qint64 nowMSecs)
+{
+    if (_windowStartMSecs < 0) {
+        _windowStartMSecs = nowMSecs;
+        return;
+    }
+
+    const qint64 elapsedMSecs = nowMSecs - _windowStartMSecs;
+    if (elapsedMSecs <= 0) {
+        return;
+    }
+
+    const double throughput = (_windowBytes * 1000.0) / elapsedMSecs;
+    if (_firstWindow) {
+        _throughputBytesPerSec  = throughput;
+    } else {
+        _throughputBytesPerSec  = ((1.0 - _windowAlpha) * _throughputBytesPerSec) + (_windowAlpha * throughput);
+    }
+
+    // Loss can only be measured from sequence gaps, a silent link is caught by the stall check instead
+    if (_windowReceived != 0) {
+        const double loss = (_windowLost * 100.0) / (_windowReceived + _windowLost);
+        if (_firstWindow) {
+            _lossPercent = loss;
+        } else {
+            _lossPercent = ((1.0 - _windowAlpha) * _lossPercent) + (_windowAlpha * loss);
+        }
+    }
+    _firstWindow = false;
+
+    _windowStartMSecs   = nowMSecs;
+    _windowReceived     = 0;
+    _windowLost         = 0;
+    _windowBytes        = 0;
+}
+
+double LinkHealth::costMSecs(void) const
+{
+    if (_rttSampleCount == 0) {
+        return -1;
+    }
+
+    // Both the message and its response have to make it through
+    const double delivery = qMax(_minDelivery, qPow(1.0 - (_lossPercent / 100.0), 2));
+    return (_srttMSecs + (2 * _jitterMSecs)) / delivery;
+}
+
+QVariantMap LinkHealth::toVariantMap(void) const
+{
+    QVariantMap map;
+    map["rttSamples"]           = _rttSampleCount;
+    map["rttMSecs"]             = _srttMSecs;
+    map["jitterMSecs"]          = _jitterMSecs;
+    map["lossPercent"]          = _lossPercent;
+    map["throughputBytesPerSec"]= _throughputBytesPerSec;
+    map["costMSecs"]            = costMSecs();
+    return map;
+}
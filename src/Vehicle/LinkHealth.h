@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QVariantMap>
+
+#include <array>
+
+/// Quality metrics for a single link to a vehicle: round trip time and jitter from TIMESYNC probes, message loss from
+/// sequence number gaps and receive throughput. Times are passed in so the metrics can be driven from tests.
+class LinkHealth
+{
+public:
+    LinkHealth(void);
+
+    /// Updates loss and throughput accounting for a message received from the vehicle on this link
+    void messageReceived(const mavlink_message_t& message, qint64 nowMSecs);
+
+    void addRttSample(double rttMSecs);
+
+    /// Closes the current measurement window and folds it into the smoothed loss and throughput values
+    void updateWindow(qint64 nowMSecs);
+
+    int     rttSampleCount          (void) const { return _rttSampleCount; }
+    double  rttMSecs                (void) const { return _srttMSecs; }
+    double  jitterMSecs             (void) const { return _jitterMSecs; }
+    double  lossPercent             (void) const { return _lossPercent; }
+    double  throughputBytesPerSec   (void) const { return _throughputBytesPerSec; }
+    qint64  lastReceiveMSecs        (void) const { return _lastReceiveMSecs; }
+
+    /// Expected time to get a message through and its response back, accounting for jitter and loss. Lower is better.
+    ///     @return -1: Not known yet
+    double costMSecs(void) const;
+
+    QVariantMap toVariantMap(void) const;
+
+private:
+    int                         _rttSampleCount         = 0;
+    double                      _srttMSecs              = 0;
+    double                      _jitterMSecs            = 0;
+    double                      _lastRttMSecs           = 0;
+    double                      _lossPercent            = 0;
+    double                      _throughputBytesPerSec  = 0;
+    qint64                      _lastReceiveMSecs       = 0;
+    qint64                      _windowStartMSecs       = -1;
+    int                         _windowReceived         = 0;
+    int                         _windowLost             = 0;
+    int                         _windowBytes            = 0;
+    bool                        _firstWindow            = true;
+    std::array<int16_t, 256>    _lastSeqByCompId;                   ///< -1 for components not heard from yet
+
+    static constexpr double _rttAlpha       = 1.0 / 8.0;    ///< Same smoothing as the RFC 6298 RTT estimate
+    static constexpr double _jitterGain     = 1.0 / 16.0;   ///< RFC 3550 interarrival jitter gain
+    static constexpr double _windowAlpha    = 0.25;
+    static constexpr double _minDelivery    = 0.05;
+    static const int        _maxSeqGap      = 128;          ///< Larger gaps are treated as a sequence reset rather than loss
+};
@@ -58,6 +58,8 @@ void MultiVehicleManager::setToolbox(QGCToolbox *toolbox)
     qmlRegisterUncreatableType<MultiVehicleManager>("QGroundControl.MultiVehicleManager", 1, 0, "MultiVehicleManager", "Reference only");
 
     connect(_mavlinkProtocol, &MAVLinkProtocol::vehicleHeartbeatInfo, this, &MultiVehicleManager::_vehicleHeartbeatInfo);
+    connect(_mavlinkProtocol, &MAVLinkProtocol::messageReceived,      this, &MultiVehicleManager::_mavlinkMessageReceived);
+    connect(_mavlinkProtocol, &MAVLinkProtocol::mavlinkMessageStatus, this, &MultiVehicleManager::_mavlinkMessageStatus);
     connect(&_gcsHeartbeatTimer, &QTimer::timeout, this, &MultiVehicleManager::_sendGCSHeartbeat);
 
     if (_gcsHeartbeatEnabled) {
@@ -136,6 +138,7 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
     connect(vehicle->parameterManager(),    &ParameterManager::parametersReadyChanged,  this, &MultiVehicleManager::_vehicleParametersReadyChanged);
 
     _vehicles.append(vehicle);
+    _vehicleRoutingTable[vehicleId] = vehicle;
 
     // Send QGC heartbeat ASAP, this allows PX4 to start accepting commands
     _sendGCSHeartbeat();
@@ -204,6 +207,7 @@ void MultiVehicleManager::_deleteVehiclePhase1(Vehicle* vehicle)
     if (!found) {
         qWarning() << "Vehicle not found in map!";
     }
+    _vehicleRoutingTable.remove(vehicle->id());
 
     vehicle->uas()->shutdownVehicle();
 
@@ -344,14 +348,34 @@ QString MultiVehicleManager::loadSetting(const QString &name, const QString& def
 
 Vehicle* MultiVehicleManager::getVehicleById(int vehicleId)
 {
-    for (int i=0; i< _vehicles.count(); i++) {
-        Vehicle* vehicle = qobject_cast<Vehicle*>(_vehicles[i]);
-        if (vehicle->id() == vehicleId) {
-            return vehicle;
+    return _vehicleRoutingTable.value(vehicleId, nullptr);
+}
+
+void MultiVehicleManager::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
+{
+    if (message.sysid == 0 || message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+        // Broadcasts go to all vehicles. RADIO_STATUS comes from the radio's own system id, so it is offered to all
+        // vehicles and each one only accepts it if the message arrived on a link it is using.
+        // Vehicles are only deleted from a queued phase so a copy of the table stays valid while handlers run.
+        const QList<Vehicle*> rgVehicles = _vehicleRoutingTable.values();
+        for (Vehicle* vehicle: rgVehicles) {
+            vehicle->_mavlinkMessageReceived(link, message);
         }
+        return;
     }
 
-    return nullptr;
+    Vehicle* vehicle = _vehicleRoutingTable.value(message.sysid, nullptr);
+    if (vehicle) {
+        vehicle->_mavlinkMessageReceived(link, message);
+    }
+}
+
+void MultiVehicleManager::_mavlinkMessageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent)
+{
+    Vehicle* vehicle = _vehicleRoutingTable.value(sysid, nullptr);
+    if (vehicle) {
+        vehicle->_mavlinkMessageStatus(sysid, totalSent, totalReceived, totalLoss, lossPercent);
+    }
 }
 
 void MultiVehicleManager::setGcsHeartbeatEnabled(bool gcsHeartBeatEnabled)
@@ -394,7 +418,7 @@ void MultiVehicleManager::_sendGCSHeartbeat(void)
 
             uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
             int len = mavlink_msg_to_send_buffer(buffer, &message);
-            link->writeBytesThreadSafe((const char*)buffer, len);
+            link->writeBytesThreadSafe((const char*)buffer, len, LinkOutboundScheduler::PriorityCommand);
         }
     }
 }
@@ -20,6 +20,8 @@
 #include "QGCToolbox.h"
 #include "QGCLoggingCategory.h"
 
+#include <QHash>
+
 class FirmwarePluginManager;
 class FollowMe;
 class JoystickManager;
@@ -94,6 +96,8 @@ private slots:
     void _vehicleHeartbeatInfo          (LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType);
     void _requestProtocolVersion        (unsigned version);
     void _coordinateChanged             (QGeoCoordinate coordinate);
+    void _mavlinkMessageReceived        (LinkInterface* link, mavlink_message_t message);
+    void _mavlinkMessageStatus          (int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
 
 private:
     bool _vehicleExists(int vehicleId);
@@ -110,6 +114,10 @@ private:
 
     QmlObjectListModel  _vehicles;
 
+    /// Incoming messages are routed through this table so each message is only delivered to the vehicle it belongs to.
+    /// Consumers which need traffic from all vehicles (MAVLink Inspector for example) connect to MAVLinkProtocol::messageReceived.
+    QHash<int /* sysid */, Vehicle*> _vehicleRoutingTable;
+
     FirmwarePluginManager*      _firmwarePluginManager;
     JoystickManager*            _joystickManager;
     MAVLinkProtocol*            _mavlinkProtocol;
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MultiVehicleManagerTest.h"
+#include "MultiVehicleManager.h"
+#include "LinkManager.h"
+#include "MockLink.h"
+#include "MockLinkSwarm.h"
+#include "QGCApplication.h"
+#include "TelemetryTracer.h"
+
+MultiVehicleManagerTest::MultiVehicleManagerTest(void)
+{
+
+}
+
+void MultiVehicleManagerTest::cleanup(void)
+{
+    _linkManager->setTelemetryTracingEnabled(false);
+    TelemetryTracer::reset();
+    UnitTest::cleanup();
+}
+
+void MultiVehicleManagerTest::_routingTableTest(void)
+{
+    MultiVehicleManager* multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+
+    MockLink* mockLink = MockLink::startSwarmMockLink(_vehicleCount, _telemetryRateHz);
+    QVERIFY(mockLink);
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == _vehicleCount; }, _vehicleWaitMSecs));
+
+    const QList<int> rgSystemIds = mockLink->swarm()->systemIds();
+    QCOMPARE(rgSystemIds.count(), _vehicleCount);
+    for (int systemId: rgSystemIds) {
+        Vehicle* vehicle = multiVehicleManager->getVehicleById(systemId);
+        QVERIFY(vehicle);
+        QCOMPARE(vehicle->id(), systemId);
+    }
+    QVERIFY(!multiVehicleManager->getVehicleById(0));
+
+    // Vehicles must leave the routing table as soon as they are removed from the vehicle list
+    mockLink->disconnect();
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == 0; }, _vehicleWaitMSecs));
+    for (int systemId: rgSystemIds) {
+        QVERIFY(!multiVehicleManager->getVehicleById(systemId));
+    }
+}
+
+void MultiVehicleManagerTest::_singleDeliveryTest(void)
+{
+    MultiVehicleManager* multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+
+    MockLink* mockLink = MockLink::startSwarmMockLink(_vehicleCount, _telemetryRateHz);
+    QVERIFY(mockLink);
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == _vehicleCount; }, _vehicleWaitMSecs));
+
+    // Each Vehicle::_mavlinkMessageReceived call is traced, so the trace count must match the number of messages
+    // vehicles accepted. Delivering every message to every vehicle would show up as vehicleCount times as many calls.
+    QList<uint> rgStartMessagesReceived;
+    for (int i=0; i<_vehicleCount; i++) {
+        rgStartMessagesReceived.append(multiVehicleManager->vehicles()->value<Vehicle*>(i)->messagesReceived());
+    }
+    TelemetryTracer::reset();
+    _linkManager->setTelemetryTracingEnabled(true);
+
+    QTest::qWait(1000);
+
+    _linkManager->setTelemetryTracingEnabled(false);
+    quint64 acceptedCount = 0;
+    for (int i=0; i<_vehicleCount; i++) {
+        Vehicle* vehicle = multiVehicleManager->vehicles()->value<Vehicle*>(i);
+        uint vehicleAcceptedCount = vehicle->messagesReceived() - rgStartMessagesReceived[i];
+        QVERIFY(vehicleAcceptedCount > 0);
+        acceptedCount += vehicleAcceptedCount;
+    }
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageVehicleMessage).count(), acceptedCount);
+
+    mockLink->disconnect();
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == 0; }, _vehicleWaitMSecs));
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests routing of incoming messages to vehicles by system id
+class MultiVehicleManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MultiVehicleManagerTest(void);
+
+protected:
+    void cleanup(void) final;
+
+private slots:
+    void _routingTableTest      (void);
+    void _singleDeliveryTest    (void);
+
+private:
+    static const int _vehicleCount      = 4;
+    static const int _telemetryRateHz   = 10;
+    static const int _vehicleWaitMSecs  = 10000;
+};
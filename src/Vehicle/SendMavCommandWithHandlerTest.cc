@@ -66,7 +66,7 @@ void SendMavCommandWithHandlerTest::_duplicateCommand(void)
     _connectMockLinkNoInitialConnectSequence();
 
     SendMavCommandWithHandlerTest::TestCase_t testCase = {
-        MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, MAV_RESULT_FAILED, 0, Vehicle::MavCmdResultFailureDuplicateCommand, 1
+        MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, MAV_RESULT_ACCEPTED, 0, Vehicle::MavCmdResultCommandResultOnly, 2
     };
 
     MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
@@ -75,14 +75,23 @@ void SendMavCommandWithHandlerTest::_duplicateCommand(void)
     _handlerCalled = false;
     _mockLink->clearSendMavCommandCounts();
     vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, testCase.command, true /* showError */);
-    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(testCase.command) == 1; }, 10));
-    QVERIFY(!_handlerCalled);
     vehicle->sendMavCommandWithHandler(_mavCmdResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, testCase.command);
 
-    // Duplicate command response should happen immediately
-    QVERIFY(_handlerCalled);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command) != -1);
-    QCOMPARE(_mockLink->sendMavCommandCount(testCase.command), 1);
+    // Duplicate command is queued behind the first one and only sent once the first one is acked
+    QVERIFY(!_handlerCalled);
+    QCOMPARE(vehicle->_mavCommandQueue.count(), 1);
+    QVERIFY(vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, testCase.command));
+    QVERIFY(QTest::qWaitFor([&]() { return _handlerCalled; }, 10000));
+    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command), -1);
+    QVERIFY(!vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, testCase.command));
+    QCOMPARE(_mockLink->sendMavCommandCount(testCase.command), testCase.expectedSendCount);
+
+    // Both acks provide RTT samples for the link
+    const QVariantMap latencyStats = vehicle->commandLatencyStats();
+    QCOMPARE(latencyStats.count(), 1);
+    QVERIFY(latencyStats.first().toMap()["samples"].toInt() >= 2);
+
+    _disconnectMockLink();
 }
 
 void SendMavCommandWithHandlerTest::_compIdAllMavCmdResultHandler(void* /*resultHandlerData*/, int compId, MAV_RESULT commandResult, uint8_t progress, Vehicle::MavCmdResultFailureCode_t failureCode)
@@ -63,19 +63,101 @@ void SendMavCommandWithSignallingTest::_duplicateCommand(void)
     MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
     Vehicle*                vehicle     = vehicleMgr->activeVehicle();
 
-    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, true /* showError */);
-    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE) == 1; }, 10));
+    _mockLink->clearSendMavCommandCounts();
+    QSignalSpy spyResult(vehicle, &Vehicle::mavCommandResult);
+    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, true /* showError */);
+    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, true /* showError */);
+
+    // Duplicate command is queued rather than failed
+    QCOMPARE(spyResult.count(),                                                         0);
+    QCOMPARE(vehicle->_mavCommandQueue.count(),                                         1);
+    QVERIFY(QTest::qWaitFor([&]() { return spyResult.count() == 2; }, 10000));
+    for (int i=0; i<2; i++) {
+        QList<QVariant> arguments = spyResult.takeFirst();
+        QCOMPARE(arguments.count(),                                                     5);
+        QCOMPARE(arguments.at(0).toInt(),                                               vehicle->id());
+        QCOMPARE(arguments.at(2).toInt(),                                               (int)MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED);
+        QCOMPARE(arguments.at(3).toInt(),                                               (int)MAV_RESULT_ACCEPTED);
+        QCOMPARE(arguments.at(4).value<Vehicle::MavCmdResultFailureCode_t>(),           Vehicle::MavCmdResultCommandResultOnly);
+    }
+    QCOMPARE(_mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED), 2);
+    QVERIFY(!vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED));
+}
+
+void SendMavCommandWithSignallingTest::_duplicateCommandMerge(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
+    Vehicle*                vehicle     = vehicleMgr->activeVehicle();
+    const int               compId      = vehicle->defaultComponentId();
+    const int               setpoints   = 5;
+
+    _mockLink->clearSendMavCommandCounts();
     QSignalSpy spyResult(vehicle, &Vehicle::mavCommandResult);
-    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, true /* showError */);
 
-    // Duplicate command returns immediately
+    // A burst of gimbal setpoints: the first goes out, the rest collapse into a single queued command holding the latest one
+    for (int i=0; i<setpoints; i++) {
+        vehicle->gimbalControlValue(10 * i, 0);
+    }
+    QCOMPARE(vehicle->_mavCommandQueue.count(),                                         1);
+    QCOMPARE(vehicle->_mavCommandQueue[0].rgParam[0],                                   10.0f * (setpoints - 1));
+
+    // Replaced setpoints are reported as never sent
+    QCOMPARE(spyResult.count(),                                                         setpoints - 2);
+    for (int i=0; i<setpoints - 2; i++) {
+        QList<QVariant> arguments = spyResult.takeFirst();
+        QCOMPARE(arguments.at(1).toInt(),                                               compId);
+        QCOMPARE(arguments.at(2).toInt(),                                               (int)MAV_CMD_DO_MOUNT_CONTROL);
+        QCOMPARE(arguments.at(3).toInt(),                                               (int)MAV_RESULT_FAILED);
+        QCOMPARE(arguments.at(4).value<Vehicle::MavCmdResultFailureCode_t>(),           Vehicle::MavCmdResultFailureDuplicateCommand);
+    }
+
+    QVERIFY(QTest::qWaitFor([&]() { return !vehicle->isMavCommandPending(compId, MAV_CMD_DO_MOUNT_CONTROL); }, 10000));
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_DO_MOUNT_CONTROL),                  2);
+    QCOMPARE(_mockLink->lastSendMavCommand(MAV_CMD_DO_MOUNT_CONTROL).param1,            10.0f * (setpoints - 1));
+
+    // Time critical commands are never queued behind an outstanding one
+    spyResult.clear();
+    vehicle->sendMavCommand(compId, MAV_CMD_COMPONENT_ARM_DISARM, false /* showError */, 1);
+    vehicle->sendMavCommand(compId, MAV_CMD_COMPONENT_ARM_DISARM, false /* showError */, 0);
+    QCOMPARE(vehicle->_mavCommandQueue.count(),                                         0);
     QCOMPARE(spyResult.count(),                                                         1);
-    QList<QVariant> arguments = spyResult.takeFirst();
-    QCOMPARE(arguments.count(),                                                         5);
-    QCOMPARE(arguments.at(0).toInt(),                                                   vehicle->id());
-    QCOMPARE(arguments.at(2).toInt(),                                                   (int)MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE);
-    QCOMPARE(arguments.at(3).toInt(),                                                   (int)MAV_RESULT_FAILED);
-    QCOMPARE(arguments.at(4).value<Vehicle::MavCmdResultFailureCode_t>(),               Vehicle::MavCmdResultFailureDuplicateCommand);
-    QCOMPARE(_mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE),    1);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE) != -1);
+    QCOMPARE(spyResult.takeFirst().at(4).value<Vehicle::MavCmdResultFailureCode_t>(),   Vehicle::MavCmdResultFailureDuplicateCommand);
+}
+
+void SendMavCommandWithSignallingTest::_latencySampling(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
+    Vehicle*                vehicle     = vehicleMgr->activeVehicle();
+    const QString           linkName    = _mockLink->linkConfiguration()->name();
+    QSignalSpy              spyResult(vehicle, &Vehicle::mavCommandResult);
+
+    auto sampleCount = [&]() { return vehicle->commandLatencyStats()[linkName].toMap()["samples"].toInt(); };
+    auto sendAndWait = [&](MAV_CMD command) {
+        spyResult.clear();
+        vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, command, false /* showError */);
+        return QTest::qWaitFor([&]() { return spyResult.count() == 1; }, 10000) && spyResult.first().at(2).toInt() == command;
+    };
+
+    _mockLink->clearSendMavCommandCounts();
+    const int startSampleCount = sampleCount();
+
+    // Acked on the first send
+    QVERIFY(sendAndWait(MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED));
+    QCOMPARE(sampleCount(),                                                                         startSampleCount + 1);
+
+    // Karn's rule: the ack to a resent command could belong to either send so it is not sampled
+    QVERIFY(sendAndWait(MockLink::MAV_CMD_MOCKLINK_SECOND_ATTEMPT_RESULT_ACCEPTED));
+    QCOMPARE(_mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_SECOND_ATTEMPT_RESULT_ACCEPTED), 2);
+    QCOMPARE(sampleCount(),                                                                         startSampleCount + 1);
+
+    // Commands which are not retried are not sampled either, their ack time is not link latency
+    QVERIFY(sendAndWait(MAV_CMD_DO_SET_SERVO));
+    QCOMPARE(spyResult.first().at(3).toInt(),                                                       (int)MAV_RESULT_UNSUPPORTED);
+    QCOMPARE(sampleCount(),                                                                         startSampleCount + 1);
+
+    _disconnectMockLink();
 }
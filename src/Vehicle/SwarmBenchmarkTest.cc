@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SwarmBenchmarkTest.h"
+#include "MockLink.h"
+#include "MockLinkSwarm.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "Vehicle.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <ctime>
+
+SwarmBenchmarkTest::SwarmBenchmarkTest(void)
+{
+
+}
+
+/// Writes out all collected results once the full benchmark run is complete
+void SwarmBenchmarkTest::cleanupTestCase(void)
+{
+    _results.write(objectName());
+}
+
+/// @return Resident set size of the process in MB, -1 if not available on this platform
+double SwarmBenchmarkTest::_residentMemoryMB(void)
+{
+#if defined(Q_OS_LINUX)
+    QFile statusFile(QStringLiteral("/proc/self/status"));
+    if (statusFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        for (const QByteArray& line: statusFile.readAll().split('\n')) {
+            if (line.startsWith("VmRSS:")) {
+                // Format is "VmRSS:     12345 kB"
+                return line.mid(6).trimmed().split(' ').first().toDouble() / 1024.0;
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+double SwarmBenchmarkTest::_percentile(const QList<qint64>& sortedNsecs, double percentile)
+{
+    if (sortedNsecs.isEmpty()) {
+        return -1;
+    }
+    int index = qMin(sortedNsecs.count() - 1, static_cast<int>(sortedNsecs.count() * percentile));
+    return sortedNsecs[index] / 1000000.0;
+}
+
+void SwarmBenchmarkTest::_swarmWorker(const QString& benchmarkName, int vehicleCount, int linkCount, int telemetryRateHz, double lossPct, int jitterMSecs)
+{
+    MultiVehicleManager* multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+    QCOMPARE(multiVehicleManager->vehicles()->count(), 0);
+
+    const double rssStartMB = _residentMemoryMB();
+
+    QList<MockLink*> rgLinks;
+    for (int i=0; i<linkCount; i++) {
+        int linkVehicleCount = (vehicleCount / linkCount) + (i < vehicleCount % linkCount ? 1 : 0);
+        MockLink* mockLink = MockLink::startSwarmMockLink(linkVehicleCount, telemetryRateHz, lossPct, jitterMSecs);
+        QVERIFY(mockLink);
+        QVERIFY(mockLink->swarm());
+        rgLinks.append(mockLink);
+    }
+
+    QElapsedTimer connectTimer;
+    connectTimer.start();
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == vehicleCount; }, _vehicleWaitMSecs));
+    const qint64 connectNsecs = connectTimer.nsecsElapsed();
+
+    // Map each vehicle back to the swarm which generates it so Fact updates can be matched to emit times
+    QHash<int, MockLinkSwarm*> systemIdToSwarm;
+    for (MockLink* mockLink: rgLinks) {
+        for (int systemId: mockLink->swarm()->systemIds()) {
+            systemIdToSwarm[systemId] = mockLink->swarm();
+        }
+    }
+
+    QList<qint64>                   rgLatencyNsecs;
+    QList<QMetaObject::Connection>  rgConnections;
+    bool                            sampling        = false;
+    int                             unmatchedCount  = 0;
+
+    for (int i=0; i<multiVehicleManager->vehicles()->count(); i++) {
+        Vehicle*        vehicle = multiVehicleManager->vehicles()->value<Vehicle*>(i);
+        MockLinkSwarm*  swarm   = systemIdToSwarm.value(vehicle->id(), nullptr);
+        QVERIFY(swarm);
+
+        Fact* altitudeRelative = vehicle->altitudeRelative();
+        rgConnections.append(connect(altitudeRelative, &Fact::rawValueChanged, vehicle, [&, swarm, vehicle](QVariant value) {
+            if (sampling) {
+                qint64 latencyNsecs = swarm->positionLatencyNsecs(vehicle->id(), value.toDouble());
+                if (latencyNsecs >= 0) {
+                    rgLatencyNsecs.append(latencyNsecs);
+                } else {
+                    unmatchedCount++;
+                }
+            }
+        }));
+    }
+
+    QTest::qWait(_warmupMSecs);
+
+    sampling = true;
+    QElapsedTimer   wallTimer;
+    std::clock_t    cpuStart = std::clock();
+    wallTimer.start();
+
+    QTest::qWait(_sampleMSecs);
+
+    std::clock_t    cpuEnd      = std::clock();
+    qint64          wallNsecs   = wallTimer.nsecsElapsed();
+    sampling = false;
+
+    const double rssEndMB = _residentMemoryMB();
+
+    for (const QMetaObject::Connection& connection: rgConnections) {
+        disconnect(connection);
+    }
+
+    for (MockLink* mockLink: rgLinks) {
+        mockLink->disconnect();
+    }
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == 0; }, _vehicleWaitMSecs));
+
+    QVERIFY(!rgLatencyNsecs.isEmpty());
+    std::sort(rgLatencyNsecs.begin(), rgLatencyNsecs.end());
+
+    qint64 totalLatencyNsecs = 0;
+    for (qint64 nsecs: rgLatencyNsecs) {
+        totalLatencyNsecs += nsecs;
+    }
+
+    const double wallSecs   = wallNsecs / 1e9;
+    // std::clock is process cpu time summed over all threads, so this can exceed 100% on multi-core machines
+    const double cpuSecs    = static_cast<double>(cpuEnd - cpuStart) / CLOCKS_PER_SEC;
+
+    QJsonObject result;
+    result["name"]                  = benchmarkName;
+    result["vehicleCount"]          = vehicleCount;
+    result["linkCount"]             = linkCount;
+    result["telemetryRateHz"]       = telemetryRateHz;
+    result["lossPct"]               = lossPct;
+    result["jitterMSecs"]           = jitterMSecs;
+    result["connectMs"]             = connectNsecs / 1000000.0;
+    result["cpuPct"]                = (cpuSecs / wallSecs) * 100.0;
+    result["rssStartMB"]            = rssStartMB;
+    result["rssEndMB"]              = rssEndMB;
+    result["rssPerVehicleKB"]       = rssStartMB < 0 ? -1 : ((rssEndMB - rssStartMB) * 1024.0) / vehicleCount;
+    result["factUpdates"]           = rgLatencyNsecs.count();
+    result["factUpdatesPerSec"]     = rgLatencyNsecs.count() / wallSecs;
+    result["unmatchedUpdates"]      = unmatchedCount;
+    result["latencyMinMs"]          = rgLatencyNsecs.first() / 1000000.0;
+    result["latencyMedianMs"]       = _percentile(rgLatencyNsecs, 0.5);
+    result["latencyP95Ms"]          = _percentile(rgLatencyNsecs, 0.95);
+    result["latencyP99Ms"]          = _percentile(rgLatencyNsecs, 0.99);
+    result["latencyMaxMs"]          = rgLatencyNsecs.last() / 1000000.0;
+    result["latencyMeanMs"]         = (totalLatencyNsecs / rgLatencyNsecs.count()) / 1000000.0;
+    _results.append(result);
+
+    qDebug() << "Benchmark" << benchmarkName
+             << "cpu(%)" << result["cpuPct"].toDouble()
+             << "rss(MB)" << rssEndMB
+             << "latency median(ms)" << result["latencyMedianMs"].toDouble()
+             << "p99(ms)" << result["latencyP99Ms"].toDouble();
+}
+
+void SwarmBenchmarkTest::_benchSwarm1(void)
+{
+    _swarmWorker(QStringLiteral("swarm1"), 1, 1, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm10(void)
+{
+    _swarmWorker(QStringLiteral("swarm10"), 10, 1, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm50(void)
+{
+    _swarmWorker(QStringLiteral("swarm50"), 50, 1, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm100(void)
+{
+    _swarmWorker(QStringLiteral("swarm100"), 100, 1, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm200(void)
+{
+    _swarmWorker(QStringLiteral("swarm200"), 200, 1, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm200FourLinks(void)
+{
+    _swarmWorker(QStringLiteral("swarm200FourLinks"), 200, 4, _telemetryRateHz, 0, 0);
+}
+
+void SwarmBenchmarkTest::_benchSwarm100LossJitter(void)
+{
+    _swarmWorker(QStringLiteral("swarm100Loss5Jitter50"), 100, 1, _telemetryRateHz, 5, 50);
+}
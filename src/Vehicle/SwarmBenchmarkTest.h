@@ -0,0 +1,55 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "BenchmarkResults.h"
+
+class MockLink;
+
+/// Scalability benchmarks which connect an increasing number of MockLink swarm vehicles and measure
+/// GCS cpu usage, resident memory and end to end latency from the link emitting a GLOBAL_POSITION_INT
+/// to the Vehicle altitudeRelative Fact changing.
+///
+/// This is a standalone test which is only run when specifically requested from the command line:
+///     QGroundControl --unittest:SwarmBenchmarkTest
+///
+/// Results are written to the shared benchmark results file, see BenchmarkResults.
+class SwarmBenchmarkTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    SwarmBenchmarkTest(void);
+
+private slots:
+    void cleanupTestCase(void);
+
+    void _benchSwarm1               (void);
+    void _benchSwarm10              (void);
+    void _benchSwarm50              (void);
+    void _benchSwarm100             (void);
+    void _benchSwarm200             (void);
+    void _benchSwarm200FourLinks    (void);
+    void _benchSwarm100LossJitter   (void);
+
+private:
+    void _swarmWorker(const QString& benchmarkName, int vehicleCount, int linkCount, int telemetryRateHz, double lossPct, int jitterMSecs);
+
+    static double _residentMemoryMB (void);
+    static double _percentile       (const QList<qint64>& sortedNsecs, double percentile);
+
+    BenchmarkResults _results;
+
+    static const int    _telemetryRateHz    = 10;
+    static const int    _warmupMSecs        = 2000;
+    static const int    _sampleMSecs        = 10000;
+    static const int    _vehicleWaitMSecs   = 30000;
+};
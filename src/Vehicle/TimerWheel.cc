@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(int tickMSecs, int slotCount, QObject* parent)
+    : QObject   (parent)
+    , _tickMSecs(qMax(1, tickMSecs))
+    , _slots    (qMax(1, slotCount))
+{
+    _tickTimer.setSingleShot(false);
+    _tickTimer.setInterval(_tickMSecs);
+    connect(&_tickTimer, &QTimer::timeout, this, &TimerWheel::_tick);
+}
+
+void TimerWheel::schedule(quint32 id, int msecs)
+{
+    cancel(id);
+
+    const int cSlots    = _slots.count();
+    const int ticks     = qMax(1, (msecs + _tickMSecs - 1) / _tickMSecs);
+    const int slot      = (_currentSlot + ticks) % cSlots;
+
+    _slots[slot].append({ id, (ticks - 1) / cSlots });
+    _idToSlot[id] = slot;
+
+    if (!_tickTimer.isActive()) {
+        _tickTimer.start();
+    }
+}
+
+void TimerWheel::cancel(quint32 id)
+{
+    auto it = _idToSlot.find(id);
+    if (it != _idToSlot.end()) {
+        _removeFromSlot(id, it.value());
+        _idToSlot.erase(it);
+    }
+    if (_idToSlot.isEmpty()) {
+        _tickTimer.stop();
+    }
+}
+
+void TimerWheel::clear(void)
+{
+    for (QVector<Entry_t>& slot: _slots) {
+        slot.clear();
+    }
+    _idToSlot.clear();
+    _tickTimer.stop();
+}
+
+void TimerWheel::_removeFromSlot(quint32 id, int slot)
+{
+    QVector<Entry_t>& entries = _slots[slot];
+    for (int i=0; i<entries.count(); i++) {
+        if (entries[i].id == id) {
+            entries.removeAt(i);
+            return;
+        }
+    }
+}
+
+void TimerWheel::_tick(void)
+{
+    _currentSlot = (_currentSlot + 1) % _slots.count();
+
+    // Collect expired ids first since expiry handlers are free to schedule and cancel
+    QVector<quint32>    expiredIds;
+    QVector<Entry_t>&   entries = _slots[_currentSlot];
+    for (int i=entries.count()-1; i>=0; i--) {
+        if (entries[i].rounds == 0) {
+            expiredIds.prepend(entries[i].id);
+            _idToSlot.remove(entries[i].id);
+            entries.removeAt(i);
+        } else {
+            entries[i].rounds--;
+        }
+    }
+
+    if (_idToSlot.isEmpty()) {
+        _tickTimer.stop();
+    }
+
+    for (quint32 id: expiredIds) {
+        emit expired(id);
+    }
+}
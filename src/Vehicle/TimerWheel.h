@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QHash>
+
+/// Hashed timer wheel for large numbers of short lived timeouts. Scheduling and cancelling are O(1) and a single
+/// QTimer drives all timeouts. The timer only runs while something is scheduled. Timeouts have a resolution of
+/// one tick and fire within one tick of the requested time.
+class TimerWheel : public QObject
+{
+    Q_OBJECT
+
+public:
+    TimerWheel(int tickMSecs, int slotCount, QObject* parent = nullptr);
+
+    /// Schedules a timeout for the specified id. An existing timeout for the same id is replaced.
+    void schedule   (quint32 id, int msecs);
+    void cancel     (quint32 id);
+    void clear      (void);
+
+    bool isScheduled(quint32 id) const { return _idToSlot.contains(id); }
+    int  count      (void) const { return _idToSlot.count(); }
+    int  tickMSecs  (void) const { return _tickMSecs; }
+
+signals:
+    void expired(quint32 id);
+
+private slots:
+    void _tick(void);
+
+private:
+    struct Entry_t {
+        quint32 id;
+        int     rounds;     ///< Number of full wheel revolutions remaining before expiry
+    };
+
+    void _removeFromSlot(quint32 id, int slot);
+
+    int                         _tickMSecs;
+    QVector<QVector<Entry_t>>   _slots;
+    QHash<quint32, int>         _idToSlot;
+    int                         _currentSlot = 0;
+    QTimer                      _tickTimer;
+
+    friend class TimerWheelTest;
+};
@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TimerWheelTest.h"
+#include "TimerWheel.h"
+
+#include <QSignalSpy>
+
+/// @return Remaining rounds for the id, -1 if it is not in the slot it is mapped to
+int TimerWheelTest::_rounds(const TimerWheel& wheel, quint32 id) const
+{
+    for (const TimerWheel::Entry_t& entry: wheel._slots[wheel._idToSlot.value(id)]) {
+        if (entry.id == id) {
+            return entry.rounds;
+        }
+    }
+    return -1;
+}
+
+void TimerWheelTest::_slotArithmeticTest(void)
+{
+    TimerWheel wheel(10 /* tickMSecs */, 4 /* slotCount */);
+
+    // Timeouts are rounded up to whole ticks, with at least one tick
+    wheel.schedule(1, 0);
+    wheel.schedule(2, 25);
+    wheel.schedule(3, 40);
+    // Longer than a revolution: ten ticks is slot 2 after two full revolutions
+    wheel.schedule(4, 100);
+
+    QCOMPARE(wheel.count(), 4);
+    QCOMPARE(wheel._idToSlot.value(1), 1);
+    QCOMPARE(_rounds(wheel, 1), 0);
+    QCOMPARE(wheel._idToSlot.value(2), 3);
+    QCOMPARE(_rounds(wheel, 2), 0);
+    QCOMPARE(wheel._idToSlot.value(3), 0);
+    QCOMPARE(_rounds(wheel, 3), 0);
+    QCOMPARE(wheel._idToSlot.value(4), 2);
+    QCOMPARE(_rounds(wheel, 4), 2);
+    QVERIFY(wheel._tickTimer.isActive());
+
+    // Slots are relative to the current position of the wheel
+    wheel._tick();
+    wheel.schedule(5, 30);
+    QCOMPARE(wheel._idToSlot.value(5), 0);
+    QCOMPARE(_rounds(wheel, 5), 0);
+}
+
+void TimerWheelTest::_expiryOrderTest(void)
+{
+    TimerWheel  wheel(10 /* tickMSecs */, 4 /* slotCount */);
+    QSignalSpy  spyExpired(&wheel, &TimerWheel::expired);
+
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 30);
+    wheel.schedule(3, 40);
+    wheel.schedule(4, 100);
+
+    // Each id must fire on exactly the tick its timeout rounds up to
+    const QList<QPair<int, quint32>> expected = { { 1, 1 }, { 3, 2 }, { 4, 3 }, { 10, 4 } };
+    int expectedIndex = 0;
+    for (int tick=1; tick<=10; tick++) {
+        wheel._tick();
+        while (expectedIndex < expected.count() && expected[expectedIndex].first == tick) {
+            QCOMPARE(spyExpired.count(), 1);
+            QCOMPARE(spyExpired.takeFirst().at(0).value<quint32>(), expected[expectedIndex].second);
+            expectedIndex++;
+        }
+        QCOMPARE(spyExpired.count(), 0);
+    }
+
+    QCOMPARE(wheel.count(), 0);
+    QVERIFY(!wheel._tickTimer.isActive());
+}
+
+void TimerWheelTest::_cancelTest(void)
+{
+    TimerWheel  wheel(10 /* tickMSecs */, 4 /* slotCount */);
+    QSignalSpy  spyExpired(&wheel, &TimerWheel::expired);
+
+    wheel.schedule(1, 20);
+    wheel.schedule(2, 20);
+    wheel.cancel(1);
+    QVERIFY(!wheel.isScheduled(1));
+    QVERIFY(wheel.isScheduled(2));
+    QCOMPARE(wheel._slots[wheel._idToSlot.value(2)].count(), 1);
+
+    // Unknown ids are ignored
+    wheel.cancel(42);
+    QCOMPARE(wheel.count(), 1);
+
+    // Timer only runs while something is scheduled
+    wheel.cancel(2);
+    QCOMPARE(wheel.count(), 0);
+    QVERIFY(!wheel._tickTimer.isActive());
+
+    for (int i=0; i<8; i++) {
+        wheel._tick();
+    }
+    QCOMPARE(spyExpired.count(), 0);
+
+    wheel.schedule(3, 20);
+    wheel.schedule(4, 100);
+    wheel.clear();
+    QCOMPARE(wheel.count(), 0);
+    QVERIFY(!wheel._tickTimer.isActive());
+    for (const QVector<TimerWheel::Entry_t>& slot: wheel._slots) {
+        QVERIFY(slot.isEmpty());
+    }
+}
+
+void TimerWheelTest::_rescheduleTest(void)
+{
+    TimerWheel  wheel(10 /* tickMSecs */, 4 /* slotCount */);
+    QSignalSpy  spyExpired(&wheel, &TimerWheel::expired);
+
+    // Rescheduling replaces the previous timeout instead of adding a second one
+    wheel.schedule(1, 10);
+    wheel.schedule(1, 30);
+    QCOMPARE(wheel.count(), 1);
+    QCOMPARE(wheel._slots[1].count(), 0);
+    QCOMPARE(wheel._idToSlot.value(1), 3);
+    QCOMPARE(_rounds(wheel, 1), 0);
+
+    for (int tick=1; tick<3; tick++) {
+        wheel._tick();
+        QCOMPARE(spyExpired.count(), 0);
+    }
+    wheel._tick();
+    QCOMPARE(spyExpired.count(), 1);
+    QCOMPARE(spyExpired.takeFirst().at(0).value<quint32>(), 1u);
+
+    // Rescheduling from within the expiry handler, as the command retry code does, must not be lost
+    int expiredCount = 0;
+    connect(&wheel, &TimerWheel::expired, this, [&](quint32 id) {
+        if (++expiredCount == 1) {
+            wheel.schedule(id, 10);
+        }
+    });
+    wheel.schedule(2, 10);
+    wheel._tick();
+    QCOMPARE(expiredCount, 1);
+    QVERIFY(wheel.isScheduled(2));
+    wheel._tick();
+    QCOMPARE(expiredCount, 2);
+    QVERIFY(!wheel.isScheduled(2));
+}
+
+void TimerWheelTest::_tickTimerTest(void)
+{
+    TimerWheel  wheel(10 /* tickMSecs */, 4 /* slotCount */);
+    QSignalSpy  spyExpired(&wheel, &TimerWheel::expired);
+
+    wheel.schedule(7, 30);
+    QVERIFY(spyExpired.wait(1000));
+    QCOMPARE(spyExpired.count(), 1);
+    QCOMPARE(spyExpired.takeFirst().at(0).value<quint32>(), 7u);
+    QVERIFY(!wheel._tickTimer.isActive());
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TimerWheel;
+
+class TimerWheelTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _slotArithmeticTest(void);
+    void _expiryOrderTest   (void);
+    void _cancelTest        (void);
+    void _rescheduleTest    (void);
+    void _tickTimerTest     (void);
+
+private:
+    int _rounds(const TimerWheel& wheel, quint32 id) const;
+};
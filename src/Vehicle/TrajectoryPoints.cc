@@ -9,12 +9,20 @@
 
 #include "TrajectoryPoints.h"
 #include "Vehicle.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "FlyViewSettings.h"
+
+#include <QtMath>
 
 TrajectoryPoints::TrajectoryPoints(Vehicle* vehicle, QObject* parent)
     : QObject       (parent)
     , _vehicle      (vehicle)
     , _lastAzimuth  (qQNaN())
 {
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(_flushIntervalMsecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &TrajectoryPoints::_flushPendingPoints);
 }
 
 void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
@@ -33,21 +41,253 @@ void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
                 // The new position IS NOT colinear with the last segment. Append the new position to the list.
                 _lastAzimuth = _lastPoint.azimuthTo(coordinate);
                 _lastPoint = coordinate;
-                _points.append(QVariant::fromValue(coordinate));
-                emit pointAdded(coordinate);
+                _appendPoint(coordinate);
             } else {
                 // The new position IS colinear with the last segment. Don't add a new point, just update
                 // the last point to be the new position.
                 _lastPoint = coordinate;
-                _points[_points.count() - 1] = QVariant::fromValue(coordinate);
-                emit updateLastPoint(coordinate);
+                _replaceLastPoint(coordinate);
             }
         }
     } else {
         // Add the very first trajectory point to the list
         _lastPoint = coordinate;
-        _points.append(QVariant::fromValue(coordinate));
-        emit pointAdded(coordinate);
+        _appendPoint(coordinate);
+    }
+}
+
+void TrajectoryPoints::_appendPoint(const QGeoCoordinate& coordinate)
+{
+    _points.append(_pack(coordinate));
+    _generation++;
+    _enforcePointLimit();
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+void TrajectoryPoints::_replaceLastPoint(const QGeoCoordinate& coordinate)
+{
+    if (_points.isEmpty()) {
+        _appendPoint(coordinate);
+        return;
+    }
+    _points.last() = _pack(coordinate);
+    _generation++;
+    if (_cDeliveredPoints == _points.count()) {
+        // Map already has this point, otherwise it goes out with the next batch
+        _lastPointDirty = true;
+    }
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+/// Sends all changes since the last flush to the map in a single batch
+void TrajectoryPoints::_flushPendingPoints(void)
+{
+    if (_lastPointDirty && _cDeliveredPoints > 0) {
+        emit updateLastPoint(_unpack(_points[_cDeliveredPoints - 1]));
+    }
+    _lastPointDirty = false;
+
+    if (_cDeliveredPoints < _points.count()) {
+        QVariantList coordinates;
+        coordinates.reserve(_points.count() - _cDeliveredPoints);
+        for (int i=_cDeliveredPoints; i<_points.count(); i++) {
+            coordinates.append(QVariant::fromValue(_unpack(_points[i])));
+        }
+        _cDeliveredPoints = _points.count();
+        emit pointsAdded(coordinates);
+    }
+}
+
+int TrajectoryPoints::_maxPoints(void) const
+{
+    return qgcApp()->toolbox()->settingsManager()->flyViewSettings()->maxTrajectoryPoints()->rawValue().toInt();
+}
+
+/// Once the point limit is reached the trail is simplified with increasing tolerance until it is back down to 3/4 of the limit
+void TrajectoryPoints::_enforcePointLimit(void)
+{
+    const int maxPoints = _maxPoints();
+    if (maxPoints <= 0 || _points.count() <= maxPoints) {
+        return;
+    }
+
+    const int               targetPoints    = (maxPoints * 3) / 4;
+    double                  tolerance       = _distanceTolerance * 2;
+    QVector<PackedPoint_t>  simplified;
+    _simplify(_points, tolerance, simplified);
+    while (simplified.count() > targetPoints && tolerance < 100000) {
+        tolerance *= 2;
+        _simplify(_points, tolerance, simplified);
+    }
+    if (simplified.count() > targetPoints) {
+        // Should not happen, but the limit must hold regardless
+        simplified.remove(0, simplified.count() - targetPoints);
+    }
+    qCDebug(VehicleLog) << "Trajectory simplified" << _points.count() << "->" << simplified.count() << "tolerance(m)" << tolerance;
+
+    _points = simplified;
+    _generation++;
+    _lodCache.clear();
+    _cDeliveredPoints   = _points.count();
+    _lastPointDirty     = false;
+    emit pointsReplaced();
+}
+
+QVariantList TrajectoryPoints::list(void)
+{
+    // Caller now has the full trail, nothing is pending for the map
+    _cDeliveredPoints   = _points.count();
+    _lastPointDirty     = false;
+    return _toVariantList(_points);
+}
+
+QVariantList TrajectoryPoints::listForZoom(double zoomLevel)
+{
+    if (_points.isEmpty()) {
+        return list();
+    }
+
+    const int zoom = qBound(0, static_cast<int>(zoomLevel), 22);
+    if (_metersPerPixel(zoom, _points.last().lat * 1e-7) <= _distanceTolerance) {
+        return list();
+    }
+
+    _cDeliveredPoints   = _points.count();
+    _lastPointDirty     = false;
+
+    auto iter = _lodCache.find(zoom);
+    if (iter == _lodCache.end()) {
+        iter = _lodCache.insert(zoom, LodCache_t());
+        _updateLodCache(*iter, zoom);
+    } else if (iter->generation != _generation) {
+        _updateLodCache(*iter, zoom);
+    }
+    return iter->points;
+}
+
+/// Simplifies any chunks which were sealed since the last update and then the tail following them. Chunks share their
+/// end points. A chunk is sealed once its end point is no longer the last point, since _replaceLastPoint can still move that.
+void TrajectoryPoints::_updateLodCache(LodCache_t& cache, int zoom) const
+{
+    const int cSealedChunks = qMax(0, (_points.count() - 2) / _lodChunkPoints);
+    for (int chunk=cache.cSealedChunks; chunk<cSealedChunks; chunk++) {
+        _appendSimplified(cache.sealedPoints, chunk * _lodChunkPoints, (chunk + 1) * _lodChunkPoints, zoom);
+    }
+    cache.cSealedChunks = cSealedChunks;
+
+    cache.points = cache.sealedPoints;
+    _appendSimplified(cache.points, cSealedChunks * _lodChunkPoints, _points.count() - 1, zoom);
+    cache.generation = _generation;
+}
+
+/// Appends _points[first..last] simplified to the pixel size at the specified zoom level
+void TrajectoryPoints::_appendSimplified(QVariantList& coordinates, int first, int last, int zoom) const
+{
+    const QVector<PackedPoint_t>    range = _points.mid(first, last - first + 1);
+    QVector<PackedPoint_t>          simplified;
+    _simplify(range, _metersPerPixel(zoom, range[range.count() / 2].lat * 1e-7), simplified);
+
+    // The first point was already added as the end of the previous chunk
+    coordinates.reserve(coordinates.count() + simplified.count());
+    for (int i=(first == 0 ? 0 : 1); i<simplified.count(); i++) {
+        coordinates.append(QVariant::fromValue(_unpack(simplified[i])));
+    }
+}
+
+/// @return Size of a pixel at the specified zoom level (web mercator, 256 pixel tiles)
+double TrajectoryPoints::_metersPerPixel(int zoom, double latitude)
+{
+    return 156543.03392 * qCos(qDegreesToRadians(latitude)) / qPow(2.0, zoom);
+}
+
+QVariantList TrajectoryPoints::_toVariantList(const QVector<PackedPoint_t>& points) const
+{
+    QVariantList coordinates;
+    coordinates.reserve(points.count());
+    for (const PackedPoint_t& point: points) {
+        coordinates.append(QVariant::fromValue(_unpack(point)));
+    }
+    return coordinates;
+}
+
+TrajectoryPoints::PackedPoint_t TrajectoryPoints::_pack(const QGeoCoordinate& coordinate)
+{
+    PackedPoint_t point;
+    point.lat = static_cast<qint32>(qRound(coordinate.latitude() * 1e7));
+    point.lon = static_cast<qint32>(qRound(coordinate.longitude() * 1e7));
+    return point;
+}
+
+QGeoCoordinate TrajectoryPoints::_unpack(const PackedPoint_t& point)
+{
+    return QGeoCoordinate(point.lat * 1e-7, point.lon * 1e-7);
+}
+
+/// Douglas-Peucker simplification. Distances are calculated on a local flat earth projection which is plenty
+/// accurate for deciding which points are visible at a given resolution.
+void TrajectoryPoints::_simplify(const QVector<PackedPoint_t>& points, double toleranceMeters, QVector<PackedPoint_t>& simplified)
+{
+    simplified.clear();
+    const int cPoints = points.count();
+    if (cPoints < 3) {
+        simplified = points;
+        return;
+    }
+
+    const double metersPerUnitLat = 111319.49 * 1e-7;
+    const double metersPerUnitLon = metersPerUnitLat * qCos(qDegreesToRadians(points[cPoints / 2].lat * 1e-7));
+    auto x = [&](int i) { return points[i].lon * metersPerUnitLon; };
+    auto y = [&](int i) { return points[i].lat * metersPerUnitLat; };
+
+    QVector<bool>               keep(cPoints, false);
+    QVector<QPair<int, int>>    stack;
+    keep[0]             = true;
+    keep[cPoints - 1]   = true;
+    stack.append(qMakePair(0, cPoints - 1));
+
+    while (!stack.isEmpty()) {
+        const QPair<int, int> segment = stack.takeLast();
+        const int first = segment.first;
+        const int last  = segment.second;
+
+        const double ax     = x(first);
+        const double ay     = y(first);
+        const double dx     = x(last) - ax;
+        const double dy     = y(last) - ay;
+        const double len2   = (dx * dx) + (dy * dy);
+
+        double  maxDistance = 0;
+        int     maxIndex    = -1;
+        for (int i=first + 1; i<last; i++) {
+            double px = x(i) - ax;
+            double py = y(i) - ay;
+            if (len2 > 0) {
+                const double t = qBound(0.0, ((px * dx) + (py * dy)) / len2, 1.0);
+                px -= t * dx;
+                py -= t * dy;
+            }
+            const double distance = qSqrt((px * px) + (py * py));
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                maxIndex    = i;
+            }
+        }
+
+        if (maxIndex != -1 && maxDistance > toleranceMeters) {
+            keep[maxIndex] = true;
+            stack.append(qMakePair(first, maxIndex));
+            stack.append(qMakePair(maxIndex, last));
+        }
+    }
+
+    for (int i=0; i<cPoints; i++) {
+        if (keep[i]) {
+            simplified.append(points[i]);
+        }
     }
 }
 
@@ -60,11 +300,17 @@ void TrajectoryPoints::start(void)
 void TrajectoryPoints::stop(void)
 {
     disconnect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
+    _flushPendingPoints();
 }
 
 void TrajectoryPoints::clear(void)
 {
+    _flushTimer.stop();
     _points.clear();
+    _lodCache.clear();
+    _generation++;
+    _cDeliveredPoints = 0;
+    _lastPointDirty = false;
     _lastPoint = QGeoCoordinate();
     _lastAzimuth = qQNaN();
     emit pointsCleared();
@@ -12,9 +12,17 @@
 #include "QmlObjectListModel.h"
 
 #include <QGeoCoordinate>
+#include <QTimer>
+#include <QMap>
 
 class Vehicle;
 
+/// Vehicle flight trail. Points are stored packed and the total number of points is capped. When the cap is
+/// reached the trail is simplified (Douglas-Peucker) to make room. New points are delivered to the map in
+/// batches and a further simplified trail can be requested for low zoom levels.
+///
+/// The low zoom trail is simplified in chunks of _lodChunkPoints. Chunks which new points can no longer change
+/// are simplified once and cached, only the tail of the trail is simplified again as the vehicle moves.
 class TrajectoryPoints : public QObject
 {
     Q_OBJECT
@@ -22,28 +30,75 @@ class TrajectoryPoints : public QObject
 public:
     TrajectoryPoints(Vehicle* vehicle, QObject* parent = nullptr);
 
-    Q_INVOKABLE QVariantList list(void) const { return _points; }
+    /// @return Full resolution trail
+    Q_INVOKABLE QVariantList list(void);
+
+    /// @return Trail simplified to the resolution of the specified map zoom level
+    Q_INVOKABLE QVariantList listForZoom(double zoomLevel);
 
     void start  (void);
     void stop   (void);
 
+    int  count  (void) const { return _points.count(); }
+
 public slots:
     void clear  (void);
 
 signals:
-    void pointAdded     (QGeoCoordinate coordinate);
+    /// Signalled at most every _flushIntervalMsecs with all points added since the last signal
+    void pointsAdded    (QVariantList coordinates);
     void updateLastPoint(QGeoCoordinate coordinate);
     void pointsCleared  (void);
 
+    /// Signalled when the stored trail was simplified to stay within the point limit. The map should reload the trail.
+    void pointsReplaced (void);
+
 private slots:
     void _vehicleCoordinateChanged(QGeoCoordinate coordinate);
+    void _flushPendingPoints      (void);
 
 private:
-    Vehicle*        _vehicle;
-    QVariantList    _points;
-    QGeoCoordinate  _lastPoint;
-    double          _lastAzimuth;
+    /// Coordinate packed to 1e-7 degree resolution (~1cm), same as MAVLink
+    struct PackedPoint_t {
+        qint32 lat;
+        qint32 lon;
+    };
+
+    struct LodCache_t {
+        int             cSealedChunks   = 0;    ///< Number of chunks simplified into sealedPoints
+        QVariantList    sealedPoints;           ///< Simplified chunks which can no longer change
+        quint64         generation      = 0;    ///< Value of _generation when points was built
+        QVariantList    points;                 ///< sealedPoints followed by the simplified tail
+    };
+
+    void                    _appendPoint        (const QGeoCoordinate& coordinate);
+    void                    _replaceLastPoint   (const QGeoCoordinate& coordinate);
+    void                    _enforcePointLimit  (void);
+    int                     _maxPoints          (void) const;
+    QVariantList            _toVariantList      (const QVector<PackedPoint_t>& points) const;
+    void                    _updateLodCache     (LodCache_t& cache, int zoom) const;
+    void                    _appendSimplified   (QVariantList& coordinates, int first, int last, int zoom) const;
+
+    static double           _metersPerPixel     (int zoom, double latitude);
+
+    static PackedPoint_t    _pack               (const QGeoCoordinate& coordinate);
+    static QGeoCoordinate   _unpack             (const PackedPoint_t& point);
+    static void             _simplify           (const QVector<PackedPoint_t>& points, double toleranceMeters, QVector<PackedPoint_t>& simplified);
+
+    Vehicle*                _vehicle;
+    QVector<PackedPoint_t>  _points;
+    QGeoCoordinate          _lastPoint;
+    double                  _lastAzimuth;
+    QTimer                  _flushTimer;
+    int                     _cDeliveredPoints   = 0;        ///< Number of points in _points which have been signalled to the map
+    bool                    _lastPointDirty     = false;    ///< Last delivered point was updated since last flush
+    quint64                 _generation         = 0;        ///< Incremented on every change to _points, used to validate the tail in _lodCache
+    QMap<int, LodCache_t>   _lodCache;                      ///< Simplified trail per integer zoom level, cleared when existing points are replaced
+
+    static constexpr double _distanceTolerance  = 2.0;
+    static constexpr double _azimuthTolerance   = 1.5;
+    static const int        _flushIntervalMsecs = 500;
+    static const int        _lodChunkPoints     = 256;
 
-    static constexpr double _distanceTolerance = 2.0;
-    static constexpr double _azimuthTolerance = 1.5;
+    friend class TrajectoryPointsTest;
 };
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TrajectoryPointsTest.h"
+#include "TrajectoryPoints.h"
+
+/// @return Coordinate on a west to east line, acrossMeters to the north (positive) or south (negative) of it
+QGeoCoordinate TrajectoryPointsTest::_coordinate(double alongMeters, double acrossMeters)
+{
+    QGeoCoordinate coordinate = QGeoCoordinate(47.0, 8.0).atDistanceAndAzimuth(alongMeters, 90);
+    return coordinate.atDistanceAndAzimuth(qAbs(acrossMeters), acrossMeters < 0 ? 180 : 0);
+}
+
+void TrajectoryPointsTest::_simplifyToleranceTest(void)
+{
+    QVector<TrajectoryPoints::PackedPoint_t> points;
+    QVector<TrajectoryPoints::PackedPoint_t> simplified;
+
+    // Fewer than three points are never simplified
+    points.append(TrajectoryPoints::_pack(_coordinate(0, 0)));
+    points.append(TrajectoryPoints::_pack(_coordinate(10, 5)));
+    TrajectoryPoints::_simplify(points, 1000, simplified);
+    QCOMPARE(simplified.count(), 2);
+
+    // A single point 5m off the line is only dropped once the tolerance is larger than its distance
+    points.clear();
+    for (int i=0; i<=10; i++) {
+        points.append(TrajectoryPoints::_pack(_coordinate(i * 10, i == 4 ? 5 : 0)));
+    }
+    TrajectoryPoints::_simplify(points, 4, simplified);
+    QCOMPARE(simplified.count(), 3);
+    QCOMPARE(TrajectoryPoints::_unpack(simplified[0]), TrajectoryPoints::_unpack(points.first()));
+    QCOMPARE(TrajectoryPoints::_unpack(simplified[1]), TrajectoryPoints::_unpack(points[4]));
+    QCOMPARE(TrajectoryPoints::_unpack(simplified[2]), TrajectoryPoints::_unpack(points.last()));
+    TrajectoryPoints::_simplify(points, 6, simplified);
+    QCOMPARE(simplified.count(), 2);
+    QCOMPARE(TrajectoryPoints::_unpack(simplified[0]), TrajectoryPoints::_unpack(points.first()));
+    QCOMPARE(TrajectoryPoints::_unpack(simplified[1]), TrajectoryPoints::_unpack(points.last()));
+
+    // Zigzag with 2m between the peaks and the line through the end points
+    points.clear();
+    for (int i=0; i<=20; i++) {
+        points.append(TrajectoryPoints::_pack(_coordinate(i * 10, i % 2 ? 1 : -1)));
+    }
+    TrajectoryPoints::_simplify(points, 0.5, simplified);
+    QCOMPARE(simplified.count(), points.count());
+    TrajectoryPoints::_simplify(points, 2.5, simplified);
+    QCOMPARE(simplified.count(), 2);
+}
+
+void TrajectoryPointsTest::_lodCacheReuseTest(void)
+{
+    // At zoom 15 a pixel is ~3.3m at this latitude, so the 2m zigzag simplifies down to the chunk end points
+    const int           zoom        = 15;
+    TrajectoryPoints    trajectoryPoints(nullptr);
+    int                 cPoints     = 0;
+
+    auto appendPoints = [&](int count) {
+        for (int i=0; i<count; i++, cPoints++) {
+            trajectoryPoints._appendPoint(_coordinate(cPoints * 10, cPoints % 2 ? 1 : -1));
+        }
+    };
+    auto coordinateAt = [](const QVariantList& coordinates, int index) {
+        return coordinates[index].value<QGeoCoordinate>();
+    };
+
+    // Three sealed chunks plus a tail
+    appendPoints((TrajectoryPoints::_lodChunkPoints * 3) + 10);
+    QVariantList coordinates = trajectoryPoints.listForZoom(zoom);
+    QCOMPARE(coordinates.count(), 5);
+    QCOMPARE(trajectoryPoints._lodCache[zoom].cSealedChunks, 3);
+    const QGeoCoordinate firstPoint = coordinateAt(coordinates, 0);
+
+    // Change a sealed point behind the cache's back. If the sealed chunks are reused the change doesn't show up.
+    trajectoryPoints._points[0] = TrajectoryPoints::_pack(_coordinate(0, 50));
+
+    // A new point only updates the tail
+    appendPoints(1);
+    coordinates = trajectoryPoints.listForZoom(zoom);
+    QCOMPARE(coordinates.count(), 5);
+    QCOMPARE(coordinateAt(coordinates, 0), firstPoint);
+    QCOMPARE(coordinateAt(coordinates, coordinates.count() - 1), TrajectoryPoints::_unpack(trajectoryPoints._points.last()));
+
+    // Moving the last point is reflected as well
+    const QGeoCoordinate movedLastPoint = _coordinate(((cPoints - 1) * 10) + 5, (cPoints - 1) % 2 ? 1 : -1);
+    trajectoryPoints._replaceLastPoint(movedLastPoint);
+    coordinates = trajectoryPoints.listForZoom(zoom);
+    QCOMPARE(coordinateAt(coordinates, coordinates.count() - 1), TrajectoryPoints::_unpack(TrajectoryPoints::_pack(movedLastPoint)));
+
+    // Nothing changed, the cached list is returned as is
+    QVERIFY(trajectoryPoints.listForZoom(zoom).isSharedWith(coordinates));
+
+    // Sealing another chunk keeps the previously sealed ones
+    appendPoints((TrajectoryPoints::_lodChunkPoints * 4) + 2 - cPoints);
+    coordinates = trajectoryPoints.listForZoom(zoom);
+    QCOMPARE(trajectoryPoints._lodCache[zoom].cSealedChunks, 4);
+    QCOMPARE(coordinates.count(), 6);
+    QCOMPARE(coordinateAt(coordinates, 0), firstPoint);
+
+    // Each zoom level has its own cache, built from the current points
+    coordinates = trajectoryPoints.listForZoom(zoom - 1);
+    QCOMPARE(coordinateAt(coordinates, 0), TrajectoryPoints::_unpack(trajectoryPoints._points[0]));
+
+    // High zoom levels get the full trail
+    QCOMPARE(trajectoryPoints.listForZoom(22).count(), trajectoryPoints.count());
+
+    trajectoryPoints.clear();
+    QVERIFY(trajectoryPoints._lodCache.isEmpty());
+    QVERIFY(trajectoryPoints.listForZoom(zoom).isEmpty());
+}
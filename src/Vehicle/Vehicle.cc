@@ -51,6 +51,7 @@
 #include "VehicleBatteryFactGroup.h"
 #include "EventHandler.h"
 #include "Actuators/Actuators.h"
+#include "TelemetryTracer.h"
 #ifdef QT_DEBUG
 #include "MockLink.h"
 #endif
@@ -180,8 +181,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
-    connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
+    // Incoming messages and status are routed to this vehicle by MultiVehicleManager based on system id
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
     connect(this, &Vehicle::armedChanged,               this, &Vehicle::_announceArmedChanged);
@@ -222,11 +222,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     _prearmErrorTimer.setInterval(_prearmErrorTimeoutMSecs);
     _prearmErrorTimer.setSingleShot(true);
 
-    // Send MAV_CMD ack timer
-    _mavCommandResponseCheckTimer.setSingleShot(false);
-    _mavCommandResponseCheckTimer.setInterval(_mavCommandResponseCheckTimeoutMSecs);
-    _mavCommandResponseCheckTimer.start();
-    connect(&_mavCommandResponseCheckTimer, &QTimer::timeout, this, &Vehicle::_sendMavCommandResponseTimeoutCheck);
+    // Send MAV_CMD ack timeouts
+    connect(&_mavCommandTimerWheel, &TimerWheel::expired, this, &Vehicle::_mavCommandAckTimeout);
 
     // Chunked status text timeout timer
     _chunkedStatusTextTimer.setSingleShot(true);
@@ -593,6 +590,8 @@ void Vehicle::resetCounters()
 
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
+    TelemetryTracer::Scope traceScope(TelemetryTracer::StageVehicleMessage, message.msgid);
+
     // If the link is already running at Mavlink V2 set our max proto version to it.
     unsigned mavlinkVersion = _mavlink->getCurrentVersion();
     if (_maxProtoVersion != mavlinkVersion && mavlinkVersion >= 200) {
@@ -659,8 +658,11 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
 
     // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
-        factGroup->handleMessage(this, message);
+    {
+        TelemetryTracer::Scope factGroupTraceScope(TelemetryTracer::StageFactGroupFanOut, message.msgid);
+        for (FactGroup* factGroup : factGroups()) {
+            factGroup->handleMessage(this, message);
+        }
     }
 
     switch (message.msgid) {
@@ -1796,7 +1798,7 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     int len = mavlink_msg_to_send_buffer(buffer, &message);
 
-    link->writeBytesThreadSafe((const char*)buffer, len);
+    link->writeBytesThreadSafe((const char*)buffer, len, LinkOutboundScheduler::priorityForMessage(message.msgid));
     _messagesSent++;
     emit messagesSentChanged();
 
@@ -1877,11 +1879,7 @@ bool Vehicle::xConfigMotors()
 
 QString Vehicle::formattedMessages()
 {
-    QString messages;
-    for(UASMessage* message: _toolbox->uasMessageHandler()->messages()) {
-        messages += message->getFormatedText();
-    }
-    return messages;
+    return _toolbox->uasMessageHandler()->formattedMessages();
 }
 
 void Vehicle::clearMessages()
@@ -2077,7 +2075,7 @@ void Vehicle::setFlightMode(const QString& flightMode)
     uint32_t    custom_mode;
 
     if (_firmwarePlugin->setFlightMode(flightMode, &base_mode, &custom_mode)) {
-        SharedLinkInterfacePtr sharedLink = vehicleLinkManager()->primaryLink().lock();
+        SharedLinkInterfacePtr sharedLink = vehicleLinkManager()->fastestLink().lock();
         if (!sharedLink) {
             qCDebug(VehicleLog) << "setFlightMode: primary link gone!";
             return;
@@ -2235,13 +2233,13 @@ void Vehicle::_gotProgressUpdate(float progressValue)
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->phaseComplete(InitialConnectStateMachine::PhaseMission);
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->phaseComplete(InitialConnectStateMachine::PhaseGeoFence);
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
@@ -2249,7 +2247,7 @@ void Vehicle::_firstRallyPointLoadComplete()
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
     _initialPlanRequestComplete = true;
     emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->phaseComplete(InitialConnectStateMachine::PhaseRallyPoints);
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -2263,7 +2261,7 @@ void Vehicle::_parametersReady(bool parametersReady)
     if (parametersReady) {
         disconnect(_parameterManager, &ParameterManager::parametersReadyChanged, this, &Vehicle::_parametersReady);
         _setupAutoDisarmSignalling();
-        _initialConnectStateMachine->advance();
+        _initialConnectStateMachine->phaseComplete(InitialConnectStateMachine::PhaseParameters);
     }
 }
 
@@ -2786,7 +2784,38 @@ void Vehicle::sendMavCommandInt(int compId, MAV_CMD command, MAV_FRAME frame, bo
 
 bool Vehicle::isMavCommandPending(int targetCompId, MAV_CMD command)
 {
-    return ((-1) < _findMavCommandListEntryIndex(targetCompId, command));
+    if ((-1) < _findMavCommandListEntryIndex(targetCompId, command)) {
+        return true;
+    }
+    return _findMavCommandQueueEntryIndex(targetCompId, command) != -1;
+}
+
+QVariantMap Vehicle::commandLatencyStats(void) const
+{
+    QVariantMap map;
+    for (auto it = _commandLatencyStats.constBegin(); it != _commandLatencyStats.constEnd(); ++it) {
+        map[it.key()] = it.value().toVariantMap();
+    }
+    return map;
+}
+
+/// Ack timeout for the next send of the command. Retried commands follow the RTT estimate for the link so a lost
+/// command is resent quickly on a good link. Commands which are not retried may legitimately take a while to be
+/// acked, so for those the estimate is only allowed to lengthen the timeout on laggy links.
+int Vehicle::_adaptiveAckTimeoutMSecs(const MavCommandListEntry_t& entry, LinkInterface* link) const
+{
+    if (link->linkConfiguration()->isHighLatency()) {
+        return _mavCommandAckTimeoutMSecsHighLatency;
+    }
+
+    const CommandLatencyStats stats = _commandLatencyStats.value(link->linkConfiguration()->name());
+    if (entry.maxTries > 1) {
+        // Back off on each retry in case the estimate is stale
+        const int timeout = stats.ackTimeoutMSecs(_mavCommandAckTimeoutMSecs, _mavCommandAckTimeoutMSecsMin, _mavCommandAckTimeoutMSecsMax);
+        return qMin(timeout << qMax(0, entry.tryCount - 1), static_cast<int>(_mavCommandAckTimeoutMSecsMax));
+    } else {
+        return qMax(static_cast<int>(_mavCommandAckTimeoutMSecs), stats.ackTimeoutMSecs(_mavCommandAckTimeoutMSecs, _mavCommandAckTimeoutMSecs, _mavCommandAckTimeoutMSecsMax));
+    }
 }
 
 int Vehicle::_findMavCommandListEntryIndex(int targetCompId, MAV_CMD command)
@@ -2801,6 +2830,18 @@ int Vehicle::_findMavCommandListEntryIndex(int targetCompId, MAV_CMD command)
     return -1;
 }
 
+int Vehicle::_findMavCommandQueueEntryIndex(int targetCompId, MAV_CMD command)
+{
+    for (int i=0; i<_mavCommandQueue.count(); i++) {
+        const MavCommandListEntry_t& entry = _mavCommandQueue[i];
+        if (entry.targetCompId == targetCompId && entry.command == command) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 bool Vehicle::_sendMavCommandShouldRetry(MAV_CMD command)
 {
     switch (command) {
@@ -2832,16 +2873,38 @@ bool Vehicle::_sendMavCommandShouldRetry(MAV_CMD command)
     }
 }
 
+/// Flight critical commands are sent over the fastest healthy link rather than the primary link
+bool Vehicle::_isHighPriorityMavCommand(MAV_CMD command)
+{
+    switch (command) {
+    case MAV_CMD_COMPONENT_ARM_DISARM:
+    case MAV_CMD_DO_SET_MODE:
+    case MAV_CMD_DO_FLIGHTTERMINATION:
+    case MAV_CMD_DO_PAUSE_CONTINUE:
+    case MAV_CMD_DO_REPOSITION:
+    case MAV_CMD_DO_CHANGE_SPEED:
+    case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+    case MAV_CMD_NAV_LAND:
+    case MAV_CMD_NAV_TAKEOFF:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void Vehicle::_sendMavCommandWorker(bool commandInt, bool showError, MavCmdResultHandler resultHandler, void* resultHandlerData, int targetCompId, MAV_CMD command, MAV_FRAME frame, float param1, float param2, float param3, float param4, float param5, float param6, float param7)
 {
-    if ((targetCompId == MAV_COMP_ID_ALL) || isMavCommandPending(targetCompId, command)) {
+    // If we send multiple versions of the same command to a component there is no way to discern which COMMAND_ACK we get back goes with which.
+    // MAV_COMP_ID_ALL is failed for that reason. A duplicate to a specific component is queued behind the one in flight instead. The exceptions
+    // are REQUEST_MESSAGE since the message wait which goes along with it can only track a single request, and the time critical commands
+    // (arm, mode change, ...) which must never go out late.
+    bool duplicate = isMavCommandPending(targetCompId, command);
+    if ((targetCompId == MAV_COMP_ID_ALL) || (duplicate && (command == MAV_CMD_REQUEST_MESSAGE || _isHighPriorityMavCommand(command)))) {
         bool    compIdAll       = targetCompId == MAV_COMP_ID_ALL;
         QString rawCommandName  = _toolbox->missionCommandTree()->rawName(command);
 
         qCDebug(VehicleLog) << QStringLiteral("_sendMavCommandWorker failing %1").arg(compIdAll ? "MAV_COMP_ID_ALL not supportded" : "duplicate command") << rawCommandName;
 
-        // If we send multiple versions of the same command to a component there is no way to discern which COMMAND_ACK we get back goes with which.
-        // Because of this we fail in that case.
         MavCmdResultFailureCode_t failureCode = compIdAll ? MavCmdResultCommandResultOnly : MavCmdResultFailureDuplicateCommand;
         if (resultHandler) {
             (*resultHandler)(resultHandlerData, targetCompId, MAV_RESULT_FAILED, 0, failureCode);
@@ -2878,13 +2941,71 @@ void Vehicle::_sendMavCommandWorker(bool commandInt, bool showError, MavCmdResul
     entry.rgParam[5]        = param6;
     entry.rgParam[6]        = param7;
     entry.maxTries          = _sendMavCommandShouldRetry(command) ? _mavCommandMaxRetryCount : 1;
-    entry.ackTimeoutMSecs   = sharedLink->linkConfiguration()->isHighLatency() ? _mavCommandAckTimeoutMSecsHighLatency : _mavCommandAckTimeoutMSecs;
-    entry.elapsedTimer.start();
+    entry.id                = ++_nextMavCommandId;
+
+    if (duplicate) {
+        // Age in the queue, restarted once the command is sent
+        entry.elapsedTimer.start();
+
+        int queueIndex = _findMavCommandQueueEntryIndex(targetCompId, command);
+        if (queueIndex != -1) {
+            // Only the latest setpoint (gimbal, speed, ...) is worth sending, the queued one is replaced
+            qCDebug(VehicleLog) << "_sendMavCommandWorker replacing queued command" << _toolbox->missionCommandTree()->rawName(command);
+            MavCommandListEntry_t supersededEntry = _mavCommandQueue[queueIndex];
+            _mavCommandQueue[queueIndex] = entry;
+            _failMavCommandEntry(supersededEntry, MavCmdResultFailureDuplicateCommand);
+        } else if (_mavCommandQueue.count() >= _mavCommandQueueMaxCount) {
+            qCDebug(VehicleLog) << "_sendMavCommandWorker command queue full" << _toolbox->missionCommandTree()->rawName(command);
+            _failMavCommandEntry(entry, MavCmdResultFailureDuplicateCommand);
+            if (showError) {
+                qgcApp()->showAppMessage(tr("Unable to send command: %1.").arg(tr("Waiting on previous response to same command.")));
+            }
+        } else {
+            qCDebug(VehicleLog) << "_sendMavCommandWorker queueing behind outstanding command" << _toolbox->missionCommandTree()->rawName(command);
+            _mavCommandQueue.append(entry);
+        }
+        return;
+    }
+
+    _mavCommandList.append(entry);
+    _sendMavCommandFromList(_mavCommandList.count() - 1);
+}
+
+/// Moves the next queued command for the target/command, if any, into flight
+void Vehicle::_sendNextQueuedMavCommand(int targetCompId, MAV_CMD command)
+{
+    if (_findMavCommandListEntryIndex(targetCompId, command) != -1) {
+        // A result handler already sent the same command again
+        return;
+    }
+
+    int queueIndex = _findMavCommandQueueEntryIndex(targetCompId, command);
+    if (queueIndex == -1) {
+        return;
+    }
+
+    MavCommandListEntry_t entry = _mavCommandQueue.takeAt(queueIndex);
+    if (entry.elapsedTimer.elapsed() > _mavCommandAckTimeoutMSecs) {
+        // Sending a command this late is a safety risk, see _sendMavCommandShouldRetry
+        qCDebug(VehicleLog) << "_sendNextQueuedMavCommand dropping stale command" << _toolbox->missionCommandTree()->rawName(command);
+        _failMavCommandEntry(entry, MavCmdResultFailureNoResponseToCommand);
+        return;
+    }
 
     _mavCommandList.append(entry);
     _sendMavCommandFromList(_mavCommandList.count() - 1);
 }
 
+/// Reports a command which is never going to be sent to its result handler
+void Vehicle::_failMavCommandEntry(const MavCommandListEntry_t& entry, MavCmdResultFailureCode_t failureCode)
+{
+    if (entry.resultHandler) {
+        (*entry.resultHandler)(entry.resultHandlerData, entry.targetCompId, MAV_RESULT_FAILED, 0, failureCode);
+    } else {
+        emit mavCommandResult(_id, entry.targetCompId, entry.command, MAV_RESULT_FAILED, failureCode);
+    }
+}
+
 void Vehicle::_sendMavCommandFromList(int index)
 {
     MavCommandListEntry_t commandEntry = _mavCommandList[index];
@@ -2894,6 +3015,7 @@ void Vehicle::_sendMavCommandFromList(int index)
     if (++_mavCommandList[index].tryCount > commandEntry.maxTries) {
         qCDebug(VehicleLog) << "_sendMavCommandFromList giving up after max retries" << rawCommandName;
         _mavCommandList.removeAt(index);
+        _mavCommandTimerWheel.cancel(commandEntry.id);
         if (commandEntry.resultHandler) {
             (*commandEntry.resultHandler)(commandEntry.resultHandlerData, commandEntry.targetCompId, MAV_RESULT_FAILED, 0, MavCmdResultFailureNoResponseToCommand);
         } else {
@@ -2902,8 +3024,18 @@ void Vehicle::_sendMavCommandFromList(int index)
         if (commandEntry.showError) {
             qgcApp()->showAppMessage(tr("Vehicle did not respond to command: %1").arg(rawCommandName));
         }
+        _sendNextQueuedMavCommand(commandEntry.targetCompId, commandEntry.command);
         return;
     }
+    commandEntry.tryCount = _mavCommandList[index].tryCount;
+
+    SharedLinkInterfacePtr sharedLink = _isHighPriorityMavCommand(commandEntry.command) ? vehicleLinkManager()->fastestLink().lock() : vehicleLinkManager()->primaryLink().lock();
+    if (sharedLink) {
+        _mavCommandList[index].ackTimeoutMSecs  = _adaptiveAckTimeoutMSecs(commandEntry, sharedLink.get());
+        _mavCommandList[index].linkName         = sharedLink->linkConfiguration()->name();
+    }
+    _mavCommandList[index].elapsedTimer.start();
+    _mavCommandTimerWheel.schedule(commandEntry.id, _mavCommandList[index].ackTimeoutMSecs);
 
     if (commandEntry.tryCount > 1 && !px4Firmware() && commandEntry.command == MAV_CMD_START_RX_PAIR) {
         // The implementation of this command comes from the IO layer and is shared across stacks. So for other firmwares
@@ -2911,9 +3043,8 @@ void Vehicle::_sendMavCommandFromList(int index)
         return;
     }
 
-    qCDebug(VehicleLog) << "_sendMavCommandFromList command:tryCount" << rawCommandName << commandEntry.tryCount;
+    qCDebug(VehicleLog) << "_sendMavCommandFromList command:tryCount:ackTimeout" << rawCommandName << commandEntry.tryCount << _mavCommandList[index].ackTimeoutMSecs;
 
-    SharedLinkInterfacePtr sharedLink = vehicleLinkManager()->primaryLink().lock();
     if (!sharedLink) {
         qCDebug(VehicleLog) << "_sendMavCommandFromList: primary link gone!";
         return;
@@ -2966,18 +3097,13 @@ void Vehicle::_sendMavCommandFromList(int index)
     sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
 }
 
-void Vehicle::_sendMavCommandResponseTimeoutCheck(void)
+void Vehicle::_mavCommandAckTimeout(quint32 entryId)
 {
-    if (_mavCommandList.isEmpty()) {
-        return;
-    }
-
-    // Walk the list backwards since _sendMavCommandFromList can remove entries
-    for (int i=_mavCommandList.count()-1; i>=0; i--) {
-        MavCommandListEntry_t& commandEntry = _mavCommandList[i];
-        if (commandEntry.elapsedTimer.elapsed() > commandEntry.ackTimeoutMSecs) {
+    for (int i=0; i<_mavCommandList.count(); i++) {
+        if (_mavCommandList[i].id == entryId) {
             // Try sending command again
             _sendMavCommandFromList(i);
+            return;
         }
     }
 }
@@ -3019,6 +3145,13 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
     bool commandInList = false;
     if (entryIndex != -1) {
         MavCommandListEntry_t commandEntry = _mavCommandList.takeAt(entryIndex);
+        _mavCommandTimerWheel.cancel(commandEntry.id);
+        if (commandEntry.maxTries > 1 && commandEntry.tryCount == 1 && !commandEntry.linkName.isEmpty()) {
+            // Only unambiguous samples are used, an ack to a resent command could belong to any of the sends. Commands
+            // which are not retried (calibration, arming, ...) can take a long time to be acked so their ack time is not
+            // link latency, they would only inflate the estimate used for the retried commands.
+            _commandLatencyStats[commandEntry.linkName].addSample(static_cast<int>(commandEntry.elapsedTimer.elapsed()));
+        }
         if (commandEntry.command == ack.command) {
             if (commandEntry.resultHandler) {
                 (*commandEntry.resultHandler)(commandEntry.resultHandlerData, message.compid, static_cast<MAV_RESULT>(ack.result), ack.progress, MavCmdResultCommandResultOnly);
@@ -3046,6 +3179,7 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
             }
             commandInList = true;
         }
+        _sendNextQueuedMavCommand(message.compid, static_cast<MAV_CMD>(ack.command));
     }
 
     if (!commandInList) {
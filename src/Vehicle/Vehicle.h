@@ -46,6 +46,8 @@
 #include "RallyPointManager.h"
 #include "FTPManager.h"
 #include "ImageProtocolManager.h"
+#include "TimerWheel.h"
+#include "CommandLatencyStats.h"
 
 class Actuators;
 class EventHandler;
@@ -91,10 +93,12 @@ class Vehicle : public FactGroup
 
     friend class InitialConnectStateMachine;
     friend class VehicleLinkManager;
+    friend class MultiVehicleManager;               // Routes incoming messages to _mavlinkMessageReceived
     friend class VehicleBatteryFactGroup;           // Allow VehicleBatteryFactGroup to call _addFactGroup
     friend class SendMavCommandWithSignallingTest;  // Unit test
     friend class SendMavCommandWithHandlerTest;     // Unit test
     friend class RequestMessageTest;                // Unit test
+    friend class InitialConnectTest;                // Unit test
 
 
 public:
@@ -178,6 +182,7 @@ public:
     Q_PROPERTY(int                  newMessageCount             READ newMessageCount                                                NOTIFY newMessageCountChanged)
     Q_PROPERTY(int                  messageCount                READ messageCount                                                   NOTIFY messageCountChanged)
     Q_PROPERTY(QString              formattedMessages           READ formattedMessages                                              NOTIFY formattedMessagesChanged)
+    Q_PROPERTY(int                  maxMessages                 READ maxMessages                                                    CONSTANT)
     Q_PROPERTY(QString              latestError                 READ latestError                                                    NOTIFY latestErrorChanged)
     Q_PROPERTY(bool                 joystickEnabled             READ joystickEnabled            WRITE setJoystickEnabled            NOTIFY joystickEnabledChanged)
     Q_PROPERTY(int                  flowImageIndex              READ flowImageIndex                                                 NOTIFY flowImageIndexChanged)
@@ -544,6 +549,7 @@ public:
     int             newMessageCount             () const{ return _currentMessageCount; }
     int             messageCount                () const{ return _messageCount; }
     QString         formattedMessages           ();
+    int             maxMessages                 () const{ return UASMessageHandler::maxMessages; }
     QString         latestError                 () { return _latestError; }
     float           latitude                    () { return static_cast<float>(_coordinate.latitude()); }
     float           longitude                   () { return static_cast<float>(_coordinate.longitude()); }
@@ -677,8 +683,8 @@ public:
 
     static const int cMaxRcChannels = 18;
 
-    /// Sends the specified MAV_CMD to the vehicle. If no Ack is received command will be retried. If a sendMavCommand is already in progress
-    /// the command will be queued and sent when the previous command completes.
+    /// Sends the specified MAV_CMD to the vehicle. If no Ack is received command will be retried. If the same command to the same component
+    /// is already waiting on an ack the command will be queued and sent when the previous command completes.
     ///     @param compId Component to send to.
     ///     @param command MAV_CMD to send
     ///     @param showError true: Display error to user if command failed, false:  no error shown
@@ -702,6 +708,10 @@ public:
     ///
     bool isMavCommandPending(int targetCompId, MAV_CMD command);
 
+    /// COMMAND_ACK round trip statistics for each link the vehicle has sent commands on
+    ///     @return Map of link name to CommandLatencyStats::toVariantMap
+    Q_INVOKABLE QVariantMap commandLatencyStats(void) const;
+
     /// Same as sendMavCommand but available from Qml.
     Q_INVOKABLE void sendCommand(int compId, int command, bool showError, double param1 = 0.0, double param2 = 0.0, double param3 = 0.0, double param4 = 0.0, double param5 = 0.0, double param6 = 0.0, double param7 = 0.0);
 
@@ -959,7 +969,7 @@ private slots:
     void _firstMissionLoadComplete          ();
     void _firstGeoFenceLoadComplete         ();
     void _firstRallyPointLoadComplete       ();
-    void _sendMavCommandResponseTimeoutCheck();
+    void _mavCommandAckTimeout              (quint32 entryId);
     void _clearCameraTriggerPoints          ();
     void _updateDistanceHeadingToHome       ();
     void _updateMissionItemIndex            ();
@@ -1257,21 +1267,35 @@ private:
         void*               resultHandlerData   = nullptr;
         int                 maxTries            = _mavCommandMaxRetryCount;
         int                 tryCount            = 0;
-        QElapsedTimer       elapsedTimer;
+        QElapsedTimer       elapsedTimer;                               ///< Time since last send, used for RTT samples
         int                 ackTimeoutMSecs     = _mavCommandAckTimeoutMSecs;
+        quint32             id                  = 0;                    ///< Timer wheel id
+        QString             linkName;                                   ///< Link the command was last sent on
     } MavCommandListEntry_t;
 
-    QList<MavCommandListEntry_t>    _mavCommandList;
-    QTimer                          _mavCommandResponseCheckTimer;
+    QList<MavCommandListEntry_t>        _mavCommandList;                ///< Commands waiting on an ack, at most one per target/command
+    QList<MavCommandListEntry_t>        _mavCommandQueue;               ///< Commands waiting for the same target/command to complete, at most one per target/command
+    TimerWheel                          _mavCommandTimerWheel           { _mavCommandTimerWheelTickMSecs, _mavCommandTimerWheelSlots };
+    quint32                             _nextMavCommandId               = 0;
+    QHash<QString, CommandLatencyStats> _commandLatencyStats;           ///< Keyed by link name
     static const int                _mavCommandMaxRetryCount                = 3;
-    static const int                _mavCommandResponseCheckTimeoutMSecs    = 500;
-    static const int                _mavCommandAckTimeoutMSecs              = 3000;
+    static const int                _mavCommandQueueMaxCount                = 16;
+    static const int                _mavCommandTimerWheelTickMSecs          = 50;
+    static const int                _mavCommandTimerWheelSlots              = 64;
+    static const int                _mavCommandAckTimeoutMSecs              = 3000;   ///< Used until there are RTT samples for the link
+    static const int                _mavCommandAckTimeoutMSecsMin           = 500;    ///< Lower bound for adaptive timeout of retried commands
+    static const int                _mavCommandAckTimeoutMSecsMax           = 15000;  ///< Upper bound for adaptive timeout
     static const int                _mavCommandAckTimeoutMSecsHighLatency   = 120000;
 
     void _sendMavCommandWorker  (bool commandInt, bool showError, MavCmdResultHandler resultHandler, void* resultHandlerData, int compId, MAV_CMD command, MAV_FRAME frame, float param1, float param2, float param3, float param4, float param5, float param6, float param7);
     void _sendMavCommandFromList(int index);
+    void _sendNextQueuedMavCommand(int targetCompId, MAV_CMD command);
+    int  _adaptiveAckTimeoutMSecs(const MavCommandListEntry_t& entry, LinkInterface* link) const;
     int  _findMavCommandListEntryIndex(int targetCompId, MAV_CMD command);
+    int  _findMavCommandQueueEntryIndex(int targetCompId, MAV_CMD command);
+    void _failMavCommandEntry(const MavCommandListEntry_t& entry, MavCmdResultFailureCode_t failureCode);
     bool _sendMavCommandShouldRetry(MAV_CMD command);
+    static bool _isHighPriorityMavCommand(MAV_CMD command);
 
     QMap<uint8_t /* batteryId */, uint8_t /* MAV_BATTERY_CHARGE_STATE_OK */> _lowestBatteryChargeStateAnnouncedMap;
 
@@ -12,6 +12,7 @@
 #include "QGCLoggingCategory.h"
 #include "LinkManager.h"
 #include "QGCApplication.h"
+#include "MAVLinkProtocol.h"
 
 QGC_LOGGING_CATEGORY(VehicleLinkManagerLog, "VehicleLinkManagerLog")
 
@@ -22,9 +23,13 @@ VehicleLinkManager::VehicleLinkManager(Vehicle* vehicle)
 {
     connect(this,                   &VehicleLinkManager::linkNamesChanged,  this, &VehicleLinkManager::linkStatusesChanged);
     connect(&_commLostCheckTimer,   &QTimer::timeout,                       this, &VehicleLinkManager::_commLostCheck);
+    connect(&_linkHealthCheckTimer, &QTimer::timeout,                       this, &VehicleLinkManager::_linkHealthCheck);
 
     _commLostCheckTimer.setSingleShot(false);
     _commLostCheckTimer.setInterval(_commLostCheckTimeoutMSecs);
+    _linkHealthCheckTimer.setSingleShot(false);
+    _linkHealthCheckTimer.setInterval(_linkHealthCheckMSecs);
+    _healthClock.start();
 }
 
 void VehicleLinkManager::mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
@@ -34,9 +39,22 @@ void VehicleLinkManager::mavlinkMessageReceived(LinkInterface* link, mavlink_mes
         int linkIndex = _containsLinkIndex(link);
         if (linkIndex == -1) {
             _addLink(link);
+            // _addLink ignores stale links
+            linkIndex = _containsLinkIndex(link);
+            if (linkIndex != -1) {
+                _rgLinkInfo[linkIndex].health.messageReceived(message, _healthClock.elapsed());
+            }
         } else {
             LinkInfo_t& linkInfo = _rgLinkInfo[linkIndex];
             linkInfo.heartbeatElapsedTimer.restart();
+            linkInfo.health.messageReceived(message, _healthClock.elapsed());
+            if (message.msgid == MAVLINK_MSG_ID_TIMESYNC) {
+                _timesyncReceived(linkInfo, message);
+            }
+            if (linkInfo.stalled) {
+                linkInfo.stalled = false;
+                emit linkStatusesChanged();
+            }
             if (_rgLinkInfo[linkIndex].commLost) {
                 _commRegainedOnLink(link);
             }
@@ -151,6 +169,182 @@ void VehicleLinkManager::_commLostCheck(void)
     }
 }
 
+void VehicleLinkManager::_linkHealthCheck(void)
+{
+    const qint64 nowMSecs = _healthClock.elapsed();
+
+    if (nowMSecs - _lastHealthWindowMSecs >= _healthWindowMSecs) {
+        _lastHealthWindowMSecs = nowMSecs;
+        for (LinkInfo_t& linkInfo: _rgLinkInfo) {
+            linkInfo.health.updateWindow(nowMSecs);
+        }
+    }
+
+    if (nowMSecs - _lastTimesyncMSecs >= _timesyncIntervalMSecs) {
+        _lastTimesyncMSecs = nowMSecs;
+        _sendTimesync();
+    }
+
+    if (!_communicationLostEnabled) {
+        return;
+    }
+
+    // A link is only stalled relative to another link which is still receiving, a quiet vehicle is left to the comm lost check
+    qint64 newestReceiveMSecs = 0;
+    for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
+        newestReceiveMSecs = qMax(newestReceiveMSecs, linkInfo.health.lastReceiveMSecs());
+    }
+    const bool otherLinkReceiving = nowMSecs - newestReceiveMSecs < _linkStallMSecs;
+
+    bool linkStatusChange = false;
+    for (LinkInfo_t& linkInfo: _rgLinkInfo) {
+        if (!linkInfo.stalled && !linkInfo.commLost && otherLinkReceiving && !linkInfo.link->linkConfiguration()->isHighLatency() &&
+                nowMSecs - linkInfo.health.lastReceiveMSecs() > _linkStallMSecs) {
+            qCDebug(VehicleLinkManagerLog) << "Link stalled" << linkInfo.link->linkConfiguration()->name();
+            linkInfo.stalled = true;
+            linkStatusChange = true;
+        }
+    }
+    if (linkStatusChange) {
+        emit linkStatusesChanged();
+    }
+
+    if (_updatePrimaryLink()) {
+        QString msg = tr("%1Switching communication to secondary link.").arg(_vehicle->_vehicleIdSpeech());
+        _vehicle->_say(msg);
+        qgcApp()->showAppMessage(msg);
+    } else {
+        _evaluateLinkQuality();
+    }
+}
+
+/// Moves the primary link to a link which has consistently measured substantially better than the current one
+void VehicleLinkManager::_evaluateLinkQuality(void)
+{
+    SharedLinkInterfacePtr  primaryLink     = _primaryLink.lock();
+    SharedLinkInterfacePtr  candidateLink   = _bestQualityLink();
+    const int               primaryIndex    = _containsLinkIndex(primaryLink.get());
+
+    if (_primaryLinkUserSelected || primaryIndex == -1 || !candidateLink || candidateLink == primaryLink || _isUsbDirectLink(primaryLink)) {
+        _qualitySwitchCount = 0;
+        return;
+    }
+
+    const double primaryCost    = _rgLinkInfo[primaryIndex].health.costMSecs();
+    const double candidateCost  = _rgLinkInfo[_containsLinkIndex(candidateLink.get())].health.costMSecs();
+    if (primaryCost < 0 || candidateCost > primaryCost * _qualitySwitchCostRatio || primaryCost - candidateCost < _qualitySwitchMinDeltaMSecs) {
+        _qualitySwitchCount = 0;
+        return;
+    }
+
+    if (candidateLink.get() != _qualitySwitchCandidate) {
+        _qualitySwitchCandidate = candidateLink.get();
+        _qualitySwitchCount     = 0;
+    }
+    if (++_qualitySwitchCount < _qualitySwitchChecks) {
+        return;
+    }
+
+    qCDebug(VehicleLinkManagerLog) << "Switching primary link on quality" << primaryLink->linkConfiguration()->name() << primaryCost << candidateLink->linkConfiguration()->name() << candidateCost;
+
+    _qualitySwitchCount = 0;
+    _primaryLink        = candidateLink;
+    emit primaryLinkChanged();
+
+    QString msg = tr("%1Switching communication to %2 for better link quality.").arg(_vehicle->_vehicleIdSpeech()).arg(candidateLink->linkConfiguration()->name());
+    _vehicle->_say(msg);
+    qgcApp()->showAppMessage(msg);
+}
+
+/// @return Usable normal latency link with the lowest known cost, nullptr if no costs are known
+SharedLinkInterfacePtr VehicleLinkManager::_bestQualityLink(void)
+{
+    SharedLinkInterfacePtr  bestLink;
+    double                  bestCost = 0;
+
+    for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
+        const double cost = linkInfo.health.costMSecs();
+        if (_linkUsable(linkInfo) && cost >= 0 && !linkInfo.link->linkConfiguration()->isHighLatency() && (!bestLink || cost < bestCost)) {
+            bestLink = linkInfo.link;
+            bestCost = cost;
+        }
+    }
+
+    return bestLink;
+}
+
+WeakLinkInterfacePtr VehicleLinkManager::fastestLink(void)
+{
+    SharedLinkInterfacePtr link = _bestQualityLink();
+    if (link) {
+        return link;
+    }
+    return _primaryLink;
+}
+
+/// Probes round trip time on each normal latency link. The vehicle answers with its own time in tc1 and our ts1.
+void VehicleLinkManager::_sendTimesync(void)
+{
+    MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+
+    for (LinkInfo_t& linkInfo: _rgLinkInfo) {
+        if (linkInfo.commLost || linkInfo.link->linkConfiguration()->isHighLatency()) {
+            continue;
+        }
+
+        mavlink_timesync_t timesync;
+        memset(&timesync, 0, sizeof(timesync));
+        timesync.tc1 = 0;
+        timesync.ts1 = qMax(static_cast<qint64>(1), _healthClock.nsecsElapsed());
+
+        if (linkInfo.timesyncPendingNsecs.count() >= _timesyncMaxPendingProbes) {
+            // Still no answer, so the round trip takes at least this long. A lower bound keeps a very slow link from
+            // looking unmeasured, which would leave it out of quality based link selection.
+            linkInfo.health.addRttSample((timesync.ts1 - linkInfo.timesyncPendingNsecs.takeFirst()) / 1.0e6);
+        }
+        linkInfo.timesyncPendingNsecs.append(timesync.ts1);
+
+        mavlink_message_t message;
+        mavlink_msg_timesync_encode_chan(static_cast<uint8_t>(mavlinkProtocol->getSystemId()),
+                                         static_cast<uint8_t>(mavlinkProtocol->getComponentId()),
+                                         linkInfo.link->mavlinkChannel(),
+                                         &message,
+                                         &timesync);
+        _vehicle->sendMessageOnLinkThreadSafe(linkInfo.link.get(), message);
+    }
+}
+
+void VehicleLinkManager::_timesyncReceived(LinkInfo_t& linkInfo, const mavlink_message_t& message)
+{
+    mavlink_timesync_t timesync;
+    mavlink_msg_timesync_decode(&message, &timesync);
+
+    // tc1 == 0 is a request from the vehicle, only answers to our own outstanding probes on this link are used
+    const int pendingIndex = linkInfo.timesyncPendingNsecs.indexOf(timesync.ts1);
+    if (timesync.tc1 != 0 && pendingIndex != -1) {
+        linkInfo.health.addRttSample((_healthClock.nsecsElapsed() - timesync.ts1) / 1.0e6);
+        // Answers come back in order, older probes which are still pending were lost
+        linkInfo.timesyncPendingNsecs.erase(linkInfo.timesyncPendingNsecs.begin(), linkInfo.timesyncPendingNsecs.begin() + pendingIndex + 1);
+    }
+}
+
+bool VehicleLinkManager::_isUsbDirectLink(const SharedLinkInterfacePtr& link)
+{
+#ifndef NO_SERIAL_LINK
+    SerialLink* serialLink = qobject_cast<SerialLink*>(link.get());
+    if (serialLink) {
+        SharedLinkConfigurationPtr config = serialLink->linkConfiguration();
+        if (config) {
+            SerialConfiguration* serialConfig = qobject_cast<SerialConfiguration*>(config.get());
+            return serialConfig && serialConfig->usbDirect();
+        }
+    }
+#else
+    Q_UNUSED(link)
+#endif
+    return false;
+}
+
 int VehicleLinkManager::_containsLinkIndex(LinkInterface* link)
 {
     for (int i=0; i<_rgLinkInfo.count(); i++) {
@@ -191,6 +385,7 @@ void VehicleLinkManager::_addLink(LinkInterface* link)
 
         if (_rgLinkInfo.count() == 1) {
             _commLostCheckTimer.start();
+            _linkHealthCheckTimer.start();
         }
     }
 }
@@ -209,6 +404,9 @@ void VehicleLinkManager::_removeLink(LinkInterface* link)
             _primaryLink.reset();
             emit primaryLinkChanged();
         }
+        if (link == _qualitySwitchCandidate) {
+            _qualitySwitchCandidate = nullptr;
+        }
 
         disconnect(link, &LinkInterface::disconnected, this, &VehicleLinkManager::_linkDisconnected);
         link->removeVehicleReference();
@@ -217,6 +415,7 @@ void VehicleLinkManager::_removeLink(LinkInterface* link)
 
         if (_rgLinkInfo.count() == 0) {
             _commLostCheckTimer.stop();
+            _linkHealthCheckTimer.stop();
         }
     }
 }
@@ -238,28 +437,20 @@ void VehicleLinkManager::_linkDisconnected(void)
 
 SharedLinkInterfacePtr VehicleLinkManager::_bestActivePrimaryLink(void)
 {
-#ifndef NO_SERIAL_LINK
     // Best choice is a USB connection
     for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
-        if (!linkInfo.commLost) {
-            SharedLinkInterfacePtr  link        = linkInfo.link;
-            SerialLink*             serialLink  = qobject_cast<SerialLink*>(link.get());
-            if (serialLink) {
-                SharedLinkConfigurationPtr config = serialLink->linkConfiguration();
-                if (config) {
-                    SerialConfiguration* serialConfig = qobject_cast<SerialConfiguration*>(config.get());
-                    if (serialConfig && serialConfig->usbDirect()) {
-                        return link;
-                    }
-                }
-            }
+        if (_linkUsable(linkInfo) && _isUsbDirectLink(linkInfo.link)) {
+            return linkInfo.link;
         }
     }
-#endif
 
-    // Next best is normal latency link
+    // Next best is the normal latency link which measures best, or the first one if nothing has been measured yet
+    SharedLinkInterfacePtr bestQualityLink = _bestQualityLink();
+    if (bestQualityLink) {
+        return bestQualityLink;
+    }
     for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
-        if (!linkInfo.commLost) {
+        if (_linkUsable(linkInfo)) {
             SharedLinkInterfacePtr      link    = linkInfo.link;
             SharedLinkConfigurationPtr  config  = link->linkConfiguration();
             if (config && !config->isHighLatency()) {
@@ -293,7 +484,7 @@ bool VehicleLinkManager::_updatePrimaryLink(void)
 {
     SharedLinkInterfacePtr primaryLink = _primaryLink.lock();
     int linkIndex = _containsLinkIndex(primaryLink.get());
-    if (linkIndex != -1 && !_rgLinkInfo[linkIndex].commLost && !primaryLink->linkConfiguration()->isHighLatency()) {
+    if (linkIndex != -1 && _linkUsable(_rgLinkInfo[linkIndex]) && !primaryLink->linkConfiguration()->isHighLatency()) {
         // Current priority link is still valid
         return false;
     }
@@ -312,7 +503,9 @@ bool VehicleLinkManager::_updatePrimaryLink(void)
                                0); // Stop transmission on this link
             }
 
-            _primaryLink = bestActivePrimaryLink;
+            _primaryLink                = bestActivePrimaryLink;
+            _primaryLinkUserSelected    = false;
+            _qualitySwitchCount         = 0;
             emit primaryLinkChanged();
 
             if (bestActivePrimaryLink && bestActivePrimaryLink->linkConfiguration()->isHighLatency()) {
@@ -367,7 +560,8 @@ void VehicleLinkManager::setPrimaryLinkByName(const QString& name)
 {
     for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
         if (linkInfo.link->linkConfiguration()->name() == name) {
-            _primaryLink = linkInfo.link;
+            _primaryLink                = linkInfo.link;
+            _primaryLinkUserSelected    = true;
             emit primaryLinkChanged();
         }
     }
@@ -389,12 +583,29 @@ QStringList VehicleLinkManager::linkStatuses(void) const
     QStringList rgStatuses;
 
     for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
-        rgStatuses.append(linkInfo.commLost ? tr("Comm Lost") : "");
+        rgStatuses.append(linkInfo.commLost ? tr("Comm Lost") : (linkInfo.stalled ? tr("Stalled") : ""));
     }
 
     return rgStatuses;
 }
 
+QVariantList VehicleLinkManager::linkHealth(void) const
+{
+    QVariantList    rgHealth;
+    LinkInterface*  primaryLink = _primaryLink.lock().get();
+
+    for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
+        QVariantMap health = linkInfo.health.toVariantMap();
+        health["name"]      = linkInfo.link->linkConfiguration()->name();
+        health["primary"]   = linkInfo.link.get() == primaryLink;
+        health["commLost"]  = linkInfo.commLost;
+        health["stalled"]   = linkInfo.stalled;
+        rgHealth.append(health);
+    }
+
+    return rgHealth;
+}
+
 bool VehicleLinkManager::primaryLinkIsPX4Flow(void) const
 {
     SharedLinkInterfacePtr sharedLink = _primaryLink.lock();
@@ -17,6 +17,7 @@
 
 #include "QGCMAVLink.h"
 #include "LinkInterface.h"
+#include "LinkHealth.h"
 
 Q_DECLARE_LOGGING_CATEGORY(VehicleLinkManagerLog)
 
@@ -24,6 +25,12 @@ class Vehicle;
 class LinkManager;
 class VehicleLinkManagerTest;
 
+/// Tracks the links to a single vehicle and picks the primary link used for outgoing traffic.
+///
+/// Each link keeps LinkHealth metrics. A link which goes silent while another link to the vehicle is still receiving is
+/// marked as stalled and failed over from well before the heartbeat based comm lost timeout. While all links are healthy
+/// the primary link moves to a link whose measured cost is consistently and substantially lower (hysteresis), unless the
+/// user picked the primary link manually.
 class VehicleLinkManager : public QObject
 {
     Q_OBJECT
@@ -42,10 +49,14 @@ public:
     Q_PROPERTY(bool             communicationLostEnabled    READ communicationLostEnabled   WRITE setCommunicationLostEnabled   NOTIFY communicationLostEnabledChanged)
     Q_PROPERTY(bool             autoDisconnect              MEMBER _autoDisconnect                                              NOTIFY autoDisconnectChanged)
 
+    /// @return Per link health metrics in the same order as linkNames
+    Q_INVOKABLE QVariantList linkHealth(void) const;
+
     bool                    primaryLinkIsPX4Flow        (void) const;
     void                    mavlinkMessageReceived      (LinkInterface* link, mavlink_message_t message);
     bool                    containsLink                (LinkInterface* link);
     WeakLinkInterfacePtr    primaryLink                 (void) { return _primaryLink; }
+    WeakLinkInterfacePtr    fastestLink                 (void);     ///< Healthy link with the lowest measured cost, primary link if not known
     QString                 primaryLinkName             (void) const;
     QStringList             linkNames                   (void) const;
     QStringList             linkStatuses                (void) const;
@@ -65,7 +76,8 @@ signals:
     void autoDisconnectChanged          (bool autoDisconnect);
 
 private slots:
-    void _commLostCheck(void);
+    void _commLostCheck     (void);
+    void _linkHealthCheck   (void);
 
 private:
     int                     _containsLinkIndex      (LinkInterface* link);
@@ -74,17 +86,34 @@ private:
     void                    _linkDisconnected       (void);
     bool                    _updatePrimaryLink      (void);
     SharedLinkInterfacePtr  _bestActivePrimaryLink  (void);
+    SharedLinkInterfacePtr  _bestQualityLink        (void);
+    void                    _evaluateLinkQuality    (void);
     void                    _commRegainedOnLink     (LinkInterface*  link);
+    void                    _sendTimesync           (void);
 
     typedef struct LinkInfo {
         SharedLinkInterfacePtr  link;
-        bool                    commLost = false;
+        bool                    commLost            = false;
+        bool                    stalled             = false;    ///< Silent while other links to the vehicle are receiving
         QElapsedTimer           heartbeatElapsedTimer;
+        LinkHealth              health;
+        QList<qint64>           timesyncPendingNsecs;           ///< Outstanding TIMESYNC probes, oldest first
     } LinkInfo_t;
 
+    void                    _timesyncReceived       (LinkInfo_t& linkInfo, const mavlink_message_t& message);
+    static bool             _linkUsable             (const LinkInfo_t& linkInfo) { return !linkInfo.commLost && !linkInfo.stalled; }
+    static bool             _isUsbDirectLink        (const SharedLinkInterfacePtr& link);
+
     Vehicle*                _vehicle                    = nullptr;
     LinkManager*            _linkMgr                    = nullptr;
     QTimer                  _commLostCheckTimer;
+    QTimer                  _linkHealthCheckTimer;
+    QElapsedTimer           _healthClock;
+    qint64                  _lastHealthWindowMSecs      = 0;
+    qint64                  _lastTimesyncMSecs          = 0;
+    LinkInterface*          _qualitySwitchCandidate     = nullptr;
+    int                     _qualitySwitchCount         = 0;
+    bool                    _primaryLinkUserSelected    = false;    ///< true: User picked the primary link, no quality based switching
     QList<LinkInfo_t>       _rgLinkInfo;
     WeakLinkInterfacePtr    _primaryLink;
     bool                    _communicationLost          = false;
@@ -93,4 +122,13 @@ private:
 
     static const int _commLostCheckTimeoutMSecs     = 1000;  // Check for comm lost once a second
     static const int _heartbeatMaxElpasedMSecs      = 3500;  // No heartbeat for longer than this indicates comm loss
+    static const int _linkHealthCheckMSecs          = 500;
+    static const int _healthWindowMSecs             = 1000;
+    static const int _linkStallMSecs                = 1500;  // Silent for longer than this while another link receives indicates a stall
+    static const int _timesyncIntervalMSecs         = 1000;
+    static const int _timesyncMaxPendingProbes      = 4;     // Round trips up to this many intervals are measured exactly
+    static const int _qualitySwitchChecks           = 6;     // Better link must stay better for this many health checks before switching
+
+    static constexpr double _qualitySwitchCostRatio         = 0.7;  // Better link must cost at most this fraction of the primary link
+    static constexpr double _qualitySwitchMinDeltaMSecs     = 50;   // and be at least this much faster
 };
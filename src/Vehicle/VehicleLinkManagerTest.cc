@@ -13,6 +13,7 @@
 #include "LinkManager.h"
 #include "QGCApplication.h"
 #include "MultiSignalSpyV2.h"
+#include "VehicleLinkManager.h"
 
 const char* VehicleLinkManagerTest::_primaryLinkChangedSignalName               = "primaryLinkChanged";
 const char* VehicleLinkManagerTest::_allLinksRemovedSignalName                  = "allLinksRemoved";
@@ -314,6 +315,205 @@ void VehicleLinkManagerTest::_highLatencyLinkTest(void)
     spyTransmissionEnabledChanged.clear();
 }
 
+void VehicleLinkManagerTest::_linkHealthTest(void)
+{
+    LinkHealth          health;
+    mavlink_message_t   message;
+
+    QCOMPARE(health.costMSecs(), -1.0);
+
+    // 10 messages received with a gap of 5 lost: 5 / 15 lost
+    memset(&message, 0, sizeof(message));
+    message.magic   = MAVLINK_STX;
+    message.compid  = MAV_COMP_ID_AUTOPILOT1;
+    message.len     = 20;
+    health.updateWindow(0);
+    for (int i=0; i<10; i++) {
+        message.seq = static_cast<uint8_t>(250 + i + (i >= 5 ? 5 : 0));
+        health.messageReceived(message, 100 * i);
+    }
+    QCOMPARE(health.lastReceiveMSecs(), static_cast<qint64>(900));
+    health.updateWindow(1000);
+    QVERIFY(qAbs(health.lossPercent() - (5 * 100.0 / 15)) < 0.001);
+    QCOMPARE(health.throughputBytesPerSec(), 10.0 * (20 + MAVLINK_NUM_NON_PAYLOAD_BYTES));
+
+    // A quiet window leaves loss as is
+    health.updateWindow(2000);
+    QVERIFY(qAbs(health.lossPercent() - (5 * 100.0 / 15)) < 0.001);
+    QVERIFY(health.throughputBytesPerSec() < 10.0 * (20 + MAVLINK_NUM_NON_PAYLOAD_BYTES));
+
+    // Jitter follows the difference between consecutive samples
+    health.addRttSample(100);
+    QCOMPARE(health.rttMSecs(),     100.0);
+    QCOMPARE(health.jitterMSecs(),  0.0);
+    health.addRttSample(116);
+    QCOMPARE(health.jitterMSecs(),  1.0);
+    QCOMPARE(health.rttSampleCount(), 2);
+
+    // Loss makes a link more expensive than its round trip time alone
+    QVERIFY(health.costMSecs() > health.rttMSecs() + (2 * health.jitterMSecs()));
+
+    LinkHealth lossFreeHealth;
+    lossFreeHealth.addRttSample(health.rttMSecs());
+    QVERIFY(lossFreeHealth.costMSecs() < health.costMSecs());
+}
+
+void VehicleLinkManagerTest::_qualitySwitchTest(void)
+{
+    SharedLinkConfigurationPtr  mockConfig1;
+    SharedLinkInterfacePtr      mockLink1;
+    SharedLinkConfigurationPtr  mockConfig2;
+    SharedLinkInterfacePtr      mockLink2;
+
+    QSignalSpy spyVehicleCreate(_multiVehicleMgr, &MultiVehicleManager::activeVehicleChanged);
+
+    _startMockLink(1, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig1, mockLink1);
+    _startMockLink(2, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig2, mockLink2);
+
+    QCOMPARE(spyVehicleCreate.wait(1000), true);
+    Vehicle* vehicle = _multiVehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    VehicleLinkManager* vehicleLinkManager = vehicle->vehicleLinkManager();
+    QSignalSpy spyVehicleInitialConnectComplete(vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyVehicleInitialConnectComplete.wait(3000), true);
+
+    SharedLinkInterfacePtr slowLink = vehicleLinkManager->primaryLink().lock();
+    SharedLinkInterfacePtr fastLink = slowLink == mockLink1 ? mockLink2 : mockLink1;
+    QVERIFY(slowLink);
+
+    // MockLink answers TIMESYNC, so both links measure a round trip time
+    QVERIFY(QTest::qWaitFor([&]() {
+        for (const VehicleLinkManager::LinkInfo_t& linkInfo: vehicleLinkManager->_rgLinkInfo) {
+            if (linkInfo.health.rttSampleCount() == 0) {
+                return false;
+            }
+        }
+        return true;
+    }, VehicleLinkManager::_timesyncIntervalMSecs * 3));
+    QCOMPARE(vehicleLinkManager->linkHealth().count(), 2);
+
+    auto degradeSlowLink = [&]() {
+        for (VehicleLinkManager::LinkInfo_t& linkInfo: vehicleLinkManager->_rgLinkInfo) {
+            if (linkInfo.link == slowLink) {
+                for (int i=0; i<30; i++) {
+                    linkInfo.health.addRttSample(500);
+                }
+            }
+        }
+    };
+
+    // The better link must stay better for the full hysteresis period before the primary link moves
+    QSignalSpy spyPrimaryLinkChanged(vehicleLinkManager, &VehicleLinkManager::primaryLinkChanged);
+    degradeSlowLink();
+    QCOMPARE(vehicleLinkManager->fastestLink().lock(), fastLink);
+    for (int i=0; i<VehicleLinkManager::_qualitySwitchChecks - 1; i++) {
+        vehicleLinkManager->_evaluateLinkQuality();
+    }
+    QCOMPARE(spyPrimaryLinkChanged.count(), 0);
+    QCOMPARE(vehicleLinkManager->primaryLink().lock(), slowLink);
+    vehicleLinkManager->_evaluateLinkQuality();
+    QCOMPARE(spyPrimaryLinkChanged.count(), 1);
+    QCOMPARE(vehicleLinkManager->primaryLink().lock(), fastLink);
+
+    // A primary link picked by the user is left alone
+    spyPrimaryLinkChanged.clear();
+    vehicleLinkManager->setPrimaryLinkByName(slowLink->linkConfiguration()->name());
+    QCOMPARE(vehicleLinkManager->primaryLink().lock(), slowLink);
+    degradeSlowLink();
+    for (int i=0; i<VehicleLinkManager::_qualitySwitchChecks * 2; i++) {
+        vehicleLinkManager->_evaluateLinkQuality();
+    }
+    QCOMPARE(vehicleLinkManager->primaryLink().lock(), slowLink);
+    QCOMPARE(spyPrimaryLinkChanged.count(), 1);
+}
+
+void VehicleLinkManagerTest::_stallFailoverTest(void)
+{
+    SharedLinkConfigurationPtr  mockConfig1;
+    SharedLinkInterfacePtr      mockLink1;
+    SharedLinkConfigurationPtr  mockConfig2;
+    SharedLinkInterfacePtr      mockLink2;
+
+    QSignalSpy spyVehicleCreate(_multiVehicleMgr, &MultiVehicleManager::activeVehicleChanged);
+
+    _startMockLink(1, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig1, mockLink1);
+    _startMockLink(2, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig2, mockLink2);
+
+    QCOMPARE(spyVehicleCreate.wait(1000), true);
+    Vehicle* vehicle = _multiVehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    VehicleLinkManager* vehicleLinkManager = vehicle->vehicleLinkManager();
+    QSignalSpy spyVehicleInitialConnectComplete(vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyVehicleInitialConnectComplete.wait(3000), true);
+
+    SharedLinkInterfacePtr silentLink   = vehicleLinkManager->primaryLink().lock();
+    SharedLinkInterfacePtr otherLink    = silentLink == mockLink1 ? mockLink2 : mockLink1;
+    QVERIFY(silentLink);
+
+    // The primary link goes silent while the other link keeps receiving, which fails over well before comm lost
+    QSignalSpy      spyPrimaryLinkChanged(vehicleLinkManager, &VehicleLinkManager::primaryLinkChanged);
+    QElapsedTimer   failoverTimer;
+    failoverTimer.start();
+    qobject_cast<MockLink*>(silentLink.get())->setCommLost(true);
+    QCOMPARE(spyPrimaryLinkChanged.wait(VehicleLinkManager::_heartbeatMaxElpasedMSecs), true);
+    QVERIFY(failoverTimer.elapsed() < VehicleLinkManager::_heartbeatMaxElpasedMSecs);
+    QCOMPARE(vehicleLinkManager->primaryLink().lock(), otherLink);
+
+    const VehicleLinkManager::LinkInfo_t& silentLinkInfo = vehicleLinkManager->_rgLinkInfo[vehicleLinkManager->_containsLinkIndex(silentLink.get())];
+    QVERIFY(silentLinkInfo.stalled);
+    QVERIFY(!silentLinkInfo.commLost);
+    QVERIFY(!vehicleLinkManager->communicationLost());
+
+    qobject_cast<MockLink*>(silentLink.get())->setCommLost(false);
+}
+
+void VehicleLinkManagerTest::_slowTimesyncTest(void)
+{
+    SharedLinkConfigurationPtr  mockConfig;
+    SharedLinkInterfacePtr      mockLink;
+
+    QSignalSpy spyVehicleCreate(_multiVehicleMgr, &MultiVehicleManager::activeVehicleChanged);
+    _startMockLink(1, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig, mockLink);
+    QCOMPARE(spyVehicleCreate.wait(1000), true);
+    Vehicle* vehicle = _multiVehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    VehicleLinkManager* vehicleLinkManager = vehicle->vehicleLinkManager();
+    QSignalSpy spyVehicleInitialConnectComplete(vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyVehicleInitialConnectComplete.wait(3000), true);
+
+    VehicleLinkManager::LinkInfo_t& linkInfo = vehicleLinkManager->_rgLinkInfo[0];
+    vehicleLinkManager->_linkHealthCheckTimer.stop();
+
+    // Probes which stay unanswered still give a lower bound for the round trip time
+    qobject_cast<MockLink*>(mockLink.get())->setCommLost(true);
+    linkInfo.timesyncPendingNsecs.clear();
+    const int sampleCount = linkInfo.health.rttSampleCount();
+    for (int i=0; i<VehicleLinkManager::_timesyncMaxPendingProbes; i++) {
+        vehicleLinkManager->_sendTimesync();
+    }
+    QCOMPARE(linkInfo.health.rttSampleCount(), sampleCount);
+    const qint64 firstProbeNsecs = linkInfo.timesyncPendingNsecs.first();
+    QTest::qWait(100);
+    vehicleLinkManager->_sendTimesync();
+    QCOMPARE(linkInfo.health.rttSampleCount(), sampleCount + 1);
+    QCOMPARE(linkInfo.timesyncPendingNsecs.count(), static_cast<int>(VehicleLinkManager::_timesyncMaxPendingProbes));
+    QVERIFY(linkInfo.timesyncPendingNsecs.first() != firstProbeNsecs);
+    QVERIFY(linkInfo.health.rttMSecs() > 0);
+
+    // A late answer to an older probe is still measured and clears the probes sent before it
+    mavlink_timesync_t  timesync;
+    mavlink_message_t   message;
+    memset(&timesync, 0, sizeof(timesync));
+    timesync.tc1 = 1;
+    timesync.ts1 = linkInfo.timesyncPendingNsecs[1];
+    mavlink_msg_timesync_encode(static_cast<uint8_t>(vehicle->id()), MAV_COMP_ID_AUTOPILOT1, &message, &timesync);
+    vehicleLinkManager->_timesyncReceived(linkInfo, message);
+    QCOMPARE(linkInfo.health.rttSampleCount(), sampleCount + 2);
+    QCOMPARE(linkInfo.timesyncPendingNsecs.count(), static_cast<int>(VehicleLinkManager::_timesyncMaxPendingProbes) - 2);
+
+    qobject_cast<MockLink*>(mockLink.get())->setCommLost(false);
+}
+
 void VehicleLinkManagerTest::_startMockLink(int mockIndex, bool highLatency, bool incrementVehicleId, SharedLinkConfigurationPtr& mockConfig, SharedLinkInterfacePtr& mockLink)
 {
     MockConfiguration* pMockConfig = new MockConfiguration(QStringLiteral("Mock %1").arg(mockIndex));
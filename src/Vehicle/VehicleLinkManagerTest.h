@@ -34,6 +34,10 @@ private slots:
     void _multiLinkSingleVehicleTest(void);
     void _connectionRemovedTest     (void);
     void _highLatencyLinkTest       (void);
+    void _linkHealthTest            (void);
+    void _qualitySwitchTest         (void);
+    void _stallFailoverTest         (void);
+    void _slowTimesyncTest          (void);
 
 private:
     void _startMockLink(int mockIndex, bool highLatency, bool incrementVehicleId, SharedLinkConfigurationPtr& sharedConfig, SharedLinkInterfacePtr& mockLink);
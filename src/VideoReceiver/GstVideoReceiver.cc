@@ -20,8 +20,10 @@
 #include <QUrl>
 #include <QDateTime>
 #include <QSysInfo>
+#include <QtMath>
 
-QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
+QGC_LOGGING_CATEGORY(VideoReceiverLog,        "VideoReceiverLog")
+QGC_LOGGING_CATEGORY(VideoReceiverMetricsLog, "VideoReceiverMetricsLog")
 
 //-----------------------------------------------------------------------------
 // Our pipeline look like this:
@@ -32,6 +34,14 @@ QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
 //              |
 //              +-->queue-->_recorderValve[-->_fileSink]
 //
+// The tee hands the same refcounted buffers to both branches, recording does not copy frames.
+//
+// Low latency profile (buffer < 0): no jitter buffer, unsynchronized video sink, a decoder queue which
+// can only hold a few frames and libav decoders switched from frame to slice threading.
+//
+// Instrumentation (VideoReceiverMetricsLog enabled): the tee and video sink probes timestamp buffers to
+// measure pipeline latency and frame pacing, queue levels and QoS drops are sampled by the watchdog.
+//
 
 GstVideoReceiver::GstVideoReceiver(QObject* parent)
     : VideoReceiver(parent)
@@ -48,6 +58,8 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _videoSink(nullptr)
     , _fileSink(nullptr)
     , _pipeline(nullptr)
+    , _decoderQueue(nullptr)
+    , _recorderQueue(nullptr)
     , _lastSourceFrameTime(0)
     , _lastVideoFrameTime(0)
     , _resetVideoSink(true)
@@ -55,6 +67,16 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _udpReconnect_us(5000000)
     , _signalDepth(0)
     , _endOfStream(false)
+    , _metricsEnabled(false)
+    , _metrics()
+    , _latencySlots()
+    , _nextLatencySlot(0)
+    , _lastDecodedUsecs(0)
+    , _latencySumMs(0)
+    , _cLatencySamples(0)
+    , _intervalSumMs(0)
+    , _intervalSqSumMs(0)
+    , _cIntervals(0)
 {
     _slotHandler.start();
     connect(&_watchdogTimer, &QTimer::timeout, this, &GstVideoReceiver::_watchdog);
@@ -101,6 +123,22 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
     _endOfStream = false;
 
+    _metricsEnabled = VideoReceiverMetricsLog().isDebugEnabled();
+    _metricsSync.lock();
+    _metrics            = {};
+    _nextLatencySlot    = 0;
+    _lastDecodedUsecs   = 0;
+    _latencySumMs       = 0;
+    _cLatencySamples    = 0;
+    _intervalSumMs      = 0;
+    _intervalSqSumMs    = 0;
+    _cIntervals         = 0;
+    _qosDropped.clear();
+    for (LatencySlot_t& slot: _latencySlots) {
+        slot.pts = GST_CLOCK_TIME_NONE;
+    }
+    _metricsSync.unlock();
+
     bool running    = false;
     bool pipelineUp = false;
 
@@ -131,6 +169,11 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             break;
         }
 
+        if (_buffer < 0) {
+            // Don't let frames pile up in front of the decoder, anything queued here is added latency
+            g_object_set(decoderQueue, "max-size-buffers", _lowLatencyQueueBuffers, "max-size-bytes", 0, "max-size-time", G_GUINT64_CONSTANT(0), nullptr);
+        }
+
         if((_decoderValve = gst_element_factory_make("valve", nullptr)) == nullptr)  {
             qCCritical(VideoReceiverLog) << "gst_element_factory_make('valve') failed";
             break;
@@ -157,6 +200,10 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         g_object_set(_pipeline, "message-forward", TRUE, nullptr);
 
+        if (_buffer < 0) {
+            g_signal_connect(_pipeline, "deep-element-added", G_CALLBACK(_onDeepElementAdded), this);
+        }
+
         if ((_source = _makeSource(uri)) == nullptr) {
             qCCritical(VideoReceiverLog) << "_makeSource() failed";
             break;
@@ -166,6 +213,9 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         pipelineUp = true;
 
+        _decoderQueue = decoderQueue;
+        _recorderQueue = recorderQueue;
+
         GstPad* srcPad = nullptr;
 
         GstIterator* it;
@@ -224,6 +274,9 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             _pipeline = nullptr;
         }
 
+        _decoderQueue = nullptr;
+        _recorderQueue = nullptr;
+
         // If we failed before adding items to the pipeline, then clean up
         if (!pipelineUp) {
             if (_recorderValve != nullptr) {
@@ -341,7 +394,9 @@ GstVideoReceiver::stop(void)
         _pipeline = nullptr;
 
         _recorderValve = nullptr;
+        _recorderQueue = nullptr;
         _decoderValve = nullptr;
+        _decoderQueue = nullptr;
         _tee = nullptr;
         _source = nullptr;
 
@@ -632,6 +687,10 @@ GstVideoReceiver::_watchdog(void)
             return;
         }
 
+        if (_metricsEnabled) {
+            _reportMetrics();
+        }
+
         const qint64 now = QDateTime::currentSecsSinceEpoch();
 
         if (_lastSourceFrameTime == 0) {
@@ -1124,6 +1183,118 @@ GstVideoReceiver::_noteTeeFrame(void)
     _lastSourceFrameTime = QDateTime::currentSecsSinceEpoch();
 }
 
+void
+GstVideoReceiver::_noteSourceBuffer(GstBuffer* buf)
+{
+    const gint64 now = g_get_monotonic_time();
+
+    QMutexLocker lock(&_metricsSync);
+
+    _metrics.framesReceived++;
+
+    // Remember when this frame entered the pipeline so the decoded frame with the same pts can be matched up
+    if (GST_BUFFER_PTS_IS_VALID(buf)) {
+        LatencySlot_t& slot = _latencySlots[_nextLatencySlot];
+        slot.pts            = GST_BUFFER_PTS(buf);
+        slot.arrivalUsecs   = now;
+        _nextLatencySlot    = (_nextLatencySlot + 1) % _cLatencySlots;
+    }
+}
+
+void
+GstVideoReceiver::_noteDecodedBuffer(GstBuffer* buf)
+{
+    const gint64 now = g_get_monotonic_time();
+
+    QMutexLocker lock(&_metricsSync);
+
+    _metrics.framesDisplayed++;
+
+    if (_lastDecodedUsecs != 0) {
+        const double intervalMs = (now - _lastDecodedUsecs) / 1000.0;
+        _intervalSumMs   += intervalMs;
+        _intervalSqSumMs += intervalMs * intervalMs;
+        _cIntervals++;
+    }
+    _lastDecodedUsecs = now;
+
+    if (GST_BUFFER_PTS_IS_VALID(buf)) {
+        const GstClockTime pts = GST_BUFFER_PTS(buf);
+        for (LatencySlot_t& slot: _latencySlots) {
+            if (slot.pts == pts) {
+                const double latencyMs = (now - slot.arrivalUsecs) / 1000.0;
+                _latencySumMs += latencyMs;
+                _cLatencySamples++;
+                _metrics.latencyMaxMs = qMax(_metrics.latencyMaxMs, latencyMs);
+                slot.pts = GST_CLOCK_TIME_NONE;
+                break;
+            }
+        }
+    }
+}
+
+void
+GstVideoReceiver::_noteQos(GstMessage* msg)
+{
+    GstFormat   format;
+    guint64     processed;
+    guint64     dropped;
+
+    gst_message_parse_qos_stats(msg, &format, &processed, &dropped);
+
+    if (format != GST_FORMAT_BUFFERS && format != GST_FORMAT_DEFAULT) {
+        return;
+    }
+
+    // Each element reports a running total, keep the latest total per element
+    QMutexLocker lock(&_metricsSync);
+    _qosDropped[GST_MESSAGE_SRC(msg)] = dropped;
+}
+
+void
+GstVideoReceiver::_reportMetrics(void)
+{
+    guint decoderLevel = 0;
+    guint recorderLevel = 0;
+
+    if (_decoderQueue != nullptr) {
+        g_object_get(_decoderQueue, "current-level-buffers", &decoderLevel, nullptr);
+    }
+    if (_recorderQueue != nullptr) {
+        g_object_get(_recorderQueue, "current-level-buffers", &recorderLevel, nullptr);
+    }
+
+    _metricsSync.lock();
+
+    _metrics.decoderQueueLevel  = static_cast<int>(decoderLevel);
+    _metrics.recorderQueueLevel = static_cast<int>(recorderLevel);
+    _metrics.latencyMs          = _cLatencySamples ? _latencySumMs / _cLatencySamples : 0;
+    _metrics.frameIntervalMs    = _cIntervals ? _intervalSumMs / _cIntervals : 0;
+    _metrics.frameJitterMs      = _cIntervals ? qSqrt(qMax(0.0, (_intervalSqSumMs / _cIntervals) - (_metrics.frameIntervalMs * _metrics.frameIntervalMs))) : 0;
+    _metrics.framesDropped      = 0;
+    for (quint64 dropped: _qosDropped) {
+        _metrics.framesDropped += dropped;
+    }
+
+    Metrics_t metrics = _metrics;
+
+    // Averages and maximums are per reporting period, frame counts are totals
+    _metrics.latencyMaxMs   = 0;
+    _latencySumMs           = 0;
+    _cLatencySamples        = 0;
+    _intervalSumMs          = 0;
+    _intervalSqSumMs        = 0;
+    _cIntervals             = 0;
+
+    _metricsSync.unlock();
+
+    qCDebug(VideoReceiverMetricsLog) << _uri
+                                     << "latency(ms)" << metrics.latencyMs << "max" << metrics.latencyMaxMs
+                                     << "interval(ms)" << metrics.frameIntervalMs << "jitter" << metrics.frameJitterMs
+                                     << "queues" << metrics.decoderQueueLevel << metrics.recorderQueueLevel
+                                     << "frames" << metrics.framesReceived << metrics.framesDisplayed << "dropped" << metrics.framesDropped;
+}
+
 void
 GstVideoReceiver::_noteVideoSinkFrame(void)
 {
@@ -1319,6 +1490,11 @@ GstVideoReceiver::_onBusMessage(GstBus* bus, GstMessage* msg, gpointer data)
             pThis->_handleEOS();
         });
         break;
+    case GST_MESSAGE_QOS:
+        if (pThis->_metricsEnabled) {
+            pThis->_noteQos(msg);
+        }
+        break;
     case GST_MESSAGE_ELEMENT:
         do {
             const GstStructure* s = gst_message_get_structure (msg);
@@ -1449,11 +1625,14 @@ GstPadProbeReturn
 GstVideoReceiver::_teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
     Q_UNUSED(pad)
-    Q_UNUSED(info)
 
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
         pThis->_noteTeeFrame();
+
+        if (pThis->_metricsEnabled && info != nullptr) {
+            pThis->_noteSourceBuffer(gst_pad_probe_info_get_buffer(info));
+        }
     }
 
     return GST_PAD_PROBE_OK;
@@ -1496,6 +1675,10 @@ GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer u
         }
 
         pThis->_noteVideoSinkFrame();
+
+        if (pThis->_metricsEnabled && info != nullptr) {
+            pThis->_noteDecodedBuffer(gst_pad_probe_info_get_buffer(info));
+        }
     }
 
     return GST_PAD_PROBE_OK;
@@ -1546,3 +1729,25 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
 
     return GST_PAD_PROBE_REMOVE;
 }
+
+void
+GstVideoReceiver::_onDeepElementAdded(GstBin* bin, GstBin* subBin, GstElement* element, gpointer data)
+{
+    Q_UNUSED(bin)
+    Q_UNUSED(subBin)
+    Q_UNUSED(data)
+
+    GstElementFactory* factory = gst_element_get_factory(element);
+
+    if (factory == nullptr) {
+        return;
+    }
+
+    const gchar* factoryName = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+
+    // Frame threading in the libav decoders holds back one frame per decoding thread
+    if (g_str_has_prefix(factoryName, "avdec_") && g_object_class_find_property(G_OBJECT_GET_CLASS(element), "thread-type") != nullptr) {
+        gst_util_set_object_arg(G_OBJECT(element), "thread-type", "slice");
+        qCDebug(VideoReceiverLog) << "Low latency: slice threading enabled for" << factoryName;
+    }
+}
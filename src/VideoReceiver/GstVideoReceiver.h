@@ -22,12 +22,14 @@
 #include <QMutex>
 #include <QQueue>
 #include <QQuickItem>
+#include <QHash>
 
 #include "VideoReceiver.h"
 
 #include <gst/gst.h>
 
 Q_DECLARE_LOGGING_CATEGORY(VideoReceiverLog)
+Q_DECLARE_LOGGING_CATEGORY(VideoReceiverMetricsLog)
 
 class Worker : public QThread
 {
@@ -113,6 +115,10 @@ protected:
     virtual void _noteTeeFrame(void);
     virtual void _noteVideoSinkFrame(void);
     virtual void _noteEndOfStream(void);
+    virtual void _noteSourceBuffer(GstBuffer* buf);
+    virtual void _noteDecodedBuffer(GstBuffer* buf);
+    virtual void _noteQos(GstMessage* msg);
+    virtual void _reportMetrics(void);
     virtual bool _unlinkBranch(GstElement* from);
     virtual void _shutdownDecodingBranch (void);
     virtual void _shutdownRecordingBranch(void);
@@ -129,6 +135,7 @@ protected:
     static GstPadProbeReturn _videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void _onDeepElementAdded(GstBin* bin, GstBin* subBin, GstElement* element, gpointer data);
 
     bool                _streaming;
     bool                _decoding;
@@ -143,6 +150,8 @@ protected:
     GstElement*         _videoSink;
     GstElement*         _fileSink;
     GstElement*         _pipeline;
+    GstElement*         _decoderQueue;          // Owned by _pipeline
+    GstElement*         _recorderQueue;         // Owned by _pipeline
 
     qint64              _lastSourceFrameTime;
     qint64              _lastVideoFrameTime;
@@ -163,6 +172,42 @@ protected:
 
     bool                _endOfStream;
 
+    //-- Instrumentation, enabled by VideoReceiverMetricsLog. Updated from the streaming threads.
+    /// Pipeline statistics for the last reporting period, written to VideoReceiverMetricsLog
+    struct Metrics_t {
+        double  latencyMs;              ///< Average time from a frame entering the pipeline to it reaching the video sink
+        double  latencyMaxMs;
+        double  frameIntervalMs;        ///< Average interval between frames reaching the video sink
+        double  frameJitterMs;          ///< Standard deviation of the frame interval
+        int     decoderQueueLevel;      ///< Buffers waiting in front of the decoder
+        int     recorderQueueLevel;     ///< Buffers waiting in front of the recorder
+        quint64 framesReceived;         ///< Totals since the stream was started
+        quint64 framesDisplayed;
+        quint64 framesDropped;
+    };
+
+    struct LatencySlot_t {
+        GstClockTime    pts;
+        gint64          arrivalUsecs;
+    };
+
+    static const int    _cLatencySlots = 64;
+
+    bool                        _metricsEnabled;
+    QMutex                      _metricsSync;
+    Metrics_t                   _metrics;
+    LatencySlot_t               _latencySlots[_cLatencySlots];
+    int                         _nextLatencySlot;
+    gint64                      _lastDecodedUsecs;
+    double                      _latencySumMs;
+    int                         _cLatencySamples;
+    double                      _intervalSumMs;
+    double                      _intervalSqSumMs;
+    int                         _cIntervals;
+    QHash<GstObject*, quint64>  _qosDropped;            ///< Dropped count as last reported by each element
+
+    static const guint  _lowLatencyQueueBuffers = 3;
+
     static const char*  _kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN];
 };
 
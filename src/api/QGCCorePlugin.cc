@@ -198,6 +198,7 @@ QVariantList& QGCCorePlugin::analyzePages()
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
         _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("MAVLink Inspector"),QUrl::fromUserInput("qrc:/qml/MAVLinkInspectorPage.qml"),   QUrl::fromUserInput("qrc:/qmlimages/MAVLinkInspector"))));
 #endif
+        _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("Telemetry Trace"),  QUrl::fromUserInput("qrc:/qml/TelemetryTracePage.qml"),     QUrl::fromUserInput("qrc:/qmlimages/TelemetryTraceIcon"))));
         _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("Vibration"),        QUrl::fromUserInput("qrc:/qml/VibrationPage.qml"),          QUrl::fromUserInput("qrc:/qmlimages/VibrationPageIcon"))));
     }
     return _p->analyzeList;
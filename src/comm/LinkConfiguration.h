@@ -33,6 +33,7 @@ public:
     Q_PROPERTY(QString          settingsURL         READ settingsURL                            CONSTANT)
     Q_PROPERTY(QString          settingsTitle       READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency         READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
+    Q_PROPERTY(int              txBudget            READ txBudget       WRITE setTxBudget       NOTIFY txBudgetChanged)
 
     // Property accessors
 
@@ -86,6 +87,16 @@ public:
     */
     void setHighLatency(bool hl = false) { _highLatency = hl; emit highLatencyChanged(); }
 
+    /// Outbound byte budget in bytes per second as configured by the user, 0 for automatic
+    int  txBudget   () const { return _txBudget; }
+    void setTxBudget(int txBudget) { _txBudget = qMax(0, txBudget); emit txBudgetChanged(); }
+
+    /// @return Outbound bytes per second the link is scheduled at, 0 for unlimited
+    int txBytesPerSecond() const { return _txBudget > 0 ? _txBudget : defaultTxBytesPerSecond(); }
+
+    /// @return Outbound bytes per second used when no budget is configured, 0 for unlimited
+    virtual int defaultTxBytesPerSecond() const { return 0; }
+
     /// Virtual Methods
 
     /*!
@@ -167,6 +178,7 @@ signals:
     void dynamicChanged     ();
     void autoConnectChanged ();
     void highLatencyChanged ();
+    void txBudgetChanged    ();
     void linkChanged        ();
 
 protected:
@@ -177,6 +189,7 @@ private:
     bool    _dynamic;       ///< A connection added automatically and not persistent (unless it's edited).
     bool    _autoConnect;   ///< This connection is started automatically at boot
     bool    _highLatency;
+    int     _txBudget;      ///< Outbound bytes per second, 0 for automatic
 };
 
 typedef std::shared_ptr<LinkConfiguration>  SharedLinkConfigurationPtr;
@@ -10,6 +10,7 @@
 #include "LinkInterface.h"
 #include "LinkManager.h"
 #include "QGCApplication.h"
+#include "TelemetryTracer.h"
 
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "LinkInterfaceLog")
 
@@ -24,8 +25,15 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPtr& config, bool isPX4Flow)
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
     qRegisterMetaType<LinkInterface*>("LinkInterface*");
 
-    // This will cause the writeBytes calls to end up on the thread of the link
-    QObject::connect(this, &LinkInterface::_invokeWriteBytes, this, &LinkInterface::_writeBytes);
+    // This will cause the writes to end up on the thread of the link. Always queued so that all frames sent before the
+    // flush runs go out together.
+    QObject::connect(this, &LinkInterface::_invokeFlushOutbound, this, &LinkInterface::_flushOutbound, Qt::QueuedConnection);
+    _outboundClock.start();
+
+    // Child object so it follows the link when it is moved to its own thread
+    _outboundTimer = new QTimer(this);
+    _outboundTimer->setSingleShot(true);
+    QObject::connect(_outboundTimer, &QTimer::timeout, this, &LinkInterface::_flushOutbound);
 }
 
 LinkInterface::~LinkInterface()
@@ -80,9 +88,37 @@ void LinkInterface::_freeMavlinkChannel()
     _mavlinkChannel = LinkManager::invalidMavlinkChannel();
 }
 
-void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
+void LinkInterface::writeBytesThreadSafe(const char *bytes, int length, LinkOutboundScheduler::Priority priority)
+{
+    _outboundScheduler.enqueue(priority, bytes, length);
+    if (!_outboundFlushPending.exchange(true)) {
+        emit _invokeFlushOutbound();
+    }
+}
+
+void LinkInterface::_flushOutbound(void)
 {
-    emit _invokeWriteBytes(QByteArray(bytes, length));
+    _outboundFlushPending = false;
+
+    if (_config) {
+        _outboundScheduler.setBytesPerSecond(_config->txBytesPerSecond());
+    }
+
+    int waitMSecs = -1;
+    while (true) {
+        QByteArray batch = _outboundScheduler.takeBatch(_outboundClock.elapsed(), waitMSecs);
+        if (!batch.isEmpty()) {
+            _writeBytes(batch);
+        }
+        if (waitMSecs != 0) {
+            break;
+        }
+    }
+
+    if (waitMSecs > 0 && !_outboundTimer->isActive()) {
+        // Out of budget, pick up the rest once enough has built up again
+        _outboundTimer->start(waitMSecs);
+    }
 }
 
 void LinkInterface::addVehicleReference(void)
@@ -119,3 +155,23 @@ bool LinkInterface::isMockLink(void)
     return dynamic_cast<MockLink*>(this);
 }
 #endif
+
+void LinkInterface::setTelemetryTracing(bool enabled)
+{
+    if (enabled) {
+        // Runs on the emitting thread so the time is captured before the signal is queued to the MAVLinkProtocol
+        QObject::connect(this, &LinkInterface::bytesReceived, this, &LinkInterface::_traceBytesReceived, static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection));
+    } else {
+        QObject::disconnect(this, &LinkInterface::bytesReceived, this, &LinkInterface::_traceBytesReceived);
+        _traceBytesReceivedNsecs.store(0);
+    }
+}
+
+void LinkInterface::_traceBytesReceived(void)
+{
+    if (TelemetryTracer::enabled()) {
+        // Only the oldest pending emit is kept, later emits queued behind it see a shorter wait
+        qint64 noPendingNsecs = 0;
+        _traceBytesReceivedNsecs.compare_exchange_strong(noPendingNsecs, TelemetryTracer::nowNsecs());
+    }
+}
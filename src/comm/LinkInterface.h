@@ -18,12 +18,15 @@
 #include <QSharedPointer>
 #include <QDebug>
 #include <QTimer>
+#include <QElapsedTimer>
 
+#include <atomic>
 #include <memory>
 
 #include "QGCMAVLink.h"
 #include "LinkConfiguration.h"
 #include "MavlinkMessagesTimer.h"
+#include "LinkOutboundScheduler.h"
 
 class LinkManager;
 
@@ -66,17 +69,25 @@ public:
 
     bool    decodedFirstMavlinkPacket   (void) const { return _decodedFirstMavlinkPacket; }
     bool    setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { return _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
-    void    writeBytesThreadSafe        (const char *bytes, int length);
+    void    writeBytesThreadSafe        (const char *bytes, int length, LinkOutboundScheduler::Priority priority = LinkOutboundScheduler::PriorityNormal);
     void    addVehicleReference         (void);
     void    removeVehicleReference      (void);
 
+    /// Telemetry tracing: Connects the timing of bytesReceived emits. Only connected while tracing is enabled so links
+    /// don't pay for an extra slot call on every emit otherwise.
+    void    setTelemetryTracing         (bool enabled);
+
+    /// Telemetry tracing: Returns the time the oldest unprocessed bytesReceived signal was emitted and clears it
+    ///     @return TelemetryTracer::nowNsecs timestamp, 0 if none was recorded
+    qint64  takeTraceBytesReceivedNsecs (void) { return _traceBytesReceivedNsecs.exchange(0); }
+
 signals:
     void bytesReceived      (LinkInterface* link, QByteArray data);
     void bytesSent          (LinkInterface* link, QByteArray data);
     void connected          (void);
     void disconnected       (void);
     void communicationError (const QString& title, const QString& error);
-    void _invokeWriteBytes  (QByteArray);
+    void _invokeFlushOutbound(void);
 
 protected:
     // Links are only created by LinkManager so constructor is not public
@@ -99,6 +110,8 @@ protected:
 
 private slots:
     virtual void _writeBytes(const QByteArray) = 0; // Not thread safe if called directly, only writeBytesThreadSafe is thread safe
+    void _traceBytesReceived(void);
+    void _flushOutbound     (void);
 
 private:
     // connect is private since all links should be created through LinkManager::createConnectedLink calls
@@ -109,6 +122,13 @@ private:
     bool    _isPX4Flow                  = false;
     int     _vehicleReferenceCount      = 0;
 
+    std::atomic<qint64> _traceBytesReceivedNsecs{0};
+
+    LinkOutboundScheduler   _outboundScheduler;
+    QElapsedTimer           _outboundClock;
+    QTimer*                 _outboundTimer          = nullptr;  ///< Picks up queued frames once the byte budget allows
+    std::atomic<bool>       _outboundFlushPending   { false };
+
     QMap<int /* vehicle id */, MavlinkMessagesTimer*> _mavlinkMessagesTimers;
 };
 
@@ -24,6 +24,8 @@
 #include "TCPLink.h"
 #include "SettingsManager.h"
 #include "LogReplayLink.h"
+#include "MAVLinkForwarder.h"
+#include "TelemetryTracer.h"
 #ifdef QGC_ENABLE_BLUETOOTH
 #include "BluetoothLink.h"
 #endif
@@ -155,6 +157,7 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr& config, bool i
         connect(link.get(), &LinkInterface::bytesReceived,       _mavlinkProtocol,    &MAVLinkProtocol::receiveBytes);
         connect(link.get(), &LinkInterface::bytesSent,           _mavlinkProtocol,    &MAVLinkProtocol::logSentBytes);
         connect(link.get(), &LinkInterface::disconnected,        this,                &LinkManager::_linkDisconnected);
+        link->setTelemetryTracing(TelemetryTracer::enabled());
 
         _mavlinkProtocol->resetMetadataForLink(link.get());
         _mavlinkProtocol->setVersion(_mavlinkProtocol->getCurrentVersion());
@@ -169,19 +172,6 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr& config, bool i
     return false;
 }
 
-SharedLinkInterfacePtr LinkManager::mavlinkForwardingLink()
-{
-    for (int i = 0; i < _rgLinks.count(); i++) {
-        SharedLinkConfigurationPtr linkConfig = _rgLinks[i]->linkConfiguration();
-        if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == _mavlinkForwardingLinkName) {
-            SharedLinkInterfacePtr& link = _rgLinks[i];
-            return link;
-        }
-    }
-
-    return nullptr;
-}
-
 void LinkManager::disconnectAll(void)
 {
     QList<SharedLinkInterfacePtr> links = _rgLinks;
@@ -191,6 +181,14 @@ void LinkManager::disconnectAll(void)
     }
 }
 
+void LinkManager::setTelemetryTracingEnabled(bool enabled)
+{
+    TelemetryTracer::setEnabled(enabled);
+    for (const SharedLinkInterfacePtr& sharedLink: _rgLinks) {
+        sharedLink->setTelemetryTracing(enabled);
+    }
+}
+
 void LinkManager::_linkDisconnected(void)
 {
     LinkInterface* link = qobject_cast<LinkInterface*>(sender());
@@ -265,6 +263,7 @@ void LinkManager::saveLinkConfigurationList()
                 settings.setValue(root + "/type", linkConfig->type());
                 settings.setValue(root + "/auto", linkConfig->isAutoConnect());
                 settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+                settings.setValue(root + "/tx_budget", linkConfig->txBudget());
                 // Have the instance save its own values
                 linkConfig->saveSettings(settings, root);
             }
@@ -295,6 +294,7 @@ void LinkManager::loadLinkConfigurationList()
                             LinkConfiguration* link = nullptr;
                             bool autoConnect = settings.value(root + "/auto").toBool();
                             bool highLatency = settings.value(root + "/high_latency").toBool();
+                            int txBudget = settings.value(root + "/tx_budget", 0).toInt();
 
                             switch(type) {
 #ifndef NO_SERIAL_LINK
@@ -328,6 +328,7 @@ void LinkManager::loadLinkConfigurationList()
                                 //-- Have the instance load its own values
                                 link->setAutoConnect(autoConnect);
                                 link->setHighLatency(highLatency);
+                                link->setTxBudget(txBudget);
                                 link->loadSettings(settings, root);
                                 addConfiguration(link);
                             }
@@ -392,33 +393,58 @@ void LinkManager::_addUDPAutoConnectLink(void)
     }
 }
 
-void LinkManager::_addMAVLinkForwardingLink(void)
+void LinkManager::_addMAVLinkForwardingLinks(void)
 {
-    if (_toolbox->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool()) {
-        bool foundMAVLinkForwardingLink = false;
+    if (!_toolbox->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool()) {
+        return;
+    }
 
-        for (int i=0; i<_rgLinks.count(); i++) {
-            SharedLinkConfigurationPtr linkConfig = _rgLinks[i]->linkConfiguration();
-            if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == _mavlinkForwardingLinkName) {
-                foundMAVLinkForwardingLink = true;
-                // TODO: should we check if the host/port matches the mavlinkForwardHostName setting and update if it does not match?
+    QString                         targetSpecs = _toolbox->settingsManager()->appSettings()->forwardMavlinkHostName()->rawValue().toString();
+    QList<MAVLinkForwardingTarget>  rgTargets;
+    QString                         errorString;
+
+    if (!MAVLinkForwardingTarget::parseList(targetSpecs, rgTargets, errorString)) {
+        if (targetSpecs != _mavlinkForwardingErrorSpecs) {
+            _mavlinkForwardingErrorSpecs = targetSpecs;
+            qgcApp()->showAppMessage(tr("MAVLink forwarding disabled: %1").arg(errorString));
+        }
+        return;
+    }
+
+    // Each target has its own UDP link so filters and rate limits apply per target
+    for (int targetIndex=0; targetIndex<rgTargets.count(); targetIndex++) {
+        MAVLinkForwardingTarget&    target      = rgTargets[targetIndex];
+        QString                     linkName    = targetIndex == 0 ? QString(_mavlinkForwardingLinkName) : QStringLiteral("%1 %2").arg(_mavlinkForwardingLinkName).arg(targetIndex + 1);
+
+        for (const SharedLinkInterfacePtr& link: _rgLinks) {
+            SharedLinkConfigurationPtr linkConfig = link->linkConfiguration();
+            if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == linkName) {
+                // TODO: should we check if the host/port matches the target and update if it does not match?
+                target.setLink(link);
                 break;
             }
         }
 
-        if (!foundMAVLinkForwardingLink) {
-            qCDebug(LinkManagerLog) << "New MAVLink forwarding port added";
+        if (target.link().expired()) {
+            qCDebug(LinkManagerLog) << "New MAVLink forwarding port added" << linkName << target.hostName();
 
-            UDPConfiguration* udpConfig = new UDPConfiguration(_mavlinkForwardingLinkName);
+            UDPConfiguration* udpConfig = new UDPConfiguration(linkName);
             udpConfig->setDynamic(true);
-
-            QString hostName = _toolbox->settingsManager()->appSettings()->forwardMavlinkHostName()->rawValue().toString();
-            udpConfig->addHost(hostName);
+            udpConfig->addHost(target.hostName());
 
             SharedLinkConfigurationPtr config = addConfiguration(udpConfig);
-            createConnectedLink(config);
+            if (createConnectedLink(config)) {
+                target.setLink(sharedLinkInterfacePointerForLink(config->link()));
+            }
         }
     }
+
+    // Filter, rate limit and removed target changes reuse the existing links, so compare the targets themselves
+    if (rgTargets != _mavlinkForwardingTargets) {
+        qCDebug(LinkManagerLog) << "MAVLink forwarding targets changed" << targetSpecs;
+        _mavlinkForwardingTargets = rgTargets;
+        _mavlinkProtocol->forwarder()->setTargets(rgTargets);
+    }
 }
 
 void LinkManager::_addZeroConfAutoConnectLink(void)
@@ -498,7 +524,7 @@ void LinkManager::_updateAutoConnectLinks(void)
     }
 
     _addUDPAutoConnectLink();
-    _addMAVLinkForwardingLink();
+    _addMAVLinkForwardingLinks();
     _addZeroConfAutoConnectLink();
 
 #ifndef __mobile__
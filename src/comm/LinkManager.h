@@ -20,6 +20,7 @@
 #include "QGCLoggingCategory.h"
 #include "QGCToolbox.h"
 #include "MAVLinkProtocol.h"
+#include "MAVLinkForwarder.h"
 #if !defined(__mobile__)
 #include "LogReplayLink.h"
 #include "UdpIODevice.h"
@@ -48,6 +49,8 @@ class LinkManager : public QGCTool
 {
     Q_OBJECT
 
+    friend class MAVLinkForwarderTest;
+
 public:
     LinkManager(QGCApplication* app, QGCToolbox* toolbox);
     ~LinkManager();
@@ -101,11 +104,11 @@ public:
     // This should only be used by Qml code
     Q_INVOKABLE void createConnectedLink(LinkConfiguration* config);
 
-    /// Returns pointer to the mavlink forwarding link, or nullptr if it does not exist
-    SharedLinkInterfacePtr mavlinkForwardingLink();
-
     void disconnectAll(void);
 
+    /// Enables or disables TelemetryTracer and the link timing it needs on all current and future links
+    void setTelemetryTracingEnabled(bool enabled);
+
 #ifdef QT_DEBUG
     // Only used by unit test tp restart after a shutdown
     void restart(void) { setConnectionsAllowed(); }
@@ -148,7 +151,7 @@ private:
     void                _removeConfiguration        (LinkConfiguration* config);
     void                _addUDPAutoConnectLink      (void);
     void                _addZeroConfAutoConnectLink (void);
-    void                _addMAVLinkForwardingLink   (void);
+    void                _addMAVLinkForwardingLinks  (void);
     bool                _isSerialPortConnected      (void);
 
 #ifndef NO_SERIAL_LINK
@@ -173,6 +176,8 @@ private:
     QMap<QString, int>                  _autoconnectPortWaitList;               ///< key: QGCSerialPortInfo::systemLocation, value: wait count
     QStringList                         _commPortList;
     QStringList                         _commPortDisplayList;
+    QString                             _mavlinkForwardingErrorSpecs;           ///< Forwarding targets which failed to parse, so the error is only reported once
+    QList<MAVLinkForwardingTarget>      _mavlinkForwardingTargets;              ///< Targets last passed to the forwarder
 
 #ifndef NO_SERIAL_LINK
     QList<SerialLink*>                  _activeLinkCheckList;                   ///< List of links we are waiting for a vehicle to show up on
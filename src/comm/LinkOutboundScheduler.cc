@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundScheduler.h"
+#include "QGCMAVLink.h"
+
+#include <QtMath>
+
+// Control inputs are only useful while fresh, bulk transfers recover from drops through their own retry logic
+const int LinkOutboundScheduler::_maxQueuedBytes[PriorityCount] = {
+    2 * 1024,       // PriorityControl
+    8 * 1024,       // PriorityCommand
+    16 * 1024,      // PriorityNormal
+    16 * 1024,      // PriorityBulk
+};
+
+LinkOutboundScheduler::LinkOutboundScheduler(void)
+{
+    _queuedBytes.fill(0);
+    _droppedFrames.fill(0);
+}
+
+LinkOutboundScheduler::Priority LinkOutboundScheduler::priorityForMessage(uint32_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+    case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
+        return PriorityControl;
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_COMMAND_ACK:
+    case MAVLINK_MSG_ID_SET_MODE:
+        return PriorityCommand;
+    case MAVLINK_MSG_ID_GPS_RTCM_DATA:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+    case MAVLINK_MSG_ID_MISSION_ACK:
+    case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+    case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+    case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+    case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+        return PriorityBulk;
+    default:
+        return PriorityNormal;
+    }
+}
+
+void LinkOutboundScheduler::setBytesPerSecond(int bytesPerSecond)
+{
+    QMutexLocker locker(&_mutex);
+
+    bytesPerSecond = qMax(0, bytesPerSecond);
+    if (bytesPerSecond != _bytesPerSecond) {
+        _bytesPerSecond     = bytesPerSecond;
+        _tokens             = qMin(_tokens, _burstBytes());
+    }
+}
+
+int LinkOutboundScheduler::bytesPerSecond(void) const
+{
+    QMutexLocker locker(&_mutex);
+    return _bytesPerSecond;
+}
+
+void LinkOutboundScheduler::enqueue(Priority priority, const char* bytes, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    QQueue<QByteArray>& queue = _queues[priority];
+    while (!queue.isEmpty() && _queuedBytes[priority] + length > _maxQueuedBytes[priority]) {
+        _queuedBytes[priority] -= queue.dequeue().size();
+        _droppedFrames[priority]++;
+    }
+    queue.enqueue(QByteArray(bytes, length));
+    _queuedBytes[priority] += length;
+}
+
+QByteArray LinkOutboundScheduler::takeBatch(qint64 nowMSecs, int& waitMSecs)
+{
+    QMutexLocker locker(&_mutex);
+
+    QByteArray batch;
+    waitMSecs = -1;
+
+    _refill(nowMSecs);
+
+    for (int priority=0; priority<PriorityCount; priority++) {
+        QQueue<QByteArray>& queue = _queues[priority];
+        while (!queue.isEmpty()) {
+            const int length = queue.head().size();
+            // A frame larger than the burst size (raw forwarded batches) goes out once a full burst is available
+            const double required = qMin(static_cast<double>(length), _burstBytes());
+            if (!batch.isEmpty() && batch.size() + length > maxBatchBytes) {
+                // Remainder goes out in the next batch
+                waitMSecs = 0;
+                return batch;
+            }
+            if (_bytesPerSecond != 0 && priority != PriorityControl && _tokens < required) {
+                // Lower priority classes wait as well so they can't starve the class ahead of them
+                waitMSecs = qCeil(((required - _tokens) * 1000.0) / _bytesPerSecond);
+                return batch;
+            }
+
+            batch.append(queue.dequeue());
+            _queuedBytes[priority] -= length;
+            if (_bytesPerSecond != 0) {
+                // Control frames may borrow ahead, but only by a single burst
+                _tokens = qMax(_tokens - length, -_burstBytes());
+            }
+        }
+    }
+
+    return batch;
+}
+
+bool LinkOutboundScheduler::isEmpty(void) const
+{
+    QMutexLocker locker(&_mutex);
+
+    for (const QQueue<QByteArray>& queue: _queues) {
+        if (!queue.isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int LinkOutboundScheduler::queuedBytes(Priority priority) const
+{
+    QMutexLocker locker(&_mutex);
+    return _queuedBytes[priority];
+}
+
+quint64 LinkOutboundScheduler::droppedFrames(Priority priority) const
+{
+    QMutexLocker locker(&_mutex);
+    return _droppedFrames[priority];
+}
+
+void LinkOutboundScheduler::_refill(qint64 nowMSecs)
+{
+    if (_lastRefillMSecs < 0) {
+        _tokens = _burstBytes();
+    } else if (nowMSecs > _lastRefillMSecs) {
+        _tokens = qMin(_tokens + (((nowMSecs - _lastRefillMSecs) * _bytesPerSecond) / 1000.0), _burstBytes());
+    }
+    _lastRefillMSecs = qMax(_lastRefillMSecs, nowMSecs);
+}
+
+double LinkOutboundScheduler::_burstBytes(void) const
+{
+    // Always allow at least one full size frame, otherwise a very low budget could never send it
+    return qMax((_bytesPerSecond * burstMSecs) / 1000.0, static_cast<double>(MAVLINK_MAX_PACKET_LEN));
+}
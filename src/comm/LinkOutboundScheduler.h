@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QQueue>
+
+#include <array>
+
+/// Outbound queue for a single link. Frames are queued by priority class and handed to the link in batches which respect
+/// a byte budget matching the capacity of the link (for example a 57600 baud telemetry radio).
+///
+/// Batches are always filled from the highest priority class first, so control inputs never wait behind bulk traffic
+/// such as RTCM corrections, parameter or mission transfers. Control frames are also never held back by the budget, they
+/// borrow from the next refill instead. Queueing is thread safe, batches are taken from the link thread.
+///
+/// Frames are queued already packed, so they carry the channel sequence number assigned at pack time. Reordering between
+/// priority classes and dropping frames from a full queue both show up as gaps in that sequence on the vehicle side, so
+/// the vehicle reports packet loss for this link even when the radio delivered everything it was given. Re-sequencing at
+/// dequeue would mean re-packing every frame (CRC and signature), so the gaps are accepted instead.
+class LinkOutboundScheduler
+{
+public:
+    enum Priority {
+        PriorityControl,    ///< Manual control and offboard setpoints
+        PriorityCommand,    ///< Commands, mode changes and the GCS heartbeat
+        PriorityNormal,
+        PriorityBulk,       ///< RTCM, parameter, mission, log and ftp transfers
+        PriorityCount
+    };
+
+    LinkOutboundScheduler(void);
+
+    /// @return Priority class for an outgoing MAVLink message id
+    static Priority priorityForMessage(uint32_t msgid);
+
+    /// @param bytesPerSecond 0: Unlimited
+    void    setBytesPerSecond   (int bytesPerSecond);
+    int     bytesPerSecond      (void) const;
+
+    /// Queues a frame. If the queue for the priority class is full the oldest frames in it are dropped.
+    void enqueue(Priority priority, const char* bytes, int length);
+
+    /// Takes the next batch of frames allowed by the byte budget. A batch holds at most maxBatchBytes unless a single
+    /// frame is larger than that.
+    ///     @param waitMSecs Set to the time until the budget allows the next queued frame, -1 if nothing is queued
+    ///     @return Empty if nothing can be sent right now
+    QByteArray takeBatch(qint64 nowMSecs, int& waitMSecs);
+
+    bool    isEmpty         (void) const;
+    int     queuedBytes     (Priority priority) const;
+    quint64 droppedFrames   (Priority priority) const;
+
+    static const int maxBatchBytes  = 1400;     ///< Keeps batches within a single UDP datagram
+    static const int burstMSecs     = 100;      ///< Budget which can be saved up while the link is idle
+
+private:
+    void    _refill     (qint64 nowMSecs);
+    double  _burstBytes (void) const;
+
+    mutable QMutex                                  _mutex;
+    std::array<QQueue<QByteArray>, PriorityCount>   _queues;
+    std::array<int, PriorityCount>                  _queuedBytes;
+    std::array<quint64, PriorityCount>              _droppedFrames;
+    int                                             _bytesPerSecond     = 0;
+    double                                          _tokens             = 0;    ///< Bytes which can be sent now, negative after control frames borrowed ahead
+    qint64                                          _lastRefillMSecs    = -1;
+
+    static const int _maxQueuedBytes[PriorityCount];
+};
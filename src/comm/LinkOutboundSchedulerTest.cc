@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundSchedulerTest.h"
+#include "LinkOutboundScheduler.h"
+#include "QGCMAVLink.h"
+
+LinkOutboundSchedulerTest::LinkOutboundSchedulerTest(void)
+{
+
+}
+
+void LinkOutboundSchedulerTest::_priorityForMessageTest(void)
+{
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_MANUAL_CONTROL),      LinkOutboundScheduler::PriorityControl);
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_COMMAND_LONG),        LinkOutboundScheduler::PriorityCommand);
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_SYSTEM_TIME),         LinkOutboundScheduler::PriorityNormal);
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_GPS_RTCM_DATA),       LinkOutboundScheduler::PriorityBulk);
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_PARAM_REQUEST_READ),  LinkOutboundScheduler::PriorityBulk);
+    QCOMPARE(LinkOutboundScheduler::priorityForMessage(MAVLINK_MSG_ID_MISSION_ITEM_INT),    LinkOutboundScheduler::PriorityBulk);
+}
+
+void LinkOutboundSchedulerTest::_priorityOrderTest(void)
+{
+    LinkOutboundScheduler   scheduler;
+    int                     waitMSecs;
+
+    QVERIFY(scheduler.isEmpty());
+    QVERIFY(scheduler.takeBatch(0, waitMSecs).isEmpty());
+    QCOMPARE(waitMSecs, -1);
+
+    scheduler.enqueue(LinkOutboundScheduler::PriorityBulk,      "b1", 2);
+    scheduler.enqueue(LinkOutboundScheduler::PriorityNormal,    "n1", 2);
+    scheduler.enqueue(LinkOutboundScheduler::PriorityBulk,      "b2", 2);
+    scheduler.enqueue(LinkOutboundScheduler::PriorityCommand,   "c1", 2);
+    scheduler.enqueue(LinkOutboundScheduler::PriorityControl,   "x1", 2);
+    QCOMPARE(scheduler.queuedBytes(LinkOutboundScheduler::PriorityBulk), 4);
+
+    // Everything fits in a single write, highest priority first and in order within a class
+    QCOMPARE(scheduler.takeBatch(0, waitMSecs), QByteArray("x1c1n1b1b2"));
+    QCOMPARE(waitMSecs, -1);
+    QVERIFY(scheduler.isEmpty());
+    QCOMPARE(scheduler.queuedBytes(LinkOutboundScheduler::PriorityBulk), 0);
+}
+
+void LinkOutboundSchedulerTest::_batchSizeTest(void)
+{
+    LinkOutboundScheduler   scheduler;
+    int                     waitMSecs;
+    const QByteArray        frame(MAVLINK_MAX_PACKET_LEN, 'x');
+    const int               framesPerBatch = LinkOutboundScheduler::maxBatchBytes / frame.size();
+    const int               frameCount = framesPerBatch * 3;
+
+    for (int i=0; i<frameCount; i++) {
+        scheduler.enqueue(LinkOutboundScheduler::PriorityNormal, frame.constData(), frame.size());
+    }
+
+    int sentFrames = 0;
+    for (int i=0; i<3; i++) {
+        QByteArray batch = scheduler.takeBatch(0, waitMSecs);
+        QCOMPARE(batch.size(), framesPerBatch * frame.size());
+        sentFrames += framesPerBatch;
+        QCOMPARE(waitMSecs, sentFrames == frameCount ? -1 : 0);
+    }
+    QVERIFY(scheduler.isEmpty());
+
+    // A single write larger than a batch still goes out on its own
+    const QByteArray largeWrite(LinkOutboundScheduler::maxBatchBytes * 2, 'y');
+    scheduler.enqueue(LinkOutboundScheduler::PriorityNormal, largeWrite.constData(), largeWrite.size());
+    QCOMPARE(scheduler.takeBatch(0, waitMSecs), largeWrite);
+}
+
+void LinkOutboundSchedulerTest::_budgetTest(void)
+{
+    LinkOutboundScheduler   scheduler;
+    int                     waitMSecs;
+    const int               bytesPerSecond  = 57600 / 10;
+    const int               burstBytes      = (bytesPerSecond * LinkOutboundScheduler::burstMSecs) / 1000;
+    const QByteArray        frame(100, 'b');
+
+    scheduler.setBytesPerSecond(bytesPerSecond);
+    QCOMPARE(scheduler.bytesPerSecond(), bytesPerSecond);
+
+    for (int i=0; i<20; i++) {
+        scheduler.enqueue(LinkOutboundScheduler::PriorityBulk, frame.constData(), frame.size());
+    }
+
+    // Only a single burst goes out at once
+    qint64 nowMSecs = 0;
+    QByteArray batch = scheduler.takeBatch(nowMSecs, waitMSecs);
+    QCOMPARE(batch.size(), (burstBytes / frame.size()) * frame.size());
+    QVERIFY(waitMSecs > 0);
+    QVERIFY(scheduler.takeBatch(nowMSecs, waitMSecs).isEmpty());
+
+    // Waiting the reported time allows the next frame
+    nowMSecs += waitMSecs;
+    QCOMPARE(scheduler.takeBatch(nowMSecs, waitMSecs).size(), frame.size());
+    QVERIFY(waitMSecs > 0);
+
+    // Control frames are not held back by the budget
+    scheduler.enqueue(LinkOutboundScheduler::PriorityControl, "control", 7);
+    QCOMPARE(scheduler.takeBatch(nowMSecs, waitMSecs), QByteArray("control"));
+    QVERIFY(waitMSecs > 0);
+
+    // Removing the budget sends the rest
+    scheduler.setBytesPerSecond(0);
+    while (!scheduler.takeBatch(0, waitMSecs).isEmpty()) { }
+    QVERIFY(scheduler.isEmpty());
+}
+
+// Control inputs on a 57600 baud radio with more RTCM queued than the radio can carry
+void LinkOutboundSchedulerTest::_controlBehindBulkTest(void)
+{
+    LinkOutboundScheduler   scheduler;
+    int                     waitMSecs;
+    const int               bytesPerSecond  = 57600 / 10;
+    const int               burstBytes      = (bytesPerSecond * LinkOutboundScheduler::burstMSecs) / 1000;
+    const int               durationMSecs   = 10000;
+    const int               controlLength   = 21;
+    const QByteArray        rtcmFrame(180, 'r');
+    const QByteArray        controlFrame(controlLength, 'c');
+
+    scheduler.setBytesPerSecond(bytesPerSecond);
+
+    int sentBytes = 0;
+    for (int nowMSecs=0; nowMSecs<durationMSecs; nowMSecs+=10) {
+        if (nowMSecs % 20 == 0) {
+            // 9 KB/s of RTCM
+            scheduler.enqueue(LinkOutboundScheduler::PriorityBulk, rtcmFrame.constData(), rtcmFrame.size());
+        }
+        if (nowMSecs % 40 == 0) {
+            // 25 Hz joystick
+            scheduler.enqueue(LinkOutboundScheduler::PriorityControl, controlFrame.constData(), controlFrame.size());
+        }
+
+        QByteArray batch = scheduler.takeBatch(nowMSecs, waitMSecs);
+        sentBytes += batch.size();
+        if (nowMSecs % 40 == 0) {
+            // The control frame queued this tick leads the very next write
+            QVERIFY(batch.startsWith(controlFrame));
+        }
+        QCOMPARE(scheduler.queuedBytes(LinkOutboundScheduler::PriorityControl), 0);
+    }
+
+    // Bulk traffic is held to what is left of the budget and the excess is shed
+    QVERIFY(sentBytes <= ((bytesPerSecond * durationMSecs) / 1000) + (2 * burstBytes));
+    QVERIFY(scheduler.droppedFrames(LinkOutboundScheduler::PriorityBulk) > 0);
+    QCOMPARE(scheduler.droppedFrames(LinkOutboundScheduler::PriorityControl), static_cast<quint64>(0));
+}
+
+void LinkOutboundSchedulerTest::_queueLimitTest(void)
+{
+    LinkOutboundScheduler   scheduler;
+    int                     waitMSecs;
+    const int               frameCount = 200;
+
+    for (int i=0; i<frameCount; i++) {
+        const QByteArray frame = QByteArray::number(i).rightJustified(20, '0');
+        scheduler.enqueue(LinkOutboundScheduler::PriorityControl, frame.constData(), frame.size());
+    }
+
+    // Stale control frames are dropped, the newest is kept
+    const quint64 droppedFrames = scheduler.droppedFrames(LinkOutboundScheduler::PriorityControl);
+    QVERIFY(droppedFrames > 0);
+    QCOMPARE(scheduler.queuedBytes(LinkOutboundScheduler::PriorityControl), static_cast<int>((frameCount - droppedFrames) * 20));
+
+    QByteArray sent;
+    while (!scheduler.isEmpty()) {
+        sent.append(scheduler.takeBatch(0, waitMSecs));
+    }
+    QVERIFY(sent.startsWith(QByteArray::number(static_cast<int>(droppedFrames)).rightJustified(20, '0')));
+    QVERIFY(sent.endsWith(QByteArray::number(frameCount - 1).rightJustified(20, '0')));
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for LinkOutboundScheduler
+class LinkOutboundSchedulerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LinkOutboundSchedulerTest(void);
+
+private slots:
+    void _priorityForMessageTest    (void);
+    void _priorityOrderTest         (void);
+    void _batchSizeTest             (void);
+    void _budgetTest                (void);
+    void _controlBehindBulkTest     (void);
+    void _queueLimitTest            (void);
+};
@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkForwarder.h"
+#include "QGCLoggingCategory.h"
+
+#include <QStringList>
+#include <QRegExp>
+
+#include <algorithm>
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(MAVLinkForwarderLog, "MAVLinkForwarderLog")
+
+//-----------------------------------------------------------------------------
+// MAVLinkForwardingTarget
+
+bool MAVLinkForwardingTarget::_parseIdList(const QString& value, quint32 maxId, QVector<quint32>& ids)
+{
+    ids.clear();
+    for (const QString& idString: value.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        bool    ok;
+        quint32 id = idString.trimmed().toUInt(&ok);
+        if (!ok || id > maxId) {
+            return false;
+        }
+        ids.append(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return !ids.isEmpty();
+}
+
+bool MAVLinkForwardingTarget::parse(const QString& spec, MAVLinkForwardingTarget& target, QString& errorString)
+{
+    const quint32 maxMsgId = 0xFFFFFF;
+    const quint32 maxSysId = 255;
+
+    target = MAVLinkForwardingTarget();
+
+    QStringList rgTokens = spec.split(QRegExp(QStringLiteral("\\s+")), Qt::SkipEmptyParts);
+    if (rgTokens.isEmpty()) {
+        errorString = QObject::tr("Forwarding target is empty");
+        return false;
+    }
+
+    target._hostName = rgTokens.takeFirst();
+    if (target._hostName.contains(QLatin1Char('='))) {
+        errorString = QObject::tr("Forwarding target '%1' must start with host:port").arg(spec);
+        return false;
+    }
+
+    for (const QString& token: rgTokens) {
+        const int       separatorIndex  = token.indexOf(QLatin1Char('='));
+        const QString   key             = token.left(separatorIndex);
+        const QString   value           = token.mid(separatorIndex + 1);
+        QVector<quint32> rgIds;
+
+        if (separatorIndex < 1) {
+            errorString = QObject::tr("Forwarding target option '%1' must be of the form name=value").arg(token);
+            return false;
+        }
+
+        if (key == QStringLiteral("allowMsgIds")) {
+            if (!_parseIdList(value, maxMsgId, target._allowMsgIds)) {
+                errorString = QObject::tr("Invalid message id list '%1'").arg(value);
+                return false;
+            }
+        } else if (key == QStringLiteral("denyMsgIds")) {
+            if (!_parseIdList(value, maxMsgId, target._denyMsgIds)) {
+                errorString = QObject::tr("Invalid message id list '%1'").arg(value);
+                return false;
+            }
+        } else if (key == QStringLiteral("allowSysIds") || key == QStringLiteral("denySysIds")) {
+            if (!_parseIdList(value, maxSysId, rgIds)) {
+                errorString = QObject::tr("Invalid system id list '%1'").arg(value);
+                return false;
+            }
+            const bool allow = key == QStringLiteral("allowSysIds");
+            for (quint32 sysid: rgIds) {
+                if (allow) {
+                    target._allowSysIds.set(sysid);
+                } else {
+                    target._denySysIds.set(sysid);
+                }
+            }
+            if (allow) {
+                target._allowAllSysIds = false;
+            }
+        } else if (key == QStringLiteral("maxRateHz")) {
+            bool ok;
+            target._maxRateHz = value.toDouble(&ok);
+            if (!ok || target._maxRateHz < 0) {
+                errorString = QObject::tr("Invalid rate '%1'").arg(value);
+                return false;
+            }
+        } else {
+            errorString = QObject::tr("Unknown forwarding target option '%1'").arg(key);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MAVLinkForwardingTarget::parseList(const QString& specs, QList<MAVLinkForwardingTarget>& targets, QString& errorString)
+{
+    targets.clear();
+    for (const QString& spec: specs.split(QLatin1Char(';'), Qt::SkipEmptyParts)) {
+        if (spec.trimmed().isEmpty()) {
+            continue;
+        }
+        MAVLinkForwardingTarget target;
+        if (!parse(spec, target, errorString)) {
+            targets.clear();
+            return false;
+        }
+        targets.append(target);
+    }
+    return true;
+}
+
+bool MAVLinkForwardingTarget::operator==(const MAVLinkForwardingTarget& other) const
+{
+    return _hostName == other._hostName &&
+            _allowMsgIds == other._allowMsgIds &&
+            _denyMsgIds == other._denyMsgIds &&
+            _allowSysIds == other._allowSysIds &&
+            _denySysIds == other._denySysIds &&
+            _allowAllSysIds == other._allowAllSysIds &&
+            qFuzzyCompare(1 + _maxRateHz, 1 + other._maxRateHz) &&
+            _link.lock() == other._link.lock();
+}
+
+bool MAVLinkForwardingTarget::accepts(uint8_t sysid, uint32_t msgid) const
+{
+    if ((!_allowAllSysIds && !_allowSysIds.test(sysid)) || _denySysIds.test(sysid)) {
+        return false;
+    }
+    if (!_allowMsgIds.isEmpty() && !std::binary_search(_allowMsgIds.constBegin(), _allowMsgIds.constEnd(), msgid)) {
+        return false;
+    }
+    if (!_denyMsgIds.isEmpty() && std::binary_search(_denyMsgIds.constBegin(), _denyMsgIds.constEnd(), msgid)) {
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// MAVLinkForwarder
+
+MAVLinkForwarder::MAVLinkForwarder(void)
+    : _queue(new QueuedFrame_t[queueFrameCount])
+{
+    _clock.start();
+    moveToThread(this);
+    start();
+}
+
+MAVLinkForwarder::~MAVLinkForwarder()
+{
+    quit();
+    wait();
+}
+
+void MAVLinkForwarder::run(void)
+{
+    exec();
+}
+
+int MAVLinkForwarder::frameLength(const mavlink_message_t& message)
+{
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + message.len + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+    const int signatureLength = (message.incompat_flags & MAVLINK_IFLAG_SIGNED) ? MAVLINK_SIGNATURE_BLOCK_LEN : 0;
+    return MAVLINK_NUM_HEADER_BYTES + message.len + MAVLINK_NUM_CHECKSUM_BYTES + signatureLength;
+}
+
+void MAVLinkForwarder::setEnabled(bool enabled)
+{
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void MAVLinkForwarder::setTargets(const QList<MAVLinkForwardingTarget>& targets)
+{
+    QMutexLocker locker(&_targetsMutex);
+
+    _targets.clear();
+    for (const MAVLinkForwardingTarget& target: targets) {
+        TargetState_t state;
+        state.target        = target;
+        state.statistics    = { target.hostName(), 0, 0, 0, 0 };
+        state.batch.reserve(maxBatchBytes + MAVLINK_MAX_PACKET_LEN);
+        _targets.append(state);
+    }
+
+    qCDebug(MAVLinkForwarderLog) << "setTargets" << targets.count();
+}
+
+QList<MAVLinkForwarder::TargetStatistics_t> MAVLinkForwarder::targetStatistics(void)
+{
+    QMutexLocker locker(&_targetsMutex);
+
+    QList<TargetStatistics_t> rgStatistics;
+    for (const TargetState_t& state: _targets) {
+        rgStatistics.append(state.statistics);
+    }
+    return rgStatistics;
+}
+
+void MAVLinkForwarder::queueMessage(LinkInterface* sourceLink, const mavlink_message_t& message, const QByteArray& bytes, int frameEndIndex)
+{
+    const int head = _queueHead.load(std::memory_order_relaxed);
+    const int next = (head + 1) % queueFrameCount;
+    if (next == _queueTail.load(std::memory_order_acquire)) {
+        // Forwarding must never hold up the receive path
+        _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    QueuedFrame_t& frame    = _queue[head];
+    frame.sourceLink        = sourceLink;
+    frame.msgid             = message.msgid;
+    frame.sysid             = message.sysid;
+    frame.compid            = message.compid;
+
+    // The frame is normally contained in the received bytes and is copied as is. If it started in a previous chunk
+    // the parser has already reassembled it, in which case it is copied out of the message (still no re-encoding).
+    const int length        = frameLength(message);
+    const int frameStart    = frameEndIndex + 1 - length;
+    if (frameStart >= 0 && static_cast<uint8_t>(bytes[frameStart]) == message.magic) {
+        memcpy(frame.frame, bytes.constData() + frameStart, static_cast<size_t>(length));
+        frame.length = static_cast<uint16_t>(length);
+    } else {
+        frame.length = mavlink_msg_to_send_buffer(frame.frame, &message);
+    }
+
+    _queueHead.store(next, std::memory_order_release);
+}
+
+void MAVLinkForwarder::flush(void)
+{
+    if (_queueHead.load(std::memory_order_relaxed) != _queueTail.load(std::memory_order_relaxed) && !_processPending.exchange(true)) {
+        QMetaObject::invokeMethod(this, &MAVLinkForwarder::_processQueue, Qt::QueuedConnection);
+    }
+}
+
+void MAVLinkForwarder::_processQueue(void)
+{
+    // Cleared before draining so frames queued while draining schedule another pass
+    _processPending.store(false);
+
+    QMutexLocker locker(&_targetsMutex);
+
+    for (TargetState_t& state: _targets) {
+        state.activeLink = state.target.link().lock();
+    }
+
+    const qint64    nowNsecs    = _clock.nsecsElapsed();
+    const int       head        = _queueHead.load(std::memory_order_acquire);
+    int             tail        = _queueTail.load(std::memory_order_relaxed);
+    while (tail != head) {
+        const QueuedFrame_t& frame = _queue[tail];
+        for (TargetState_t& state: _targets) {
+            _forwardFrame(state, frame, nowNsecs);
+        }
+        tail = (tail + 1) % queueFrameCount;
+        _queueTail.store(tail, std::memory_order_release);
+    }
+
+    for (TargetState_t& state: _targets) {
+        _writeBatch(state);
+        state.activeLink.reset();
+    }
+}
+
+void MAVLinkForwarder::_forwardFrame(TargetState_t& state, const QueuedFrame_t& frame, qint64 nowNsecs)
+{
+    if (!state.activeLink || state.activeLink.get() == frame.sourceLink) {
+        return;
+    }
+
+    if (!state.target.accepts(frame.sysid, frame.msgid)) {
+        state.statistics.filteredFrames++;
+        return;
+    }
+
+    if (state.target.maxRateHz() > 0) {
+        const qint64    intervalNsecs   = static_cast<qint64>(1e9 / state.target.maxRateHz());
+        const quint64   streamKey       = (static_cast<quint64>(frame.sysid) << 32) | (static_cast<quint64>(frame.compid) << 24) | frame.msgid;
+        auto            it              = state.nextAllowedNsecs.find(streamKey);
+
+        if (it == state.nextAllowedNsecs.end()) {
+            state.nextAllowedNsecs.insert(streamKey, nowNsecs + intervalNsecs);
+        } else if (nowNsecs < it.value()) {
+            state.statistics.rateLimitedFrames++;
+            return;
+        } else {
+            // Stay on schedule if only slightly late so a stream arriving at exactly the limit is not thinned out by jitter
+            it.value() = nowNsecs - it.value() < intervalNsecs ? it.value() + intervalNsecs : nowNsecs + intervalNsecs;
+        }
+    }
+
+    if (state.batch.size() + frame.length > maxBatchBytes) {
+        _writeBatch(state);
+    }
+    state.batch.append(reinterpret_cast<const char*>(frame.frame), frame.length);
+
+    state.statistics.forwardedFrames++;
+    state.statistics.forwardedBytes += frame.length;
+}
+
+void MAVLinkForwarder::_writeBatch(TargetState_t& state)
+{
+    if (state.batch.isEmpty()) {
+        return;
+    }
+    if (state.activeLink) {
+        state.activeLink->writeBytesThreadSafe(state.batch.constData(), state.batch.size());
+    }
+    // Capacity is reserved, so this keeps the allocation for the next batch
+    state.batch.resize(0);
+}
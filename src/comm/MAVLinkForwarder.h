@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LinkInterface.h"
+#include "QGCMAVLink.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include <atomic>
+#include <bitset>
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkForwarderLog)
+
+/// A downstream forwarding target along with the filters and rate limit applied to it.
+///
+/// Targets are specified as a single line:
+///     host:port [allowMsgIds=0,30,33] [denyMsgIds=253] [allowSysIds=1,2] [denySysIds=3] [maxRateHz=5]
+/// Allow lists restrict forwarding to the listed ids, deny lists exclude the listed ids. maxRateHz limits each
+/// sysid/compid/msgid stream independently, 0 is unlimited.
+class MAVLinkForwardingTarget
+{
+public:
+    /// @return false: Specification is invalid, errorString describes the problem
+    static bool parse(const QString& spec, MAVLinkForwardingTarget& target, QString& errorString);
+
+    /// Parses a ';' separated list of target specifications
+    static bool parseList(const QString& specs, QList<MAVLinkForwardingTarget>& targets, QString& errorString);
+
+    /// @return true: Message passes the sysid and msgid filters
+    bool accepts(uint8_t sysid, uint32_t msgid) const;
+
+    /// @return true: Same host, filters, rate limit and link
+    bool operator==(const MAVLinkForwardingTarget& other) const;
+
+    const QString&          hostName    (void) const { return _hostName; }
+    double                  maxRateHz   (void) const { return _maxRateHz; }
+    WeakLinkInterfacePtr    link        (void) const { return _link; }
+    void                    setLink     (WeakLinkInterfacePtr link) { _link = link; }
+
+private:
+    static bool _parseIdList(const QString& value, quint32 maxId, QVector<quint32>& ids);
+
+    QString                 _hostName;                  ///< host:port
+    QVector<quint32>        _allowMsgIds;               ///< Sorted, empty allows all
+    QVector<quint32>        _denyMsgIds;                ///< Sorted
+    std::bitset<256>        _allowSysIds;
+    std::bitset<256>        _denySysIds;
+    bool                    _allowAllSysIds = true;
+    double                  _maxRateHz      = 0;
+    WeakLinkInterfacePtr    _link;
+};
+
+/// Forwards received MAVLink frames to one or more downstream targets from its own thread.
+///
+/// MAVLinkProtocol queues each received frame exactly as it arrived on the wire (no re-encoding) into a preallocated
+/// single producer/single consumer queue and wakes the forwarding thread once per received chunk. The forwarding thread
+/// applies the per target filters and rate limits and batches the frames for each target into datagram sized writes.
+/// Frames are never forwarded back to the link they arrived on.
+class MAVLinkForwarder : public QThread
+{
+    Q_OBJECT
+
+public:
+    MAVLinkForwarder(void);
+    ~MAVLinkForwarder();
+
+    typedef struct {
+        QString hostName;
+        quint64 forwardedFrames;
+        quint64 forwardedBytes;
+        quint64 filteredFrames;     ///< Frames rejected by the sysid/msgid filters
+        quint64 rateLimitedFrames;  ///< Frames dropped by the rate limit
+    } TargetStatistics_t;
+
+    bool enabled    (void) const { return _enabled.load(std::memory_order_relaxed); }
+    void setEnabled (bool enabled);
+
+    /// Replaces all targets and resets their statistics. Thread safe.
+    void setTargets(const QList<MAVLinkForwardingTarget>& targets);
+
+    /// Queues a received message for forwarding. Must only be called from a single thread (MAVLinkProtocol::receiveBytes).
+    ///     @param sourceLink       Link the message arrived on
+    ///     @param bytes            Received bytes which contain the end of the frame
+    ///     @param frameEndIndex    Index of the last byte of the frame within bytes
+    void queueMessage(LinkInterface* sourceLink, const mavlink_message_t& message, const QByteArray& bytes, int frameEndIndex);
+
+    /// Wakes the forwarding thread to process everything queued so far
+    void flush(void);
+
+    QList<TargetStatistics_t>   targetStatistics(void);
+    quint64                     droppedFrames   (void) const { return _droppedFrames.load(std::memory_order_relaxed); } ///< Frames dropped due to a full queue
+
+    /// @return Length of the frame on the wire for a parsed message, including signature
+    static int frameLength(const mavlink_message_t& message);
+
+    static const int queueFrameCount    = 1024;
+    static const int maxBatchBytes      = 1400;     ///< Keeps batched UDP datagrams within a typical MTU
+
+protected:
+    void run(void) final;
+
+private slots:
+    void _processQueue(void);
+
+private:
+    typedef struct {
+        LinkInterface*  sourceLink;
+        uint32_t        msgid;
+        uint8_t         sysid;
+        uint8_t         compid;
+        uint16_t        length;
+        uint8_t         frame[MAVLINK_MAX_PACKET_LEN];
+    } QueuedFrame_t;
+
+    typedef struct {
+        MAVLinkForwardingTarget     target;
+        SharedLinkInterfacePtr      activeLink;         ///< Only valid while processing the queue
+        QByteArray                  batch;
+        QHash<quint64, qint64>      nextAllowedNsecs;   ///< Rate limit schedule per sysid/compid/msgid stream
+        TargetStatistics_t          statistics;
+    } TargetState_t;
+
+    void _forwardFrame  (TargetState_t& state, const QueuedFrame_t& frame, qint64 nowNsecs);
+    void _writeBatch    (TargetState_t& state);
+
+    std::atomic<bool>                   _enabled        { false };
+    std::atomic<bool>                   _processPending { false };
+    std::atomic<int>                    _queueHead      { 0 };      ///< Next slot written by the producer
+    std::atomic<int>                    _queueTail      { 0 };      ///< Next slot read by the forwarding thread
+    std::atomic<quint64>                _droppedFrames  { 0 };
+    std::unique_ptr<QueuedFrame_t[]>    _queue;
+
+    QMutex                  _targetsMutex;
+    QVector<TargetState_t>  _targets;
+    QElapsedTimer           _clock;
+};
@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkForwarderTest.h"
+#include "MAVLinkForwarder.h"
+#include "LinkManager.h"
+#include "MockLink.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+
+MAVLinkForwarderTest::MAVLinkForwarderTest(void)
+{
+
+}
+
+QByteArray MAVLinkForwarderTest::_frameBytes(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int     length = mavlink_msg_to_send_buffer(buffer, &message);
+    return QByteArray(reinterpret_cast<const char*>(buffer), length);
+}
+
+void MAVLinkForwarderTest::_parseTest(void)
+{
+    QList<MAVLinkForwardingTarget>  rgTargets;
+    QString                         errorString;
+
+    // Plain host name as used before filters were supported
+    QVERIFY(MAVLinkForwardingTarget::parseList(QStringLiteral("localhost:14445"), rgTargets, errorString));
+    QCOMPARE(rgTargets.count(), 1);
+    QCOMPARE(rgTargets[0].hostName(), QStringLiteral("localhost:14445"));
+    QCOMPARE(rgTargets[0].maxRateHz(), 0.0);
+
+    QVERIFY(MAVLinkForwardingTarget::parseList(QStringLiteral("localhost:14445 allowMsgIds=0,33 maxRateHz=5; 10.0.0.2:14550  denySysIds=2 ;"), rgTargets, errorString));
+    QCOMPARE(rgTargets.count(), 2);
+    QCOMPARE(rgTargets[0].maxRateHz(), 5.0);
+    QCOMPARE(rgTargets[1].hostName(), QStringLiteral("10.0.0.2:14550"));
+
+    const char* rgInvalidSpecs[] = {
+        "localhost:14445 allowMsgIds=",
+        "localhost:14445 allowMsgIds=abc",
+        "localhost:14445 allowSysIds=256",
+        "localhost:14445 maxRateHz=-1",
+        "localhost:14445 unknown=1",
+        "localhost:14445 allowMsgIds",
+        "allowMsgIds=0",
+    };
+    for (const char* invalidSpec: rgInvalidSpecs) {
+        QVERIFY2(!MAVLinkForwardingTarget::parseList(QString(invalidSpec), rgTargets, errorString), invalidSpec);
+        QVERIFY(!errorString.isEmpty());
+        QCOMPARE(rgTargets.count(), 0);
+    }
+}
+
+void MAVLinkForwarderTest::_filterTest(void)
+{
+    MAVLinkForwardingTarget target;
+    QString                 errorString;
+
+    QVERIFY(MAVLinkForwardingTarget::parse(QStringLiteral("localhost:14445"), target, errorString));
+    QVERIFY(target.accepts(1, MAVLINK_MSG_ID_HEARTBEAT));
+    QVERIFY(target.accepts(255, MAVLINK_MSG_ID_ATTITUDE));
+
+    QVERIFY(MAVLinkForwardingTarget::parse(QStringLiteral("localhost:14445 allowMsgIds=30,0,33 denyMsgIds=33 allowSysIds=1,2 denySysIds=2"), target, errorString));
+    QVERIFY(target.accepts(1, MAVLINK_MSG_ID_HEARTBEAT));
+    QVERIFY(target.accepts(1, MAVLINK_MSG_ID_ATTITUDE));
+    QVERIFY(!target.accepts(1, MAVLINK_MSG_ID_GLOBAL_POSITION_INT));   // Denied msgid wins over allowed
+    QVERIFY(!target.accepts(1, MAVLINK_MSG_ID_VFR_HUD));               // Not in allow list
+    QVERIFY(!target.accepts(2, MAVLINK_MSG_ID_HEARTBEAT));             // Denied sysid wins over allowed
+    QVERIFY(!target.accepts(3, MAVLINK_MSG_ID_HEARTBEAT));             // Not in allow list
+}
+
+void MAVLinkForwarderTest::_frameLengthTest(void)
+{
+    mavlink_message_t message;
+
+    mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    QCOMPARE(MAVLinkForwarder::frameLength(message), _frameBytes(message).size());
+
+    mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 1000, 0.1f, 0.2f, 0.3f, 0, 0, 0);
+    QCOMPARE(MAVLinkForwarder::frameLength(message), _frameBytes(message).size());
+}
+
+void MAVLinkForwarderTest::_forwardTest(void)
+{
+    MockLink* mockLink = MockLink::startNoInitialConnectMockLink(false);
+    QVERIFY(mockLink);
+    SharedLinkInterfacePtr targetLink = _linkManager->sharedLinkInterfacePointerForLink(mockLink);
+    QVERIFY(targetLink);
+
+    QList<MAVLinkForwardingTarget>  rgTargets;
+    QString                         errorString;
+    QVERIFY(MAVLinkForwardingTarget::parseList(QStringLiteral("a:1 allowSysIds=1; b:2 denyMsgIds=0 maxRateHz=1"), rgTargets, errorString));
+    for (MAVLinkForwardingTarget& target: rgTargets) {
+        target.setLink(targetLink);
+    }
+
+    MAVLinkForwarder forwarder;
+    forwarder.setEnabled(true);
+    forwarder.setTargets(rgTargets);
+
+    const int           attitudeCount = 5;
+    mavlink_message_t   message;
+
+    // The same chunk holds several frames, so frames are located by their end index
+    QByteArray bytes;
+    QList<QPair<mavlink_message_t, int>> rgQueued;
+    for (int i=0; i<attitudeCount; i++) {
+        mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, static_cast<uint32_t>(i), 0, 0, 0, 0, 0, 0);
+        bytes.append(_frameBytes(message));
+        rgQueued.append(qMakePair(message, bytes.size() - 1));
+    }
+    mavlink_msg_heartbeat_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    bytes.append(_frameBytes(message));
+    rgQueued.append(qMakePair(message, bytes.size() - 1));
+
+    const int attitudeFrameLength = MAVLinkForwarder::frameLength(rgQueued[0].first);
+    for (const auto& queued: rgQueued) {
+        forwarder.queueMessage(nullptr, queued.first, bytes, queued.second);
+    }
+
+    // Frames which arrived on a target link are never sent back to it
+    forwarder.queueMessage(mockLink, rgQueued[0].first, bytes, rgQueued[0].second);
+
+    forwarder.flush();
+
+    QVERIFY(QTest::qWaitFor([&]() {
+        QList<MAVLinkForwarder::TargetStatistics_t> rgStatistics = forwarder.targetStatistics();
+        return rgStatistics[0].forwardedFrames + rgStatistics[0].filteredFrames == attitudeCount + 1 &&
+                rgStatistics[1].forwardedFrames + rgStatistics[1].filteredFrames + rgStatistics[1].rateLimitedFrames == attitudeCount + 1;
+    }, 5000));
+    QTest::qWait(100);
+
+    QList<MAVLinkForwarder::TargetStatistics_t> rgStatistics = forwarder.targetStatistics();
+
+    QCOMPARE(rgStatistics[0].hostName,          QStringLiteral("a:1"));
+    QCOMPARE(rgStatistics[0].forwardedFrames,   static_cast<quint64>(attitudeCount));
+    QCOMPARE(rgStatistics[0].forwardedBytes,    static_cast<quint64>(attitudeCount * attitudeFrameLength));
+    QCOMPARE(rgStatistics[0].filteredFrames,    static_cast<quint64>(1));
+    QCOMPARE(rgStatistics[0].rateLimitedFrames, static_cast<quint64>(0));
+
+    QCOMPARE(rgStatistics[1].forwardedFrames,   static_cast<quint64>(1));
+    QCOMPARE(rgStatistics[1].filteredFrames,    static_cast<quint64>(1));
+    QCOMPARE(rgStatistics[1].rateLimitedFrames, static_cast<quint64>(attitudeCount - 1));
+
+    QCOMPARE(forwarder.droppedFrames(), static_cast<quint64>(0));
+
+    targetLink.reset();
+    forwarder.setTargets(QList<MAVLinkForwardingTarget>());
+    mockLink->disconnect();
+}
+
+/// Changing the filters of an existing target or removing a target reuses the existing links, the new targets must
+/// still reach the forwarder
+void MAVLinkForwarderTest::_targetUpdateTest(void)
+{
+    AppSettings*        appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+    MAVLinkForwarder*   forwarder   = qgcApp()->toolbox()->mavlinkProtocol()->forwarder();
+    mavlink_message_t   message;
+
+    mavlink_msg_heartbeat_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    const QByteArray bytes = _frameBytes(message);
+
+    appSettings->forwardMavlinkHostName()->setRawValue(QStringLiteral("127.0.0.1:14445; 127.0.0.1:14446"));
+    appSettings->forwardMavlink()->setRawValue(true);
+    _linkManager->_addMAVLinkForwardingLinks();
+    QCOMPARE(forwarder->targetStatistics().count(), 2);
+
+    forwarder->queueMessage(nullptr, message, bytes, bytes.size() - 1);
+    forwarder->flush();
+    QVERIFY(QTest::qWaitFor([&]() { return forwarder->targetStatistics()[0].forwardedFrames == 1; }, 5000));
+
+    // Unchanged targets are left alone, setTargets would have reset the statistics
+    _linkManager->_addMAVLinkForwardingLinks();
+    QCOMPARE(forwarder->targetStatistics()[0].forwardedFrames, static_cast<quint64>(1));
+
+    // New filter on the existing first target, second target removed
+    appSettings->forwardMavlinkHostName()->setRawValue(QStringLiteral("127.0.0.1:14445 denySysIds=2"));
+    _linkManager->_addMAVLinkForwardingLinks();
+    QList<MAVLinkForwarder::TargetStatistics_t> rgStatistics = forwarder->targetStatistics();
+    QCOMPARE(rgStatistics.count(), 1);
+    QCOMPARE(rgStatistics[0].hostName, QStringLiteral("127.0.0.1:14445"));
+    QCOMPARE(rgStatistics[0].forwardedFrames, static_cast<quint64>(0));
+
+    forwarder->queueMessage(nullptr, message, bytes, bytes.size() - 1);
+    forwarder->flush();
+    QVERIFY(QTest::qWaitFor([&]() { return forwarder->targetStatistics()[0].filteredFrames == 1; }, 5000));
+    QCOMPARE(forwarder->targetStatistics()[0].forwardedFrames, static_cast<quint64>(0));
+
+    // Removing the last target empties the forwarder
+    appSettings->forwardMavlinkHostName()->setRawValue(QString());
+    _linkManager->_addMAVLinkForwardingLinks();
+    QCOMPARE(forwarder->targetStatistics().count(), 0);
+
+    appSettings->forwardMavlink()->setRawValue(false);
+    appSettings->forwardMavlinkHostName()->setRawValue(appSettings->forwardMavlinkHostName()->rawDefaultValue());
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for MAVLinkForwarder and MAVLinkForwardingTarget
+class MAVLinkForwarderTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkForwarderTest(void);
+
+private slots:
+    void _parseTest         (void);
+    void _filterTest        (void);
+    void _frameLengthTest   (void);
+    void _forwardTest       (void);
+    void _targetUpdateTest  (void);
+
+private:
+    static QByteArray _frameBytes(const mavlink_message_t& message);
+};
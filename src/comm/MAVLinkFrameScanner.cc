@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameScanner.h"
+
+#include <QtAlgorithms>
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QGC_FRAME_SCANNER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define QGC_FRAME_SCANNER_NEON
+#endif
+
+/// Lookup table for crc_accumulate: crc = (crc >> 8) ^ _crcTable[(crc ^ byte) & 0xFF]
+const uint16_t MAVLinkFrameScanner::_crcTable[256] = {
+    0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
+    0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
+    0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
+    0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
+    0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
+    0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
+    0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
+    0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
+    0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
+    0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
+    0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
+    0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
+    0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
+    0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
+    0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
+    0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
+    0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
+    0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
+    0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
+    0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
+    0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
+    0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
+    0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
+    0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
+    0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
+    0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
+    0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
+    0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
+    0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
+    0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
+    0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
+    0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78
+};
+
+uint16_t MAVLinkFrameScanner::crcAccumulate(const uint8_t* bytes, int length, uint16_t crc)
+{
+    for (int i=0; i<length; i++) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ _crcTable[(crc ^ bytes[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+int MAVLinkFrameScanner::findStartMarker(const uint8_t* bytes, int position, int length)
+{
+#if defined(QGC_FRAME_SCANNER_SSE2)
+    const __m128i stx       = _mm_set1_epi8(static_cast<char>(MAVLINK_STX));
+    const __m128i stxV1     = _mm_set1_epi8(static_cast<char>(MAVLINK_STX_MAVLINK1));
+    for (; position + 16 <= length; position += 16) {
+        const __m128i   block   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + position));
+        const int       mask    = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, stx), _mm_cmpeq_epi8(block, stxV1)));
+        if (mask) {
+            return position + static_cast<int>(qCountTrailingZeroBits(static_cast<quint32>(mask)));
+        }
+    }
+#elif defined(QGC_FRAME_SCANNER_NEON)
+    const uint8x16_t stx    = vdupq_n_u8(MAVLINK_STX);
+    const uint8x16_t stxV1  = vdupq_n_u8(MAVLINK_STX_MAVLINK1);
+    for (; position + 16 <= length; position += 16) {
+        const uint8x16_t block = vld1q_u8(bytes + position);
+        if (vmaxvq_u8(vorrq_u8(vceqq_u8(block, stx), vceqq_u8(block, stxV1)))) {
+            // Match is within this block, the scalar loop below finds it
+            break;
+        }
+    }
+#endif
+    for (; position < length; position++) {
+        if (bytes[position] == MAVLINK_STX || bytes[position] == MAVLINK_STX_MAVLINK1) {
+            return position;
+        }
+    }
+    return length;
+}
+
+bool MAVLinkFrameScanner::parse(uint8_t channel, const uint8_t* bytes, int length, int& position, mavlink_message_t* message, mavlink_status_t* status)
+{
+    mavlink_status_t*   channelStatus   = mavlink_get_channel_status(channel);
+    mavlink_message_t*  channelMessage  = mavlink_get_channel_buffer(channel);
+
+    while (position < length) {
+        if (channelStatus->parse_state == MAVLINK_PARSE_STATE_UNINIT || channelStatus->parse_state == MAVLINK_PARSE_STATE_IDLE) {
+            const int markerIndex = findStartMarker(bytes, position, length);
+            if (markerIndex != position) {
+                // The reference parser ignores bytes outside of a frame apart from its per byte status reporting
+                channelStatus->msg_received = MAVLINK_FRAMING_INCOMPLETE;
+                if (message) {
+                    message->len = channelMessage->len;
+                }
+                _updateStatus(channelStatus, status);
+                position = markerIndex;
+                if (position == length) {
+                    break;
+                }
+            }
+
+            int frameLength;
+            if (_decodeFrame(channelStatus, channelMessage, bytes + position, length - position, frameLength, message, status)) {
+                position += frameLength - 1;
+                return true;
+            }
+        }
+
+        // Frames split across blocks and anything the fast path does not handle go through the reference state machine
+        if (mavlink_parse_char(channel, bytes[position], message, status)) {
+            return true;
+        }
+        position++;
+    }
+
+    position = length - 1;
+    return false;
+}
+
+bool MAVLinkFrameScanner::_decodeFrame(mavlink_status_t* channelStatus, mavlink_message_t* channelMessage, const uint8_t* frame, int available, int& frameLength, mavlink_message_t* message, mavlink_status_t* status)
+{
+    const bool  mavlink1        = frame[0] == MAVLINK_STX_MAVLINK1;
+    const int   headerLength    = mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 : MAVLINK_NUM_HEADER_BYTES;
+
+    if (available < headerLength || channelStatus->signing) {
+        return false;
+    }
+
+    const uint8_t payloadLength = frame[1];
+    const uint8_t incompatFlags = mavlink1 ? 0 : frame[2];
+    frameLength = headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (incompatFlags != 0 || available < frameLength) {
+        // Signed frames, unknown incompatible flags and frames which continue in the next block
+        return false;
+    }
+
+    const uint32_t              msgid   = mavlink1 ? frame[5] : (frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16));
+    const mavlink_msg_entry_t*  entry   = mavlink_get_msg_entry(msgid);
+    if (!entry) {
+        return false;
+    }
+#ifdef MAVLINK_CHECK_MESSAGE_LENGTH
+    if (payloadLength < entry->min_msg_len || payloadLength > entry->max_msg_len) {
+        return false;
+    }
+#endif
+
+    uint16_t crc = crcAccumulate(frame + 1, headerLength - 1 + payloadLength, X25_INIT_CRC);
+    crc = crcAccumulate(&entry->crc_extra, 1, crc);
+    const uint8_t* checksum = frame + headerLength + payloadLength;
+    if (checksum[0] != (crc & 0xFF) || checksum[1] != (crc >> 8)) {
+        // Let the reference parser account for the error
+        return false;
+    }
+
+    // Leave the channel buffer and status exactly as the reference parser would after the last byte of the frame
+    const int seqIndex = mavlink1 ? 2 : 4;
+    channelMessage->magic           = frame[0];
+    channelMessage->len             = payloadLength;
+    channelMessage->incompat_flags  = incompatFlags;
+    channelMessage->compat_flags    = mavlink1 ? 0 : frame[3];
+    channelMessage->seq             = frame[seqIndex];
+    channelMessage->sysid           = frame[seqIndex + 1];
+    channelMessage->compid          = frame[seqIndex + 2];
+    channelMessage->msgid           = msgid;
+    channelMessage->checksum        = crc;
+    channelMessage->ck[0]           = checksum[0];
+    channelMessage->ck[1]           = checksum[1];
+    uint8_t* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(channelMessage));
+    memcpy(payload, frame + headerLength, payloadLength);
+    if (payloadLength < entry->max_msg_len) {
+        // Zero fill truncated payloads
+        memset(payload + payloadLength, 0, entry->max_msg_len - payloadLength);
+    }
+
+    if (mavlink1) {
+        channelStatus->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    } else {
+        channelStatus->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+    channelStatus->msg_received     = MAVLINK_FRAMING_OK;
+    channelStatus->parse_state      = MAVLINK_PARSE_STATE_IDLE;
+    channelStatus->packet_idx       = payloadLength;
+    channelStatus->current_rx_seq   = channelMessage->seq;
+    if (channelStatus->packet_rx_success_count == 0) {
+        channelStatus->packet_rx_drop_count = 0;
+    }
+    channelStatus->packet_rx_success_count++;
+
+    if (message) {
+        memcpy(message, channelMessage, sizeof(mavlink_message_t));
+    }
+    _updateStatus(channelStatus, status);
+
+    return true;
+}
+
+/// Status reporting done by mavlink_frame_char_buffer after each byte
+void MAVLinkFrameScanner::_updateStatus(mavlink_status_t* channelStatus, mavlink_status_t* status)
+{
+    if (status) {
+        status->parse_state             = channelStatus->parse_state;
+        status->packet_idx              = channelStatus->packet_idx;
+        status->current_rx_seq          = channelStatus->current_rx_seq + 1;
+        status->packet_rx_success_count = channelStatus->packet_rx_success_count;
+        status->packet_rx_drop_count    = channelStatus->parse_error;
+        status->flags                   = channelStatus->flags;
+    }
+    channelStatus->parse_error = 0;
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QByteArray>
+
+/// Block oriented MAVLink frame decoder which produces results identical to calling mavlink_parse_char for each byte.
+///
+/// While the channel parser is idle the received block is scanned for start markers using vector compares. A frame which
+/// is entirely contained in the block, is unsigned, has a known message id and a valid checksum is then validated with a
+/// table driven CRC-16/MCRF4XX and decoded in a single step. Everything else (frames split across blocks, bad checksums,
+/// signed or unknown messages) goes through the reference mavlink_parse_char state machine, which is also what keeps the
+/// channel status and error counters exactly as the reference parser would leave them.
+class MAVLinkFrameScanner
+{
+public:
+    /// Parses bytes starting at position until a message is decoded or all bytes are consumed.
+    ///     @param position     In: index of the first byte to parse. Out: index of the last byte consumed, which is the
+    ///                         last byte of the frame if a message was decoded.
+    ///     @param message      Same semantics as the r_message argument of mavlink_parse_char
+    ///     @param status       Same semantics as the r_mavlink_status argument of mavlink_parse_char
+    ///     @return true: message was decoded
+    static bool parse(uint8_t channel, const uint8_t* bytes, int length, int& position, mavlink_message_t* message, mavlink_status_t* status);
+
+    static bool parse(uint8_t channel, const QByteArray& bytes, int& position, mavlink_message_t* message, mavlink_status_t* status)
+    {
+        return parse(channel, reinterpret_cast<const uint8_t*>(bytes.constData()), bytes.size(), position, message, status);
+    }
+
+    /// @return Index of the first MAVLink v1 or v2 start marker at or after position, length if there is none
+    static int findStartMarker(const uint8_t* bytes, int position, int length);
+
+    /// CRC-16/MCRF4XX as used by MAVLink, bit exact with crc_accumulate
+    static uint16_t crcAccumulate(const uint8_t* bytes, int length, uint16_t crc);
+
+private:
+    static bool _decodeFrame    (mavlink_status_t* channelStatus, mavlink_message_t* channelMessage, const uint8_t* frame, int available, int& frameLength, mavlink_message_t* message, mavlink_status_t* status);
+    static void _updateStatus   (mavlink_status_t* channelStatus, mavlink_status_t* status);
+
+    static const uint16_t _crcTable[256];
+};
@@ -0,0 +1,289 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameScannerTest.h"
+#include "MAVLinkFrameScanner.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+
+#include <string.h>
+
+MAVLinkFrameScannerTest::MAVLinkFrameScannerTest(void)
+{
+
+}
+
+void MAVLinkFrameScannerTest::init(void)
+{
+    UnitTest::init();
+
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    _referenceChannel   = linkManager->allocateMavlinkChannel();
+    _scannerChannel     = linkManager->allocateMavlinkChannel();
+    _encodeChannel      = linkManager->allocateMavlinkChannel();
+    QVERIFY(_referenceChannel != LinkManager::invalidMavlinkChannel());
+    QVERIFY(_scannerChannel != LinkManager::invalidMavlinkChannel());
+    QVERIFY(_encodeChannel != LinkManager::invalidMavlinkChannel());
+
+    // Outbound v2 unless a test asks for v1
+    mavlink_get_channel_status(_encodeChannel)->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    _resetChannels();
+}
+
+void MAVLinkFrameScannerTest::cleanup(void)
+{
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    linkManager->freeMavlinkChannel(_referenceChannel);
+    linkManager->freeMavlinkChannel(_scannerChannel);
+    linkManager->freeMavlinkChannel(_encodeChannel);
+
+    UnitTest::cleanup();
+}
+
+void MAVLinkFrameScannerTest::_resetChannels(void)
+{
+    for (uint8_t channel: { _referenceChannel, _scannerChannel }) {
+        memset(mavlink_get_channel_status(channel), 0, sizeof(mavlink_status_t));
+        memset(mavlink_get_channel_buffer(channel), 0, sizeof(mavlink_message_t));
+    }
+}
+
+void MAVLinkFrameScannerTest::_appendFrame(QByteArray& stream, const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+    stream.append(reinterpret_cast<const char*>(buffer), length);
+}
+
+QByteArray MAVLinkFrameScannerTest::buildStream(uint8_t encodeChannel, int messageCount, bool includeErrors, quint32 seed)
+{
+    QRandomGenerator    rng(seed);
+    QByteArray          stream;
+    mavlink_message_t   message;
+    mavlink_status_t*   encodeStatus = mavlink_get_channel_status(encodeChannel);
+
+    for (int i=0; i<messageCount; i++) {
+        const uint8_t   sysid   = static_cast<uint8_t>(1 + rng.bounded(3));
+        const uint8_t   compid  = MAV_COMP_ID_AUTOPILOT1;
+        const int       kind    = includeErrors ? rng.bounded(14) : 100;
+
+        if (kind == 0) {
+            // Line noise, including stray start markers
+            const int noiseLength = 1 + rng.bounded(40);
+            for (int j=0; j<noiseLength; j++) {
+                const quint32 value = rng.bounded(8);
+                stream.append(static_cast<char>(value == 0 ? MAVLINK_STX : (value == 1 ? MAVLINK_STX_MAVLINK1 : rng.bounded(256))));
+            }
+            continue;
+        }
+
+        const bool mavlink1 = kind == 1;
+        if (mavlink1) {
+            encodeStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
+        switch (rng.bounded(7)) {
+        case 0:
+            mavlink_msg_heartbeat_pack_chan(sysid, compid, encodeChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, rng.bounded(1000), MAV_STATE_ACTIVE);
+            break;
+        case 1:
+            mavlink_msg_attitude_pack_chan(sysid, compid, encodeChannel, &message, rng.generate(), 0.1f, -0.2f, static_cast<float>(rng.generateDouble()), 0, 0, 0);
+            break;
+        case 2:
+            mavlink_msg_global_position_int_pack_chan(sysid, compid, encodeChannel, &message, rng.generate(), 473977418, 85455939, 500000, 10000, 0, 0, 0, 9000);
+            break;
+        case 3:
+            mavlink_msg_gps_raw_int_pack_chan(sysid, compid, encodeChannel, &message, rng.generate(), 3, 473977418, 85455939, 500000, 100, 100, 0, 0, 12, 0, 0, 0, 0, 0, 0);
+            break;
+        case 4:
+            // Mostly zero payload which is truncated on the wire
+            mavlink_msg_param_value_pack_chan(sysid, compid, encodeChannel, &message, "P", 0, MAV_PARAM_TYPE_REAL32, 0, 0);
+            break;
+        case 5:
+            mavlink_msg_vfr_hud_pack_chan(sysid, compid, encodeChannel, &message, 10.0f, 11.0f, 90, 50, 100.0f, 0.5f);
+            break;
+        default:
+            mavlink_msg_radio_status_pack_chan(sysid, compid, encodeChannel, &message, 200, 190, 100, 10, 10, 0, 0);
+            break;
+        }
+        if (mavlink1) {
+            encodeStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
+
+        QByteArray frame;
+        _appendFrame(frame, message);
+        uint8_t* frameBytes = reinterpret_cast<uint8_t*>(frame.data());
+
+        if (kind == 2) {
+            // Corrupted byte anywhere in the frame
+            frameBytes[rng.bounded(frame.size())] ^= static_cast<uint8_t>(1 + rng.bounded(255));
+        } else if (kind == 3) {
+            // Frame which is cut off by the next one
+            frame.truncate(1 + rng.bounded(frame.size() - 1));
+        } else if (kind == 4) {
+            // Unknown message id, which the reference parser accepts with a zero crc extra
+            frameBytes[7] = 0xEF;
+            frameBytes[8] = 0xCD;
+            frameBytes[9] = 0xAB;
+            const int   crcLength   = MAVLINK_NUM_HEADER_BYTES - 1 + message.len;
+            uint16_t    crc         = crc_calculate(frameBytes + 1, static_cast<uint16_t>(crcLength));
+            crc_accumulate(0, &crc);
+            frameBytes[crcLength + 1] = static_cast<uint8_t>(crc & 0xFF);
+            frameBytes[crcLength + 2] = static_cast<uint8_t>(crc >> 8);
+        } else if (kind == 5) {
+            // Signed frame, accepted since signing is not configured on the channel
+            frameBytes[2] |= MAVLINK_IFLAG_SIGNED;
+            const int   crcLength   = MAVLINK_NUM_HEADER_BYTES - 1 + message.len;
+            uint16_t    crc         = crc_calculate(frameBytes + 1, static_cast<uint16_t>(crcLength));
+            crc_accumulate(mavlink_get_msg_entry(message.msgid)->crc_extra, &crc);
+            frameBytes[crcLength + 1] = static_cast<uint8_t>(crc & 0xFF);
+            frameBytes[crcLength + 2] = static_cast<uint8_t>(crc >> 8);
+            for (int j=0; j<MAVLINK_SIGNATURE_BLOCK_LEN; j++) {
+                frame.append(static_cast<char>(rng.bounded(256)));
+            }
+        }
+
+        stream.append(frame);
+    }
+
+    return stream;
+}
+
+void MAVLinkFrameScannerTest::_crcTest(void)
+{
+    const char* checkString = "123456789";
+    QCOMPARE(MAVLinkFrameScanner::crcAccumulate(reinterpret_cast<const uint8_t*>(checkString), 9, X25_INIT_CRC), static_cast<uint16_t>(0x6F91));
+
+    QRandomGenerator rng(1);
+    for (int i=0; i<100; i++) {
+        uint8_t data[MAVLINK_MAX_PACKET_LEN];
+        const int length = 1 + rng.bounded(MAVLINK_MAX_PACKET_LEN);
+        for (int j=0; j<length; j++) {
+            data[j] = static_cast<uint8_t>(rng.bounded(256));
+        }
+        QCOMPARE(MAVLinkFrameScanner::crcAccumulate(data, length, X25_INIT_CRC), crc_calculate(data, static_cast<uint16_t>(length)));
+    }
+}
+
+void MAVLinkFrameScannerTest::_findStartMarkerTest(void)
+{
+    uint8_t data[100];
+    memset(data, 0x55, sizeof(data));
+
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 0, 100), 100);
+    data[37] = MAVLINK_STX_MAVLINK1;
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 0, 100), 37);
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 37, 100), 37);
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 38, 100), 100);
+    data[99] = MAVLINK_STX;
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 38, 100), 99);
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 38, 99), 99);
+    data[3] = MAVLINK_STX;
+    QCOMPARE(MAVLinkFrameScanner::findStartMarker(data, 0, 100), 3);
+}
+
+void MAVLinkFrameScannerTest::_splitFrameTest(void)
+{
+    mavlink_message_t   message;
+    mavlink_status_t    status = {};
+    QByteArray          frame;
+
+    mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, 1234, 0.1f, 0.2f, 0.3f, 0, 0, 0);
+    _appendFrame(frame, message);
+
+    QByteArray  first   = frame.left(7);
+    QByteArray  second  = frame.mid(7);
+    int         position = 0;
+
+    memset(&message, 0, sizeof(message));
+    QVERIFY(!MAVLinkFrameScanner::parse(_scannerChannel, first, position, &message, &status));
+    QCOMPARE(position, first.size() - 1);
+
+    position = 0;
+    QVERIFY(MAVLinkFrameScanner::parse(_scannerChannel, second, position, &message, &status));
+    QCOMPARE(position, second.size() - 1);
+    QCOMPARE(message.msgid, static_cast<uint32_t>(MAVLINK_MSG_ID_ATTITUDE));
+
+    mavlink_attitude_t attitude;
+    mavlink_msg_attitude_decode(&message, &attitude);
+    QCOMPARE(attitude.time_boot_ms, static_cast<uint32_t>(1234));
+    QCOMPARE(attitude.yaw, 0.3f);
+}
+
+void MAVLinkFrameScannerTest::_bitExactWorker(const QByteArray& stream, quint32 seed)
+{
+    QRandomGenerator    rng(seed);
+    mavlink_message_t   referenceMessage    = {};
+    mavlink_message_t   scannerMessage      = {};
+    mavlink_status_t    referenceStatus     = {};
+    mavlink_status_t    scannerStatus       = {};
+    int                 totalMessageCount   = 0;
+
+    _resetChannels();
+
+    // Random chunk sizes exercise frames split across receive buffers
+    for (int chunkStart = 0; chunkStart < stream.size(); ) {
+        const int           chunkLength = qMin(stream.size() - chunkStart, 1 + rng.bounded(600));
+        const QByteArray    chunk       = stream.mid(chunkStart, chunkLength);
+        chunkStart += chunkLength;
+
+        QVector<int>                referenceEnds;
+        QVector<mavlink_message_t>  referenceMessages;
+        QVector<mavlink_status_t>   referenceStatuses;
+        for (int i=0; i<chunk.size(); i++) {
+            if (mavlink_parse_char(_referenceChannel, static_cast<uint8_t>(chunk[i]), &referenceMessage, &referenceStatus)) {
+                referenceEnds.append(i);
+                referenceMessages.append(referenceMessage);
+                referenceStatuses.append(referenceStatus);
+                // Same as MAVLinkProtocol::receiveBytes
+                memset(&referenceStatus,  0, sizeof(referenceStatus));
+                memset(&referenceMessage, 0, sizeof(referenceMessage));
+            }
+        }
+
+        int messageIndex = 0;
+        for (int position = 0; position < chunk.size(); position++) {
+            if (MAVLinkFrameScanner::parse(_scannerChannel, chunk, position, &scannerMessage, &scannerStatus)) {
+                QVERIFY(messageIndex < referenceEnds.count());
+                QCOMPARE(position, referenceEnds[messageIndex]);
+                QVERIFY(memcmp(&scannerMessage, &referenceMessages[messageIndex], sizeof(mavlink_message_t)) == 0);
+                QVERIFY(memcmp(&scannerStatus, &referenceStatuses[messageIndex], sizeof(mavlink_status_t)) == 0);
+                messageIndex++;
+                memset(&scannerStatus,  0, sizeof(scannerStatus));
+                memset(&scannerMessage, 0, sizeof(scannerMessage));
+            }
+        }
+        QCOMPARE(messageIndex, referenceEnds.count());
+        totalMessageCount += messageIndex;
+
+        QVERIFY(memcmp(&scannerMessage, &referenceMessage, sizeof(mavlink_message_t)) == 0);
+        QVERIFY(memcmp(&scannerStatus, &referenceStatus, sizeof(mavlink_status_t)) == 0);
+        QVERIFY(memcmp(mavlink_get_channel_status(_scannerChannel), mavlink_get_channel_status(_referenceChannel), sizeof(mavlink_status_t)) == 0);
+        QVERIFY(memcmp(mavlink_get_channel_buffer(_scannerChannel), mavlink_get_channel_buffer(_referenceChannel), sizeof(mavlink_message_t)) == 0);
+    }
+
+    QVERIFY(totalMessageCount > 0);
+}
+
+void MAVLinkFrameScannerTest::_bitExactTest(void)
+{
+    for (quint32 seed=1; seed<=5; seed++) {
+        _bitExactWorker(buildStream(_encodeChannel, 2000, false /* includeErrors */, seed), seed);
+    }
+}
+
+void MAVLinkFrameScannerTest::_bitExactErrorsTest(void)
+{
+    for (quint32 seed=1; seed<=20; seed++) {
+        _bitExactWorker(buildStream(_encodeChannel, 2000, true /* includeErrors */, seed), seed);
+    }
+}
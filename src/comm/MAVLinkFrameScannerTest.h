@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for MAVLinkFrameScanner. Verifies results are bit exact with mavlink_parse_char.
+class MAVLinkFrameScannerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkFrameScannerTest(void);
+
+    /// Builds a stream of typical telemetry. If includeErrors is true the stream also contains line noise, corrupted
+    /// frames, MAVLink v1 frames, signed frames and unknown message ids.
+    static QByteArray buildStream(uint8_t encodeChannel, int messageCount, bool includeErrors, quint32 seed);
+
+protected:
+    void init   (void) final;
+    void cleanup(void) final;
+
+private slots:
+    void _crcTest               (void);
+    void _findStartMarkerTest   (void);
+    void _splitFrameTest        (void);
+    void _bitExactTest          (void);
+    void _bitExactErrorsTest    (void);
+
+private:
+    void _bitExactWorker    (const QByteArray& stream, quint32 seed);
+    void _resetChannels     (void);
+
+    static void _appendFrame(QByteArray& stream, const mavlink_message_t& message);
+
+    uint8_t _referenceChannel   = 0;
+    uint8_t _scannerChannel     = 0;
+    uint8_t _encodeChannel      = 0;
+};
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkParseBenchmarkTest.h"
+#include "MAVLinkFrameScannerTest.h"
+#include "MAVLinkFrameScanner.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <string.h>
+
+MAVLinkParseBenchmarkTest::MAVLinkParseBenchmarkTest(void)
+{
+
+}
+
+void MAVLinkParseBenchmarkTest::init(void)
+{
+    UnitTest::init();
+
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    _parseChannel   = linkManager->allocateMavlinkChannel();
+    _encodeChannel  = linkManager->allocateMavlinkChannel();
+    QVERIFY(_parseChannel != LinkManager::invalidMavlinkChannel());
+    QVERIFY(_encodeChannel != LinkManager::invalidMavlinkChannel());
+
+    mavlink_get_channel_status(_encodeChannel)->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+}
+
+void MAVLinkParseBenchmarkTest::cleanup(void)
+{
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+    linkManager->freeMavlinkChannel(_parseChannel);
+    linkManager->freeMavlinkChannel(_encodeChannel);
+
+    UnitTest::cleanup();
+}
+
+/// Writes out all collected results once the full benchmark run is complete
+void MAVLinkParseBenchmarkTest::cleanupTestCase(void)
+{
+    _results.write(objectName());
+}
+
+qint64 MAVLinkParseBenchmarkTest::_parseReference(const QByteArray& stream, int& messageCount)
+{
+    mavlink_message_t   message = {};
+    mavlink_status_t    status  = {};
+    QElapsedTimer       timer;
+
+    memset(mavlink_get_channel_status(_parseChannel), 0, sizeof(mavlink_status_t));
+    messageCount = 0;
+
+    timer.start();
+    for (int chunkStart = 0; chunkStart < stream.size(); chunkStart += _chunkBytes) {
+        const uint8_t*  bytes   = reinterpret_cast<const uint8_t*>(stream.constData()) + chunkStart;
+        const int       length  = qMin(_chunkBytes, stream.size() - chunkStart);
+        for (int position = 0; position < length; position++) {
+            if (mavlink_parse_char(_parseChannel, bytes[position], &message, &status)) {
+                messageCount++;
+            }
+        }
+    }
+    return timer.nsecsElapsed();
+}
+
+qint64 MAVLinkParseBenchmarkTest::_parseScanner(const QByteArray& stream, int& messageCount)
+{
+    mavlink_message_t   message = {};
+    mavlink_status_t    status  = {};
+    QElapsedTimer       timer;
+
+    memset(mavlink_get_channel_status(_parseChannel), 0, sizeof(mavlink_status_t));
+    messageCount = 0;
+
+    timer.start();
+    for (int chunkStart = 0; chunkStart < stream.size(); chunkStart += _chunkBytes) {
+        const uint8_t*  bytes   = reinterpret_cast<const uint8_t*>(stream.constData()) + chunkStart;
+        const int       length  = qMin(_chunkBytes, stream.size() - chunkStart);
+        for (int position = 0; position < length; position++) {
+            if (MAVLinkFrameScanner::parse(_parseChannel, bytes, length, position, &message, &status)) {
+                messageCount++;
+            }
+        }
+    }
+    return timer.nsecsElapsed();
+}
+
+void MAVLinkParseBenchmarkTest::_parseWorker(const QString& benchmarkName, bool includeErrors)
+{
+    const QByteArray stream = MAVLinkFrameScannerTest::buildStream(_encodeChannel, _messageCount, includeErrors, 1 /* seed */);
+
+    QList<qint64>   rgReferenceNsecs;
+    QList<qint64>   rgScannerNsecs;
+    int             referenceMessageCount;
+    int             scannerMessageCount;
+
+    for (int i=0; i<_iterations; i++) {
+        rgReferenceNsecs.append(_parseReference(stream, referenceMessageCount));
+        rgScannerNsecs.append(_parseScanner(stream, scannerMessageCount));
+        QCOMPARE(scannerMessageCount, referenceMessageCount);
+    }
+
+    std::sort(rgReferenceNsecs.begin(), rgReferenceNsecs.end());
+    std::sort(rgScannerNsecs.begin(), rgScannerNsecs.end());
+
+    const double referenceMedianNsecs   = rgReferenceNsecs[rgReferenceNsecs.count() / 2];
+    const double scannerMedianNsecs     = rgScannerNsecs[rgScannerNsecs.count() / 2];
+    const double megaBytes              = stream.size() / (1024.0 * 1024.0);
+
+    QJsonObject result;
+    result["name"]                  = benchmarkName;
+    result["iterations"]            = _iterations;
+    result["bytes"]                 = stream.size();
+    result["messages"]              = referenceMessageCount;
+    result["referenceNsecsPerByte"] = referenceMedianNsecs / stream.size();
+    result["scannerNsecsPerByte"]   = scannerMedianNsecs / stream.size();
+    result["referenceMBPerSec"]     = megaBytes / (referenceMedianNsecs / 1e9);
+    result["scannerMBPerSec"]       = megaBytes / (scannerMedianNsecs / 1e9);
+    result["speedup"]               = referenceMedianNsecs / scannerMedianNsecs;
+    _results.append(result);
+
+    qDebug() << "Benchmark" << benchmarkName << "reference(MB/s)" << result["referenceMBPerSec"].toDouble() << "scanner(MB/s)" << result["scannerMBPerSec"].toDouble() << "speedup" << result["speedup"].toDouble();
+}
+
+void MAVLinkParseBenchmarkTest::_benchTelemetry(void)
+{
+    _parseWorker(QStringLiteral("telemetry"), false /* includeErrors */);
+}
+
+void MAVLinkParseBenchmarkTest::_benchTelemetryErrors(void)
+{
+    _parseWorker(QStringLiteral("telemetryErrors"), true /* includeErrors */);
+}
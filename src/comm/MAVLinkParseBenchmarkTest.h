@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "BenchmarkResults.h"
+
+/// Microbenchmark comparing MAVLinkFrameScanner against calling mavlink_parse_char for each byte.
+///
+/// This is a standalone test which is only run when specifically requested from the command line:
+///     QGroundControl --unittest:MAVLinkParseBenchmarkTest
+///
+/// Results are written to the shared benchmark results file, see BenchmarkResults.
+class MAVLinkParseBenchmarkTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkParseBenchmarkTest(void);
+
+protected:
+    void init   (void) final;
+    void cleanup(void) final;
+
+private slots:
+    void cleanupTestCase(void);
+
+    void _benchTelemetry        (void);
+    void _benchTelemetryErrors  (void);
+
+private:
+    void    _parseWorker        (const QString& benchmarkName, bool includeErrors);
+    qint64  _parseReference     (const QByteArray& stream, int& messageCount);
+    qint64  _parseScanner       (const QByteArray& stream, int& messageCount);
+
+    BenchmarkResults    _results;
+    uint8_t             _parseChannel   = 0;
+    uint8_t             _encodeChannel  = 0;
+
+    static const int    _iterations     = 5;
+    static const int    _messageCount   = 100000;   ///< Roughly 4MB of telemetry
+    static const int    _chunkBytes     = 4096;     ///< Typical size of a single link read
+};
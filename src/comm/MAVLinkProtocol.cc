@@ -31,6 +31,9 @@
 #include "QGCLoggingCategory.h"
 #include "MultiVehicleManager.h"
 #include "SettingsManager.h"
+#include "TelemetryTracer.h"
+#include "MAVLinkForwarder.h"
+#include "MAVLinkFrameScanner.h"
 
 Q_DECLARE_METATYPE(mavlink_message_t)
 
@@ -58,6 +61,7 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     , _tempLogFile(QString("%2.%3").arg(_tempLogFileTemplate).arg(_logFileExtension))
     , _linkMgr(nullptr)
     , _multiVehicleManager(nullptr)
+    , _forwarder(new MAVLinkForwarder())
 {
     memset(totalReceiveCounter, 0, sizeof(totalReceiveCounter));
     memset(totalLossCounter,    0, sizeof(totalLossCounter));
@@ -71,6 +75,7 @@ MAVLinkProtocol::~MAVLinkProtocol()
 {
     storeSettings();
     _closeLogFile();
+    delete _forwarder;
 }
 
 void MAVLinkProtocol::setVersion(unsigned version)
@@ -112,6 +117,10 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &MAVLinkProtocol::_vehicleCountChanged);
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
 
+   Fact* forwardMavlinkFact = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink();
+   _forwarder->setEnabled(forwardMavlinkFact->rawValue().toBool());
+   connect(forwardMavlinkFact, &Fact::rawValueChanged, this, [this](QVariant value) { _forwarder->setEnabled(value.toBool()); });
+
    emit versionCheckChanged(m_enable_version_check);
 }
 
@@ -205,8 +214,20 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 
     uint8_t mavlinkChannel = link->mavlinkChannel();
 
+    TelemetryTracer::Scope traceScope(TelemetryTracer::StageProtocolReceive, static_cast<quint32>(b.size()));
+    if (TelemetryTracer::enabled()) {
+        const qint64 nowNsecs               = TelemetryTracer::nowNsecs();
+        const qint64 bytesReceivedNsecs     = link->takeTraceBytesReceivedNsecs();
+        if (bytesReceivedNsecs) {
+            TelemetryTracer::record(TelemetryTracer::StageLinkQueue, bytesReceivedNsecs, nowNsecs - bytesReceivedNsecs, static_cast<quint32>(b.size()));
+        }
+        // Fact updates resulting from these bytes measure their end to end latency from here
+        TelemetryTracer::setOriginNsecs(bytesReceivedNsecs ? bytesReceivedNsecs : nowNsecs);
+    }
+
+    // The scanner advances position to the last byte of each decoded frame
     for (int position = 0; position < b.size(); position++) {
-        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
+        if (MAVLinkFrameScanner::parse(mavlinkChannel, b, position, &_message, &_status)) {
             // Got a valid message
             if (!link->decodedFirstMavlinkPacket()) {
                 link->setDecodedFirstMavlinkPacket(true);
@@ -261,15 +282,8 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 
             //-----------------------------------------------------------------
             // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (forwardingEnabled) {
-                SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
-
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
-                }
+            if (_forwarder->enabled()) {
+                _forwarder->queueMessage(link, _message, b, position);
             }
 
             //-----------------------------------------------------------------
@@ -373,6 +387,9 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
             memset(&_message, 0, sizeof(_message));
         }
     }
+
+    _forwarder->flush();
+    TelemetryTracer::setOriginNsecs(0);
 }
 
 /**
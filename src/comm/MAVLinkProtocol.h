@@ -25,6 +25,7 @@
 #include "QGCToolbox.h"
 
 class LinkManager;
+class MAVLinkForwarder;
 class MultiVehicleManager;
 class QGCApplication;
 
@@ -74,6 +75,8 @@ public:
     /// Set protocol version
     void setVersion(unsigned version);
 
+    MAVLinkForwarder* forwarder(void) { return _forwarder; }
+
     // Override from QGCTool
     virtual void setToolbox(QGCToolbox *toolbox);
 
@@ -121,7 +124,9 @@ signals:
     /// Heartbeat received on link
     void vehicleHeartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType);
 
-    /** @brief Message received and directly copied via signal */
+    /** @brief Message received and directly copied via signal.
+     *  Every connection sees all traffic from all vehicles. Per vehicle handling is routed by MultiVehicleManager,
+     *  so only connect here for consumers which need messages across vehicles. */
     void messageReceived(LinkInterface* link, mavlink_message_t message);
     /** @brief Emitted if version check is enabled / disabled */
     void versionCheckChanged(bool enabled);
@@ -170,5 +175,6 @@ private:
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
+    MAVLinkForwarder*       _forwarder;
 };
 
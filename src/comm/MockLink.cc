@@ -20,6 +20,7 @@
 #include <QFile>
 #include <QMutexLocker>
 #include <QTimer>
+#include <QDateTime>
 
 #include <string.h>
 
@@ -48,6 +49,10 @@ const char* MockConfiguration::_vehicleTypeKey          = "VehicleType";
 const char* MockConfiguration::_sendStatusTextKey       = "SendStatusText";
 const char* MockConfiguration::_incrementVehicleIdKey   = "IncrementVehicleId";
 const char* MockConfiguration::_failureModeKey          = "FailureMode";
+const char* MockConfiguration::_swarmCountKey           = "SwarmCount";
+const char* MockConfiguration::_telemetryRateHzKey      = "TelemetryRateHz";
+const char* MockConfiguration::_lossPctKey              = "LossPct";
+const char* MockConfiguration::_jitterMSecsKey          = "JitterMSecs";
 
 constexpr MAV_CMD MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED;
 constexpr MAV_CMD MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_FAILED;
@@ -90,6 +95,7 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
     _vehicleType        = mockConfig->vehicleType();
     _sendStatusText     = mockConfig->sendStatusText();
     _failureMode        = mockConfig->failureMode();
+    _ftpCapability      = mockConfig->ftpCapability();
     _vehicleSystemId    = mockConfig->incrementVehicleId() ?  _nextVehicleSystemId++ : _nextVehicleSystemId;
     _vehicleLatitude    = _defaultVehicleLatitude + ((_vehicleSystemId - 128) * 0.0001);
     _vehicleLongitude   = _defaultVehicleLongitude + ((_vehicleSystemId - 128) * 0.0001);
@@ -105,6 +111,10 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
 
     _mockLinkFTP = new MockLinkFTP(_vehicleSystemId, _vehicleComponentId, this);
 
+    if (mockConfig->swarmCount() > 0) {
+        _swarm = new MockLinkSwarm(this, mockConfig->swarmCount(), mockConfig->telemetryRateHz(), mockConfig->lossPct(), mockConfig->jitterMSecs(), _firmwareType, _vehicleType);
+    }
+
     moveToThread(this);
 
     _loadParams();
@@ -204,17 +214,26 @@ void MockLink::run(void)
     QObject::connect(&timer10HzTasks, &QTimer::timeout, this, &MockLink::_run10HzTasks);
     QObject::connect(&timer500HzTasks, &QTimer::timeout, this, &MockLink::_run500HzTasks);
 
-    timer1HzTasks.start(1000);
-    timer10HzTasks.start(100);
-    timer500HzTasks.start(2);
-
-    // Send first set right away
-    _run1HzTasks();
-    _run10HzTasks();
-    _run500HzTasks();
+    if (_swarm) {
+        // In swarm mode the swarm vehicles replace the single simulated vehicle
+        _swarm->start();
+    } else {
+        timer1HzTasks.start(1000);
+        timer10HzTasks.start(100);
+        timer500HzTasks.start(2);
+
+        // Send first set right away
+        _run1HzTasks();
+        _run10HzTasks();
+        _run500HzTasks();
+    }
 
     exec();
 
+    if (_swarm) {
+        _swarm->stop();
+    }
+
     QObject::disconnect(&timer1HzTasks,  &QTimer::timeout, this, &MockLink::_run1HzTasks);
     QObject::disconnect(&timer10HzTasks, &QTimer::timeout, this, &MockLink::_run10HzTasks);
     QObject::disconnect(&timer500HzTasks, &QTimer::timeout, this, &MockLink::_run500HzTasks);
@@ -546,6 +565,13 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
     }
 }
 
+void MockLink::respondWithBytes(const QByteArray& bytes)
+{
+    if (!_commLost && !bytes.isEmpty()) {
+        emit bytesReceived(this, bytes);
+    }
+}
+
 /// @brief Called when QGC wants to write bytes to the MAV
 void MockLink::_writeBytes(const QByteArray bytes)
 {
@@ -652,6 +678,9 @@ void MockLink::_handleIncomingMavlinkMsg(const mavlink_message_t &msg)
     case MAVLINK_MSG_ID_PARAM_MAP_RC:
         _handleParamMapRC(msg);
         break;
+    case MAVLINK_MSG_ID_TIMESYNC:
+        _handleTimesync(msg);
+        break;
     default:
         break;
     }
@@ -663,6 +692,25 @@ void MockLink::_handleHeartBeat(const mavlink_message_t& msg)
     qCDebug(MockLinkLog) << "Heartbeat";
 }
 
+void MockLink::_handleTimesync(const mavlink_message_t& msg)
+{
+    mavlink_timesync_t timesync;
+    mavlink_msg_timesync_decode(&msg, &timesync);
+
+    if (timesync.tc1 == 0) {
+        // Answer requests with our time and the requesters timestamp
+        timesync.tc1 = QDateTime::currentMSecsSinceEpoch() * 1000000;
+
+        mavlink_message_t responseMsg;
+        mavlink_msg_timesync_encode_chan(_vehicleSystemId,
+                                         _vehicleComponentId,
+                                         mavlinkChannel(),
+                                         &responseMsg,
+                                         &timesync);
+        respondWithMavlinkMessage(responseMsg);
+    }
+}
+
 void MockLink::_handleParamMapRC(const mavlink_message_t& msg)
 {
     mavlink_param_map_rc_t paramMapRC;
@@ -1060,6 +1108,7 @@ void MockLink::_handleCommandLong(const mavlink_message_t& msg)
     mavlink_msg_command_long_decode(&msg, &request);
 
     _sendMavCommandCountMap[static_cast<MAV_CMD>(request.command)]++;
+    _lastSendMavCommandMap[static_cast<MAV_CMD>(request.command)] = request;
 
     switch (request.command) {
     case MAV_CMD_COMPONENT_ARM_DISARM:
@@ -1192,7 +1241,8 @@ void MockLink::_respondWithAutopilotVersion(void)
     }
 #endif
     uint64_t capabilities = MAV_PROTOCOL_CAPABILITY_MAVLINK2 | MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY | MAV_PROTOCOL_CAPABILITY_MISSION_INT |
-            (_firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA ? MAV_PROTOCOL_CAPABILITY_TERRAIN : 0);
+            (_firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA ? MAV_PROTOCOL_CAPABILITY_TERRAIN : 0) |
+            (_ftpCapability ? MAV_PROTOCOL_CAPABILITY_FTP : 0);
 
     mavlink_msg_autopilot_version_pack_chan(_vehicleSystemId,
                                             _vehicleComponentId,
@@ -1363,6 +1413,11 @@ MockConfiguration::MockConfiguration(MockConfiguration* source)
     _sendStatusText     = source->_sendStatusText;
     _incrementVehicleId = source->_incrementVehicleId;
     _failureMode        = source->_failureMode;
+    _swarmCount         = source->_swarmCount;
+    _telemetryRateHz    = source->_telemetryRateHz;
+    _lossPct            = source->_lossPct;
+    _jitterMSecs        = source->_jitterMSecs;
+    _ftpCapability      = source->_ftpCapability;
 }
 
 void MockConfiguration::copyFrom(LinkConfiguration *source)
@@ -1380,6 +1435,11 @@ void MockConfiguration::copyFrom(LinkConfiguration *source)
     _sendStatusText     = usource->_sendStatusText;
     _incrementVehicleId = usource->_incrementVehicleId;
     _failureMode        = usource->_failureMode;
+    _swarmCount         = usource->_swarmCount;
+    _telemetryRateHz    = usource->_telemetryRateHz;
+    _lossPct            = usource->_lossPct;
+    _jitterMSecs        = usource->_jitterMSecs;
+    _ftpCapability      = usource->_ftpCapability;
 }
 
 void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
@@ -1390,6 +1450,10 @@ void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
     settings.setValue(_sendStatusTextKey,       _sendStatusText);
     settings.setValue(_incrementVehicleIdKey,   _incrementVehicleId);
     settings.setValue(_failureModeKey,          (int)_failureMode);
+    settings.setValue(_swarmCountKey,           _swarmCount);
+    settings.setValue(_telemetryRateHzKey,      _telemetryRateHz);
+    settings.setValue(_lossPctKey,              _lossPct);
+    settings.setValue(_jitterMSecsKey,          _jitterMSecs);
     settings.sync();
     settings.endGroup();
 }
@@ -1402,6 +1466,10 @@ void MockConfiguration::loadSettings(QSettings& settings, const QString& root)
     _sendStatusText     = settings.value(_sendStatusTextKey, false).toBool();
     _incrementVehicleId = settings.value(_incrementVehicleIdKey, true).toBool();
     _failureMode        = (FailureMode_t)settings.value(_failureModeKey, (int)FailNone).toInt();
+    _swarmCount         = settings.value(_swarmCountKey, 0).toInt();
+    _telemetryRateHz    = settings.value(_telemetryRateHzKey, 10).toInt();
+    _lossPct            = settings.value(_lossPctKey, 0).toDouble();
+    _jitterMSecs        = settings.value(_jitterMSecsKey, 0).toInt();
     settings.endGroup();
 }
 
@@ -1419,7 +1487,7 @@ MockLink* MockLink::_startMockLink(MockConfiguration* mockConfig)
     }
 }
 
-MockLink* MockLink::_startMockLinkWorker(QString configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode)
+MockLink* MockLink::_startMockLinkWorker(QString configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode, bool ftpCapability)
 {
     MockConfiguration* mockConfig = new MockConfiguration(configName);
 
@@ -1427,6 +1495,7 @@ MockLink* MockLink::_startMockLinkWorker(QString configName, MAV_AUTOPILOT firmw
     mockConfig->setVehicleType(vehicleType);
     mockConfig->setSendStatusText(sendStatusText);
     mockConfig->setFailureMode(failureMode);
+    mockConfig->setFtpCapability(ftpCapability);
 
     return _startMockLink(mockConfig);
 }
@@ -1446,9 +1515,9 @@ MockLink* MockLink::startNoInitialConnectMockLink(bool sendStatusText, MockConfi
     return _startMockLinkWorker("No Initial Connect MockLink", MAV_AUTOPILOT_PX4, MAV_TYPE_GENERIC, sendStatusText, failureMode);
 }
 
-MockLink*  MockLink::startAPMArduCopterMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode)
+MockLink*  MockLink::startAPMArduCopterMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode, bool ftpCapability)
 {
-    return _startMockLinkWorker("ArduCopter MockLink",MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_QUADROTOR, sendStatusText, failureMode);
+    return _startMockLinkWorker("ArduCopter MockLink",MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_QUADROTOR, sendStatusText, failureMode, ftpCapability);
 }
 
 MockLink*  MockLink::startAPMArduPlaneMockLink(bool sendStatusText, MockConfiguration::FailureMode_t failureMode)
@@ -1466,6 +1535,21 @@ MockLink*  MockLink::startAPMArduRoverMockLink(bool sendStatusText, MockConfigur
     return _startMockLinkWorker("ArduRover MockLink", MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_GROUND_ROVER, sendStatusText, failureMode);
 }
 
+/// Swarm vehicles are MAV_TYPE_GENERIC so that they skip the initial connect sequence during unit tests
+MockLink* MockLink::startSwarmMockLink(int swarmCount, int telemetryRateHz, double lossPct, int jitterMSecs)
+{
+    MockConfiguration* mockConfig = new MockConfiguration(QStringLiteral("Swarm MockLink"));
+
+    mockConfig->setFirmwareType(MAV_AUTOPILOT_PX4);
+    mockConfig->setVehicleType(MAV_TYPE_GENERIC);
+    mockConfig->setSwarmCount(swarmCount);
+    mockConfig->setTelemetryRateHz(telemetryRateHz);
+    mockConfig->setLossPct(lossPct);
+    mockConfig->setJitterMSecs(jitterMSecs);
+
+    return _startMockLink(mockConfig);
+}
+
 void MockLink::_sendRCChannels(void)
 {
     mavlink_message_t   msg;
@@ -1557,6 +1641,8 @@ void MockLink::_handleLogRequestData(const mavlink_message_t& msg)
         return;
     }
 
+    _logDownloadRequests.append(qMakePair(request.ofs, request.count));
+
     if (request.ofs > _logDownloadFileSize - 1) {
         qCWarning(MockLinkLog) << "_handleLogRequestData offset past end of file request.ofs:size" << request.ofs << _logDownloadFileSize;
         return;
@@ -1583,16 +1669,20 @@ void MockLink::_logDownloadWorker(void)
 
             qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
 
-            mavlink_message_t responseMsg;
-            mavlink_msg_log_data_pack_chan(_vehicleSystemId,
-                                           _vehicleComponentId,
-                                           mavlinkChannel(),
-                                           &responseMsg,
-                                           _logDownloadLogId,
-                                           _logDownloadCurrentOffset,
-                                           bytesToRead,
-                                           &buffer[0]);
-            respondWithMavlinkMessage(responseMsg);
+            if (_logDownloadDropOffsets.removeOne(_logDownloadCurrentOffset)) {
+                qCDebug(MockLinkLog) << "_logDownloadWorker dropping" << _logDownloadCurrentOffset;
+            } else {
+                mavlink_message_t responseMsg;
+                mavlink_msg_log_data_pack_chan(_vehicleSystemId,
+                                               _vehicleComponentId,
+                                               mavlinkChannel(),
+                                               &responseMsg,
+                                               _logDownloadLogId,
+                                               _logDownloadCurrentOffset,
+                                               bytesToRead,
+                                               &buffer[0]);
+                respondWithMavlinkMessage(responseMsg);
+            }
 
             _logDownloadCurrentOffset += bytesToRead;
             _logDownloadBytesRemaining -= bytesToRead;
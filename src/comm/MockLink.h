@@ -17,6 +17,7 @@
 
 #include "MockLinkMissionItemHandler.h"
 #include "MockLinkFTP.h"
+#include "MockLinkSwarm.h"
 #include "QGCMAVLink.h"
 
 Q_DECLARE_LOGGING_CATEGORY(MockLinkLog)
@@ -36,6 +37,10 @@ public:
     Q_PROPERTY(int      vehicle             READ vehicle            WRITE setVehicle            NOTIFY vehicleChanged)
     Q_PROPERTY(bool     sendStatus          READ sendStatusText     WRITE setSendStatusText     NOTIFY sendStatusChanged)
     Q_PROPERTY(bool     incrementVehicleId  READ incrementVehicleId WRITE setIncrementVehicleId NOTIFY incrementVehicleIdChanged)
+    Q_PROPERTY(int      swarmCount          READ swarmCount         WRITE setSwarmCount         NOTIFY swarmChanged)
+    Q_PROPERTY(int      telemetryRateHz     READ telemetryRateHz    WRITE setTelemetryRateHz    NOTIFY swarmChanged)
+    Q_PROPERTY(double   lossPct             READ lossPct            WRITE setLossPct            NOTIFY swarmChanged)
+    Q_PROPERTY(int      jitterMSecs         READ jitterMSecs        WRITE setJitterMSecs        NOTIFY swarmChanged)
 
     int     firmware                (void)                      { return (int)_firmwareType; }
     void    setFirmware             (int type)                  { _firmwareType = (MAV_AUTOPILOT)type; emit firmwareChanged(); }
@@ -56,6 +61,20 @@ public:
     void            setVehicleType      (MAV_TYPE vehicleType)          { _vehicleType = vehicleType; emit vehicleChanged(); }
     void            setSendStatusText   (bool sendStatusText)           { _sendStatusText = sendStatusText; emit sendStatusChanged(); }
 
+    /// Swarm mode: When swarmCount is non-zero the link simulates that many telemetry only vehicles instead of a single full vehicle
+    int             swarmCount          (void) const                    { return _swarmCount; }
+    int             telemetryRateHz     (void) const                    { return _telemetryRateHz; }
+    double          lossPct             (void) const                    { return _lossPct; }
+    int             jitterMSecs         (void) const                    { return _jitterMSecs; }
+    void            setSwarmCount       (int swarmCount)                { _swarmCount = swarmCount; emit swarmChanged(); }
+    void            setTelemetryRateHz  (int telemetryRateHz)           { _telemetryRateHz = telemetryRateHz; emit swarmChanged(); }
+    void            setLossPct          (double lossPct)                { _lossPct = lossPct; emit swarmChanged(); }
+    void            setJitterMSecs      (int jitterMSecs)               { _jitterMSecs = jitterMSecs; emit swarmChanged(); }
+
+    /// true: AUTOPILOT_VERSION advertises MAV_PROTOCOL_CAPABILITY_FTP, used to test the FTP based transfers
+    bool            ftpCapability       (void) const                    { return _ftpCapability; }
+    void            setFtpCapability    (bool ftpCapability)            { _ftpCapability = ftpCapability; }
+
     typedef enum {
         FailNone,                                                   // No failures
         FailParamNoReponseToRequestList,                            // Do no respond to PARAM_REQUEST_LIST
@@ -82,6 +101,7 @@ signals:
     void vehicleChanged             (void);
     void sendStatusChanged          (void);
     void incrementVehicleIdChanged  (void);
+    void swarmChanged               (void);
 
 private:
     MAV_AUTOPILOT   _firmwareType       = MAV_AUTOPILOT_PX4;
@@ -91,12 +111,21 @@ private:
     bool            _incrementVehicleId = true;
     uint16_t        _boardVendorId      = 0;
     uint16_t        _boardProductId     = 0;
+    int             _swarmCount         = 0;
+    int             _telemetryRateHz    = 10;
+    double          _lossPct            = 0;
+    int             _jitterMSecs        = 0;
+    bool            _ftpCapability      = false;
 
     static const char* _firmwareTypeKey;
     static const char* _vehicleTypeKey;
     static const char* _sendStatusTextKey;
     static const char* _incrementVehicleIdKey;
     static const char* _failureModeKey;
+    static const char* _swarmCountKey;
+    static const char* _telemetryRateHzKey;
+    static const char* _lossPctKey;
+    static const char* _jitterMSecsKey;
 };
 
 class MockLink : public LinkInterface
@@ -124,8 +153,14 @@ public:
     /// Sends the specified mavlink message to QGC
     void respondWithMavlinkMessage(const mavlink_message_t& msg);
 
+    /// Sends already packed mavlink bytes to QGC
+    void respondWithBytes(const QByteArray& bytes);
+
     MockLinkFTP* mockLinkFTP(void) { return _mockLinkFTP; }
 
+    /// @return Swarm generator, nullptr if the link is not in swarm mode
+    MockLinkSwarm* swarm(void) { return _swarm; }
+
     // Overrides from LinkInterface
     bool isConnected(void) const override { return _connected; }
     void disconnect (void) override;
@@ -149,18 +184,34 @@ public:
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    /// MISSION_ITEM for each of these sequence numbers is dropped the first time it is requested
+    void setMissionItemReadDropSequenceNumbers(const QList<uint16_t>& seqs) { _missionItemHandler.setReadDropSequenceNumbers(seqs); }
+
+    /// Returns the sequence number of each MISSION_REQUEST received during the most recent read, in order
+    QList<uint16_t> missionItemReadRequests(void) const { return _missionItemHandler.readRequests(); }
+
+    /// Returns the plan of the specified type in the ArduPilot @MISSION FTP file format
+    QByteArray planFileContents(MAV_MISSION_TYPE missionType) const { return _missionItemHandler.planFileContents(missionType); }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
+    /// LOG_DATA for each of these offsets is dropped the first time it is sent
+    void setLogDownloadDropOffsets(const QList<uint32_t>& offsets) { _logDownloadDropOffsets = offsets; }
+
+    /// Returns the offset/count of each LOG_REQUEST_DATA received, in order
+    QList<QPair<uint32_t, uint32_t>> logDownloadRequests(void) const { return _logDownloadRequests; }
+
     Q_INVOKABLE void setCommLost                    (bool commLost)   { _commLost = commLost; }
     Q_INVOKABLE void simulateConnectionRemoved      (void);
     static MockLink* startPX4MockLink               (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startGenericMockLink           (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startNoInitialConnectMockLink  (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
-    static MockLink* startAPMArduCopterMockLink     (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
+    static MockLink* startAPMArduCopterMockLink     (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone, bool ftpCapability = false);
     static MockLink* startAPMArduPlaneMockLink      (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startAPMArduSubMockLink        (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startAPMArduRoverMockLink      (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
+    static MockLink* startSwarmMockLink             (int swarmCount, int telemetryRateHz, double lossPct = 0, int jitterMSecs = 0);
 
     // Special commands for testing COMMAND_LONG handlers. By default all commands except for MAV_CMD_MOCKLINK_NO_RESPONSE_NO_RETRY should retry.
     static constexpr MAV_CMD MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED            = MAV_CMD_USER_1;
@@ -170,8 +221,9 @@ public:
     static constexpr MAV_CMD MAV_CMD_MOCKLINK_NO_RESPONSE                       = MAV_CMD_USER_5;
     static constexpr MAV_CMD MAV_CMD_MOCKLINK_NO_RESPONSE_NO_RETRY              = static_cast<MAV_CMD>(MAV_CMD_USER_5 + 1);
 
-    void clearSendMavCommandCounts(void) { _sendMavCommandCountMap.clear(); }
+    void clearSendMavCommandCounts(void) { _sendMavCommandCountMap.clear(); _lastSendMavCommandMap.clear(); }
     int sendMavCommandCount(MAV_CMD command) { return _sendMavCommandCountMap[command]; }
+    mavlink_command_long_t lastSendMavCommand(MAV_CMD command) { return _lastSendMavCommandMap.value(command); }
 
     typedef enum {
         FailRequestMessageNone,
@@ -224,6 +276,7 @@ private:
     void _handleLogRequestList          (const mavlink_message_t& msg);
     void _handleLogRequestData          (const mavlink_message_t& msg);
     void _handleParamMapRC              (const mavlink_message_t& msg);
+    void _handleTimesync                (const mavlink_message_t& msg);
     bool _handleRequestMessage          (const mavlink_command_long_t& request, bool& noAck);
     float _floatUnionForParam           (int componentId, const QString& paramName);
     void _setParamFloatUnionIntoMap     (int componentId, const QString& paramName, float paramFloat);
@@ -242,7 +295,7 @@ private:
     void _moveADSBVehicle               (void);
     void _sendGeneralMetaData           (void);
 
-    static MockLink* _startMockLinkWorker(QString configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode);
+    static MockLink* _startMockLinkWorker(QString configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode, bool ftpCapability = false);
     static MockLink* _startMockLink(MockConfiguration* mockConfig);
 
     uint8_t                     _mavlinkAuxChannel              = std::numeric_limits<uint8_t>::max();
@@ -286,10 +339,12 @@ private:
     uint16_t                    _boardVendorId      = 0;
     uint16_t                    _boardProductId     = 0;
 
-    MockLinkFTP* _mockLinkFTP = nullptr;
+    MockLinkFTP*    _mockLinkFTP    = nullptr;
+    MockLinkSwarm*  _swarm          = nullptr;
 
     bool _sendStatusText;
     bool _apmSendHomePositionOnEmptyList;
+    bool _ftpCapability = false;
     MockConfiguration::FailureMode_t _failureMode;
 
     int _sendHomePositionDelayCount;
@@ -304,6 +359,8 @@ private:
     QString     _logDownloadFilename;       ///< Filename for log download which is in progress
     uint32_t    _logDownloadCurrentOffset;  ///< Current offset we are sending from
     uint32_t    _logDownloadBytesRemaining; ///< Number of bytes still to send, 0 = send inactive
+    QList<uint32_t>                     _logDownloadDropOffsets;
+    QList<QPair<uint32_t, uint32_t>>    _logDownloadRequests;
 
     QGeoCoordinate  _adsbVehicleCoordinate;
     double          _adsbAngle;
@@ -311,6 +368,7 @@ private:
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
     QMap<MAV_CMD, int>  _sendMavCommandCountMap;
+    QMap<MAV_CMD, mavlink_command_long_t>       _lastSendMavCommandMap;
     QMap<int, QMap<QString, QVariant>>          _mapParamName2Value;
     QMap<int, QMap<QString, MAV_PARAM_TYPE>>    _mapParamName2MavParamType;
 
@@ -10,6 +10,7 @@
 
 #include "MockLinkFTP.h"
 #include "MockLink.h"
+#include "QGC.h"
 
 const MockLinkFTP::ErrorMode_t MockLinkFTP::rgFailureModes[] = {
     MockLinkFTP::errModeNoResponse,
@@ -113,18 +114,15 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
 
     _currentFile.close();
 
-    QString sizePrefix = sizeFilenamePrefix;
+    QString     sizePrefix = sizeFilenamePrefix;
+    QByteArray  planContents;
     if (path.startsWith(sizePrefix)) {
         QString sizeString = path.right(path.length() - sizePrefix.length());
-        tmpFilename = _createTestTempFile(sizeString.toInt());
-    } else if (path == "/general.json") {
-        tmpFilename = ":MockLink/General.MetaData.json";
-    } else if (path == "/general.json.xz") {
-        tmpFilename = ":MockLink/General.MetaData.json.xz";
-    } else if (path == "/parameter.json") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json";
-    } else if (path == "/parameter.json.xz") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json.xz";
+        tmpFilename = _createTempFile(_testFileContents(sizeString.toInt()));
+    } else if (_planFileContents(path, planContents)) {
+        tmpFilename = _createTempFile(planContents);
+    } else {
+        tmpFilename = _resourceFileForPath(path);
     }
 
     if (!tmpFilename.isEmpty()) {
@@ -239,6 +237,84 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     }
 }
 
+void MockLinkFTP::_createCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    ensureNullTemination(request);
+
+    _writeFilePath = (char *)request->data;
+    _uploadedFiles[_writeFilePath].clear();
+
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdCreateFile;
+    response.hdr.session    = _sessionId;
+    response.hdr.size       = 0;
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
+void MockLinkFTP::_writeCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    if (request->hdr.session != _sessionId || _writeFilePath.isEmpty()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdWriteFile);
+        return;
+    }
+
+    // Writes may arrive out of order, each one carries its own offset
+    QByteArray& fileContents    = _uploadedFiles[_writeFilePath];
+    int         writeEnd        = static_cast<int>(request->hdr.offset) + request->hdr.size;
+    if (fileContents.size() < writeEnd) {
+        fileContents.resize(writeEnd);
+    }
+    memcpy(fileContents.data() + request->hdr.offset, request->data, request->hdr.size);
+
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdWriteFile;
+    response.hdr.session    = _sessionId;
+    response.hdr.offset     = request->hdr.offset;
+    response.hdr.size       = sizeof(uint32_t);
+    response.writeFileLength = request->hdr.size;
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
+void MockLinkFTP::_calcFileCrc32Command(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+    QByteArray          fileContents;
+
+    ensureNullTemination(request);
+
+    QString path        = (char *)request->data;
+    QString sizePrefix  = sizeFilenamePrefix;
+    if (path.startsWith(sizePrefix)) {
+        fileContents = _testFileContents(path.right(path.length() - sizePrefix.length()).toInt());
+    } else if (_uploadedFiles.contains(path)) {
+        fileContents = _uploadedFiles[path];
+    } else if (!_planFileContents(path, fileContents)) {
+        QFile file(_resourceFileForPath(path));
+        if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly)) {
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+            return;
+        }
+        fileContents = file.readAll();
+    }
+
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdCalcFileCRC32;
+    response.hdr.session    = 0;
+    response.hdr.size       = sizeof(uint32_t);
+    response.crc32          = QGC::crc32(reinterpret_cast<const quint8*>(fileContents.constData()), static_cast<unsigned>(fileContents.size()), 0);
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
 void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
@@ -248,6 +324,7 @@ void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderCompon
         return;
     }
     
+    _writeFilePath.clear();
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
 
     emit terminateCommandReceived();
@@ -281,8 +358,8 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
 
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&requestFTP.payload[0];
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.opcode != MavlinkFTP::kCmdResetSessions) {
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if (_randomDropsEnabled && request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.opcode != MavlinkFTP::kCmdCreateFile && request->hdr.opcode != MavlinkFTP::kCmdResetSessions) {
         if ((rand() % 5) == 0) {
             qDebug() << "MockLinkFTP: Random drop of incoming packet";
             return;
@@ -336,6 +413,18 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
         _burstReadCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
 
+    case MavlinkFTP::kCmdCreateFile:
+        _createCommand(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
+    case MavlinkFTP::kCmdWriteFile:
+        _writeCommand(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
+    case MavlinkFTP::kCmdCalcFileCRC32:
+        _calcFileCrc32Command(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
     case MavlinkFTP::kCmdTerminateSession:
         _terminateCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
@@ -407,8 +496,8 @@ void MockLinkFTP::_sendResponse(uint8_t targetSystemId, uint8_t targetComponentI
                                                  targetComponentId,
                                                  (uint8_t*)request);            // Payload
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions) {
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if (_randomDropsEnabled && request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO && request->hdr.req_opcode != MavlinkFTP::kCmdCreateFile && request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions) {
         if ((rand() % 5) == 0) {
             qDebug() << "MockLinkFTP: Random drop of outgoing packet";
             return;
@@ -430,13 +519,54 @@ uint16_t MockLinkFTP::_nextSeqNumber(uint16_t seqNumber)
     return outgoingSeqNumber;
 }
 
-QString MockLinkFTP::_createTestTempFile(int size)
+QString MockLinkFTP::_createTempFile(const QByteArray& contents)
 {
     QGCTemporaryFile tmpFile("MockLinkFTPTestCase");
     tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
-    for (int i=0; i<size; i++) {
-        tmpFile.write(QByteArray(1, i % 255));
-    }
+    tmpFile.write(contents);
     tmpFile.close();
     return tmpFile.fileName();
 }
+
+/// Contents of the test files which are generated from the mocklink-size-<size> file names
+QByteArray MockLinkFTP::_testFileContents(int size)
+{
+    QByteArray bytes(size, 0);
+    for (int i=0; i<size; i++) {
+        bytes[i] = static_cast<char>(i % 255);
+    }
+    return bytes;
+}
+
+/// ArduPilot exposes the current plan through the @MISSION virtual files
+///     @return false: path is not a plan file
+bool MockLinkFTP::_planFileContents(const QString& path, QByteArray& contents)
+{
+    MAV_MISSION_TYPE missionType;
+    if (path == "@MISSION/mission.dat") {
+        missionType = MAV_MISSION_TYPE_MISSION;
+    } else if (path == "@MISSION/fence.dat") {
+        missionType = MAV_MISSION_TYPE_FENCE;
+    } else if (path == "@MISSION/rally.dat") {
+        missionType = MAV_MISSION_TYPE_RALLY;
+    } else {
+        return false;
+    }
+    contents = _mockLink->planFileContents(missionType);
+    return true;
+}
+
+/// @return Resource file which backs the specified vehicle path, empty if none
+QString MockLinkFTP::_resourceFileForPath(const QString& path)
+{
+    if (path == "/general.json") {
+        return ":MockLink/General.MetaData.json";
+    } else if (path == "/general.json.xz") {
+        return ":MockLink/General.MetaData.json.xz";
+    } else if (path == "/parameter.json") {
+        return ":MockLink/Parameter.MetaData.json";
+    } else if (path == "/parameter.json.xz") {
+        return ":MockLink/Parameter.MetaData.json.xz";
+    }
+    return QString();
+}
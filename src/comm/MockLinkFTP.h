@@ -14,6 +14,7 @@
 
 #include <QStringList>
 #include <QFile>
+#include <QMap>
 
 class MockLink;
 
@@ -55,6 +56,9 @@ public:
 
     void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
 
+    /// @return Contents of a file which was uploaded through kCmdCreateFile/kCmdWriteFile, empty if none
+    QByteArray uploadedFile(const QString& path) const { return _uploadedFiles.value(path); }
+
     static const char* sizeFilenamePrefix;
 
 signals:
@@ -73,10 +77,17 @@ private:
     void        _openCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _readCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _burstReadCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _createCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _writeCommand           (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _calcFileCrc32Command   (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _terminateCommand       (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _resetCommand           (uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
     uint16_t    _nextSeqNumber          (uint16_t seqNumber);
-    QString     _createTestTempFile     (int size);
+    QString     _createTempFile         (const QByteArray& contents);
+    bool        _planFileContents       (const QString& path, QByteArray& contents);
+
+    static QByteArray   _testFileContents   (int size);
+    static QString      _resourceFileForPath(const QString& path);
     
     /// if request is a string, this ensures it's null-terminated
     static void ensureNullTemination(MavlinkFTP::Request* request);
@@ -92,6 +103,8 @@ private:
     uint16_t                _lastReplySequence  = 0;
     mavlink_message_t       _lastReply;
     bool                    _randomDropsEnabled = false;
+    QMap<QString, QByteArray> _uploadedFiles;                   ///< Files written by the client, keyed by path
+    QString                 _writeFilePath;                     ///< Path of file open for writing, empty if none
 
     static const uint8_t    _sessionId          = 1;    ///< We only support a single fixed session
 };
@@ -12,6 +12,7 @@
 #include "MockLink.h"
 
 #include <QDebug>
+#include <QtEndian>
 
 QGC_LOGGING_CATEGORY(MockLinkMissionItemHandlerLog, "MockLinkMissionItemHandlerLog")
 
@@ -119,6 +120,7 @@ void MockLinkMissionItemHandler::_handleMissionRequestList(const mavlink_message
     qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequestList read sequence";
     
     _failReadRequest1FirstResponse = true;
+    _readRequests.clear();
 
     if (_failureMode == FailReadRequestListNoResponse) {
         qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequestList not responding due to failure mode FailReadRequestListNoResponse";
@@ -177,6 +179,8 @@ void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t&
     
     Q_ASSERT(request.target_system == _mockLink->vehicleId());
 
+    _readRequests.append(request.seq);
+
     if (_failureMode == FailReadRequest0NoResponse && request.seq == 0) {
         qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequest not responding due to failure mode FailReadRequest0NoResponse";
     } else if (_failureMode == FailReadRequest1NoResponse && request.seq == 1) {
@@ -184,6 +188,8 @@ void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t&
     } else if (_failureMode == FailReadRequest1FirstResponse && request.seq == 1 && _failReadRequest1FirstResponse) {
         _failReadRequest1FirstResponse = false;
         qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequest not responding due to failure mode FailReadRequest1FirstResponse";
+    } else if (_readDropSequenceNumbers.removeOne(request.seq)) {
+        qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequest dropping response to seq" << request.seq;
     } else {
         // FIXME: Track whether all items are requested, or requested in sequence
         
@@ -420,6 +426,37 @@ void MockLinkMissionItemHandler::setFailureMode(FailureMode_t failureMode, MAV_M
     _failureAckResult = failureAckResult;
 }
 
+QByteArray MockLinkMissionItemHandler::planFileContents(MAV_MISSION_TYPE missionType) const
+{
+    MissionItemList_t items;
+    switch (missionType) {
+    case MAV_MISSION_TYPE_MISSION:
+        items = _missionItems;
+        break;
+    case MAV_MISSION_TYPE_FENCE:
+        items = _fenceItems;
+        break;
+    case MAV_MISSION_TYPE_RALLY:
+        items = _rallyItems;
+        break;
+    default:
+        return QByteArray();
+    }
+
+    // Header: magic, type, options, start, count. Followed by the packed items.
+    QByteArray  bytes(_planFileHeaderSize, 0);
+    uchar*      header = reinterpret_cast<uchar*>(bytes.data());
+    qToLittleEndian<quint16>(_planFileMagic,                        header);
+    qToLittleEndian<quint16>(missionType,                           header + 2);
+    qToLittleEndian<quint16>(0,                                     header + 6);
+    qToLittleEndian<quint16>(static_cast<quint16>(items.count()),   header + 8);
+    for (const mavlink_mission_item_int_t& missionItem: items) {
+        bytes.append(reinterpret_cast<const char*>(&missionItem), sizeof(missionItem));
+    }
+
+    return bytes;
+}
+
 void MockLinkMissionItemHandler::shutdown(void)
 {
     if (_missionItemResponseTimer) {
@@ -76,7 +76,16 @@ public:
     void sendUnexpectedMissionRequest(void);
     
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
-    void reset(void) { _missionItems.clear(); }
+    void reset(void) { _missionItems.clear(); _readDropSequenceNumbers.clear(); _readRequests.clear(); }
+
+    /// MISSION_ITEM for each of these sequence numbers is dropped the first time it is requested
+    void setReadDropSequenceNumbers(const QList<uint16_t>& seqs) { _readDropSequenceNumbers = seqs; }
+
+    /// @return Sequence number of each MISSION_REQUEST received during the most recent read, in order
+    QList<uint16_t> readRequests(void) const { return _readRequests; }
+
+    /// @return Plan of the specified type in the ArduPilot @MISSION FTP file format
+    QByteArray planFileContents(MAV_MISSION_TYPE missionType) const;
 
     void setSendHomePositionOnEmptyList(bool sendHomePositionOnEmptyList) { _sendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
@@ -114,5 +123,10 @@ private:
     bool                _failReadRequestListFirstResponse;
     bool                _failReadRequest1FirstResponse;
     bool                _failWriteMissionCountFirstResponse;
+    QList<uint16_t>     _readDropSequenceNumbers;
+    QList<uint16_t>     _readRequests;
+
+    static const quint16 _planFileMagic         = 0x763d;   ///< ArduPilot @MISSION file header magic
+    static const int     _planFileHeaderSize    = 10;
 };
 
@@ -0,0 +1,292 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkSwarm.h"
+#include "MockLink.h"
+#include "QGCLoggingCategory.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(MockLinkSwarmLog, "MockLinkSwarmLog")
+
+// Same center as the default MockLink vehicle location
+const double    MockLinkSwarm::_centerLatitude      = 47.397;
+const double    MockLinkSwarm::_centerLongitude     = 8.5455;
+const double    MockLinkSwarm::_circleRadiusDegrees = 0.0005;
+const double    MockLinkSwarm::_swarmSpacingDegrees = 0.0015;
+int             MockLinkSwarm::_nextSystemId        = 1;
+
+MockLinkSwarm::MockLinkSwarm(MockLink* mockLink, int vehicleCount, int telemetryRateHz, double lossPct, int jitterMSecs, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType)
+    : QObject           (mockLink)
+    , _mockLink         (mockLink)
+    , _telemetryTimer   (this)
+    , _telemetryRateHz  (qBound(1, telemetryRateHz, 100))
+    , _lossPct          (qBound(0.0, lossPct, 100.0))
+    , _jitterMSecs      (qMax(0, jitterMSecs))
+    , _firmwareType     (firmwareType)
+    , _vehicleType      (vehicleType)
+{
+    vehicleCount = qBound(0, vehicleCount, static_cast<int>(maxVehicleCount));
+
+    // Vehicles are laid out on a square grid so their circles don't overlap
+    const int gridWidth = qCeil(qSqrt(vehicleCount));
+
+    _vehicles.resize(vehicleCount);
+    for (int i=0; i<vehicleCount; i++) {
+        SwarmVehicle_t& vehicle = _vehicles[i];
+
+        vehicle.systemId            = _allocateSystemId();
+        vehicle.random.seed(vehicle.systemId);
+        vehicle.centerLatitude      = _centerLatitude + ((i / gridWidth) * _swarmSpacingDegrees);
+        vehicle.centerLongitude     = _centerLongitude + ((i % gridWidth) * _swarmSpacingDegrees);
+        vehicle.angle               = vehicle.random.bounded(2.0 * M_PI);
+        vehicle.positionSeq         = 0;
+        vehicle.lastDeliveryMSecs   = 0;
+        vehicle.pendingPositionSlot = -1;
+        memset(&vehicle.mavlinkStatus, 0, sizeof(vehicle.mavlinkStatus));
+        for (int j=0; j<_latencyRingSize; j++) {
+            vehicle.positionEmitNsecs[j] = -1;
+        }
+    }
+
+    _telemetryTimer.setInterval(1000 / _telemetryRateHz);
+    _telemetryTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_telemetryTimer, &QTimer::timeout, this, &MockLinkSwarm::_telemetryTick);
+
+    qCDebug(MockLinkSwarmLog) << "MockLinkSwarm vehicleCount:telemetryRateHz:lossPct:jitterMSecs" << vehicleCount << _telemetryRateHz << _lossPct << _jitterMSecs;
+}
+
+MockLinkSwarm::~MockLinkSwarm()
+{
+    _telemetryTimer.stop();
+}
+
+void MockLinkSwarm::start(void)
+{
+    _tickCount = 0;
+    _telemetryTimer.start();
+    _telemetryTick();
+}
+
+void MockLinkSwarm::stop(void)
+{
+    _telemetryTimer.stop();
+}
+
+QList<int> MockLinkSwarm::systemIds(void) const
+{
+    QList<int> rgSystemIds;
+    for (const SwarmVehicle_t& vehicle: _vehicles) {
+        rgSystemIds.append(vehicle.systemId);
+    }
+    return rgSystemIds;
+}
+
+qint64 MockLinkSwarm::clockNsecs(void)
+{
+    static const QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+uint8_t MockLinkSwarm::_allocateSystemId(void)
+{
+    // Skip the id range used by regular MockLinks as well as the GCS id. Wrap around if the range is exhausted.
+    if (_nextSystemId >= _mockLinkSystemIdFirst && _nextSystemId <= _mockLinkSystemIdLast) {
+        _nextSystemId = _mockLinkSystemIdLast + 1;
+    }
+    if (_nextSystemId >= 255) {
+        _nextSystemId = 1;
+    }
+    return static_cast<uint8_t>(_nextSystemId++);
+}
+
+int MockLinkSwarm::_vehicleIndex(int systemId) const
+{
+    for (int i=0; i<_vehicles.count(); i++) {
+        if (_vehicles[i].systemId == systemId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+qint64 MockLinkSwarm::positionLatencyNsecs(int systemId, double altitudeRelative) const
+{
+    int vehicleIndex = _vehicleIndex(systemId);
+    if (vehicleIndex == -1) {
+        return -1;
+    }
+
+    int slot = qRound(altitudeRelative * 1000.0) - _relativeAltitudeMM;
+    if (slot < 0 || slot >= _latencyRingSize) {
+        return -1;
+    }
+
+    QMutexLocker locker(&_emitTimesMutex);
+    qint64 emitNsecs = _vehicles[vehicleIndex].positionEmitNsecs[slot];
+    return emitNsecs == -1 ? -1 : clockNsecs() - emitNsecs;
+}
+
+void MockLinkSwarm::_telemetryTick(void)
+{
+    if (!_mockLink->isConnected()) {
+        return;
+    }
+
+    const bool sendOneHz = (_tickCount++ % _telemetryRateHz) == 0;
+
+    // Message packing for each vehicle is independent so the whole swarm is generated in parallel
+    QtConcurrent::blockingMap(_vehicles, [this, sendOneHz](SwarmVehicle_t& vehicle) {
+        _generateVehicleTelemetry(vehicle, sendOneHz);
+    });
+
+    if (_jitterMSecs == 0) {
+        // Without jitter all vehicles are delivered as a single burst as they would be from a radio read
+        QByteArray bytes;
+        for (const SwarmVehicle_t& vehicle: _vehicles) {
+            bytes.append(vehicle.pendingBytes);
+        }
+        {
+            QMutexLocker locker(&_emitTimesMutex);
+            const qint64 nowNsecs = clockNsecs();
+            for (SwarmVehicle_t& vehicle: _vehicles) {
+                if (vehicle.pendingPositionSlot != -1) {
+                    vehicle.positionEmitNsecs[vehicle.pendingPositionSlot] = nowNsecs;
+                }
+            }
+        }
+        _mockLink->respondWithBytes(bytes);
+    } else {
+        const qint64 nowMSecs = QDateTime::currentMSecsSinceEpoch();
+        for (int i=0; i<_vehicles.count(); i++) {
+            SwarmVehicle_t& vehicle = _vehicles[i];
+            if (vehicle.pendingBytes.isEmpty()) {
+                continue;
+            }
+
+            qint64 deliveryMSecs = qMax(nowMSecs + vehicle.random.bounded(_jitterMSecs + 1), vehicle.lastDeliveryMSecs);
+            vehicle.lastDeliveryMSecs = deliveryMSecs;
+
+            QByteArray  bytes           = vehicle.pendingBytes;
+            int         positionSlot    = vehicle.pendingPositionSlot;
+            QTimer::singleShot(static_cast<int>(deliveryMSecs - nowMSecs), this, [this, i, bytes, positionSlot]() {
+                _deliver(i, bytes, positionSlot);
+            });
+        }
+    }
+}
+
+void MockLinkSwarm::_deliver(int vehicleIndex, const QByteArray& bytes, int positionSlot)
+{
+    if (positionSlot != -1) {
+        QMutexLocker locker(&_emitTimesMutex);
+        _vehicles[vehicleIndex].positionEmitNsecs[positionSlot] = clockNsecs();
+    }
+    _mockLink->respondWithBytes(bytes);
+}
+
+/// Called from the thread pool. Only touches state owned by this vehicle.
+void MockLinkSwarm::_generateVehicleTelemetry(SwarmVehicle_t& vehicle, bool sendOneHz)
+{
+    vehicle.pendingBytes.clear();
+    vehicle.pendingPositionSlot = -1;
+
+    // ~10 m/s around the circle independent of telemetry rate
+    const double angularVelocity    = 0.2;  // radians per second
+    const double deltaAngle         = angularVelocity / _telemetryRateHz;
+    vehicle.angle = fmod(vehicle.angle + deltaAngle, 2.0 * M_PI);
+
+    const double    heading         = qRadiansToDegrees(fmod(vehicle.angle + (M_PI / 2.0), 2.0 * M_PI));
+    const double    latitude        = vehicle.centerLatitude + (qSin(vehicle.angle) * _circleRadiusDegrees);
+    const double    longitude       = vehicle.centerLongitude + (qCos(vehicle.angle) * _circleRadiusDegrees);
+    const float     groundSpeed     = 10.0f;
+    const uint32_t  timeBootMs      = static_cast<uint32_t>(clockNsecs() / 1000000);
+
+    if (sendOneHz) {
+        mavlink_heartbeat_t heartbeat;
+        memset(&heartbeat, 0, sizeof(heartbeat));
+        heartbeat.type              = _vehicleType;
+        heartbeat.autopilot         = _firmwareType;
+        heartbeat.base_mode         = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | MAV_MODE_FLAG_SAFETY_ARMED;
+        heartbeat.system_status     = MAV_STATE_ACTIVE;
+        heartbeat.mavlink_version   = 3;
+        _appendMessage(vehicle, MAVLINK_MSG_ID_HEARTBEAT, &heartbeat, MAVLINK_MSG_ID_HEARTBEAT_MIN_LEN, MAVLINK_MSG_ID_HEARTBEAT_LEN, MAVLINK_MSG_ID_HEARTBEAT_CRC);
+
+        mavlink_sys_status_t sysStatus;
+        memset(&sysStatus, 0, sizeof(sysStatus));
+        sysStatus.voltage_battery   = 16000 - vehicle.random.bounded(200);
+        sysStatus.current_battery   = -1;
+        sysStatus.battery_remaining = 80;
+        _appendMessage(vehicle, MAVLINK_MSG_ID_SYS_STATUS, &sysStatus, MAVLINK_MSG_ID_SYS_STATUS_MIN_LEN, MAVLINK_MSG_ID_SYS_STATUS_LEN, MAVLINK_MSG_ID_SYS_STATUS_CRC);
+    }
+
+    mavlink_global_position_int_t globalPosition;
+    memset(&globalPosition, 0, sizeof(globalPosition));
+    const int positionSlot          = vehicle.positionSeq++ % _latencyRingSize;
+    globalPosition.time_boot_ms     = timeBootMs;
+    globalPosition.lat              = static_cast<int32_t>(latitude * 1e7);
+    globalPosition.lon              = static_cast<int32_t>(longitude * 1e7);
+    globalPosition.relative_alt     = _relativeAltitudeMM + positionSlot;
+    globalPosition.alt              = globalPosition.relative_alt + 488000;
+    globalPosition.vx               = static_cast<int16_t>(qCos(qDegreesToRadians(heading)) * groundSpeed * 100);
+    globalPosition.vy               = static_cast<int16_t>(qSin(qDegreesToRadians(heading)) * groundSpeed * 100);
+    globalPosition.hdg              = static_cast<uint16_t>(heading * 100);
+    if (_appendMessage(vehicle, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, &globalPosition, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_MIN_LEN, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_CRC)) {
+        vehicle.pendingPositionSlot = positionSlot;
+    }
+
+    mavlink_attitude_t attitude;
+    memset(&attitude, 0, sizeof(attitude));
+    attitude.time_boot_ms   = timeBootMs;
+    attitude.roll           = static_cast<float>(qDegreesToRadians(15.0) + ((vehicle.random.generateDouble() - 0.5) * 0.01));
+    attitude.pitch          = static_cast<float>((vehicle.random.generateDouble() - 0.5) * 0.01);
+    attitude.yaw            = static_cast<float>(qDegreesToRadians(heading > 180 ? heading - 360 : heading));
+    _appendMessage(vehicle, MAVLINK_MSG_ID_ATTITUDE, &attitude, MAVLINK_MSG_ID_ATTITUDE_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_LEN, MAVLINK_MSG_ID_ATTITUDE_CRC);
+
+    mavlink_vfr_hud_t vfrHud;
+    memset(&vfrHud, 0, sizeof(vfrHud));
+    vfrHud.airspeed     = groundSpeed;
+    vfrHud.groundspeed  = groundSpeed;
+    vfrHud.heading      = static_cast<int16_t>(heading);
+    vfrHud.throttle     = 50;
+    vfrHud.alt          = globalPosition.alt / 1000.0f;
+    _appendMessage(vehicle, MAVLINK_MSG_ID_VFR_HUD, &vfrHud, MAVLINK_MSG_ID_VFR_HUD_MIN_LEN, MAVLINK_MSG_ID_VFR_HUD_LEN, MAVLINK_MSG_ID_VFR_HUD_CRC);
+}
+
+/// Packs the payload into a message using the vehicle's own sequence numbering and appends it to the pending bytes
+///     @return false: message was dropped due to simulated loss
+bool MockLinkSwarm::_appendMessage(SwarmVehicle_t& vehicle, uint32_t msgId, const void* payload, uint8_t minLength, uint8_t length, uint8_t crcExtra)
+{
+    mavlink_message_t msg;
+
+    msg.msgid = msgId;
+    memcpy(_MAV_PAYLOAD_NON_CONST(&msg), payload, length);
+    mavlink_finalize_message_buffer(&msg, vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, &vehicle.mavlinkStatus, minLength, length, crcExtra);
+
+    // Sequence number is still consumed for lost messages so QGC sees the gap
+    if (_lossPct > 0 && (vehicle.random.generateDouble() * 100.0) < _lossPct) {
+        return false;
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+    vehicle.pendingBytes.append(reinterpret_cast<const char*>(buffer), cBuffer);
+
+    return true;
+}
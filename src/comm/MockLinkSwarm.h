@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QMutex>
+#include <QVector>
+#include <QRandomGenerator>
+#include <QLoggingCategory>
+
+#include "QGCMAVLink.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MockLinkSwarmLog)
+
+class MockLink;
+
+/// Simulates a swarm of telemetry only vehicles on a single MockLink. Each vehicle has its own system id
+/// and flies a small circle around the default MockLink location. Messages for all vehicles are generated
+/// in parallel on the global thread pool each telemetry tick and are then delivered through the owning link.
+///
+/// Swarm vehicles only send telemetry, they do not respond to parameter, mission or command requests. Use
+/// MAV_TYPE_GENERIC for the vehicle type when running under unit tests so the initial connect sequence is skipped.
+class MockLinkSwarm : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param mockLink         Link to deliver swarm telemetry through
+    /// @param vehicleCount     Number of vehicles to simulate, clamped to maxVehicleCount
+    /// @param telemetryRateHz  Rate for position, attitude and vfr hud messages. Heartbeat and sys status are always 1Hz.
+    /// @param lossPct          Percentage of messages randomly dropped (0-100)
+    /// @param jitterMSecs      Maximum random delay added to the delivery of each vehicle's messages
+    MockLinkSwarm(MockLink* mockLink, int vehicleCount, int telemetryRateHz, double lossPct, int jitterMSecs, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType);
+    ~MockLinkSwarm();
+
+    /// Starts telemetry generation. Must be called from the owning link thread.
+    void start  (void);
+    void stop   (void);
+
+    int         vehicleCount    (void) const { return _vehicles.count(); }
+    QList<int>  systemIds       (void) const;
+
+    /// Calculates the end to end latency for a relative altitude value received from a swarm vehicle. The low order millimeters of
+    /// the relative altitude encode the slot of the position message in a ring of emit times which allows the value from a Fact
+    /// update to be matched with the time the message was handed to the link.
+    ///     @return Latency in nanoseconds, -1 if no matching position message has been sent
+    qint64 positionLatencyNsecs(int systemId, double altitudeRelative) const;
+
+    /// @return Monotonic time in nanoseconds shared by all swarms and their consumers
+    static qint64 clockNsecs(void);
+
+    static const int maxVehicleCount = 200;
+
+private slots:
+    void _telemetryTick(void);
+
+private:
+    static const int _latencyRingSize = 64;
+
+    struct SwarmVehicle_t {
+        uint8_t             systemId;
+        mavlink_status_t    mavlinkStatus;              ///< Per vehicle sequence numbering, no shared channel state is used
+        QRandomGenerator    random;
+        double              centerLatitude;
+        double              centerLongitude;
+        double              angle;                      ///< Current position on circle in radians
+        uint32_t            positionSeq;
+        qint64              lastDeliveryMSecs;          ///< Jittered delivery never reorders a vehicle's own messages
+        QByteArray          pendingBytes;               ///< Messages generated by the most recent tick
+        int                 pendingPositionSlot;        ///< Latency ring slot for position message in pendingBytes, -1 for none
+        qint64              positionEmitNsecs[_latencyRingSize];
+    };
+
+    void _generateVehicleTelemetry  (SwarmVehicle_t& vehicle, bool sendOneHz);
+    bool _appendMessage             (SwarmVehicle_t& vehicle, uint32_t msgId, const void* payload, uint8_t minLength, uint8_t length, uint8_t crcExtra);
+    void _deliver                   (int vehicleIndex, const QByteArray& bytes, int positionSlot);
+    int  _vehicleIndex              (int systemId) const;
+
+    static uint8_t _allocateSystemId(void);
+
+    MockLink*               _mockLink;
+    QVector<SwarmVehicle_t> _vehicles;
+    QTimer                  _telemetryTimer;
+    int                     _telemetryRateHz;
+    double                  _lossPct;
+    int                     _jitterMSecs;
+    MAV_AUTOPILOT           _firmwareType;
+    MAV_TYPE                _vehicleType;
+    int                     _tickCount          = 0;
+    mutable QMutex          _emitTimesMutex;    ///< Protects SwarmVehicle_t::positionEmitNsecs which is read from the gui thread
+
+    static const double     _centerLatitude;
+    static const double     _centerLongitude;
+    static const double     _circleRadiusDegrees;
+    static const double     _swarmSpacingDegrees;
+    static const int32_t    _relativeAltitudeMM = 50000;
+    static const int        _mockLinkSystemIdFirst = 128;   ///< MockLink::_nextVehicleSystemId range which swarm ids stay clear of
+    static const int        _mockLinkSystemIdLast  = 159;
+    static int              _nextSystemId;
+};
@@ -150,6 +150,9 @@ public:
 
                     // Length of file chunk written by write command
                     uint32_t writeFileLength;
+
+                    // CRC32 returned by CalcFileCRC32 command
+                    uint32_t crc32;
                 };
             }) Request;
 
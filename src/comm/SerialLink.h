@@ -81,6 +81,7 @@ public:
     void        updateSettings  ();
     QString     settingsURL     () { return "SerialSettings.qml"; }
     QString     settingsTitle   () { return tr("Serial Link Settings"); }
+    int         defaultTxBytesPerSecond() const { return _usbDirect ? 0 : _baud / 10; }   ///< 8N1 framing, USB direct links are not baud limited
 
 signals:
     void baudChanged            ();
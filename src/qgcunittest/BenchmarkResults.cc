@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "BenchmarkResults.h"
+#include "QGCApplication.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QThread>
+
+const char* BenchmarkResults::_outputEnvVar       = "QGC_BENCHMARK_OUTPUT";
+const char* BenchmarkResults::_defaultOutputFile  = "QGCBenchmarkResults.json";
+
+QString BenchmarkResults::outputFile(void)
+{
+    QString outputFile = qEnvironmentVariable(_outputEnvVar);
+    if (outputFile.isEmpty()) {
+        outputFile = QDir::temp().absoluteFilePath(_defaultOutputFile);
+    }
+    return outputFile;
+}
+
+bool BenchmarkResults::write(const QString& benchmarkName) const
+{
+    const QString fileName = outputFile();
+
+    // Keep the results of other benchmarks which were written to the same file
+    QJsonObject jsonRoot;
+    QFile existingFile(fileName);
+    if (existingFile.open(QIODevice::ReadOnly)) {
+        QJsonParseError jsonParseError;
+        QJsonDocument   doc = QJsonDocument::fromJson(existingFile.readAll(), &jsonParseError);
+        if (jsonParseError.error == QJsonParseError::NoError && doc.isObject()) {
+            jsonRoot = doc.object();
+        } else {
+            qWarning() << "BenchmarkResults replacing unreadable results file" << fileName << jsonParseError.errorString();
+        }
+        existingFile.close();
+    }
+
+    QJsonObject benchmarkJson;
+    benchmarkJson["version"]    = qgcApp()->applicationVersion();
+    benchmarkJson["timestamp"]  = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    benchmarkJson["cpu"]        = QSysInfo::currentCpuArchitecture();
+    benchmarkJson["cpuCores"]   = QThread::idealThreadCount();
+    benchmarkJson["os"]         = QSysInfo::prettyProductName();
+#ifdef QT_DEBUG
+    benchmarkJson["buildType"]  = "debug";
+#else
+    benchmarkJson["buildType"]  = "release";
+#endif
+    benchmarkJson["results"]    = _results;
+
+    QJsonObject benchmarksJson = jsonRoot["benchmarks"].toObject();
+    benchmarksJson[benchmarkName] = benchmarkJson;
+    jsonRoot["benchmarks"] = benchmarksJson;
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(jsonRoot).toJson()) == -1 || !file.commit()) {
+        qWarning() << benchmarkName << "unable to write results" << fileName << file.errorString();
+        return false;
+    }
+    qDebug() << benchmarkName << "results written to" << fileName;
+    return true;
+}
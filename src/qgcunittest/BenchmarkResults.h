@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+/// Collects the results of a benchmark test and writes them as json to the file specified by the QGC_BENCHMARK_OUTPUT
+/// environment variable (defaults to QGCBenchmarkResults.json in the temp directory) so they can be tracked over time.
+///
+/// All benchmark tests share the output file. Each test owns the entry keyed by its name below "benchmarks", writing
+/// replaces only that entry so a run of several benchmarks keeps the results of all of them.
+class BenchmarkResults
+{
+public:
+    void append(const QJsonObject& result) { _results.append(result); }
+
+    /// Merges the collected results into the output file
+    ///     @param benchmarkName Name of the benchmark test, used as the key for the results
+    /// @return false: File could not be written
+    bool write(const QString& benchmarkName) const;
+
+    static QString outputFile(void);
+
+private:
+    QJsonArray _results;
+
+    static const char* _outputEnvVar;
+    static const char* _defaultOutputFile;
+};
@@ -0,0 +1,227 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTracerTest.h"
+#include "TelemetryTracer.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+#include "MultiVehicleManager.h"
+#include "MockLink.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+TelemetryTracerTest::TelemetryTracerTest(void)
+{
+
+}
+
+void TelemetryTracerTest::init(void)
+{
+    UnitTest::init();
+    TelemetryTracer::setEnabled(false);
+    TelemetryTracer::reset();
+}
+
+void TelemetryTracerTest::cleanup(void)
+{
+    TelemetryTracer::setEnabled(false);
+    TelemetryTracer::reset();
+    UnitTest::cleanup();
+}
+
+void TelemetryTracerTest::_histogramBuckets_test(void)
+{
+    // Values below the sub bucket count have their own exact bucket
+    for (quint64 value=0; value<static_cast<quint64>(TraceHistogram::subBucketCount); value++) {
+        QCOMPARE(TraceHistogram::bucketIndex(value), static_cast<int>(value));
+        QCOMPARE(TraceHistogram::bucketLowerBound(static_cast<int>(value)), value);
+    }
+
+    // Every value must fall within its bucket and the bucket width must stay within the relative error bound
+    const quint64 rgValues[] = { 16, 17, 31, 32, 33, 1000, 123456, 1000000, 999999999, Q_UINT64_C(0x7fffffffffffffff), Q_UINT64_C(0xffffffffffffffff) };
+    for (quint64 value: rgValues) {
+        int index = TraceHistogram::bucketIndex(value);
+        QVERIFY(index >= 0 && index < TraceHistogram::bucketCount);
+        quint64 lowerBound = TraceHistogram::bucketLowerBound(index);
+        QVERIFY(lowerBound <= value);
+        if (index + 1 < TraceHistogram::bucketCount) {
+            quint64 nextLowerBound = TraceHistogram::bucketLowerBound(index + 1);
+            QVERIFY(value < nextLowerBound);
+            QVERIFY(static_cast<double>(nextLowerBound - lowerBound) / lowerBound <= 1.0 / TraceHistogram::subBucketCount);
+        } else {
+            QCOMPARE(index, TraceHistogram::bucketCount - 1);
+        }
+    }
+
+    // Bucket indices must be monotonic across power of two boundaries
+    int lastIndex = -1;
+    for (int bit=0; bit<64; bit++) {
+        int index = TraceHistogram::bucketIndex(Q_UINT64_C(1) << bit);
+        QVERIFY(index > lastIndex);
+        lastIndex = index;
+    }
+}
+
+void TelemetryTracerTest::_histogramPercentile_test(void)
+{
+    TraceHistogram histogram;
+
+    QCOMPARE(histogram.count(), static_cast<quint64>(0));
+    QCOMPARE(histogram.valueAtPercentile(50), static_cast<quint64>(0));
+    QCOMPARE(histogram.min(), static_cast<quint64>(0));
+
+    // 1us - 1ms in 1us steps
+    for (quint64 value=1000; value<=1000000; value+=1000) {
+        histogram.record(value);
+    }
+
+    QCOMPARE(histogram.count(), static_cast<quint64>(1000));
+    QCOMPARE(histogram.min(), static_cast<quint64>(1000));
+    QCOMPARE(histogram.max(), static_cast<quint64>(1000000));
+    QCOMPARE(histogram.mean(), 500500.0);
+
+    const double maxRelativeError = 1.0 / TraceHistogram::subBucketCount;
+    const double rgPercentiles[]  = { 50, 90, 99, 99.9 };
+    for (double percentile: rgPercentiles) {
+        double expected = percentile * 10000;
+        double actual   = histogram.valueAtPercentile(percentile);
+        QVERIFY2(qAbs(actual - expected) / expected <= maxRelativeError, qPrintable(QStringLiteral("p%1 expected:actual %2:%3").arg(percentile).arg(expected).arg(actual)));
+    }
+    QCOMPARE(histogram.valueAtPercentile(100), histogram.max());
+
+    TraceHistogram other;
+    other.record(10);
+    histogram.merge(other);
+    QCOMPARE(histogram.count(), static_cast<quint64>(1001));
+    QCOMPARE(histogram.min(), static_cast<quint64>(10));
+
+    histogram.reset();
+    QCOMPARE(histogram.count(), static_cast<quint64>(0));
+    QCOMPARE(histogram.max(), static_cast<quint64>(0));
+}
+
+void TelemetryTracerTest::_scopeDisabled_test(void)
+{
+    {
+        TelemetryTracer::Scope scope(TelemetryTracer::StageVehicleMessage, 33);
+    }
+    TelemetryTracer::record(TelemetryTracer::StageProtocolReceive, TelemetryTracer::nowNsecs(), 1000, 10);
+
+    for (int stage=0; stage<TelemetryTracer::StageCount; stage++) {
+        QCOMPARE(TelemetryTracer::histogram(static_cast<TelemetryTracer::Stage_t>(stage)).count(), static_cast<quint64>(0));
+    }
+}
+
+void TelemetryTracerTest::_scopeEnabled_test(void)
+{
+    TelemetryTracer::setEnabled(true);
+
+    for (int i=0; i<3; i++) {
+        TelemetryTracer::Scope scope(TelemetryTracer::StageVehicleMessage, 33);
+    }
+
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageVehicleMessage).count(), static_cast<quint64>(3));
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageFactGroupFanOut).count(), static_cast<quint64>(0));
+
+    QVariantList rgStages = TelemetryTracer::stageStatistics();
+    QCOMPARE(rgStages.count(), static_cast<int>(TelemetryTracer::StageCount));
+    QVariantMap stageMap = rgStages[TelemetryTracer::StageVehicleMessage].toMap();
+    QCOMPARE(stageMap[QStringLiteral("name")].toString(), TelemetryTracer::stageName(TelemetryTracer::StageVehicleMessage));
+    QCOMPARE(stageMap[QStringLiteral("count")].toULongLong(), static_cast<quint64>(3));
+
+    TelemetryTracer::reset();
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageVehicleMessage).count(), static_cast<quint64>(0));
+}
+
+void TelemetryTracerTest::_endToEnd_test(void)
+{
+    TelemetryTracer::setEnabled(true);
+
+    // No origin, nothing recorded
+    TelemetryTracer::setOriginNsecs(0);
+    TelemetryTracer::recordEndToEnd(TelemetryTracer::originNsecs());
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageEndToEnd).count(), static_cast<quint64>(0));
+
+    const qint64 originOffsetNsecs = 5000000;
+    TelemetryTracer::setOriginNsecs(TelemetryTracer::nowNsecs() - originOffsetNsecs);
+    TelemetryTracer::recordEndToEnd(TelemetryTracer::originNsecs());
+    TelemetryTracer::setOriginNsecs(0);
+
+    TraceHistogram histogram = TelemetryTracer::histogram(TelemetryTracer::StageEndToEnd);
+    QCOMPARE(histogram.count(), static_cast<quint64>(1));
+    QVERIFY(histogram.min() >= static_cast<quint64>(originOffsetNsecs));
+}
+
+void TelemetryTracerTest::_chromeTrace_test(void)
+{
+    TelemetryTracer::setEnabled(true);
+
+    TelemetryTracer::record(TelemetryTracer::StageProtocolReceive, TelemetryTracer::nowNsecs(), 2000, 280);
+    TelemetryTracer::record(TelemetryTracer::StageVehicleMessage, TelemetryTracer::nowNsecs(), 1000, 33);
+
+    QJsonParseError error;
+    QJsonDocument   doc = QJsonDocument::fromJson(TelemetryTracer::chromeTraceJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(doc.isObject());
+
+    QJsonArray  rgTraceEvents   = doc.object()[QStringLiteral("traceEvents")].toArray();
+    int         metadataCount   = 0;
+    QJsonObject protocolEvent;
+    QJsonObject vehicleEvent;
+    for (const QJsonValue& value: rgTraceEvents) {
+        QJsonObject traceEvent = value.toObject();
+        QString     phase       = traceEvent[QStringLiteral("ph")].toString();
+        QString     name        = traceEvent[QStringLiteral("name")].toString();
+        if (phase == QStringLiteral("M")) {
+            metadataCount++;
+        } else if (name == TelemetryTracer::stageName(TelemetryTracer::StageProtocolReceive)) {
+            protocolEvent = traceEvent;
+        } else if (name == TelemetryTracer::stageName(TelemetryTracer::StageVehicleMessage)) {
+            vehicleEvent = traceEvent;
+        }
+    }
+
+    QVERIFY(metadataCount >= 1);
+    QCOMPARE(protocolEvent[QStringLiteral("ph")].toString(), QStringLiteral("X"));
+    QCOMPARE(protocolEvent[QStringLiteral("dur")].toDouble(), 2.0);
+    QCOMPARE(protocolEvent[QStringLiteral("args")].toObject()[QStringLiteral("bytes")].toInt(), 280);
+    QCOMPARE(vehicleEvent[QStringLiteral("args")].toObject()[QStringLiteral("msgid")].toInt(), 33);
+}
+
+void TelemetryTracerTest::_linkTiming_test(void)
+{
+    LinkManager*            linkManager         = qgcApp()->toolbox()->linkManager();
+    MultiVehicleManager*    multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+
+    MockLink* mockLink = MockLink::startPX4MockLink(false);
+    QVERIFY(mockLink);
+
+    // Enabling the tracer alone leaves the link side timing disconnected
+    TelemetryTracer::setEnabled(true);
+    QVERIFY(QTest::qWaitFor([]() { return TelemetryTracer::histogram(TelemetryTracer::StageProtocolReceive).count() > 0; }, 2000));
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageLinkQueue).count(), static_cast<quint64>(0));
+
+    linkManager->setTelemetryTracingEnabled(true);
+    QVERIFY(TelemetryTracer::enabled());
+    QVERIFY(QTest::qWaitFor([]() { return TelemetryTracer::histogram(TelemetryTracer::StageLinkQueue).count() > 0; }, 2000));
+
+    // Disabling through the link manager disconnects it again
+    linkManager->setTelemetryTracingEnabled(false);
+    QVERIFY(!TelemetryTracer::enabled());
+    TelemetryTracer::reset();
+    TelemetryTracer::setEnabled(true);
+    QVERIFY(QTest::qWaitFor([]() { return TelemetryTracer::histogram(TelemetryTracer::StageProtocolReceive).count() > 0; }, 2000));
+    QCOMPARE(TelemetryTracer::histogram(TelemetryTracer::StageLinkQueue).count(), static_cast<quint64>(0));
+    TelemetryTracer::setEnabled(false);
+
+    mockLink->disconnect();
+    QVERIFY(QTest::qWaitFor([&]() { return multiVehicleManager->vehicles()->count() == 0; }, 10000));
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for TelemetryTracer and TraceHistogram
+class TelemetryTracerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TelemetryTracerTest(void);
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _histogramBuckets_test     (void);
+    void _histogramPercentile_test  (void);
+    void _scopeDisabled_test        (void);
+    void _scopeEnabled_test         (void);
+    void _endToEnd_test             (void);
+    void _chromeTrace_test          (void);
+    void _linkTiming_test           (void);
+};
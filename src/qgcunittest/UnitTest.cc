@@ -369,7 +369,7 @@ QString UnitTest::_getSaveFileName(
     return _fileDialogResponseSingle(getSaveFileName);
 }
 
-void UnitTest::_connectMockLink(MAV_AUTOPILOT autopilot, MockConfiguration::FailureMode_t failureMode)
+void UnitTest::_connectMockLink(MAV_AUTOPILOT autopilot, MockConfiguration::FailureMode_t failureMode, bool ftpCapability)
 {
     Q_ASSERT(!_mockLink);
 
@@ -380,7 +380,7 @@ void UnitTest::_connectMockLink(MAV_AUTOPILOT autopilot, MockConfiguration::Fail
         _mockLink = MockLink::startPX4MockLink(false, failureMode);
         break;
     case MAV_AUTOPILOT_ARDUPILOTMEGA:
-        _mockLink = MockLink::startAPMArduCopterMockLink(false, failureMode);
+        _mockLink = MockLink::startAPMArduCopterMockLink(false, failureMode, ftpCapability);
         break;
     case MAV_AUTOPILOT_GENERIC:
         _mockLink = MockLink::startGenericMockLink(false, failureMode);
@@ -115,7 +115,8 @@ protected slots:
     virtual void cleanup(void);
 
 protected:
-    void _connectMockLink(MAV_AUTOPILOT autopilot = MAV_AUTOPILOT_PX4, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
+    /// @param ftpCapability true: ArduPilot MockLink advertises MAV_PROTOCOL_CAPABILITY_FTP
+    void _connectMockLink(MAV_AUTOPILOT autopilot = MAV_AUTOPILOT_PX4, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone, bool ftpCapability = false);
     void _connectMockLinkNoInitialConnectSequence(void) { _connectMockLink(MAV_AUTOPILOT_INVALID); }
     void _disconnectMockLink(void);
     void _missionItemsEqual(MissionItem& actual, MissionItem& expected);
@@ -27,6 +27,7 @@
 //#include "MainWindowTest.h"
 //#include "FileManagerTest.h"
 #include "ParameterManagerTest.h"
+#include "SettingsFactWriterTest.h"
 #include "MissionCommandTreeTest.h"
 //#include "LogDownloadTest.h"
 #include "SendMavCommandWithSignallingTest.h"
@@ -35,6 +36,7 @@
 #include "CameraSectionTest.h"
 #include "SpeedSectionTest.h"
 #include "PlanMasterControllerTest.h"
+#include "PlanBenchmarkTest.h"
 #include "MissionSettingsTest.h"
 #include "QGCMapPolygonTest.h"
 #include "AudioOutputTest.h"
@@ -48,8 +50,25 @@
 #include "FTPManagerTest.h"
 #include "MissionCommandTreeEditorTest.h"
 #include "VehicleLinkManagerTest.h"
+#include "MultiVehicleManagerTest.h"
 #include "LandingComplexItemTest.h"
 #include "InitialConnectTest.h"
+#include "ULogReaderTest.h"
+#include "ExifParserTest.h"
+#include "TimeSeriesRingBufferTest.h"
+#include "LogDownloadControllerTest.h"
+#include "ADSBTest.h"
+#include "ParameterSearchIndexTest.h"
+#include "UASMessageHandlerTest.h"
+#include "SwarmBenchmarkTest.h"
+#include "TelemetryTracerTest.h"
+#include "TrajectoryPointsTest.h"
+#include "MAVLinkForwarderTest.h"
+#include "MAVLinkFrameScannerTest.h"
+#include "MAVLinkParseBenchmarkTest.h"
+#include "LinkOutboundSchedulerTest.h"
+#include "TimerWheelTest.h"
+#include "CommandLatencyStatsTest.h"
 
 UT_REGISTER_TEST(ComponentInformationCacheTest)
 UT_REGISTER_TEST(FactSystemTestGeneric)
@@ -57,6 +76,7 @@ UT_REGISTER_TEST(FactSystemTestPX4)
 //UT_REGISTER_TEST(FileDialogTest)
 UT_REGISTER_TEST(GeoTest)
 UT_REGISTER_TEST(VehicleLinkManagerTest)
+UT_REGISTER_TEST(MultiVehicleManagerTest)
 //UT_REGISTER_TEST(MessageBoxTest)
 UT_REGISTER_TEST(SendMavCommandWithSignallingTest)
 UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
@@ -70,6 +90,7 @@ UT_REGISTER_TEST(MissionManagerTest)
 //UT_REGISTER_TEST(RadioConfigTest)
 //UT_REGISTER_TEST(FileManagerTest)
 UT_REGISTER_TEST(ParameterManagerTest)
+UT_REGISTER_TEST(SettingsFactWriterTest)
 UT_REGISTER_TEST(MissionCommandTreeTest)
 //UT_REGISTER_TEST(LogDownloadTest)
 UT_REGISTER_TEST(SurveyComplexItemTest)
@@ -86,8 +107,25 @@ UT_REGISTER_TEST(QGCMapPolylineTest)
 UT_REGISTER_TEST(CameraCalcTest)
 UT_REGISTER_TEST(FWLandingPatternTest)
 UT_REGISTER_TEST(LandingComplexItemTest)
+UT_REGISTER_TEST(ULogReaderTest)
+UT_REGISTER_TEST(ExifParserTest)
+UT_REGISTER_TEST(TimeSeriesRingBufferTest)
+UT_REGISTER_TEST(LogDownloadControllerTest)
+UT_REGISTER_TEST(ADSBTest)
+UT_REGISTER_TEST(ParameterSearchIndexTest)
+UT_REGISTER_TEST(UASMessageHandlerTest)
+UT_REGISTER_TEST(TelemetryTracerTest)
+UT_REGISTER_TEST(TrajectoryPointsTest)
+UT_REGISTER_TEST(MAVLinkForwarderTest)
+UT_REGISTER_TEST(MAVLinkFrameScannerTest)
+UT_REGISTER_TEST(LinkOutboundSchedulerTest)
+UT_REGISTER_TEST(TimerWheelTest)
+UT_REGISTER_TEST(CommandLatencyStatsTest)
 
 UT_REGISTER_TEST_STANDALONE(MissionCommandTreeEditorTest)
+UT_REGISTER_TEST_STANDALONE(PlanBenchmarkTest)
+UT_REGISTER_TEST_STANDALONE(SwarmBenchmarkTest)
+UT_REGISTER_TEST_STANDALONE(MAVLinkParseBenchmarkTest)
 
 // List of unit test which are currently disabled.
 // If disabling a new test, include reason in comment.
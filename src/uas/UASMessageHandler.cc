@@ -19,6 +19,8 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 
+#include <QMutexLocker>
+
 UASMessage::UASMessage(int componentid, int severity, QString text)
 {
     _compId   = componentid;
@@ -44,6 +46,7 @@ UASMessageHandler::UASMessageHandler(QGCApplication* app, QGCToolbox* toolbox)
     , _activeVehicle(nullptr)
     , _activeComponent(-1)
     , _multiComp(false)
+    , _messages(maxMessages, nullptr)
     , _errorCount(0)
     , _errorCountTotal(0)
     , _warningCount(0)
@@ -73,10 +76,15 @@ void UASMessageHandler::setToolbox(QGCToolbox *toolbox)
 void UASMessageHandler::clearMessages()
 {
     _mutex.lock();
-    while(_messages.count()) {
-        delete _messages.last();
-        _messages.pop_back();
+    for (int i=0; i<_cMessages; i++) {
+        UASMessage*& message = _messages[(_firstMessage + i) % maxMessages];
+        delete message;
+        message = nullptr;
     }
+    _firstMessage           = 0;
+    _cMessages              = 0;
+    _cFormattedCharsEvicted = 0;
+    _formattedMessages.clear();
     _errorCount   = 0;
     _warningCount = 0;
     _normalCount  = 0;
@@ -193,12 +201,12 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
         _latestError = severityText + " " + text;
     }
 
+    _appendMessage(message);
+    int count = _cMessages;
+
     _mutex.unlock();
 
     emit textMessageReceived(message);
-
-    _messages.append(message);
-    int count = _messages.count();
     emit textMessageCountChanged(count);
 
     if (_showErrorsInToolbar && message->severityIsError()) {
@@ -206,6 +214,39 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
     }
 }
 
+/// Adds the message to the ring buffer, evicting the oldest message once full. Must be called with access locked.
+void UASMessageHandler::_appendMessage(UASMessage* message)
+{
+    if (_cMessages == maxMessages) {
+        UASMessage* oldestMessage = _messages[_firstMessage];
+        // The formatted text is trimmed lazily to prevent a memmove of the whole string on every message
+        _cFormattedCharsEvicted += oldestMessage->_formatedText.length();
+        delete oldestMessage;
+
+        _messages[_firstMessage] = message;
+        _firstMessage = (_firstMessage + 1) % maxMessages;
+    } else {
+        _messages[(_firstMessage + _cMessages) % maxMessages] = message;
+        _cMessages++;
+    }
+
+    _formattedMessages += message->_formatedText;
+    if (_cFormattedCharsEvicted > _formattedMessages.length() / 2) {
+        _formattedMessages.remove(0, _cFormattedCharsEvicted);
+        _cFormattedCharsEvicted = 0;
+    }
+}
+
+QString UASMessageHandler::formattedMessages()
+{
+    QMutexLocker locker(&_mutex);
+    if (_cFormattedCharsEvicted) {
+        _formattedMessages.remove(0, _cFormattedCharsEvicted);
+        _cFormattedCharsEvicted = 0;
+    }
+    return _formattedMessages;
+}
+
 int UASMessageHandler::getErrorCountTotal() {
     _mutex.lock();
     int c = _errorCountTotal;
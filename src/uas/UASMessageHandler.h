@@ -62,10 +62,14 @@ class UASMessageHandler : public QGCTool
 {
     Q_OBJECT
 
+    friend class UASMessageHandlerTest;
+
 public:
     explicit UASMessageHandler(QGCApplication* app, QGCToolbox* toolbox);
     ~UASMessageHandler();
 
+    static const int maxMessages = 2000;    ///< Only the most recent messages are kept
+
     /**
      * @brief Locks access to the message list
      */
@@ -75,9 +79,9 @@ public:
      */
     void unlockAccess() {_mutex.unlock(); }
     /**
-     * @brief Access to the message list
+     * @brief Concatenated formatted text of the stored messages. Maintained incrementally as messages arrive.
      */
-    const QVector<UASMessage*>& messages() { return _messages; }
+    QString formattedMessages();
     /**
      * @brief Clear messages
      */
@@ -135,10 +139,16 @@ private slots:
     void _activeVehicleChanged(Vehicle* vehicle);
 
 private:
+    void _appendMessage(UASMessage* message);
+
     Vehicle*                _activeVehicle;
     int                     _activeComponent;
     bool                    _multiComp;
-    QVector<UASMessage*>    _messages;
+    QVector<UASMessage*>    _messages;                          ///< Ring buffer of maxMessages entries
+    int                     _firstMessage       = 0;            ///< Index of oldest message in _messages
+    int                     _cMessages          = 0;
+    QString                 _formattedMessages;
+    int                     _cFormattedCharsEvicted = 0;        ///< Characters of evicted messages still at the start of _formattedMessages
     QMutex                  _mutex;
     int                     _errorCount;
     int                     _errorCountTotal;
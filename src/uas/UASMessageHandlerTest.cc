@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UASMessageHandlerTest.h"
+#include "UASMessageHandler.h"
+#include "QGCApplication.h"
+#include "Vehicle.h"
+
+void UASMessageHandlerTest::init(void)
+{
+    UnitTest::init();
+
+    // Messages are only handled while there is an active vehicle
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+    _handler = qgcApp()->toolbox()->uasMessageHandler();
+    _handler->clearMessages();
+}
+
+void UASMessageHandlerTest::cleanup(void)
+{
+    _handler = nullptr;
+    _disconnectMockLink();
+    UnitTest::cleanup();
+}
+
+QString UASMessageHandlerTest::_messageText(int index)
+{
+    return QStringLiteral("message %1.").arg(index);
+}
+
+void UASMessageHandlerTest::_ringEvictionTest(void)
+{
+    const int cEvicted = 5;
+    const int cTotal   = UASMessageHandler::maxMessages + cEvicted;
+
+    for (int i=0; i<cTotal; i++) {
+        _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, _messageText(i));
+    }
+
+    // Only the most recent messages are kept, oldest first
+    QCOMPARE(_handler->_cMessages, static_cast<int>(UASMessageHandler::maxMessages));
+    QCOMPARE(_handler->_messages[_handler->_firstMessage]->getText(), _messageText(cEvicted));
+    QCOMPARE(_handler->_messages[(_handler->_firstMessage + _handler->_cMessages - 1) % UASMessageHandler::maxMessages]->getText(), _messageText(cTotal - 1));
+
+    const QString formattedMessages = _handler->formattedMessages();
+    QCOMPARE(formattedMessages.count(QStringLiteral("<br/>")), static_cast<int>(UASMessageHandler::maxMessages));
+    QVERIFY(!formattedMessages.contains(_messageText(cEvicted - 1)));
+    QVERIFY(formattedMessages.indexOf(_messageText(cEvicted)) < formattedMessages.indexOf(_messageText(cEvicted + 1)));
+
+    _handler->clearMessages();
+    QCOMPARE(_handler->_cMessages, 0);
+    QVERIFY(_handler->formattedMessages().isEmpty());
+}
+
+/// The per severity counts are consumed by the vehicle as each message arrives
+void UASMessageHandlerTest::_severityCountTest(void)
+{
+    const int errorCountTotal = _handler->getErrorCountTotal();
+
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO,      QStringLiteral("info"));
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_DEBUG,     QStringLiteral("debug"));
+    QCOMPARE(_vehicle->newMessageCount(), 2);
+    QVERIFY(_vehicle->messageTypeNormal());
+
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_WARNING,   QStringLiteral("warning"));
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_NOTICE,    QStringLiteral("notice"));
+    QCOMPARE(_vehicle->newMessageCount(), 4);
+    QVERIFY(_vehicle->messageTypeWarning());
+
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_CRITICAL,  QStringLiteral("critical"));
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_ERROR,     QStringLiteral("error"));
+    QCOMPARE(_vehicle->newMessageCount(), 6);
+    QVERIFY(_vehicle->messageTypeError());
+    QCOMPARE(_vehicle->messageCount(), 6);
+    QCOMPARE(_vehicle->latestError(), QStringLiteral(" Error: error"));
+
+    // Counts reset once read, except for the total error count
+    QCOMPARE(_handler->getErrorCount(),         0);
+    QCOMPARE(_handler->getWarningCount(),       0);
+    QCOMPARE(_handler->getNormalCount(),        0);
+    QCOMPARE(_handler->getErrorCountTotal(),    errorCountTotal + 2);
+
+    // Messages from a second component are tagged with their component id from then on
+    _handler->handleTextMessage(0, MAV_COMP_ID_CAMERA, MAV_SEVERITY_INFO, QStringLiteral("camera"));
+    QVERIFY(_handler->formattedMessages().contains(QStringLiteral(" COMP:%1] Info: camera").arg(MAV_COMP_ID_CAMERA)));
+    QCOMPARE(_handler->_cMessages, 7);
+}
+
+/// Evicted messages are trimmed from the formatted text lazily, once they make up half of it
+void UASMessageHandlerTest::_formattedTrimTest(void)
+{
+    for (int i=0; i<UASMessageHandler::maxMessages; i++) {
+        _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, _messageText(i));
+    }
+    QCOMPARE(_handler->_cFormattedCharsEvicted, 0);
+    const int fullLength = _handler->_formattedMessages.length();
+
+    // The evicted text stays in place until it makes up half of the string
+    int index = UASMessageHandler::maxMessages;
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, _messageText(index++));
+    QVERIFY(_handler->_cFormattedCharsEvicted > 0);
+    QVERIFY(_handler->_formattedMessages.length() > fullLength);
+
+    bool trimmed = false;
+    for (int i=0; i<UASMessageHandler::maxMessages && !trimmed; i++) {
+        const int cEvictedBefore = _handler->_cFormattedCharsEvicted;
+        _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, _messageText(index++));
+        QVERIFY(_handler->_cFormattedCharsEvicted * 2 <= _handler->_formattedMessages.length());
+        trimmed = _handler->_cFormattedCharsEvicted < cEvictedBefore;
+    }
+    QVERIFY(trimmed);
+    QCOMPARE(_handler->_cFormattedCharsEvicted, 0);
+
+    // Reading the text trims any remaining evicted messages
+    _handler->handleTextMessage(0, MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, _messageText(index++));
+    QVERIFY(_handler->_cFormattedCharsEvicted > 0);
+    const QString formattedMessages = _handler->formattedMessages();
+    QCOMPARE(_handler->_cFormattedCharsEvicted, 0);
+    QCOMPARE(formattedMessages.count(QStringLiteral("<br/>")), static_cast<int>(UASMessageHandler::maxMessages));
+    QVERIFY(formattedMessages.startsWith(_handler->_messages[_handler->_firstMessage]->getFormatedText()));
+}
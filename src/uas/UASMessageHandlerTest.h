@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class UASMessageHandler;
+
+class UASMessageHandlerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init(void) override;
+    void cleanup(void) override;
+
+    void _ringEvictionTest  (void);
+    void _severityCountTest (void);
+    void _formattedTrimTest (void);
+
+private:
+    static QString _messageText(int index);
+
+    UASMessageHandler* _handler = nullptr;
+};
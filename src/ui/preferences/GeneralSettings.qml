@@ -1035,6 +1035,26 @@ Rectangle {
                                 visible:                adsbGrid.adsbSettings.adsbServerPort.visible
                                 Layout.preferredWidth:  _valueFieldWidth
                             }
+
+                            QGCLabel {
+                                text:               adsbGrid.adsbSettings.adsbAlertHorizontalDistance.shortDescription
+                                visible:            adsbGrid.adsbSettings.adsbAlertHorizontalDistance.visible
+                            }
+                            FactTextField {
+                                fact:                   adsbGrid.adsbSettings.adsbAlertHorizontalDistance
+                                visible:                adsbGrid.adsbSettings.adsbAlertHorizontalDistance.visible
+                                Layout.preferredWidth:  _valueFieldWidth
+                            }
+
+                            QGCLabel {
+                                text:               adsbGrid.adsbSettings.adsbAlertVerticalDistance.shortDescription
+                                visible:            adsbGrid.adsbSettings.adsbAlertVerticalDistance.visible
+                            }
+                            FactTextField {
+                                fact:                   adsbGrid.adsbSettings.adsbAlertVerticalDistance
+                                visible:                adsbGrid.adsbSettings.adsbAlertVerticalDistance.visible
+                                Layout.preferredWidth:  _valueFieldWidth
+                            }
                         }
                     }
 
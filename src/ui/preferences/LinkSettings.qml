@@ -209,6 +209,17 @@ Rectangle {
                                     onCheckedChanged:   editingConfig.highLatency = checked
                                 }
 
+                                QGCLabel { text: qsTr("Bandwidth (bytes/s)") }
+                                QGCTextField {
+                                    Layout.preferredWidth:  _secondColumnWidth
+                                    Layout.fillWidth:       true
+                                    text:                   editingConfig.txBudget > 0 ? editingConfig.txBudget : ""
+                                    placeholderText:        qsTr("Automatic")
+                                    validator:              IntValidator { bottom: 0 }
+                                    inputMethodHints:       Qt.ImhDigitsOnly
+                                    onEditingFinished:      editingConfig.txBudget = text === "" ? 0 : parseInt(text)
+                                }
+
                                 QGCLabel { text: qsTr("Type") }
                                 QGCComboBox {
                                     Layout.preferredWidth:  _secondColumnWidth
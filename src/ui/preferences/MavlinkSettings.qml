@@ -179,6 +179,10 @@ Rectangle {
                         }
 
                     }
+                   QGCLabel {
+                        text:       qsTr("<i> Separate multiple targets with ';'. Filters may follow each host, i.e: localhost:14445 allowMsgIds=0,33 maxRateHz=5 </i>")
+                        visible:    QGroundControl.settingsManager.appSettings.forwardMavlinkHostName.visible
+                    }
                    QGCLabel {
                         text:       qsTr("<i> Changing the host name requires restart of application. </i>")
                         visible:    QGroundControl.settingsManager.appSettings.forwardMavlinkHostName.visible
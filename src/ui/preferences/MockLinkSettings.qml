@@ -27,6 +27,8 @@ GridLayout {
     readonly property int _MAV_TYPE_FIXED_WING:         1
     readonly property int _MAV_TYPE_QUADROTOR:          2
 
+    property bool _swarmEnabled: parseInt(swarmCountField.text) > 0
+
     function saveSettings() {
         switch (firmwareTypeCombo.currentIndex) {
         case 0:
@@ -46,6 +48,10 @@ GridLayout {
         }
         subEditConfig.sendStatus = sendStatus.checked
         subEditConfig.incrementVehicleId = incrementVehicleId.checked
+        subEditConfig.swarmCount = parseInt(swarmCountField.text)
+        subEditConfig.telemetryRateHz = parseInt(telemetryRateField.text)
+        subEditConfig.lossPct = parseFloat(lossPctField.text)
+        subEditConfig.jitterMSecs = parseInt(jitterField.text)
     }
 
     Component.onCompleted: {
@@ -100,4 +106,48 @@ GridLayout {
         model:                  [ qsTr("ArduCopter"), qsTr("ArduPlane") ]
         visible:                firmwareTypeCombo.apmFirmwareSelected
     }
+
+    QGCLabel { text: qsTr("Swarm Vehicles (0 = off)") }
+    QGCTextField {
+        id:                     swarmCountField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.swarmCount.toString()
+        inputMethodHints:       Qt.ImhDigitsOnly
+    }
+
+    QGCLabel {
+        text:       qsTr("Swarm Telemetry Rate (Hz)")
+        visible:    _swarmEnabled
+    }
+    QGCTextField {
+        id:                     telemetryRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.telemetryRateHz.toString()
+        inputMethodHints:       Qt.ImhDigitsOnly
+        visible:                _swarmEnabled
+    }
+
+    QGCLabel {
+        text:       qsTr("Swarm Message Loss (%)")
+        visible:    _swarmEnabled
+    }
+    QGCTextField {
+        id:                     lossPctField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.lossPct.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+        visible:                _swarmEnabled
+    }
+
+    QGCLabel {
+        text:       qsTr("Swarm Jitter (ms)")
+        visible:    _swarmEnabled
+    }
+    QGCTextField {
+        id:                     jitterField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.jitterMSecs.toString()
+        inputMethodHints:       Qt.ImhDigitsOnly
+        visible:                _swarmEnabled
+    }
 }
@@ -38,8 +38,16 @@ Item {
         _rgMenuItems.length = 0
 
         // Add new items
+        var rgLinkHealth = _activeVehicle ? _activeVehicle.vehicleLinkManager.linkHealth() : [ ]
         for (i = 0; i < _rgLinkNames.length; i++) {
-            var menuItem = linkSelectionMenuItemComponent.createObject(null, { "text": _rgLinkNames[i] + " " + _rgLinkStatus[i] })
+            var healthText = ""
+            for (var j = 0; j < rgLinkHealth.length; j++) {
+                var health = rgLinkHealth[j]
+                if (health.name === _rgLinkNames[i] && health.rttSamples > 0) {
+                    healthText = qsTr(" (%1 ms, %2% loss)").arg(Math.round(health.rttMSecs)).arg(Math.round(health.lossPercent))
+                }
+            }
+            var menuItem = linkSelectionMenuItemComponent.createObject(null, { "text": _rgLinkNames[i] + " " + _rgLinkStatus[i] + healthText, "linkName": _rgLinkNames[i] })
             _rgMenuItems.push(menuItem)
             linkSelectionMenu.insertItem(i, menuItem)
         }
@@ -60,7 +68,10 @@ Item {
 
         MouseArea {
             anchors.fill:   parent
-            onClicked:      linkSelectionMenu.popup()
+            onClicked: {
+                updateLinkSelectionMenu()
+                linkSelectionMenu.popup()
+            }
         }
     }
 
@@ -69,7 +80,8 @@ Item {
     Component {
         id: linkSelectionMenuItemComponent
         QGCMenuItem {
-            onTriggered: _activeVehicle.vehicleLinkManager.primaryLinkName = text
+            property string linkName
+            onTriggered: _activeVehicle.vehicleLinkManager.primaryLinkName = linkName
         }
     }
 }
@@ -83,15 +83,25 @@ Item {
             color:          qgcPal.window
             border.color:   qgcPal.text
 
+            // New messages are appended to the text as they arrive. The vehicle only keeps the most recent messages, so once
+            // that many have been appended the text is reloaded to drop the evicted ones instead of growing without bound.
+            property int    _cAppendedMessages:     0
+            property int    _maxAppendedMessages:   _activeVehicle.maxMessages
+            property string _messageFont:           "; font: " + (ScreenTools.defaultFontPointSize.toFixed(0) - 1) + "pt monospace;"
+            property string _warningStyle:          "color: " + qgcPal.warningText + _messageFont
+            property string _normalStyle:           "color: " + qgcPal.text + _messageFont
+
             function formatMessage(message) {
-                message = message.replace(new RegExp("<#E>", "g"), "color: " + qgcPal.warningText + "; font: " + (ScreenTools.defaultFontPointSize.toFixed(0) - 1) + "pt monospace;");
-                message = message.replace(new RegExp("<#I>", "g"), "color: " + qgcPal.warningText + "; font: " + (ScreenTools.defaultFontPointSize.toFixed(0) - 1) + "pt monospace;");
-                message = message.replace(new RegExp("<#N>", "g"), "color: " + qgcPal.text + "; font: " + (ScreenTools.defaultFontPointSize.toFixed(0) - 1) + "pt monospace;");
-                return message;
+                return message.replace(/<#E>|<#I>/g, _warningStyle).replace(/<#N>/g, _normalStyle)
             }
 
-            Component.onCompleted: {
+            function loadMessages() {
                 messageText.text = formatMessage(_activeVehicle.formattedMessages)
+                _cAppendedMessages = 0
+            }
+
+            Component.onCompleted: {
+                loadMessages()
                 //-- Hack to scroll to last message
                 for (var i = 0; i < _activeVehicle.messageCount; i++)
                     messageFlick.flick(0,-5000)
@@ -101,7 +111,11 @@ Item {
             Connections {
                 target: _activeVehicle
                 onNewFormattedMessage :{
-                    messageText.append(formatMessage(formattedMessage))
+                    if (++_cAppendedMessages >= _maxAppendedMessages) {
+                        loadMessages()
+                    } else {
+                        messageText.append(formatMessage(formattedMessage))
+                    }
                     //-- Hack to scroll down
                     messageFlick.flick(0,-500)
                 }